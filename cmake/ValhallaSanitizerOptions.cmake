@@ -3,6 +3,10 @@ if (ENABLE_SANITIZERS)
   set(ENABLE_UNDEFINED_SANITIZER ON)
 endif()
 
+if (ENABLE_THREAD_SANITIZER AND ENABLE_ADDRESS_SANITIZER)
+  message(FATAL_ERROR "The thread sanitizer (TSan) can't be combined with the address sanitizer (ASan).")
+endif()
+
 # Include build macros for updating configuration variables
 include(HandleLibcxxFlags)
 
@@ -27,6 +31,16 @@ if(ENABLE_UNDEFINED_SANITIZER)
   append_flags_if_supported(SANITIZER_SHARED_LINKER_FLAGS_LIST -fsanitize=undefined -fno-sanitize=vptr)
 endif()
 
+if(ENABLE_THREAD_SANITIZER)
+  message(STATUS "Enabling thread sanitizer (TSan).")
+  set(OLD_CMAKE_REQUIRED_FLAGS ${CMAKE_REQUIRED_FLAGS})
+  set(CMAKE_REQUIRED_FLAGS "${CMAKE_REQUIRED_FLAGS} -fsanitize=thread")
+  append_flags_if_supported(SANITIZER_FLAGS_LIST -fsanitize=thread -fno-omit-frame-pointer)
+  append_flags_if_supported(SANITIZER_EXE_LINKER_FLAGS_LIST -fsanitize=thread)
+  append_flags_if_supported(SANITIZER_SHARED_LINKER_FLAGS_LIST -fsanitize=thread)
+  set(CMAKE_REQUIRED_FLAGS ${OLD_CMAKE_REQUIRED_FLAGS})
+endif()
+
 list(JOIN SANITIZER_FLAGS_LIST " " SANITIZER_FLAGS_LIST)
 list(JOIN SANITIZER_EXE_LINKER_FLAGS_LIST " " SANITIZER_EXE_LINKER_FLAGS_LIST)
 list(JOIN SANITIZER_SHARED_LINKER_FLAGS_LIST " " SANITIZER_SHARED_LINKER_FLAGS_LIST)
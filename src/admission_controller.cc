@@ -0,0 +1,189 @@
+#include "admission_controller.h"
+#include "midgard/pointll.h"
+
+#include <algorithm>
+
+namespace {
+
+std::mutex installed_mutex;
+std::shared_ptr<valhalla::admission_controller_t> installed_controller;
+
+valhalla::midgard::PointLL to_ll(const valhalla::Location& location) {
+  return {location.ll().lng(), location.ll().lat()};
+}
+
+// kilometers along the locations in the order given
+float path_km(const google::protobuf::RepeatedPtrField<valhalla::Location>& locations) {
+  float meters = 0;
+  for (int i = 1; i < locations.size(); ++i) {
+    meters += to_ll(locations.Get(i - 1)).Distance(to_ll(locations.Get(i)));
+  }
+  return meters / 1000.f;
+}
+
+// most of the distance of a matrix is covered by its longest connection
+float span_km(const google::protobuf::RepeatedPtrField<valhalla::Location>& sources,
+              const google::protobuf::RepeatedPtrField<valhalla::Location>& targets) {
+  float meters = 0;
+  for (const auto& source : sources) {
+    for (const auto& target : targets) {
+      meters = std::max(meters, static_cast<float>(to_ll(source).Distance(to_ll(target))));
+    }
+  }
+  return meters / 1000.f;
+}
+
+} // namespace
+
+namespace valhalla {
+
+admission_controller_t::admission_controller_t(const boost::property_tree::ptree& config)
+    : heavy_cost_(config.get<float>("heavy_cost", 0.f)),
+      max_wait_(config.get<uint32_t>("max_wait_ms", 0)),
+      lease_duration_(config.get<uint32_t>("lease_seconds", 600)),
+      max_waiting_(config.get<uint32_t>("max_waiting", 0)), waiting_count_(0), next_ticket_(1) {
+  for (int action = 0; action < Options::Action_ARRAYSIZE; ++action) {
+    const auto& name = Options_Action_Name(static_cast<Options::Action>(action));
+    // 0 leaves heavy requests of the action unlimited
+    max_heavy_[action] = config.get<uint32_t>("max_heavy." + name, 0);
+    in_flight_[action] = 0;
+  }
+}
+
+void admission_controller_t::install(const std::shared_ptr<admission_controller_t>& controller) {
+  std::lock_guard<std::mutex> lock(installed_mutex);
+  installed_controller = controller;
+}
+
+std::shared_ptr<admission_controller_t> admission_controller_t::installed() {
+  std::lock_guard<std::mutex> lock(installed_mutex);
+  return installed_controller;
+}
+
+float admission_controller_t::estimate_cost(const Api& api) {
+  const auto& options = api.options();
+  auto action = options.action();
+  if (action == Options::expansion) {
+    action = options.expansion_action();
+  }
+
+  float cost = 0;
+  switch (action) {
+    case Options::route:
+    case Options::centroid:
+      cost = path_km(options.locations());
+      break;
+    case Options::optimized_route:
+      // a matrix between all of the locations and then a route through them
+      cost = options.locations_size() * options.locations_size() +
+             path_km(options.locations()) * 2;
+      break;
+    case Options::sources_to_targets:
+      cost = options.sources_size() * options.targets_size() +
+             span_km(options.sources(), options.targets());
+      break;
+    case Options::isochrone: {
+      // the expanded area grows with the square of the largest contour, in km or about a km a minute
+      float largest = 0;
+      for (const auto& contour : options.contours()) {
+        largest = std::max({largest, contour.time(), contour.distance()});
+      }
+      cost = options.locations_size() * largest * largest / 4.f;
+      break;
+    }
+    case Options::trace_route:
+    case Options::trace_attributes:
+      cost = path_km(options.shape()) + options.shape_size() / 10.f;
+      break;
+    default:
+      return 0;
+  }
+
+  // transit schedules make for many more labels per edge
+  if (options.costing_type() == Costing::multimodal || options.costing_type() == Costing::transit) {
+    cost *= 4;
+  }
+  return cost;
+}
+
+bool admission_controller_t::admit(Api& api, float cost) {
+  const auto action = api.options().action();
+  if (heavy_cost_ <= 0 || cost < heavy_cost_ || max_heavy_[action] == 0) {
+    return true;
+  }
+
+  // take a free slot unless others are already waiting for one
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto& waiting = waiting_[action];
+  expire_leases(std::chrono::steady_clock::now());
+  bool admitted = in_flight_[action] < max_heavy_[action] && waiting.empty();
+
+  // the caller's worker is blocked while it waits, so once enough requests wait the rest are
+  // turned away right away rather than taking the workers which cheap requests need
+  if (!admitted && max_wait_.count() > 0 && waiting_count_ < max_waiting_) {
+    // queue up behind the cheaper requests and those of the same cost which came first
+    const auto ticket = std::make_pair(cost, next_ticket_++);
+    waiting.insert(ticket);
+    ++waiting_count_;
+    const auto deadline = std::chrono::steady_clock::now() + max_wait_;
+    admitted = slot_freed_.wait_until(lock, deadline, [&]() {
+      expire_leases(std::chrono::steady_clock::now());
+      return in_flight_[action] < max_heavy_[action] && *waiting.begin() == ticket;
+    });
+    waiting.erase(ticket);
+    --waiting_count_;
+  }
+
+  // either way the next request in line may now be first and find a free slot
+  if (admitted) {
+    ++in_flight_[action];
+    const auto lease = next_ticket_++;
+    leases_.emplace(lease, lease_t{action, std::chrono::steady_clock::now() + lease_duration_});
+    api.mutable_info()->set_admission_slot(lease);
+  }
+  lock.unlock();
+  slot_freed_.notify_all();
+  return admitted;
+}
+
+void admission_controller_t::release(Api& api) {
+  const auto lease = api.info().admission_slot();
+  if (lease == 0) {
+    return;
+  }
+  api.mutable_info()->set_admission_slot(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto found = leases_.find(lease);
+  // the lease may have expired already
+  if (found == leases_.end()) {
+    return;
+  }
+  --in_flight_[found->second.action];
+  leases_.erase(found);
+  lock.unlock();
+  slot_freed_.notify_all();
+}
+
+void admission_controller_t::expire_leases(std::chrono::steady_clock::time_point now) {
+  for (auto lease = leases_.begin(); lease != leases_.end();) {
+    if (lease->second.expires <= now) {
+      --in_flight_[lease->second.action];
+      lease = leases_.erase(lease);
+    } else {
+      ++lease;
+    }
+  }
+}
+
+uint32_t admission_controller_t::in_flight(Options::Action action) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return in_flight_[action];
+}
+
+uint32_t admission_controller_t::waiting(Options::Action action) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return waiting_[action].size();
+}
+
+} // namespace valhalla
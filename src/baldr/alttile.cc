@@ -0,0 +1,101 @@
+#include "baldr/alttile.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+
+#include <fstream>
+
+namespace valhalla {
+namespace baldr {
+
+std::string AltTile::FileName(const std::string& alt_dir, const GraphId& tile_id) {
+  return alt_dir + filesystem::path::preferred_separator +
+         GraphTile::FileSuffix(tile_id.Tile_Base(), SUFFIX_ALT);
+}
+
+std::shared_ptr<const AltTile> AltTile::Create(const std::string& alt_dir,
+                                               const GraphTile& graph_tile) {
+  const auto tile_id = graph_tile.id();
+  std::ifstream file(FileName(alt_dir, tile_id), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    return nullptr;
+  }
+
+  auto tile = std::make_shared<AltTile>();
+  if (!file.read(reinterpret_cast<char*>(&tile->header_), sizeof(AltTileHeader))) {
+    LOG_WARN("Could not read the landmark side tile header of " + std::to_string(tile_id));
+    return nullptr;
+  }
+  // distances of another build would not be a lower bound anymore
+  if (tile->header_.dataset_id != graph_tile.header()->dataset_id() ||
+      tile->header_.node_count != graph_tile.header()->nodecount()) {
+    LOG_WARN("The landmark side tile of " + std::to_string(tile_id) +
+             " was computed for another build of the graph tile");
+    return nullptr;
+  }
+
+  tile->distances_.resize(static_cast<size_t>(tile->header_.landmark_count) *
+                          tile->header_.node_count);
+  if (!file.read(reinterpret_cast<char*>(tile->distances_.data()),
+                 tile->distances_.size() * sizeof(uint32_t))) {
+    LOG_WARN("Could not read the landmark distances of " + std::to_string(tile_id));
+    return nullptr;
+  }
+  return tile;
+}
+
+namespace {
+
+// Default number of bytes of side tiles kept in memory
+constexpr size_t kDefaultAltCacheSize = 256 * 1024 * 1024;
+
+// Bookkeeping bytes per cached tile, so missing tiles count towards the budget too
+constexpr size_t kAltCacheEntryOverhead = 64;
+
+size_t entry_size(const std::shared_ptr<const AltTile>& tile) {
+  return kAltCacheEntryOverhead + (tile ? tile->SizeBytes() : 0);
+}
+
+} // namespace
+
+AltLandmarks::AltLandmarks(const boost::property_tree::ptree& pt)
+    : alt_dir_(pt.get<std::string>("alt_dir", "")),
+      max_cache_size_(pt.get<size_t>("alt_cache_size", kDefaultAltCacheSize)), cache_size_(0) {
+}
+
+std::shared_ptr<const AltTile> AltLandmarks::GetTile(const graph_tile_ptr& graph_tile) {
+  if (!graph_tile) {
+    return nullptr;
+  }
+  const auto base = graph_tile->id();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = tiles_.find(base);
+    if (found != tiles_.end()) {
+      lru_.splice(lru_.begin(), lru_, found->second);
+      return found->second->second;
+    }
+  }
+
+  // read the tile without holding the lock, if another thread beat us to it we use its copy
+  auto tile = AltTile::Create(alt_dir_, *graph_tile);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto inserted = tiles_.emplace(base, lru_.end());
+  if (!inserted.second) {
+    lru_.splice(lru_.begin(), lru_, inserted.first->second);
+    return inserted.first->second->second;
+  }
+  lru_.emplace_front(base, std::move(tile));
+  inserted.first->second = lru_.begin();
+  cache_size_ += entry_size(lru_.front().second);
+
+  // evict the least recently used tiles, the ones still in use stay alive through their callers
+  while (cache_size_ > max_cache_size_ && lru_.size() > 1) {
+    cache_size_ -= entry_size(lru_.back().second);
+    tiles_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  return lru_.front().second;
+}
+
+} // namespace baldr
+} // namespace valhalla
@@ -8,6 +8,9 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <string>
 #include <utility>
 
@@ -558,8 +561,10 @@ graph_tile_ptr GraphReader::GetGraphTile(const GraphId& graphid) {
   auto base = graphid.Tile_Base();
   if (const auto& cached = cache_->Get(base)) {
     // LOG_DEBUG("Memory cache hit " + GraphTile::FileSuffix(base));
+    ++tile_stats_.cache_hits;
     return cached;
   }
+  ++tile_stats_.cache_misses;
 
   // Try getting it from the memmapped tar extract
   if (!tile_extract_->tiles.empty()) {
@@ -630,6 +635,48 @@ graph_tile_ptr GraphReader::GetGraphTile(const GraphId& graphid) {
   }
 }
 
+uint64_t GraphReader::GetTrafficLastUpdate() const {
+  uint64_t last_update = 0;
+  for (const auto& tile : tile_extract_->traffic_tiles) {
+    // the traffic tiles are updated in place by another process
+    const volatile auto* header =
+        reinterpret_cast<const volatile TrafficTileHeader*>(tile.second.first);
+    const uint64_t updated = header->last_update;
+    last_update = std::max(last_update, updated);
+  }
+  return last_update;
+}
+
+uint64_t GraphReader::GetTileSetVersion() const {
+  try {
+    // the extract is replaced as a whole
+    if (!tile_extract_->tiles.empty()) {
+      return std::chrono::system_clock::to_time_t(filesystem::last_write_time(tile_extract()));
+    }
+    if (tile_dir_.empty()) {
+      return 0;
+    }
+
+    // every tile of a build has the same dataset id, the smallest id makes the choice stable. the
+    // mtime of the directory itself doesn't change when the tiles below it are replaced
+    auto ids = GetTileSet(0);
+    if (ids.empty()) {
+      return 0;
+    }
+    const auto path = tile_dir_ + filesystem::path::preferred_separator +
+                      GraphTile::FileSuffix(*std::min_element(ids.begin(), ids.end()));
+    GraphTileHeader header;
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+      return 0;
+    }
+    if (header.dataset_id() != 0) {
+      return header.dataset_id();
+    }
+    return std::chrono::system_clock::to_time_t(filesystem::last_write_time(path));
+  } catch (...) { return 0; }
+}
+
 // Convenience method to get an opposing directed edge graph Id.
 GraphId GraphReader::GetOpposingEdgeId(const GraphId& edgeid, graph_tile_ptr& opp_tile) {
   // If you cant get the tile you get an invalid id
@@ -56,35 +56,45 @@ std::string VerbalTextFormatter::Format(const std::string& text) const {
   return verbal_text;
 }
 
-std::string VerbalTextFormatter::ProcessNumberSplitMatch(const std::smatch& m) const {
-  std::string tts;
-  if (m[1].matched) {
-    tts += m[1].str();
-  }
-
-  std::string num = m[2].str();
-  const size_t step = 2;
-  const char space = ' ';
-  for (size_t i = (num.size() % 2 == 0) ? step : (step - 1); i < num.size(); i += step + 1) {
-    num.insert(num.begin() + i, space);
-  }
-  tts += num;
+std::string VerbalTextFormatter::FormNumberSplitTts(const std::string& source) const {
+  return SplitNumbers(source, false);
+}
 
-  if (m[3].matched) {
-    tts += m[3].str();
-  }
+std::string VerbalTextFormatter::SplitNumbers(const std::string& source,
+                                              bool keep_ordinals) const {
+  std::string tts;
+  tts.reserve(source.size() + source.size() / 2);
+  for (size_t i = 0; i < source.size();) {
+    if (!is_ascii_digit(source[i])) {
+      tts.push_back(source[i++]);
+      continue;
+    }
 
-  return tts;
-}
+    size_t end = i;
+    while (end < source.size() && is_ascii_digit(source[end])) {
+      ++end;
+    }
 
-std::string VerbalTextFormatter::FormNumberSplitTts(const std::string& source) const {
+    // if the number has st,nd,rd,th appended to it then do not split it
+    bool ordinal = false;
+    if (keep_ordinals && end + 1 < source.size()) {
+      const char a = ascii_tolower(source[end]);
+      const char b = ascii_tolower(source[end + 1]);
+      ordinal = (a == 's' && b == 't') || (a == 'n' && b == 'd') || (a == 'r' && b == 'd') ||
+                (a == 't' && b == 'h');
+    }
 
-  std::string tts;
-  for (std::sregex_iterator it(source.begin(), source.end(), kNumberSplitRegex), end_it; it != end_it;
-       ++it) {
-    tts += ProcessNumberSplitMatch(*it);
+    // a space before every pair of digits counting from the end
+    const size_t count = end - i;
+    for (size_t d = 0; d < count; ++d) {
+      if (!ordinal && d != 0 && (count - d) % 2 == 0) {
+        tts.push_back(' ');
+      }
+      tts.push_back(source[i + d]);
+    }
+    i = end;
   }
-  return tts.empty() ? source : tts;
+  return tts;
 }
 
 } // namespace baldr
@@ -2,9 +2,202 @@
 #include "baldr/verbal_text_formatter.h"
 #include "midgard/util.h"
 
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+using namespace valhalla::baldr;
+
+bool is_word(const std::string& source, size_t pos) {
+  return pos < source.size() &&
+         (is_ascii_alpha(source[pos]) || is_ascii_digit(source[pos]) || source[pos] == '_');
+}
+
+bool is_separator(const std::string& source, size_t pos) {
+  return pos < source.size() && (source[pos] == ' ' || source[pos] == '-');
+}
+
+// Case insensitive comparison of the text at the position
+bool matches(const std::string& source, size_t pos, const char* text) {
+  for (; *text; ++text, ++pos) {
+    if (pos >= source.size() || ascii_tolower(source[pos]) != ascii_tolower(*text)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The number of characters of a kind from the position, but at most max
+template <typename predicate_t>
+size_t count(const std::string& source, size_t pos, size_t max, predicate_t predicate) {
+  size_t n = 0;
+  while (n < max && pos + n < source.size() && predicate(source[pos + n])) {
+    ++n;
+  }
+  return n;
+}
+
+} // namespace
+
 namespace valhalla {
 namespace baldr {
 
+bool RouteRule::Match(const std::string& source, size_t pos, size_t& keep, size_t& end) const {
+  // The prefix has to start a word
+  if (!is_word(source, pos) || (pos > 0 && is_word(source, pos - 1))) {
+    return false;
+  }
+  for (const char* c = prefix; *c; ++c) {
+    if (pos >= source.size() || ascii_tolower(source[pos]) != ascii_tolower(*c)) {
+      return false;
+    }
+    ++pos;
+    if (split_prefix && *(c + 1) && is_separator(source, pos)) {
+      ++pos;
+    }
+  }
+
+  // The separator between the prefix and the number
+  if (separator != Separator::kNone && is_separator(source, pos)) {
+    ++pos;
+  } else if (separator == Separator::kRequired) {
+    return false;
+  }
+  keep = pos;
+
+  // Routes which are only letters have to end a word
+  auto ends_word = [&](size_t at) { return !is_word(source, at); };
+  if (max_digits == 0) {
+    for (size_t letters = count(source, pos, 2, is_ascii_alpha); letters > 0; --letters) {
+      if (ends_word(pos + letters)) {
+        end = pos + letters;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Try with and without the optional infix, then the longest letters and numbers first
+  const size_t infix_length = std::strlen(infix);
+  for (bool with_infix : {true, false}) {
+    if (with_infix && (infix_length == 0 || !matches(source, pos, infix))) {
+      continue;
+    }
+    const size_t start = pos + (with_infix ? infix_length : 0);
+    const size_t max_leading = leading_letters ? count(source, start, 2, is_ascii_alpha) : 0;
+    for (size_t leading = max_leading + 1; leading-- > 0;) {
+      const size_t number = start + leading;
+      for (size_t digits = count(source, number, max_digits, is_ascii_digit); digits > 0; --digits) {
+        if (!trailing_letters) {
+          end = number + digits;
+          return true;
+        }
+        const size_t max_trailing = count(source, number + digits, 2, is_ascii_alpha);
+        for (size_t trailing = max_trailing + 1; trailing-- > 0;) {
+          if (ends_word(number + digits + trailing)) {
+            end = number + digits + trailing;
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
+std::string RouteRule::Replace(const std::string& source) const {
+  std::string tts;
+  size_t copied = 0;
+  for (size_t pos = 0; pos < source.size();) {
+    size_t keep, end;
+    if (ascii_tolower(source[pos]) != ascii_tolower(*prefix) || !Match(source, pos, keep, end)) {
+      ++pos;
+      continue;
+    }
+    tts.append(source, copied, pos - copied);
+    tts.append(label);
+    tts.push_back(' ');
+    tts.append(source, keep, end - keep);
+    pos = copied = end;
+  }
+
+  // Nothing was replaced
+  if (copied == 0) {
+    return source;
+  }
+  tts.append(source, copied, std::string::npos);
+  return tts;
+}
+
+std::string RoundNumberRule::Replace(const std::string& source) const {
+  const size_t zeros_length = std::strlen(zeros);
+  auto is_non_zero_digit = [](const char c) { return c >= '1' && c <= '9'; };
+
+  std::string tts;
+  size_t copied = 0;
+  for (size_t pos = 0; pos < source.size();) {
+    // Either the start of the text or a non digit comes before the number
+    bool found = false;
+    size_t digits_end = 0, end = 0;
+    for (size_t before : {0, 1}) {
+      if ((before == 0 && pos != 0) || (before == 1 && is_ascii_digit(source[pos]))) {
+        continue;
+      }
+      const size_t number = pos + before;
+      for (size_t digits = count(source, number, 2, is_non_zero_digit); digits > 0 && !found;
+           --digits) {
+        digits_end = number + digits;
+        const size_t after = digits_end + zeros_length;
+        if (source.compare(digits_end, zeros_length, zeros) != 0) {
+          continue;
+        }
+        switch (ending) {
+          case Ending::kEnd:
+            found = after == source.size();
+            end = after;
+            break;
+          case Ending::kOrdinal:
+            found = matches(source, after, "th");
+            end = after + 2;
+            break;
+          case Ending::kSeparator:
+            found = is_separator(source, after);
+            end = after + 1;
+            break;
+          case Ending::kNonDigit:
+            found = after < source.size() && !is_ascii_digit(source[after]);
+            end = after;
+            break;
+        }
+      }
+      if (found) {
+        break;
+      }
+    }
+
+    if (!found) {
+      ++pos;
+      continue;
+    }
+    tts.append(source, copied, digits_end - copied);
+    tts.append(spoken);
+    pos = copied = end;
+    // The non digit after the number is kept but it cannot start the next number
+    if (ending == Ending::kNonDigit) {
+      tts.push_back(source[pos]);
+      pos = ++copied;
+    }
+  }
+
+  // Nothing was replaced
+  if (copied == 0) {
+    return source;
+  }
+  tts.append(source, copied, std::string::npos);
+  return tts;
+}
+
 VerbalTextFormatterUs::VerbalTextFormatterUs(const std::string& country_code,
                                              const std::string& state_code)
     : VerbalTextFormatter(country_code, state_code) {
@@ -31,57 +224,23 @@ std::string VerbalTextFormatterUs::Format(const std::string& text) const {
   return verbal_text;
 }
 
-std::string VerbalTextFormatterUs::ProcessNumberSplitMatch(const std::smatch& m) const {
-  std::string tts;
-  if (m[1].matched) {
-    tts += m[1].str();
-  }
-
-  // if source number has st,nd,rd,th appended to it
-  // then do not split the number just return source value
-  if (m[3].matched) {
-    tts += m[2].str();
-    tts += m[3].str();
-  } else {
-    std::string num = m[2].str();
-    const size_t step = 2;
-    const char space = ' ';
-    for (size_t i = (num.size() % 2 == 0) ? step : (step - 1); i < num.size(); i += step + 1) {
-      num.insert(num.begin() + i, space);
-    }
-    tts += num;
-  }
-
-  if (m[4].matched) {
-    tts += m[4].str();
-  }
-
-  return tts;
-}
-
 std::string VerbalTextFormatterUs::FormNumberSplitTts(const std::string& source) const {
-
-  std::string tts;
-  for (std::sregex_iterator it(source.begin(), source.end(), kUsNumberSplitRegex), end_it;
-       it != end_it; ++it) {
-    tts += ProcessNumberSplitMatch(*it);
-  }
-  return tts.empty() ? source : tts;
+  return SplitNumbers(source, true);
 }
 
 std::string VerbalTextFormatterUs::FormInterstateTts(const std::string& source) const {
-  return std::regex_replace(source, kInterstateRegex, kInterstateOutPattern);
+  return kInterstateRoute.Replace(source);
 }
 
 std::string VerbalTextFormatterUs::FormUsHighwayTts(const std::string& source) const {
-  return std::regex_replace(source, kUsHighwayRegex, kUsHighwayOutPattern);
+  return kUsHighwayRoute.Replace(source);
 }
 
 std::string VerbalTextFormatterUs::ProcessStatesTts(const std::string& source) const {
 
   std::string tts;
-  for (auto& state_find_replace : kStateRoutes) {
-    if (FormStateTts(source, state_find_replace.first, state_find_replace.second, tts)) {
+  for (const auto& state_rule : kStateRoutes) {
+    if (FormStateTts(source, state_rule, tts)) {
       // State has been found and transformed - so return
       return tts;
     }
@@ -91,11 +250,10 @@ std::string VerbalTextFormatterUs::ProcessStatesTts(const std::string& source) c
 }
 
 bool VerbalTextFormatterUs::FormStateTts(const std::string& source,
-                                         const std::regex& state_regex,
-                                         const std::string& state_output_pattern,
+                                         const RouteRule& state_rule,
                                          std::string& tts) const {
 
-  tts = std::regex_replace(source, state_regex, state_output_pattern);
+  tts = state_rule.Replace(source);
 
   // Return true if transformed
   return (tts != source);
@@ -104,8 +262,8 @@ bool VerbalTextFormatterUs::FormStateTts(const std::string& source,
 std::string VerbalTextFormatterUs::ProcessCountysTts(const std::string& source) const {
 
   std::string tts;
-  for (auto& county_find_replace : kCountyRoutes) {
-    if (FormCountyTts(source, county_find_replace.first, county_find_replace.second, tts)) {
+  for (const auto& county_rule : kCountyRoutes) {
+    if (FormCountyTts(source, county_rule, tts)) {
       // County has been found and transformed - so return
       return tts;
     }
@@ -115,11 +273,10 @@ std::string VerbalTextFormatterUs::ProcessCountysTts(const std::string& source)
 }
 
 bool VerbalTextFormatterUs::FormCountyTts(const std::string& source,
-                                          const std::regex& county_regex,
-                                          const std::string& county_output_pattern,
+                                          const RouteRule& county_rule,
                                           std::string& tts) const {
 
-  tts = std::regex_replace(source, county_regex, county_output_pattern);
+  tts = county_rule.Replace(source);
 
   // Return true if transformed
   return (tts != source);
@@ -128,35 +285,31 @@ bool VerbalTextFormatterUs::FormCountyTts(const std::string& source,
 std::string VerbalTextFormatterUs::ProcessThousandTts(const std::string& source) const {
 
   std::string tts = source;
-  for (auto& thousand_find_replace : kThousandFindReplace) {
-    tts = FormThousandTts(tts, thousand_find_replace.first, thousand_find_replace.second);
+  for (const auto& thousand_rule : kThousandFindReplace) {
+    tts = thousand_rule.Replace(tts);
   }
   return tts;
 }
 
-std::string VerbalTextFormatterUs::FormThousandTts(const std::string& source,
-                                                   const std::regex& thousand_regex,
-                                                   const std::string& thousand_output_pattern) const {
-  return std::regex_replace(source, thousand_regex, thousand_output_pattern);
-}
-
 std::string VerbalTextFormatterUs::ProcessHundredTts(const std::string& source) const {
 
   std::string tts = source;
-  for (auto& hundred_find_replace : kHundredFindReplace) {
-    tts = FormHundredTts(tts, hundred_find_replace.first, hundred_find_replace.second);
+  for (const auto& hundred_rule : kHundredFindReplace) {
+    tts = hundred_rule.Replace(tts);
   }
   return tts;
 }
 
-std::string VerbalTextFormatterUs::FormHundredTts(const std::string& source,
-                                                  const std::regex& hundred_regex,
-                                                  const std::string& hundred_output_pattern) const {
-  return std::regex_replace(source, hundred_regex, hundred_output_pattern);
-}
-
 std::string VerbalTextFormatterUs::FormLeadingOhTts(const std::string& source) const {
-  return std::regex_replace(source, kLeadingOhRegex, kLeadingOhOutPattern);
+  // A space, a zero and a non zero digit, the zero is spoken as the letter o
+  std::string tts(source);
+  for (size_t i = 0; i + 2 < tts.size(); ++i) {
+    if (tts[i] == ' ' && tts[i + 1] == '0' && tts[i + 2] >= '1' && tts[i + 2] <= '9') {
+      tts[i + 1] = 'o';
+      i += 2;
+    }
+  }
+  return tts;
 }
 
 } // namespace baldr
@@ -17,7 +17,7 @@ VerbalTextFormatterUsCo::~VerbalTextFormatterUsCo() {
 std::string VerbalTextFormatterUsCo::ProcessStatesTts(const std::string& source) const {
 
   std::string tts;
-  if (FormStateTts(source, kColoradoRegex, kColoradoOutPattern, tts)) {
+  if (FormStateTts(source, kColoradoRoute, tts)) {
     // Colorado has been found and transformed - so return
     return tts;
   }
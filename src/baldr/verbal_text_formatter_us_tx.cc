@@ -23,10 +23,10 @@ std::string VerbalTextFormatterUsTx::Format(const std::string& text) const {
 }
 
 std::string VerbalTextFormatterUsTx::FormFmTts(const std::string& source) const {
-  return std::regex_replace(source, kFmRegex, kFmOutPattern);
+  return kFmRoute.Replace(source);
 }
 std::string VerbalTextFormatterUsTx::FormRmTts(const std::string& source) const {
-  return std::regex_replace(source, kRmRegex, kRmOutPattern);
+  return kRmRoute.Replace(source);
 }
 
 } // namespace baldr
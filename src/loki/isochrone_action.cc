@@ -72,6 +72,7 @@ void loki_worker_t::isochrones(Api& request) {
 
   try {
     // correlate the various locations to the underlying graph
+    auto correlate = measure_scope_time(request, "correlate_ms");
     auto locations = PathLocation::fromPBF(options.locations());
     const auto projections = loki::Search(locations, *reader, costing);
     for (size_t i = 0; i < locations.size(); ++i) {
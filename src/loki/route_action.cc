@@ -33,6 +33,15 @@ void check_distance(const google::protobuf::RepeatedPtrField<valhalla::Location>
   }
 }
 
+void check_origin_distance(const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+                           float max_distance) {
+  // test if the distance from the origin to any of the other locations exceeds the maximum
+  for (int i = 1; i < locations.size(); ++i) {
+    if (to_ll(locations.Get(0)).Distance(to_ll(locations.Get(i))) > max_distance)
+      throw valhalla_exception_t{154, std::to_string(static_cast<size_t>(max_distance)) + " meters"};
+  }
+}
+
 } // namespace
 
 namespace valhalla {
@@ -58,6 +67,12 @@ void loki_worker_t::route(Api& request) {
   if (request.options().action() == Options::centroid) {
     check_locations(options.locations_size(), max_locations.find("centroid")->second);
     check_distance(options.locations(), max_distance.find("centroid")->second, true);
+  } else if (options.one_to_many()) {
+    // the destinations are found by one flat expansion from the origin like a row of a matrix, so
+    // they are held to the matrix limits rather than to those of a route through hierarchies
+    check_locations(options.locations_size(), max_locations.find(costing_name)->second);
+    check_locations(options.locations_size() - 1, max_matrix_locations.find(costing_name)->second);
+    check_origin_distance(options.locations(), max_matrix_distance.find(costing_name)->second);
   } else {
     check_locations(options.locations_size(), max_locations.find(costing_name)->second);
     check_distance(options.locations(), max_distance.find(costing_name)->second, false);
@@ -96,6 +111,7 @@ void loki_worker_t::route(Api& request) {
   // correlate the various locations to the underlying graph
   std::unordered_map<size_t, size_t> color_counts;
   try {
+    auto correlate = measure_scope_time(request, "correlate_ms");
     auto locations = PathLocation::fromPBF(options.locations(), true);
     const auto projections = loki::Search(locations, *reader, costing);
     for (size_t i = 0; i < locations.size(); ++i) {
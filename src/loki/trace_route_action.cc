@@ -183,6 +183,7 @@ void loki_worker_t::locations_from_shape(Api& request) {
 
   // Add first and last correlated locations to request
   try {
+    auto correlate = measure_scope_time(request, "correlate_ms");
     // If trace route has 2 locations get the lat,lng of the first and last so we can support
     // side of street.
     bool has_locations = false;
@@ -1,4 +1,5 @@
 #include "loki/worker.h"
+#include "admission_controller.h"
 #include "loki/polygon_search.h"
 #include "loki/search.h"
 #include "midgard/logging.h"
@@ -8,6 +9,7 @@
 #include "sif/motorscootercost.h"
 #include "sif/pedestriancost.h"
 #include "tyr/actor.h"
+#include "tyr/result_cache.h"
 
 #include <boost/property_tree/ptree.hpp>
 
@@ -302,6 +304,23 @@ void loki_worker_t::cleanup() {
   }
 }
 
+bool loki_worker_t::cached_result(Api& request, std::string& response) {
+  if (!result_cache) {
+    return false;
+  }
+  auto key = result_cache->key(request, *reader);
+  if (key.empty()) {
+    return false;
+  }
+  if (result_cache->get(key, response)) {
+    add_statistic(request, "result_cache_hit", 1, count);
+    return true;
+  }
+  add_statistic(request, "result_cache_miss", 1, count);
+  request.mutable_info()->set_result_cache_key(std::move(key));
+  return false;
+}
+
 void loki_worker_t::set_interrupt(const std::function<void()>* interrupt_function) {
   interrupt = interrupt_function;
   reader->SetInterrupt(interrupt);
@@ -364,7 +383,11 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
   // grab the request info and make sure to record any metrics before we are done
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Loki Request " + std::to_string(info.id));
-  Api request;
+  // the request lives on an arena which reuses the memory of this worker from request to request
+  google::protobuf::Arena arena(request_arena_options());
+  Api& request = *google::protobuf::Arena::CreateMessage<Api>(&arena);
+  // gives back the slot of a heavy request however we leave, unless it goes on to the next stage
+  admission_guard_t admission_guard(admission, request);
   prime_server::worker_t::result_t result{true, {}, ""};
   try {
     // request parsing
@@ -381,6 +404,22 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
 
     // Set the interrupt function
     service_worker_t::set_interrupt(&interrupt_function);
+    // identical requests on the same data can skip the rest of the pipeline
+    std::string cached;
+    if (cached_result(request, cached)) {
+      result = to_response(cached, info, request);
+      enqueue_statistics(request);
+      return result;
+    }
+    // heavy requests only get in while there is room so that cheap ones keep their latency
+    if (admission) {
+      auto cost = admission_controller_t::estimate_cost(request);
+      add_statistic(request, "admission_cost", cost);
+      if (!admission->admit(request, cost)) {
+        add_statistic(request, "admission_rejected", 1, count);
+        throw valhalla_exception_t{108};
+      }
+    }
     // do request specific processing
     switch (options.action()) {
       case Options::route:
@@ -438,6 +477,7 @@ loki_worker_t::work(const std::list<zmq::message_t>& job,
   }
 
   // keep track of the metrics if the request is going back to the client
+  admission_guard.hand_on(result.intermediate);
   if (!result.intermediate)
     enqueue_statistics(request);
 
@@ -0,0 +1,95 @@
+#include "midgard/threadpool.h"
+
+namespace valhalla {
+namespace midgard {
+
+ThreadPool::ThreadPool(size_t size)
+    : size_(size), task_(nullptr), count_(0), next_(0), busy_(0), generation_(0), stop_(false) {
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+  std::lock_guard<std::mutex> job_lock(job_mutex_);
+
+  // not worth waking anyone for
+  if (size_ <= 1 || count <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (threads_.empty()) {
+      for (size_t i = 1; i < size_; ++i) {
+        threads_.emplace_back(&ThreadPool::work, this);
+      }
+    }
+    task_ = &task;
+    count_ = count;
+    next_ = 0;
+    error_ = nullptr;
+    busy_ = threads_.size();
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  // the calling thread helps out and then waits for the others to finish their last calls
+  drain();
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return busy_ == 0; });
+    task_ = nullptr;
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::work() {
+  uint64_t generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this, &generation]() { return stop_ || generation_ != generation; });
+    if (stop_) {
+      return;
+    }
+    generation = generation_;
+    lock.unlock();
+    drain();
+    lock.lock();
+    if (--busy_ == 0) {
+      done_.notify_all();
+    }
+  }
+}
+
+void ThreadPool::drain() {
+  for (size_t i = next_++; i < count_; i = next_++) {
+    try {
+      (*task_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      next_ = count_;
+    }
+  }
+}
+
+} // namespace midgard
+} // namespace valhalla
@@ -0,0 +1,219 @@
+#include "mjolnir/affected_tiles.h"
+#include "baldr/edgeinfo.h"
+#include "baldr/tilehierarchy.h"
+#include "midgard/logging.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <osmium/io/pbf_input.hpp>
+
+#include <map>
+
+namespace valhalla {
+namespace mjolnir {
+
+namespace {
+
+// Adds the tiles containing the location on every level, if it is within the tiling system
+void add_tiles(const midgard::PointLL& ll, std::set<baldr::GraphId>& tiles) {
+  for (const auto& level : baldr::TileHierarchy::levels()) {
+    auto tileid = level.tiles.TileId(ll);
+    if (tileid >= 0) {
+      tiles.emplace(tileid, level.level, 0);
+    }
+  }
+}
+
+// Calls the function with every tile of the graph which exists, trimming the cache as we go
+template <typename tile_function_t>
+void for_each_tile(baldr::GraphReader& reader,
+                   const std::set<baldr::GraphId>& tile_ids,
+                   const tile_function_t& tile_function) {
+  for (const auto& tile_id : tile_ids) {
+    if (!reader.DoesTileExist(tile_id)) {
+      continue;
+    }
+
+    // Trim reader if over-committed
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+    tile_function(tile_id, reader.GetGraphTile(tile_id));
+  }
+}
+
+// Adds the tiles at the ends of the transitions of all of the nodes of the tile
+void add_transition_tiles(const baldr::graph_tile_ptr& tile, std::set<baldr::GraphId>& tiles) {
+  for (uint32_t i = 0; i < tile->header()->transitioncount(); ++i) {
+    tiles.insert(tile->transition(i)->endnode().Tile_Base());
+  }
+}
+
+} // namespace
+
+void read_osm_change(const std::string& filename, OsmChange& change) {
+  boost::property_tree::ptree osc;
+  boost::property_tree::read_xml(filename, osc);
+
+  // osmChange holds any number of create, modify and delete blocks in the order they apply
+  for (const auto& action : osc.get_child("osmChange")) {
+    if (action.first != "create" && action.first != "modify" && action.first != "delete") {
+      continue;
+    }
+    for (const auto& element : action.second) {
+      const auto& attributes = element.second.get_child("<xmlattr>", {});
+      if (element.first == "node") {
+        change.node_ids.insert(attributes.get<uint64_t>("id"));
+        // deletions may leave out the location
+        auto lat = attributes.get_optional<double>("lat");
+        auto lon = attributes.get_optional<double>("lon");
+        if (lat && lon) {
+          change.locations.emplace_back(*lon, *lat);
+        }
+      } else if (element.first == "way") {
+        change.way_ids.insert(attributes.get<uint64_t>("id"));
+        for (const auto& nd : element.second) {
+          if (nd.first == "nd") {
+            change.way_node_ids.insert(nd.second.get<uint64_t>("<xmlattr>.ref"));
+          }
+        }
+      } else if (element.first == "relation") {
+        for (const auto& member : element.second) {
+          if (member.first != "member") {
+            continue;
+          }
+          const auto type = member.second.get<std::string>("<xmlattr>.type", "");
+          if (type == "way") {
+            change.way_ids.insert(member.second.get<uint64_t>("<xmlattr>.ref"));
+          } else if (type == "node") {
+            change.member_node_ids.insert(member.second.get<uint64_t>("<xmlattr>.ref"));
+          }
+        }
+      }
+    }
+  }
+}
+
+void read_previous_osm(const std::vector<std::string>& pbf_files, OsmChange& change) {
+  if (change.node_ids.empty() && change.way_node_ids.empty() && change.member_node_ids.empty()) {
+    return;
+  }
+
+  // nodes come before ways in a sorted extract so the ways are only looked at once all the nodes
+  // have been read
+  size_t found = 0;
+  std::unordered_set<uint64_t> ways;
+  for (const auto& file : pbf_files) {
+    osmium::io::Reader reader(file, osmium::osm_entity_bits::node | osmium::osm_entity_bits::way);
+    while (osmium::memory::Buffer buffer = reader.read()) {
+      for (const osmium::memory::Item& item : buffer) {
+        if (item.type() == osmium::item_type::node) {
+          const auto& node = static_cast<const osmium::Node&>(item);
+          const auto id = static_cast<uint64_t>(node.id());
+          if ((change.node_ids.count(id) || change.way_node_ids.count(id) ||
+               change.member_node_ids.count(id)) &&
+              node.location().valid()) {
+            change.locations.emplace_back(node.location().lon(), node.location().lat());
+            ++found;
+          }
+        } else if (item.type() == osmium::item_type::way) {
+          // the ways through a node which moved or went away have to be formed again
+          const auto& way = static_cast<const osmium::Way&>(item);
+          for (const auto& node_ref : way.nodes()) {
+            if (change.node_ids.count(static_cast<uint64_t>(node_ref.ref()))) {
+              ways.insert(static_cast<uint64_t>(way.id()));
+              break;
+            }
+          }
+        }
+      }
+    }
+    reader.close();
+  }
+  change.way_ids.insert(ways.begin(), ways.end());
+
+  LOG_INFO("Found the previous locations of " + std::to_string(found) + " nodes and " +
+           std::to_string(ways.size()) + " ways through the changed nodes");
+}
+
+std::set<baldr::GraphId> collect_affected_tiles(baldr::GraphReader& reader, const OsmChange& change) {
+  // The tiles on every level where the changed nodes were and are, a new edge may end up on any of
+  // them depending on its road class
+  std::set<baldr::GraphId> changed;
+  for (const auto& ll : change.locations) {
+    add_tiles(ll, changed);
+  }
+
+  // A single pass over the graph finds the tiles at both ends of the edges of the changed ways and
+  // which shortcuts cross each tile. The reverse edge of a forward edge is in the tile at its end so
+  // looking at forward edges is enough
+  const auto transit_level = baldr::TileHierarchy::GetTransitLevel().level;
+  std::set<baldr::GraphId> all_tiles;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    if (tile_id.level() != transit_level) {
+      all_tiles.insert(tile_id);
+    }
+  }
+  // the tiles at both ends of the shortcuts whose shape crosses a tile, by that tile
+  std::map<baldr::GraphId, std::set<baldr::GraphId>> shortcut_tiles;
+  for_each_tile(reader, all_tiles, [&](baldr::GraphId edge_id, const baldr::graph_tile_ptr& tile) {
+    const auto& tiles = baldr::TileHierarchy::levels()[edge_id.level()].tiles;
+    for (uint32_t n = 0; n < tile->header()->directededgecount(); n++, ++edge_id) {
+      const baldr::DirectedEdge* edge = tile->directededge(edge_id);
+      if (!edge->forward()) {
+        continue;
+      }
+      // shortcuts are formed from the edges along them, which start at the shape points of the
+      // shortcut
+      if (edge->is_shortcut()) {
+        for (const auto& ll : tile->edgeinfo(edge).shape()) {
+          auto tileid = tiles.TileId(ll);
+          if (tileid >= 0) {
+            auto& ends = shortcut_tiles[{static_cast<uint32_t>(tileid), edge_id.level(), 0}];
+            ends.insert(edge_id.Tile_Base());
+            ends.insert(edge->endnode().Tile_Base());
+          }
+        }
+      } else if (!change.way_ids.empty() && change.way_ids.count(tile->edgeinfo(edge).wayid())) {
+        changed.insert(edge_id.Tile_Base());
+        changed.insert(edge->endnode().Tile_Base());
+      }
+    }
+  });
+
+  // The hierarchy is formed from the local level, the nodes of a changed tile transition to the
+  // tiles on the other levels it is part of
+  std::set<baldr::GraphId> hierarchy;
+  for_each_tile(reader, changed, [&](const baldr::GraphId&, const baldr::graph_tile_ptr& tile) {
+    add_transition_tiles(tile, hierarchy);
+  });
+  changed.insert(hierarchy.begin(), hierarchy.end());
+
+  // The shortcuts crossing a changed tile may be formed differently
+  std::set<baldr::GraphId> shortcuts;
+  for (const auto& tile_id : changed) {
+    auto found = shortcut_tiles.find(tile_id);
+    if (found != shortcut_tiles.end()) {
+      shortcuts.insert(found->second.begin(), found->second.end());
+    }
+  }
+  changed.insert(shortcuts.begin(), shortcuts.end());
+
+  // The nodes and edges of a changed tile may be numbered differently once it is formed again so
+  // the tiles whose edges and transitions refer to them change too. Edges come in pairs so those
+  // are the tiles at the ends of the edges and transitions of the changed tile
+  std::set<baldr::GraphId> tiles = changed;
+  for_each_tile(reader, changed, [&](baldr::GraphId edge_id, const baldr::graph_tile_ptr& tile) {
+    for (uint32_t n = 0; n < tile->header()->directededgecount(); n++, ++edge_id) {
+      tiles.insert(tile->directededge(edge_id)->endnode().Tile_Base());
+    }
+    add_transition_tiles(tile, tiles);
+  });
+
+  LOG_INFO("The change touches " + std::to_string(changed.size()) + " tiles and affects " +
+           std::to_string(tiles.size()) + " tiles on all levels");
+  return tiles;
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -0,0 +1,297 @@
+#include "mjolnir/altbuilder.h"
+#include "baldr/alttile.h"
+#include "baldr/graphid.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtile.h"
+#include "filesystem.h"
+#include "midgard/constants.h"
+#include "midgard/logging.h"
+#include "midgard/pointll.h"
+#include "scoped_timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// Default number of landmarks, each one costs 4 bytes per node of the graph
+constexpr uint32_t kDefaultLandmarkCount = 8;
+
+// The nodes of a graph tile and their distances, laid out landmark by landmark like the side tiles
+struct tile_nodes_t {
+  uint64_t dataset_id;
+  uint32_t node_count;
+  std::vector<uint32_t> distances;
+};
+
+// A distance for every node of every tile
+using node_distances_t = std::unordered_map<GraphId, tile_nodes_t>;
+
+/**
+ * Finds the road distance from the landmark to every node with dijkstra. All edges are used whatever
+ * their access so the distances are a lower bound for every mode of travel. Every edge has an
+ * opposing edge of the same length so the distances hold in both directions. Nodes on different
+ * levels of the hierarchy are the same place so transitions between them are free. Only the slot of
+ * the landmark is written so several landmarks can be computed at once into the same tiles.
+ *
+ * @param reader     graph reader
+ * @param landmark   the node to find the distances from
+ * @param slot       the index of the landmark in the distances of the tiles
+ * @param distances  the distances to fill in, kInvalidAltDistance for nodes which are not connected
+ */
+void compute_distances(GraphReader& reader,
+                       const GraphId& landmark,
+                       const uint32_t slot,
+                       node_distances_t& distances) {
+  for (auto& tile : distances) {
+    auto begin = tile.second.distances.begin() + static_cast<size_t>(slot) * tile.second.node_count;
+    std::fill(begin, begin + tile.second.node_count, kInvalidAltDistance);
+  }
+
+  // the distance of a node or nullptr if the node is not in the graph
+  auto lookup = [&](const GraphId& node) -> uint32_t* {
+    auto found = distances.find(node.Tile_Base());
+    if (found == distances.end() || node.id() >= found->second.node_count) {
+      return nullptr;
+    }
+    return &found->second
+                .distances[static_cast<size_t>(slot) * found->second.node_count + node.id()];
+  };
+
+  using entry_t = std::pair<uint32_t, uint64_t>;
+  std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> queue;
+  auto relax = [&](const GraphId& node, const uint32_t distance) {
+    auto* best = lookup(node);
+    if (best && distance < *best) {
+      *best = distance;
+      queue.emplace(distance, node.value);
+    }
+  };
+  relax(landmark, 0);
+
+  while (!queue.empty()) {
+    auto entry = queue.top();
+    queue.pop();
+    GraphId node(entry.second);
+    if (entry.first > *lookup(node)) {
+      continue;
+    }
+
+    graph_tile_ptr tile = reader.GetGraphTile(node);
+    if (!tile) {
+      continue;
+    }
+    for (const auto& edge : tile->GetDirectedEdges(node)) {
+      relax(edge.endnode(), entry.first + edge.length());
+    }
+    for (const auto& transition : tile->GetNodeTransitions(node)) {
+      relax(transition.endnode(), entry.first);
+    }
+
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+  }
+}
+
+/**
+ * Spreads the landmarks around the edge of the graph. The plane around the center of the nodes
+ * reachable from the start is cut into one sector per landmark and the reachable node furthest from
+ * the center is taken in each sector. Sectors without nodes are made up for with the furthest nodes
+ * not taken yet. Ties are broken by id so that builds are repeatable.
+ *
+ * @param reader          graph reader
+ * @param reachable       the distances of the nodes from the start, in the first slot
+ * @param landmark_count  the number of landmarks to select
+ * @return the landmarks, fewer than landmark_count if there are not enough reachable nodes
+ */
+std::vector<GraphId> select_landmarks(GraphReader& reader,
+                                      const node_distances_t& reachable,
+                                      const uint32_t landmark_count) {
+  std::vector<std::pair<GraphId, PointLL>> nodes;
+  double lng = 0, lat = 0;
+  for (const auto& tile : reachable) {
+    graph_tile_ptr graph_tile = reader.GetGraphTile(tile.first);
+    for (uint32_t i = 0; i < tile.second.node_count; ++i) {
+      if (tile.second.distances[i] == kInvalidAltDistance) {
+        continue;
+      }
+      GraphId node(tile.first.tileid(), tile.first.level(), i);
+      nodes.emplace_back(node, graph_tile->get_node_ll(node));
+      lng += nodes.back().second.lng();
+      lat += nodes.back().second.lat();
+    }
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+  }
+  if (nodes.empty() || landmark_count == 0) {
+    return {};
+  }
+  const PointLL center(lng / nodes.size(), lat / nodes.size());
+
+  // furthest from the center first, then by id
+  std::vector<double> spread(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    spread[i] = center.Distance(nodes[i].second);
+  }
+  std::vector<size_t> order(nodes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&spread, &nodes](size_t a, size_t b) {
+    return spread[a] != spread[b] ? spread[a] > spread[b] : nodes[a].first < nodes[b].first;
+  });
+
+  // the first node in this order within each sector
+  const double cos_lat = std::cos(center.lat() * kRadPerDegD);
+  std::vector<GraphId> landmarks(landmark_count);
+  std::vector<bool> taken(nodes.size(), false);
+  for (const auto index : order) {
+    const auto& ll = nodes[index].second;
+    double angle = std::atan2(ll.lat() - center.lat(), (ll.lng() - center.lng()) * cos_lat) + kPiD;
+    auto sector = std::min(static_cast<uint32_t>(angle / (2 * kPiD) * landmark_count),
+                           landmark_count - 1);
+    if (!landmarks[sector].Is_Valid()) {
+      landmarks[sector] = nodes[index].first;
+      taken[index] = true;
+    }
+  }
+
+  // make up for the empty sectors
+  auto next = order.begin();
+  for (auto& landmark : landmarks) {
+    while (!landmark.Is_Valid() && next != order.end()) {
+      if (!taken[*next]) {
+        landmark = nodes[*next].first;
+        taken[*next] = true;
+      }
+      ++next;
+    }
+  }
+  landmarks.erase(std::remove_if(landmarks.begin(), landmarks.end(),
+                                 [](const GraphId& landmark) { return !landmark.Is_Valid(); }),
+                  landmarks.end());
+  return landmarks;
+}
+
+/**
+ * Writes the side tile of a graph tile with the distances to all the landmarks at once
+ *
+ * @param alt_dir         where the side tiles are
+ * @param tile_id         the graph tile
+ * @param landmark_count  the number of landmarks
+ * @param nodes           the distances of the nodes of the tile to every landmark
+ */
+void write_tile(const std::string& alt_dir,
+                const GraphId& tile_id,
+                const uint32_t landmark_count,
+                const tile_nodes_t& nodes) {
+  auto file_name = AltTile::FileName(alt_dir, tile_id);
+  auto dir = filesystem::path(file_name).parent_path();
+  if (!filesystem::exists(dir) && !filesystem::create_directories(dir)) {
+    throw std::runtime_error("Could not create directory " + dir.string());
+  }
+  std::ofstream file(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+  AltTileHeader header{nodes.dataset_id, landmark_count, nodes.node_count};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(nodes.distances.data()),
+             nodes.distances.size() * sizeof(uint32_t));
+  if (!file) {
+    throw std::runtime_error("Could not write " + file_name);
+  }
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+void AltBuilder::Build(const boost::property_tree::ptree& pt) {
+  auto alt_dir = pt.get<std::string>("mjolnir.alt_dir", "");
+  if (alt_dir.empty()) {
+    LOG_INFO("Skipping landmark distances, mjolnir.alt_dir is not configured");
+    return;
+  }
+  auto landmark_count = pt.get<uint32_t>("mjolnir.alt_landmark_count", kDefaultLandmarkCount);
+
+  SCOPED_TIMER();
+  LOG_INFO("Computing distances to " + std::to_string(landmark_count) + " landmarks");
+  GraphReader reader(pt.get_child("mjolnir"));
+
+  // Find the nodes reachable from an arbitrary start node, the landmarks are picked among them
+  node_distances_t reachable;
+  for (const auto& tile_id : reader.GetTileSet()) {
+    graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+    if (!tile || tile->header()->nodecount() == 0) {
+      continue;
+    }
+    reachable[tile_id] = {tile->header()->dataset_id(), tile->header()->nodecount(),
+                          std::vector<uint32_t>(tile->header()->nodecount())};
+    if (reader.OverCommitted()) {
+      reader.Trim();
+    }
+  }
+  if (reachable.empty()) {
+    LOG_WARN("No nodes to compute landmark distances for");
+    return;
+  }
+  auto start = std::min_element(reachable.begin(), reachable.end(),
+                                [](const auto& a, const auto& b) { return a.first < b.first; })
+                   ->first;
+  compute_distances(reader, start, 0, reachable);
+  auto landmarks = select_landmarks(reader, reachable, landmark_count);
+
+  // The same tiles now hold the distances to every landmark
+  node_distances_t distances = std::move(reachable);
+  for (auto& tile : distances) {
+    tile.second.distances.assign(static_cast<size_t>(landmark_count) * tile.second.node_count,
+                                 kInvalidAltDistance);
+  }
+
+  // Each thread runs the dijkstra of one landmark at a time with a reader of its own
+  const auto concurrency =
+      std::max(1u, pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency()));
+  std::atomic<size_t> next(0);
+  std::vector<std::exception_ptr> errors(std::min<size_t>(concurrency, landmarks.size()));
+  std::vector<std::thread> threads;
+  for (auto& error : errors) {
+    threads.emplace_back([&pt, &landmarks, &distances, &next, &error]() {
+      try {
+        GraphReader thread_reader(pt.get_child("mjolnir"));
+        for (size_t i = next++; i < landmarks.size(); i = next++) {
+          compute_distances(thread_reader, landmarks[i], i, distances);
+          LOG_INFO("Landmark " + std::to_string(i) + " is node " + std::to_string(landmarks[i]));
+        }
+      } catch (...) { error = std::current_exception(); }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // Every side tile is written once with all its landmarks
+  for (const auto& tile : distances) {
+    write_tile(alt_dir, tile.first, landmark_count, tile.second);
+  }
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -2,6 +2,7 @@
 #include "baldr/graphconstants.h"
 #include "baldr/graphid.h"
 #include "baldr/graphreader.h"
+#include "baldr/tilehierarchy.h"
 #include "filesystem.h"
 #include "midgard/elevation_encoding.h"
 #include "midgard/encoded.h"
@@ -14,7 +15,8 @@
 #include "skadi/sample.h"
 #include "skadi/util.h"
 
-#include <random>
+#include <algorithm>
+#include <cmath>
 #include <thread>
 #include <utility>
 
@@ -34,21 +36,10 @@ using cache_t =
     std::unordered_map<uint32_t, std::tuple<uint32_t, uint32_t, float, float, float, float>>;
 
 /**
- * Encode elevation along an edge to store in tiles.
+ * Encode elevation along an edge to store in tiles given the heights sampled at the uniformly
+ * resampled shape (see uniform_resample_spherical_polyline).
  */
-std::vector<int8_t> encode_edge_elevation(const std::unique_ptr<valhalla::skadi::sample>& sample,
-                                          const std::vector<PointLL>& shape,
-                                          const uint32_t length,
-                                          uint32_t wayid) {
-  // Uniformly resample the polyline to create the desired number of vertices
-  uint32_t n = encoded_elevation_count(length) + 2;
-  std::vector<PointLL> resampled =
-      valhalla::midgard::uniform_resample_spherical_polyline(shape, length, n);
-
-  // Get elevation (height) at each sampled point along the edge.
-  std::vector<double> heights(resampled.size());
-  heights = sample->get_all(resampled);
-
+std::vector<int8_t> encode_edge_elevation(const std::vector<double>& heights, uint32_t wayid) {
   // Encode the elevation.
   bool error = false;
   std::vector<int8_t> encoded = encode_elevation(heights, error);
@@ -66,19 +57,13 @@ std::vector<int8_t> encode_edge_elevation(const std::unique_ptr<valhalla::skadi:
 }
 
 /**
- * Encode elevation for a bridge, tunnel, ferry.
+ * Encode elevation for a bridge, tunnel, ferry given the heights at its first and last shape point.
  */
-std::vector<int8_t> encode_btf_elevation(const std::unique_ptr<valhalla::skadi::sample>& sample,
-                                         const std::vector<PointLL>& shape,
-                                         const uint32_t length,
-                                         uint32_t wayid) {
+std::vector<int8_t>
+encode_btf_elevation(const double h1, const double h2, const uint32_t length, uint32_t wayid) {
   // Compute a uniform sampling interval along the edge based on its length.
   double interval = sampling_interval(length);
 
-  // Sample at the first and last shape point
-  double h1 = sample->get(shape.front());
-  double h2 = sample->get(shape.back());
-
   // Use linear interpolation from h1 to h2 along the length of the edge
   uint32_t n = static_cast<uint32_t>(length / interval) + 1;
   std::vector<double> heights(n);
@@ -117,12 +102,15 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
   // retrieved/used?
   tilebuilder.header_builder().set_has_elevation(true);
 
-  // Iterate through the nodes edges, get the node lat,lng, sample and store elevation.
+  // Get the lat,lng of every node, sample them all at once and store the elevations.
+  std::vector<PointLL> node_lls;
+  node_lls.reserve(tilebuilder.header()->nodecount());
   for (uint32_t i = 0; i < tilebuilder.header()->nodecount(); ++i) {
-    // Get a writeable reference to the node edge
-    NodeInfo& nodeinfo = tilebuilder.node_builder(i);
-    PointLL ll = nodeinfo.latlng(tilebuilder.header()->base_ll());
-    nodeinfo.set_elevation(sample->get(ll));
+    node_lls.push_back(tilebuilder.node_builder(i).latlng(tilebuilder.header()->base_ll()));
+  }
+  auto node_heights = sample->get_all(node_lls);
+  for (uint32_t i = 0; i < tilebuilder.header()->nodecount(); ++i) {
+    tilebuilder.node_builder(i).set_elevation(node_heights[i]);
   }
 
   // Reserve twice the number of directed edges in the tile. We do not directly know
@@ -167,8 +155,12 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
           valhalla::midgard::resample_spherical_polyline(shape, POSTING_INTERVAL);
       resampled.push_back(shape.back());
 
-      // Get the heights at each sampled point.
+      // Get the heights at each sampled point along with those needed to encode the elevation
+      // along the edge, in a single batch so that the elevation tile is looked up once per edge.
+      // Bridges, tunnels, ferries are special cases which only sample both ends.
       std::vector<double> heights(resampled.size());
+      std::vector<int8_t> encoded;
+      auto wayid = tilebuilder.edgeinfo(&directededge).wayid();
       if (directededge.bridge() || directededge.tunnel() || directededge.use() == Use::kFerry) {
         // Get height at beginning and end of bridge/tunnel
         std::vector<PointLL> tmp;
@@ -180,8 +172,17 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
         for (size_t i = 1; i < heights.size(); ++i) {
           heights[i] = heights[i - 1] + dh;
         }
+        encoded = encode_btf_elevation(h[0], h[1], length, wayid);
       } else {
-        heights = sample->get_all(resampled);
+        // Uniformly resample the polyline to create the desired number of encoded vertices
+        uint32_t n = encoded_elevation_count(length) + 2;
+        std::vector<PointLL> uniform =
+            valhalla::midgard::uniform_resample_spherical_polyline(shape, length, n);
+        size_t count = resampled.size();
+        resampled.insert(resampled.end(), uniform.begin(), uniform.end());
+        auto h = sample->get_all(resampled);
+        heights.assign(h.begin(), h.begin() + count);
+        encoded = encode_edge_elevation(std::vector<double>(h.begin() + count, h.end()), wayid);
       }
 
       // Compute "weighted" grades as well as max grades in both directions. Valid range
@@ -214,15 +215,8 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
       // Store the new edge info offset
       new_offsets[edge_info_offset] = ei_offset;
 
-      // Encode elevation along the edge and add to EdgeInfo along with the mean elevation.
-      // Bridges, tunnels, ferries are special cases. Increment the new edge info offset.
-      std::vector<int8_t> encoded;
-      auto wayid = tilebuilder.edgeinfo(&directededge).wayid();
-      if (directededge.bridge() || directededge.tunnel() || directededge.use() == Use::kFerry) {
-        encoded = encode_btf_elevation(sample, shape, length, wayid);
-      } else {
-        encoded = encode_edge_elevation(sample, shape, length, wayid);
-      }
+      // Add the encoded elevation along the edge to EdgeInfo along with the mean elevation.
+      // Increment the new edge info offset.
       ei_offset += tilebuilder.set_elevation(edge_info_offset, mean_elevation, encoded);
     }
 
@@ -261,7 +255,8 @@ void add_elevations_to_single_tile(GraphReader& graphreader,
 }
 
 /**
- * Adds elevation to a set of tiles. Each thread pulls a tile of the queue
+ * Adds elevation to a set of tiles. Each thread pulls a tile of the queue. The sample is shared by
+ * all threads so that each elevation tile is unpacked once for all of them
  */
 void add_elevations_to_multiple_tiles(const boost::property_tree::ptree& pt,
                                       std::deque<GraphId>& tilequeue,
@@ -291,17 +286,41 @@ void add_elevations_to_multiple_tiles(const boost::property_tree::ptree& pt,
   }
 }
 
+/**
+ * Orders the tiles by the elevation (hgt) tile holding their center so that the threads, which
+ * take the tiles off the front of the queue, work on neighbouring tiles at the same time. This
+ * way they share the unpacked elevation tiles in the cache of the sample rather than each thread
+ * unpacking (and evicting) different ones.
+ */
+void order_by_elevation_tile(std::deque<GraphId>& tilequeue) {
+  auto hgt_index = [](const GraphId& id) {
+    auto center = TileHierarchy::get_tiling(id.level()).TileBounds(id.tileid()).Center();
+    auto lat = std::min(std::max(std::floor(center.lat()) + 90, 0.), 179.);
+    auto lon = std::min(std::max(std::floor(center.lng()) + 180, 0.), 359.);
+    return static_cast<uint32_t>(lat) * 360 + static_cast<uint32_t>(lon);
+  };
+
+  std::vector<std::pair<uint32_t, GraphId>> keyed;
+  keyed.reserve(tilequeue.size());
+  for (const auto& id : tilequeue) {
+    keyed.emplace_back(hgt_index(id), id);
+  }
+  std::sort(keyed.begin(), keyed.end());
+
+  tilequeue.clear();
+  for (const auto& key : keyed) {
+    tilequeue.push_back(key.second);
+  }
+}
+
 std::deque<GraphId> get_tile_ids(const boost::property_tree::ptree& pt) {
   std::deque<GraphId> tilequeue;
   GraphReader reader(pt.get_child("mjolnir"));
-  // Create a randomized queue of tiles (at all levels) to work from
+  // Create a queue of tiles (at all levels) to work from
   auto tileset = reader.GetTileSet();
   for (const auto& id : tileset)
     tilequeue.emplace_back(id);
 
-  std::random_device rd;
-  std::shuffle(tilequeue.begin(), tilequeue.end(), std::mt19937(rd()));
-
   return tilequeue;
 }
 
@@ -327,6 +346,7 @@ void ElevationBuilder::Build(const boost::property_tree::ptree& pt,
 
   if (tile_ids.empty())
     tile_ids = get_tile_ids(pt);
+  order_by_elevation_tile(tile_ids);
 
   std::vector<std::shared_ptr<std::thread>> threads(nthreads);
 
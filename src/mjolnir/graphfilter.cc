@@ -10,12 +10,19 @@
 #include "midgard/pointll.h"
 #include "midgard/sequence.h"
 #include "mjolnir/graphtilebuilder.h"
+#include "mjolnir/tileworkers.h"
 #include "mjolnir/util.h"
 #include "scoped_timer.h"
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <limits>
+#include <list>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -25,12 +32,12 @@ using namespace valhalla::mjolnir;
 
 namespace {
 
-uint32_t n_original_edges = 0;
-uint32_t n_original_nodes = 0;
-uint32_t n_filtered_edges = 0;
-uint32_t n_filtered_nodes = 0;
-uint32_t can_aggregate = 0;
-uint32_t aggregated = 0;
+std::atomic<uint32_t> n_original_edges(0);
+std::atomic<uint32_t> n_original_nodes(0);
+std::atomic<uint32_t> n_filtered_edges(0);
+std::atomic<uint32_t> n_filtered_nodes(0);
+std::atomic<uint32_t> can_aggregate(0);
+std::atomic<uint32_t> aggregated(0);
 
 // Group wheelchair and pedestrian access together
 constexpr uint32_t kAllPedestrianAccess = (kPedestrianAccess | kWheelchairAccess);
@@ -219,222 +226,277 @@ bool Aggregate(GraphId& start_node,
                         GraphId(), start_node, rc, validate);
 }
 
+// New ids of the nodes of a tile, indexed by the old node id. Filtering and aggregation only drop
+// nodes, so a node keeps its tile and only its id within the tile changes.
+constexpr uint32_t kNoNode = std::numeric_limits<uint32_t>::max();
+using NodeRemap = std::unordered_map<GraphId, std::vector<uint32_t>>;
+
 /**
- * Filter edges to optionally remove edges by access.
+ * Get the local tiles in a stable order. Their remap tables (if any) are created up front so that
+ * each thread can fill in the table of its own tile without locking the map.
  * @param  reader  Graph reader.
- * @param  old_to_new  Map of original node Ids to new nodes Ids (after filtering).
- * @param  include_driving  Include edge if driving (any vehicular) access in either direction.
- * @param  include_bicycle  Include edge if bicycle access in either direction.
- * @param  include_pedestrian  Include edge if pedestrian or wheelchair access in either direction.
+ * @param  remap   Optional node remap to create the tables in.
  */
-void FilterTiles(GraphReader& reader,
-                 std::unordered_map<GraphId, GraphId>& old_to_new,
-                 const bool include_driving,
-                 const bool include_bicycle,
-                 const bool include_pedestrian) {
-  SCOPED_TIMER();
-  // lambda to check if an edge should be included
-  auto include_edge = [&include_driving, &include_bicycle,
-                       &include_pedestrian](const DirectedEdge* edge) {
-    // Edge filtering
-    bool bicycle_access =
-        (edge->forwardaccess() & kBicycleAccess) || (edge->reverseaccess() & kBicycleAccess);
-    bool pedestrian_access = (edge->forwardaccess() & kAllPedestrianAccess) ||
-                             (edge->reverseaccess() & kAllPedestrianAccess);
-    bool driving_access =
-        (edge->forwardaccess() & kVehicularAccess) || (edge->reverseaccess() & kVehicularAccess);
-    return (driving_access && include_driving) || (bicycle_access && include_bicycle) ||
-           (pedestrian_access && include_pedestrian);
-  };
-
-  // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
-    // Create a new tilebuilder - should copy header information
-    GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
-    n_original_nodes += tilebuilder.header()->nodecount();
-    n_original_edges += tilebuilder.header()->directededgecount();
-
-    // Get the graph tile. Read from this tile to create the new tile.
-    graph_tile_ptr tile = reader.GetGraphTile(tile_id);
-    assert(tile);
+std::vector<GraphId> GetLocalTiles(GraphReader& reader, NodeRemap* remap = nullptr) {
+  auto tileset = reader.GetTileSet(TileHierarchy::levels().back().level);
+  std::vector<GraphId> tiles(tileset.begin(), tileset.end());
+  std::sort(tiles.begin(), tiles.end());
+  if (remap) {
+    remap->clear();
+    remap->reserve(tiles.size());
+    for (const auto& tile_id : tiles) {
+      (*remap)[tile_id];
+    }
+  }
+  return tiles;
+}
 
-    std::hash<std::string> hasher;
-    GraphId nodeid(tile_id.tileid(), tile_id.level(), 0);
-    for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
-      bool diff_names = false;
-      bool diff_tile = false;
-      bool edge_filtered = false;
-      // Count of edges added for this node
-      uint32_t edge_count = 0;
-
-      // Current edge index for first edge from this node
-      uint32_t edge_index = tilebuilder.directededges().size();
-
-      // Iterate through directed edges outbound from this node
-      std::vector<uint64_t> wayid;
-      std::vector<RoadClass> classification;
-      std::vector<GraphId> endnode;
-      const NodeInfo* nodeinfo = tile->node(nodeid);
-      std::string begin_node_iso = tile->admin(nodeinfo->admin_index())->country_iso();
+/**
+ * Run a pass over the tiles with mjolnir.concurrency threads. A pass may only write the tile it is
+ * given and may only read other tiles if it stages its output.
+ * @param  pt     Configuration.
+ * @param  tiles  Tiles to run the pass over.
+ * @param  pass   Called with the thread's reader and a tile.
+ */
+template <typename pass_t>
+void RunPass(const boost::property_tree::ptree& pt,
+             const std::vector<GraphId>& tiles,
+             const pass_t& pass) {
+  RunTileWorkers(pt, std::deque<GraphId>(tiles.begin(), tiles.end()), [&pass](GraphReader& reader) {
+    return [&pass, &reader](const GraphId& tile_id) { pass(reader, tile_id); };
+  });
+}
 
-      GraphId edgeid(nodeid.tileid(), nodeid.level(), nodeinfo->edge_index());
-      for (uint32_t j = 0; j < nodeinfo->edge_count(); ++j, ++edgeid) {
-        // Check if the directed edge should be included
-        const DirectedEdge* directededge = tile->directededge(edgeid);
-        if (!include_edge(directededge)) {
-          ++n_filtered_edges;
-          edge_filtered = true;
-          continue;
-        }
+/**
+ * Filter the edges of a tile to optionally remove edges by access. Only the tile itself is read.
+ * @param  reader  Graph reader.
+ * @param  tile_id  Tile to filter.
+ * @param  new_ids  New ids of the nodes of the tile (after filtering).
+ * @param  include_edge  Whether an edge is kept.
+ */
+template <typename include_t>
+void FilterTile(GraphReader& reader,
+                const GraphId& tile_id,
+                std::vector<uint32_t>& new_ids,
+                const include_t& include_edge) {
+  // Create a new tilebuilder - should copy header information
+  GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
+  n_original_nodes += tilebuilder.header()->nodecount();
+  n_original_edges += tilebuilder.header()->directededgecount();
+
+  // Get the graph tile. Read from this tile to create the new tile.
+  graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+  assert(tile);
+  new_ids.assign(tile->header()->nodecount(), kNoNode);
+
+  std::hash<std::string> hasher;
+  GraphId nodeid(tile_id.tileid(), tile_id.level(), 0);
+  for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
+    bool diff_names = false;
+    bool diff_tile = false;
+    bool edge_filtered = false;
+    // Count of edges added for this node
+    uint32_t edge_count = 0;
+
+    // Current edge index for first edge from this node
+    uint32_t edge_index = tilebuilder.directededges().size();
+
+    // Iterate through directed edges outbound from this node
+    std::vector<uint64_t> wayid;
+    std::vector<RoadClass> classification;
+    std::vector<GraphId> endnode;
+    const NodeInfo* nodeinfo = tile->node(nodeid);
+    std::string begin_node_iso = tile->admin(nodeinfo->admin_index())->country_iso();
+
+    GraphId edgeid(nodeid.tileid(), nodeid.level(), nodeinfo->edge_index());
+    for (uint32_t j = 0; j < nodeinfo->edge_count(); ++j, ++edgeid) {
+      // Check if the directed edge should be included
+      const DirectedEdge* directededge = tile->directededge(edgeid);
+      if (!include_edge(directededge)) {
+        ++n_filtered_edges;
+        edge_filtered = true;
+        continue;
+      }
 
-        // Copy the directed edge information
-        DirectedEdge newedge = *directededge;
+      // Copy the directed edge information
+      DirectedEdge newedge = *directededge;
 
-        // Set opposing edge indexes to 0 (gets set in graph validator).
-        newedge.set_opp_index(0);
+      // Set opposing edge indexes to 0 (gets set in graph validator).
+      newedge.set_opp_index(0);
 
-        // Get signs from the base directed edge
-        if (directededge->sign()) {
-          std::vector<SignInfo> signs = tile->GetSigns(edgeid.id());
-          if (signs.size() == 0) {
-            LOG_ERROR("Base edge should have signs, but none found");
-          }
-          tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
+      // Get signs from the base directed edge
+      if (directededge->sign()) {
+        std::vector<SignInfo> signs = tile->GetSigns(edgeid.id());
+        if (signs.size() == 0) {
+          LOG_ERROR("Base edge should have signs, but none found");
         }
+        tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
+      }
 
-        // Get turn lanes from the base directed edge
-        if (directededge->turnlanes()) {
-          uint32_t offset = tile->turnlanes_offset(edgeid.id());
-          tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
-        }
+      // Get turn lanes from the base directed edge
+      if (directededge->turnlanes()) {
+        uint32_t offset = tile->turnlanes_offset(edgeid.id());
+        tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
+      }
 
-        // Get access restrictions from the base directed edge. Add these to
-        // the list of access restrictions in the new tile. Update the
-        // edge index in the restriction to be the current directed edge Id
-        if (directededge->access_restriction()) {
-          auto restrictions = tile->GetAccessRestrictions(edgeid.id(), kAllAccess);
-          for (const auto& res : restrictions) {
-            tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
-                                                               res.type(), res.modes(), res.value()));
-          }
+      // Get access restrictions from the base directed edge. Add these to
+      // the list of access restrictions in the new tile. Update the
+      // edge index in the restriction to be the current directed edge Id
+      if (directededge->access_restriction()) {
+        auto restrictions = tile->GetAccessRestrictions(edgeid.id(), kAllAccess);
+        for (const auto& res : restrictions) {
+          tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
+                                                             res.type(), res.modes(), res.value()));
         }
+      }
 
-        // Copy lane connectivity
-        if (directededge->laneconnectivity()) {
-          auto laneconnectivity = tile->GetLaneConnectivity(edgeid.id());
-          if (laneconnectivity.size() == 0) {
-            LOG_ERROR("Base edge should have lane connectivity, but none found");
-          }
-          for (auto& lc : laneconnectivity) {
-            lc.set_to(tilebuilder.directededges().size());
-          }
-          tilebuilder.AddLaneConnectivity(laneconnectivity);
+      // Copy lane connectivity
+      if (directededge->laneconnectivity()) {
+        auto laneconnectivity = tile->GetLaneConnectivity(edgeid.id());
+        if (laneconnectivity.size() == 0) {
+          LOG_ERROR("Base edge should have lane connectivity, but none found");
         }
-
-        // Names can be different in the forward and backward direction
-        diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
-
-        // Get edge info, shape, and names from the old tile and add to the
-        // new. Cannot use edge info offset since edges in arterial and
-        // highway hierarchy can cross base tiles! Use a hash based on the
-        // encoded shape plus way Id.
-        bool added;
-        const auto& edgeinfo = tile->edgeinfo(directededge);
-        std::string encoded_shape = edgeinfo.encoded_shape();
-        uint32_t w = hasher(encoded_shape + std::to_string(edgeinfo.wayid()));
-        uint32_t edge_info_offset =
-            tilebuilder.AddEdgeInfo(w, nodeid, directededge->endnode(), edgeinfo.wayid(),
-                                    edgeinfo.mean_elevation(), edgeinfo.bike_network(),
-                                    edgeinfo.speed_limit(), encoded_shape, edgeinfo.GetNames(),
-                                    edgeinfo.GetTaggedValues(), edgeinfo.GetLinguisticTaggedValues(),
-                                    edgeinfo.GetTypes(), added, diff_names);
-        newedge.set_edgeinfo_offset(edge_info_offset);
-        wayid.push_back(edgeinfo.wayid());
-        classification.push_back(directededge->classification());
-        endnode.push_back(directededge->endnode());
-
-        if (directededge->endnode().tile_value() != tile->header()->graphid().tile_value()) {
-          diff_tile = true;
+        for (auto& lc : laneconnectivity) {
+          lc.set_to(tilebuilder.directededges().size());
         }
+        tilebuilder.AddLaneConnectivity(laneconnectivity);
+      }
 
-        // Add directed edge
-        tilebuilder.directededges().emplace_back(std::move(newedge));
-        ++edge_count;
+      // Names can be different in the forward and backward direction
+      diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
+
+      // Get edge info, shape, and names from the old tile and add to the
+      // new. Cannot use edge info offset since edges in arterial and
+      // highway hierarchy can cross base tiles! Use a hash based on the
+      // encoded shape plus way Id.
+      bool added;
+      const auto& edgeinfo = tile->edgeinfo(directededge);
+      std::string encoded_shape = edgeinfo.encoded_shape();
+      uint32_t w = hasher(encoded_shape + std::to_string(edgeinfo.wayid()));
+      uint32_t edge_info_offset =
+          tilebuilder.AddEdgeInfo(w, nodeid, directededge->endnode(), edgeinfo.wayid(),
+                                  edgeinfo.mean_elevation(), edgeinfo.bike_network(),
+                                  edgeinfo.speed_limit(), encoded_shape, edgeinfo.GetNames(),
+                                  edgeinfo.GetTaggedValues(), edgeinfo.GetLinguisticTaggedValues(),
+                                  edgeinfo.GetTypes(), added, diff_names);
+      newedge.set_edgeinfo_offset(edge_info_offset);
+      wayid.push_back(edgeinfo.wayid());
+      classification.push_back(directededge->classification());
+      endnode.push_back(directededge->endnode());
+
+      if (directededge->endnode().tile_value() != tile->header()->graphid().tile_value()) {
+        diff_tile = true;
       }
 
-      // Add the node to the tilebuilder unless no edges remain
-      if (edge_count > 0) {
-        // Add a node builder to the tile. Update the edge count and edgeindex
-        GraphId new_node(nodeid.tileid(), nodeid.level(), tilebuilder.nodes().size());
-        tilebuilder.nodes().push_back(*nodeinfo);
-        NodeInfo& node = tilebuilder.nodes().back();
-        node.set_edge_count(edge_count);
-        node.set_edge_index(edge_index);
-        const auto& admin = tile->admininfo(nodeinfo->admin_index());
-        node.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
-                                                  admin.country_iso(), admin.state_iso()));
-
-        // Get named signs from the base node
-        if (nodeinfo->named_intersection()) {
-          std::vector<SignInfo> signs = tile->GetSigns(nodeid.id(), true);
-          if (signs.size() == 0) {
-            LOG_ERROR("Base node should have signs, but none found");
-          }
-          node.set_named_intersection(true);
-          tilebuilder.AddSigns(tilebuilder.nodes().size() - 1, signs);
-        }
+      // Add directed edge
+      tilebuilder.directededges().emplace_back(std::move(newedge));
+      ++edge_count;
+    }
 
-        // Associate the old node to the new node.
-        old_to_new[nodeid] = new_node;
-
-        // Check if edges at this node can be aggregated. Only 2 edges, same way Id (so that
-        // edge attributes should match), don't end at same node (no loops), no traffic signal,
-        // no signs exist at the node(named_intersection), does not have different
-        // names, and end node of edges are not in a different tile.
-        //
-        // Note: The classification check is here due to the reclassification of ferries.  Found
-        // that some edges that were split at pedestrian edges had different classifications due to
-        // the reclassification of ferry edges (e.g., https://www.openstreetmap.org/way/204337649)
-        if (edge_filtered && edge_count == 2 && wayid[0] == wayid[1] &&
-            classification[0] == classification[1] && endnode[0] != endnode[1] &&
-            !nodeinfo->traffic_signal() && !nodeinfo->named_intersection() && !diff_names &&
-            !diff_tile) {
-
-          // one more check on intersection and node type.  similar to shortcuts
-          bool aggregate =
-              (nodeinfo->intersection() != IntersectionType::kFork &&
-               nodeinfo->type() != NodeType::kGate && nodeinfo->type() != NodeType::kTollBooth &&
-               nodeinfo->type() != NodeType::kTollGantry && nodeinfo->type() != NodeType::kBollard &&
-               nodeinfo->type() != NodeType::kSumpBuster &&
-               nodeinfo->type() != NodeType::kBorderControl);
-
-          if (aggregate) {
-            // temporarily used to check aggregating edges from this node
-            node.set_mode_change(true);
-            ++can_aggregate;
-          }
+    // Add the node to the tilebuilder unless no edges remain
+    if (edge_count > 0) {
+      // Add a node builder to the tile. Update the edge count and edgeindex
+      GraphId new_node(nodeid.tileid(), nodeid.level(), tilebuilder.nodes().size());
+      tilebuilder.nodes().push_back(*nodeinfo);
+      NodeInfo& node = tilebuilder.nodes().back();
+      node.set_edge_count(edge_count);
+      node.set_edge_index(edge_index);
+      const auto& admin = tile->admininfo(nodeinfo->admin_index());
+      node.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
+                                                admin.country_iso(), admin.state_iso()));
+
+      // Get named signs from the base node
+      if (nodeinfo->named_intersection()) {
+        std::vector<SignInfo> signs = tile->GetSigns(nodeid.id(), true);
+        if (signs.size() == 0) {
+          LOG_ERROR("Base node should have signs, but none found");
         }
-      } else {
-        ++n_filtered_nodes;
+        node.set_named_intersection(true);
+        tilebuilder.AddSigns(tilebuilder.nodes().size() - 1, signs);
       }
-    }
 
-    // Store the updated tile data (or remove tile if all edges are filtered)
-    if (tilebuilder.nodes().size() > 0) {
-      tilebuilder.StoreTileData();
+      // Associate the old node to the new node.
+      new_ids[i] = new_node.id();
+
+      // Check if edges at this node can be aggregated. Only 2 edges, same way Id (so that
+      // edge attributes should match), don't end at same node (no loops), no traffic signal,
+      // no signs exist at the node(named_intersection), does not have different
+      // names, and end node of edges are not in a different tile.
+      //
+      // Note: The classification check is here due to the reclassification of ferries.  Found
+      // that some edges that were split at pedestrian edges had different classifications due to
+      // the reclassification of ferry edges (e.g., https://www.openstreetmap.org/way/204337649)
+      if (edge_filtered && edge_count == 2 && wayid[0] == wayid[1] &&
+          classification[0] == classification[1] && endnode[0] != endnode[1] &&
+          !nodeinfo->traffic_signal() && !nodeinfo->named_intersection() && !diff_names &&
+          !diff_tile) {
+
+        // one more check on intersection and node type.  similar to shortcuts
+        bool aggregate =
+            (nodeinfo->intersection() != IntersectionType::kFork &&
+             nodeinfo->type() != NodeType::kGate && nodeinfo->type() != NodeType::kTollBooth &&
+             nodeinfo->type() != NodeType::kTollGantry && nodeinfo->type() != NodeType::kBollard &&
+             nodeinfo->type() != NodeType::kSumpBuster &&
+             nodeinfo->type() != NodeType::kBorderControl);
+
+        if (aggregate) {
+          // temporarily used to check aggregating edges from this node
+          node.set_mode_change(true);
+          ++can_aggregate;
+        }
+      }
     } else {
-      // Remove the tile - all nodes and edges were filtered
-      std::string file_location =
-          reader.tile_dir() + filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id);
-      remove(file_location.c_str());
-      LOG_INFO("Remove file: " + file_location + " all edges were filtered");
+      ++n_filtered_nodes;
     }
+  }
 
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
+  // Store the updated tile data (or remove tile if all edges are filtered). No other thread reads
+  // this tile during this pass so it is replaced in place.
+  if (tilebuilder.nodes().size() > 0) {
+    tilebuilder.StoreTileData();
+  } else {
+    // Remove the tile - all nodes and edges were filtered
+    std::string file_location =
+        reader.tile_dir() + filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id);
+    remove(file_location.c_str());
+    LOG_INFO("Remove file: " + file_location + " all edges were filtered");
   }
+}
+
+/**
+ * Filter edges to optionally remove edges by access.
+ * @param  pt  Configuration.
+ * @param  remap  Map of original node Ids to new nodes Ids (after filtering).
+ * @param  include_driving  Include edge if driving (any vehicular) access in either direction.
+ * @param  include_bicycle  Include edge if bicycle access in either direction.
+ * @param  include_pedestrian  Include edge if pedestrian or wheelchair access in either direction.
+ */
+void FilterTiles(const boost::property_tree::ptree& pt,
+                 NodeRemap& remap,
+                 const bool include_driving,
+                 const bool include_bicycle,
+                 const bool include_pedestrian) {
+  SCOPED_TIMER();
+  // lambda to check if an edge should be included
+  auto include_edge = [&include_driving, &include_bicycle,
+                       &include_pedestrian](const DirectedEdge* edge) {
+    // Edge filtering
+    bool bicycle_access =
+        (edge->forwardaccess() & kBicycleAccess) || (edge->reverseaccess() & kBicycleAccess);
+    bool pedestrian_access = (edge->forwardaccess() & kAllPedestrianAccess) ||
+                             (edge->reverseaccess() & kAllPedestrianAccess);
+    bool driving_access =
+        (edge->forwardaccess() & kVehicularAccess) || (edge->reverseaccess() & kVehicularAccess);
+    return (driving_access && include_driving) || (bicycle_access && include_bicycle) ||
+           (pedestrian_access && include_pedestrian);
+  };
+
+  // Iterate through all tiles in the local level
+  GraphReader reader(pt.get_child("mjolnir"));
+  auto local_tiles = GetLocalTiles(reader, &remap);
+  RunPass(pt, local_tiles, [&remap, &include_edge](GraphReader& reader, const GraphId& tile_id) {
+    FilterTile(reader, tile_id, remap.at(tile_id), include_edge);
+  });
   LOG_INFO("Filtered " + std::to_string(n_filtered_nodes) + " nodes out of " +
            std::to_string(n_original_nodes));
   LOG_INFO("Filtered " + std::to_string(n_filtered_edges) + " directededges out of " +
@@ -538,247 +600,285 @@ void ValidateData(GraphReader& reader,
   }
 }
 
-void AggregateTiles(GraphReader& reader, std::unordered_map<GraphId, GraphId>& old_to_new) {
-
-  SCOPED_TIMER();
-  LOG_INFO("Validating edges for aggregation");
-  // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
-    // Get the graph tile. Read from this tile to create the new tile.
-    graph_tile_ptr tile = reader.GetGraphTile(tile_id);
-    assert(tile);
-
-    std::unordered_set<GraphId> processed_nodes;
-    std::unordered_set<uint64_t> no_agg_ways;
-    processed_nodes.reserve(tile->header()->nodecount());
-    no_agg_ways.reserve(tile->header()->directededgecount());
-
-    GraphId nodeid = GraphId(tile_id.tileid(), tile_id.level(), 0);
-    for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
-      const NodeInfo* nodeinfo = tile->node(i);
-      uint32_t idx = nodeinfo->edge_index();
-      for (uint32_t j = 0; j < nodeinfo->edge_count(); j++, idx++) {
-        const DirectedEdge* directededge = tile->directededge(idx);
-        if (processed_nodes.find(nodeid) == processed_nodes.end()) {
-          GraphId en = directededge->endnode();
-          std::list<PointLL> shape;
-          // check if we can aggregate the edges at this node.
-          ValidateData(reader, shape, en, processed_nodes, no_agg_ways, nodeid, tile, directededge);
-        }
-      }
-    }
-
-    // Now loop again double checking the ways.
-    nodeid = GraphId(tile_id.tileid(), tile_id.level(), 0);
-    for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
-      const NodeInfo* nodeinfo = tile->node(i);
-      uint32_t idx = nodeinfo->edge_index();
-      for (uint32_t j = 0; j < nodeinfo->edge_count(); j++, idx++) {
-        const DirectedEdge* directededge = tile->directededge(idx);
-        if (no_agg_ways.find(tile->edgeinfo(directededge).wayid()) != no_agg_ways.end()) {
-          processed_nodes.insert(directededge->endnode());
-        }
+/**
+ * Find the nodes of a tile at which edges can not be aggregated after all. Validation walks into
+ * neighboring tiles so this only reads.
+ * @param  reader  Graph reader.
+ * @param  tile_id  Tile to validate.
+ * @param  processed_nodes  Set to the nodes whose aggregation flag has to be turned off.
+ */
+void ValidateTile(GraphReader& reader,
+                  const GraphId& tile_id,
+                  std::unordered_set<GraphId>& processed_nodes) {
+  // Get the graph tile. Read from this tile to create the new tile.
+  graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+  assert(tile);
+
+  std::unordered_set<uint64_t> no_agg_ways;
+  processed_nodes.reserve(tile->header()->nodecount());
+  no_agg_ways.reserve(tile->header()->directededgecount());
+
+  GraphId nodeid = GraphId(tile_id.tileid(), tile_id.level(), 0);
+  for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
+    const NodeInfo* nodeinfo = tile->node(i);
+    uint32_t idx = nodeinfo->edge_index();
+    for (uint32_t j = 0; j < nodeinfo->edge_count(); j++, idx++) {
+      const DirectedEdge* directededge = tile->directededge(idx);
+      if (processed_nodes.find(nodeid) == processed_nodes.end()) {
+        GraphId en = directededge->endnode();
+        std::list<PointLL> shape;
+        // check if we can aggregate the edges at this node.
+        ValidateData(reader, shape, en, processed_nodes, no_agg_ways, nodeid, tile, directededge);
       }
     }
+  }
 
-    // Create a new tile builder
-    GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
-    std::vector<NodeInfo> nodes;
-
-    // Copy edges (they do not change)
-    std::vector<DirectedEdge> directededges;
-    size_t n = tile->header()->directededgecount();
-    directededges.reserve(n);
-    const DirectedEdge* orig_edges = tile->directededge(0);
-    std::copy(orig_edges, orig_edges + n, std::back_inserter(directededges));
-
-    nodeid = GraphId(tile_id.tileid(), tile_id.level(), 0);
-    for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
-      NodeInfo nodeinfo = tilebuilder.node(i);
-      bool found = (processed_nodes.find(nodeid) != processed_nodes.end());
-
-      // We can not aggregate at this node.  Turn off the mode change(aggregation) bit
-      if (found) {
-        nodeinfo.set_mode_change(false);
+  // Now loop again double checking the ways.
+  nodeid = GraphId(tile_id.tileid(), tile_id.level(), 0);
+  for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
+    const NodeInfo* nodeinfo = tile->node(i);
+    uint32_t idx = nodeinfo->edge_index();
+    for (uint32_t j = 0; j < nodeinfo->edge_count(); j++, idx++) {
+      const DirectedEdge* directededge = tile->directededge(idx);
+      if (no_agg_ways.find(tile->edgeinfo(directededge).wayid()) != no_agg_ways.end()) {
+        processed_nodes.insert(directededge->endnode());
       }
-      // Add the node to the local list
-      nodes.emplace_back(std::move(nodeinfo));
     }
-    tilebuilder.Update(nodes, directededges);
+  }
+}
 
-    if (reader.OverCommitted()) {
-      reader.Trim();
+/**
+ * Turn off the aggregation flag of the nodes found by validation.
+ * @param  reader  Graph reader.
+ * @param  tile_id  Tile to update.
+ * @param  processed_nodes  Nodes of the tile that can not be aggregated.
+ */
+void ClearAggregation(GraphReader& reader,
+                      const GraphId& tile_id,
+                      const std::unordered_set<GraphId>& processed_nodes) {
+  graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+  assert(tile);
+
+  // Create a new tile builder
+  GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
+  std::vector<NodeInfo> nodes;
+
+  // Copy edges (they do not change)
+  std::vector<DirectedEdge> directededges;
+  size_t n = tile->header()->directededgecount();
+  directededges.reserve(n);
+  const DirectedEdge* orig_edges = tile->directededge(0);
+  std::copy(orig_edges, orig_edges + n, std::back_inserter(directededges));
+
+  GraphId nodeid = GraphId(tile_id.tileid(), tile_id.level(), 0);
+  for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
+    NodeInfo nodeinfo = tilebuilder.node(i);
+    bool found = (processed_nodes.find(nodeid) != processed_nodes.end());
+
+    // We can not aggregate at this node.  Turn off the mode change(aggregation) bit
+    if (found) {
+      nodeinfo.set_mode_change(false);
     }
+    // Add the node to the local list
+    nodes.emplace_back(std::move(nodeinfo));
   }
+  tilebuilder.Update(nodes, directededges);
+}
 
-  LOG_INFO("Aggregating edges");
-  reader.Clear();
-  // Iterate through all tiles in the local level
-  local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  // Iterate through all tiles in the local level
-  for (const auto& tile_id : local_tiles) {
-    // Create a new tilebuilder - should copy header information
-    GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
-
-    // Get the graph tile. Read from this tile to create the new tile.
-    graph_tile_ptr tile = reader.GetGraphTile(tile_id);
-    assert(tile);
+/**
+ * Aggregate the edges of a tile through the nodes marked for aggregation and stage the new tile.
+ * Aggregation walks into neighboring tiles which other threads are working on at the same time,
+ * so only the original tiles are read.
+ * @param  reader  Graph reader.
+ * @param  tile_id  Tile to aggregate.
+ * @param  new_ids  New ids of the nodes of the tile (after aggregation).
+ * @param  staging_dir  Directory to store the new tile in.
+ */
+void AggregateTile(GraphReader& reader,
+                   const GraphId& tile_id,
+                   std::vector<uint32_t>& new_ids,
+                   const std::string& staging_dir) {
+  // Create a new tilebuilder - should copy header information
+  GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
+
+  // Get the graph tile. Read from this tile to create the new tile.
+  graph_tile_ptr tile = reader.GetGraphTile(tile_id);
+  assert(tile);
+  new_ids.assign(tile->header()->nodecount(), kNoNode);
+
+  std::hash<std::string> hasher;
+  GraphId nodeid(tile_id.tileid(), tile_id.level(), 0);
+  for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
+    bool diff_names = false;
+
+    // Count of edges added for this node
+    uint32_t edge_count = 0;
+
+    // Current edge index for first edge from this node
+    uint32_t edge_index = tilebuilder.directededges().size();
+
+    // Iterate through directed edges outbound from this node
+    std::vector<uint64_t> wayid;
+    std::vector<GraphId> endnode;
+    const NodeInfo* nodeinfo = tile->node(nodeid);
+
+    // Nodes marked with mode_change = true are tossed.
+    if (nodeinfo->mode_change()) {
+      continue;
+    }
 
-    std::hash<std::string> hasher;
-    GraphId nodeid(tile_id.tileid(), tile_id.level(), 0);
-    for (uint32_t i = 0; i < tile->header()->nodecount(); ++i, ++nodeid) {
-      bool diff_names = false;
+    GraphId edgeid(nodeid.tileid(), nodeid.level(), nodeinfo->edge_index());
 
-      // Count of edges added for this node
-      uint32_t edge_count = 0;
+    for (uint32_t j = 0; j < nodeinfo->edge_count(); ++j, ++edgeid) {
+      // Check if the directed edge should be included
+      const DirectedEdge* directededge = tile->directededge(edgeid);
 
-      // Current edge index for first edge from this node
-      uint32_t edge_index = tilebuilder.directededges().size();
+      // Copy the directed edge information
+      DirectedEdge newedge = *directededge;
 
-      // Iterate through directed edges outbound from this node
-      std::vector<uint64_t> wayid;
-      std::vector<GraphId> endnode;
-      const NodeInfo* nodeinfo = tile->node(nodeid);
+      // Set opposing edge indexes to 0 (gets set in graph validator).
+      newedge.set_opp_index(0);
 
-      // Nodes marked with mode_change = true are tossed.
-      if (nodeinfo->mode_change()) {
-        continue;
+      // Get signs from the base directed edge
+      if (directededge->sign()) {
+        std::vector<SignInfo> signs = tile->GetSigns(edgeid.id());
+        if (signs.size() == 0) {
+          LOG_ERROR("Base edge should have signs, but none found");
+        }
+        tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
       }
 
-      GraphId edgeid(nodeid.tileid(), nodeid.level(), nodeinfo->edge_index());
-
-      for (uint32_t j = 0; j < nodeinfo->edge_count(); ++j, ++edgeid) {
-        // Check if the directed edge should be included
-        const DirectedEdge* directededge = tile->directededge(edgeid);
-
-        // Copy the directed edge information
-        DirectedEdge newedge = *directededge;
-
-        // Set opposing edge indexes to 0 (gets set in graph validator).
-        newedge.set_opp_index(0);
+      // Get turn lanes from the base directed edge
+      if (directededge->turnlanes()) {
+        uint32_t offset = tile->turnlanes_offset(edgeid.id());
+        tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
+      }
 
-        // Get signs from the base directed edge
-        if (directededge->sign()) {
-          std::vector<SignInfo> signs = tile->GetSigns(edgeid.id());
-          if (signs.size() == 0) {
-            LOG_ERROR("Base edge should have signs, but none found");
-          }
-          tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
+      // Get access restrictions from the base directed edge. Add these to
+      // the list of access restrictions in the new tile. Update the
+      // edge index in the restriction to be the current directed edge Id
+      if (directededge->access_restriction()) {
+        auto restrictions = tile->GetAccessRestrictions(edgeid.id(), kAllAccess);
+        for (const auto& res : restrictions) {
+          tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
+                                                             res.type(), res.modes(), res.value()));
         }
+      }
 
-        // Get turn lanes from the base directed edge
-        if (directededge->turnlanes()) {
-          uint32_t offset = tile->turnlanes_offset(edgeid.id());
-          tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
+      // Copy lane connectivity
+      if (directededge->laneconnectivity()) {
+        auto laneconnectivity = tile->GetLaneConnectivity(edgeid.id());
+        if (laneconnectivity.size() == 0) {
+          LOG_ERROR("Base edge should have lane connectivity, but none found");
         }
-
-        // Get access restrictions from the base directed edge. Add these to
-        // the list of access restrictions in the new tile. Update the
-        // edge index in the restriction to be the current directed edge Id
-        if (directededge->access_restriction()) {
-          auto restrictions = tile->GetAccessRestrictions(edgeid.id(), kAllAccess);
-          for (const auto& res : restrictions) {
-            tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
-                                                               res.type(), res.modes(), res.value()));
-          }
+        for (auto& lc : laneconnectivity) {
+          lc.set_to(tilebuilder.directededges().size());
         }
+        tilebuilder.AddLaneConnectivity(laneconnectivity);
+      }
 
-        // Copy lane connectivity
-        if (directededge->laneconnectivity()) {
-          auto laneconnectivity = tile->GetLaneConnectivity(edgeid.id());
-          if (laneconnectivity.size() == 0) {
-            LOG_ERROR("Base edge should have lane connectivity, but none found");
-          }
-          for (auto& lc : laneconnectivity) {
-            lc.set_to(tilebuilder.directededges().size());
-          }
-          tilebuilder.AddLaneConnectivity(laneconnectivity);
-        }
-
-        // Names can be different in the forward and backward direction
-        diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
-
-        const auto& edgeinfo = tile->edgeinfo(directededge);
-        std::string encoded_shape = edgeinfo.encoded_shape();
-        std::list<PointLL> shape = valhalla::midgard::decode7<std::list<PointLL>>(encoded_shape);
+      // Names can be different in the forward and backward direction
+      diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
 
-        // Aggregate if end node is marked and in same tile
-        bool aggregated = false;
-        GraphId en = directededge->endnode();
+      const auto& edgeinfo = tile->edgeinfo(directededge);
+      std::string encoded_shape = edgeinfo.encoded_shape();
+      std::list<PointLL> shape = valhalla::midgard::decode7<std::list<PointLL>>(encoded_shape);
 
-        if (en.tile_value() == tile_id) {
-          if (tile->node(en.id())->mode_change()) {
-            GetAggregatedData(reader, shape, en, nodeid, tile, directededge);
-            newedge.set_endnode(en);
-            aggregated = true;
-          }
-        }
+      // Aggregate if end node is marked and in same tile
+      bool aggregated = false;
+      GraphId en = directededge->endnode();
 
-        // Hammerhead specific.  bike network not saved to edgeinfo
-        bool added;
-        encoded_shape = encode7(shape);
-        uint32_t w = hasher(encoded_shape + std::to_string(edgeinfo.wayid()));
-        uint32_t edge_info_offset =
-            tilebuilder.AddEdgeInfo(w, nodeid, en, edgeinfo.wayid(), edgeinfo.mean_elevation(),
-                                    edgeinfo.bike_network(), edgeinfo.speed_limit(), encoded_shape,
-                                    edgeinfo.GetNames(), edgeinfo.GetTaggedValues(),
-                                    edgeinfo.GetLinguisticTaggedValues(), edgeinfo.GetTypes(), added,
-                                    diff_names);
-        newedge.set_edgeinfo_offset(edge_info_offset);
-
-        // Update length and curvature if the edge was aggregated
-        if (aggregated) {
-          newedge.set_length(valhalla::midgard::length(shape));
-          newedge.set_curvature(compute_curvature(shape));
+      if (en.tile_value() == tile_id) {
+        if (tile->node(en.id())->mode_change()) {
+          GetAggregatedData(reader, shape, en, nodeid, tile, directededge);
+          newedge.set_endnode(en);
+          aggregated = true;
         }
+      }
 
-        // Add directed edge
-        tilebuilder.directededges().emplace_back(std::move(newedge));
-        ++edge_count;
+      // Hammerhead specific.  bike network not saved to edgeinfo
+      bool added;
+      encoded_shape = encode7(shape);
+      uint32_t w = hasher(encoded_shape + std::to_string(edgeinfo.wayid()));
+      uint32_t edge_info_offset =
+          tilebuilder.AddEdgeInfo(w, nodeid, en, edgeinfo.wayid(), edgeinfo.mean_elevation(),
+                                  edgeinfo.bike_network(), edgeinfo.speed_limit(), encoded_shape,
+                                  edgeinfo.GetNames(), edgeinfo.GetTaggedValues(),
+                                  edgeinfo.GetLinguisticTaggedValues(), edgeinfo.GetTypes(), added,
+                                  diff_names);
+      newedge.set_edgeinfo_offset(edge_info_offset);
+
+      // Update length and curvature if the edge was aggregated
+      if (aggregated) {
+        newedge.set_length(valhalla::midgard::length(shape));
+        newedge.set_curvature(compute_curvature(shape));
       }
 
-      // Add the node to the tilebuilder unless no edges remain
-      if (edge_count > 0) {
-        // Add a node builder to the tile. Update the edge count and edgeindex
-        GraphId new_node(nodeid.tileid(), nodeid.level(), tilebuilder.nodes().size());
-        tilebuilder.nodes().push_back(*nodeinfo);
-        NodeInfo& node = tilebuilder.nodes().back();
-        node.set_edge_count(edge_count);
-        node.set_edge_index(edge_index);
-        const auto& admin = tile->admininfo(nodeinfo->admin_index());
-        node.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
-                                                  admin.country_iso(), admin.state_iso()));
-
-        // Get named signs from the base node
-        if (nodeinfo->named_intersection()) {
-          std::vector<SignInfo> signs = tile->GetSigns(nodeid.id(), true);
-          if (signs.size() == 0) {
-            LOG_ERROR("Base node should have signs, but none found");
-          }
-          node.set_named_intersection(true);
-          tilebuilder.AddSigns(tilebuilder.nodes().size() - 1, signs);
+      // Add directed edge
+      tilebuilder.directededges().emplace_back(std::move(newedge));
+      ++edge_count;
+    }
+
+    // Add the node to the tilebuilder unless no edges remain
+    if (edge_count > 0) {
+      // Add a node builder to the tile. Update the edge count and edgeindex
+      GraphId new_node(nodeid.tileid(), nodeid.level(), tilebuilder.nodes().size());
+      tilebuilder.nodes().push_back(*nodeinfo);
+      NodeInfo& node = tilebuilder.nodes().back();
+      node.set_edge_count(edge_count);
+      node.set_edge_index(edge_index);
+      const auto& admin = tile->admininfo(nodeinfo->admin_index());
+      node.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
+                                                admin.country_iso(), admin.state_iso()));
+
+      // Get named signs from the base node
+      if (nodeinfo->named_intersection()) {
+        std::vector<SignInfo> signs = tile->GetSigns(nodeid.id(), true);
+        if (signs.size() == 0) {
+          LOG_ERROR("Base node should have signs, but none found");
         }
-        // Associate the old node to the new node.
-        old_to_new[nodeid] = new_node;
+        node.set_named_intersection(true);
+        tilebuilder.AddSigns(tilebuilder.nodes().size() - 1, signs);
       }
+      // Associate the old node to the new node.
+      new_ids[i] = new_node.id();
     }
+  }
 
-    // Store the updated tile data (or remove tile if all edges are filtered)
-    if (tilebuilder.nodes().size() > 0) {
-      tilebuilder.StoreTileData();
-    } else {
-      // Remove the tile - all nodes and edges were filtered
-      std::string file_location =
-          reader.tile_dir() + filesystem::path::preferred_separator + GraphTile::FileSuffix(tile_id);
-      remove(file_location.c_str());
-      LOG_INFO("Remove file: " + file_location + " all edges were filtered");
-    }
+  // Stage the updated tile data, a tile that isn't staged is removed once all tiles are done
+  if (tilebuilder.nodes().size() > 0) {
+    tilebuilder.StoreTileData(staging_dir);
+  }
+}
 
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
+void AggregateTiles(const boost::property_tree::ptree& pt, NodeRemap& remap) {
+
+  SCOPED_TIMER();
+  LOG_INFO("Validating edges for aggregation");
+  // Find the nodes that can't be aggregated in all tiles before turning off any of their flags
+  GraphReader reader(pt.get_child("mjolnir"));
+  auto local_tiles = GetLocalTiles(reader);
+  std::unordered_map<GraphId, std::unordered_set<GraphId>> processed_nodes;
+  for (const auto& tile_id : local_tiles) {
+    processed_nodes[tile_id];
   }
+  RunPass(pt, local_tiles, [&processed_nodes](GraphReader& reader, const GraphId& tile_id) {
+    ValidateTile(reader, tile_id, processed_nodes.at(tile_id));
+  });
+  RunPass(pt, local_tiles, [&processed_nodes](GraphReader& reader, const GraphId& tile_id) {
+    ClearAggregation(reader, tile_id, processed_nodes.at(tile_id));
+  });
+  processed_nodes.clear();
+
+  LOG_INFO("Aggregating edges");
+  auto staging_dir = StagingDir(reader.tile_dir(), "filter_staging");
+  filesystem::remove_all(staging_dir);
+  local_tiles = GetLocalTiles(reader, &remap);
+  RunPass(pt, local_tiles,
+          [&remap, &staging_dir](GraphReader& reader, const GraphId& tile_id) {
+            AggregateTile(reader, tile_id, remap.at(tile_id), staging_dir);
+          });
+  PublishStagedTiles(reader.tile_dir(), staging_dir, local_tiles, true);
 
   LOG_INFO("Aggregated " + std::to_string(aggregated) + " directededges out of " +
            std::to_string(n_original_edges));
@@ -786,15 +886,16 @@ void AggregateTiles(GraphReader& reader, std::unordered_map<GraphId, GraphId>& o
 
 /**
  * Update end nodes of all directed edges.
- * @param  reader  Graph reader.
- * @param  old_to_new  Map of original node Ids to new nodes Ids (after filtering).
+ * @param  pt  Configuration.
+ * @param  remap  Map of original node Ids to new nodes Ids (after filtering).
  */
-void UpdateEndNodes(GraphReader& reader, std::unordered_map<GraphId, GraphId>& old_to_new) {
+void UpdateEndNodes(const boost::property_tree::ptree& pt, const NodeRemap& remap) {
   SCOPED_TIMER();
   LOG_INFO("Update end nodes of directed edges");
-  // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
+  // Iterate through all tiles in the local level. Only the tile itself is read.
+  GraphReader reader(pt.get_child("mjolnir"));
+  auto local_tiles = GetLocalTiles(reader);
+  RunPass(pt, local_tiles, [&remap](GraphReader& reader, const GraphId& tile_id) {
     // Get the graph tile. Skip if no tile exists (should not happen!?)
     graph_tile_ptr tile = reader.GetGraphTile(tile_id);
     assert(tile);
@@ -815,15 +916,17 @@ void UpdateEndNodes(GraphReader& reader, std::unordered_map<GraphId, GraphId>& o
     for (uint32_t j = 0; j < tile->header()->directededgecount(); ++j, ++edgeid) {
       const DirectedEdge* edge = tile->directededge(j);
 
-      // Find the end node in the old_to_new mapping
+      // Find the end node in the remap table of its tile
       GraphId end_node;
-      auto iter = old_to_new.find(edge->endnode());
-      if (iter == old_to_new.end()) {
+      auto iter = remap.find(edge->endnode().Tile_Base());
+      if (iter == remap.end() || edge->endnode().id() >= iter->second.size() ||
+          iter->second[edge->endnode().id()] == kNoNode) {
         LOG_ERROR("UpdateEndNodes - failed to find associated node");
         std::cout << std::to_string(edge->endnode().value) << " "
                   << std::to_string(tile->edgeinfo(edge).wayid()) << std::endl;
       } else {
-        end_node = iter->second;
+        end_node = GraphId(edge->endnode().tileid(), edge->endnode().level(),
+                           iter->second[edge->endnode().id()]);
       }
 
       // Copy the edge to the directededges vector and update the end node
@@ -834,24 +937,24 @@ void UpdateEndNodes(GraphReader& reader, std::unordered_map<GraphId, GraphId>& o
 
     // Update the tile with new directededges.
     tilebuilder.Update(nodes, directededges);
-
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
-  }
+  });
 }
 
 /**
  * Update Opposing Edge Index of all directed edges.
- * @param  reader  Graph reader.
+ * @param  pt  Configuration.
  */
-void UpdateOpposingEdgeIndex(GraphReader& reader) {
+void UpdateOpposingEdgeIndex(const boost::property_tree::ptree& pt) {
   SCOPED_TIMER();
   LOG_INFO("Update Opposing Edge Index of directed edges");
 
-  // Iterate through all tiles in the local level
-  auto local_tiles = reader.GetTileSet(TileHierarchy::levels().back().level);
-  for (const auto& tile_id : local_tiles) {
+  // Iterate through all tiles in the local level. The opposing edges are looked up in the
+  // neighboring tiles so the updated tiles are staged until all of them are done.
+  GraphReader reader(pt.get_child("mjolnir"));
+  auto local_tiles = GetLocalTiles(reader);
+  auto staging_dir = StagingDir(reader.tile_dir(), "filter_staging");
+  filesystem::remove_all(staging_dir);
+  RunPass(pt, local_tiles, [&staging_dir](GraphReader& reader, const GraphId& tile_id) {
     GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
 
     // Get the graph tile. Read from this tile to create the new tile.
@@ -893,13 +996,10 @@ void UpdateOpposingEdgeIndex(GraphReader& reader) {
       }
     }
 
-    // Update the tile with new directededges.
-    tilebuilder.Update(nodes, directededges);
-
-    if (reader.OverCommitted()) {
-      reader.Trim();
-    }
-  }
+    // Stage the tile with new directededges.
+    tilebuilder.Update(nodes, directededges, staging_dir);
+  });
+  PublishStagedTiles(reader.tile_dir(), staging_dir, local_tiles, true);
 }
 
 } // namespace
@@ -907,11 +1007,9 @@ void UpdateOpposingEdgeIndex(GraphReader& reader) {
 namespace valhalla {
 namespace mjolnir {
 
-// Optionally filter edges and nodes based on access.
+// Optionally filter edges and nodes based on access. Each pass runs over the tiles in parallel,
+// the passes that read neighboring tiles stage their output until all tiles are done.
 void GraphFilter::Filter(const boost::property_tree::ptree& pt) {
-
-  // TODO: thread this. Could be difficult due to sequence creates to associate nodes
-
   SCOPED_TIMER();
   // Edge filtering (optionally exclude edges)
   bool include_driving = pt.get_child("mjolnir").get<bool>("include_driving", true);
@@ -932,30 +1030,22 @@ void GraphFilter::Filter(const boost::property_tree::ptree& pt) {
     return;
   }
 
-  // Map of old node Ids to new node Ids (after filtering).
-  std::unordered_map<baldr::GraphId, baldr::GraphId> old_to_new;
-
-  // Construct GraphReader
-  GraphReader reader(pt.get_child("mjolnir"));
+  // New node Ids of the original nodes of each tile (after filtering).
+  NodeRemap remap;
 
   // Filter edges (and nodes) by access
-  FilterTiles(reader, old_to_new, include_driving, include_bicycle, include_pedestrian);
+  FilterTiles(pt, remap, include_driving, include_bicycle, include_pedestrian);
 
-  // Update end nodes. Clear the GraphReader cache first.
-  reader.Clear();
-  UpdateEndNodes(reader, old_to_new);
+  // Update end nodes
+  UpdateEndNodes(pt, remap);
 
-  reader.Clear();
-  old_to_new.clear();
-  AggregateTiles(reader, old_to_new);
+  AggregateTiles(pt, remap);
 
-  // Update end nodes. Clear the GraphReader cache first.
-  reader.Clear();
-  UpdateEndNodes(reader, old_to_new);
+  // Update end nodes
+  UpdateEndNodes(pt, remap);
 
-  // Update Opposing Edge Index. Clear the GraphReader cache first.
-  reader.Clear();
-  UpdateOpposingEdgeIndex(reader);
+  // Update Opposing Edge Index
+  UpdateOpposingEdgeIndex(pt);
 
   LOG_INFO("Done GraphFilter");
 }
@@ -0,0 +1,2061 @@
+#include "mjolnir/graphtagtransform.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+using namespace valhalla::mjolnir;
+
+// This is a line for line port of lua/graph.lua, mind the lua semantics when changing it: nil
+// (nullptr here) is the only false value besides false itself, so a tag being present is enough
+// for it to count as true and `a or b` takes the first of its values that is not nil.
+
+namespace {
+
+using ValueTable = std::unordered_map<std::string_view, const char*>;
+using NumberTable = std::unordered_map<std::string_view, int>;
+
+// The default access of each mode on the known highway types, in the order of kForwardModes
+const std::array<const char*, 8> kForwardModes = {"auto_forward",       "truck_forward",
+                                                  "bus_forward",        "taxi_forward",
+                                                  "moped_forward",      "motorcycle_forward",
+                                                  "pedestrian_forward", "bike_forward"};
+const std::unordered_map<std::string_view, std::array<bool, 8>> kHighway = {
+    {"motorway", {true, true, true, true, false, true, false, false}},
+    {"motorway_link", {true, true, true, true, false, true, false, false}},
+    {"trunk", {true, true, true, true, true, true, true, true}},
+    {"trunk_link", {true, true, true, true, true, true, true, true}},
+    {"primary", {true, true, true, true, true, true, true, true}},
+    {"primary_link", {true, true, true, true, true, true, true, true}},
+    {"secondary", {true, true, true, true, true, true, true, true}},
+    {"secondary_link", {true, true, true, true, true, true, true, true}},
+    {"residential", {true, true, true, true, true, true, true, true}},
+    {"residential_link", {true, true, true, true, true, true, true, true}},
+    {"service", {true, true, true, true, true, true, true, true}},
+    {"tertiary", {true, true, true, true, true, true, true, true}},
+    {"tertiary_link", {true, true, true, true, true, true, true, true}},
+    {"road", {true, true, true, true, true, true, true, true}},
+    {"track", {true, true, true, true, true, true, true, true}},
+    {"unclassified", {true, true, true, true, true, true, true, true}},
+    {"undefined", {false, false, false, false, false, false, false, false}},
+    {"unknown", {false, false, false, false, false, false, false, false}},
+    {"living_street", {true, true, true, true, true, true, true, true}},
+    {"footway", {false, false, false, false, false, false, true, false}},
+    {"pedestrian", {false, false, false, false, false, false, true, false}},
+    {"steps", {false, false, false, false, false, false, true, true}},
+    {"bridleway", {false, false, false, false, false, false, false, false}},
+    {"cycleway", {false, false, false, false, false, false, false, true}},
+    {"path", {false, false, false, false, false, false, true, true}},
+    {"bus_guideway", {false, false, true, false, false, false, false, false}},
+    {"busway", {false, false, true, false, false, false, false, false}},
+    {"corridor", {false, false, false, false, false, false, true, false}},
+    {"elevator", {false, false, false, false, false, false, true, false}},
+    {"platform", {false, false, false, false, false, false, true, false}}};
+
+const std::array<int, 8> kDefaultSpeed = {105, 90, 75, 60, 50, 40, 35, 25};
+
+const NumberTable kRoadClass = {
+    {"motorway", 0}, {"motorway_link", 0}, {"trunk", 1}, {"trunk_link", 1}, {"primary", 2},
+    {"primary_link", 2}, {"secondary", 3}, {"secondary_link", 3}, {"tertiary", 4},
+    {"tertiary_link", 4}, {"unclassified", 5}, {"residential", 6}, {"residential_link", 6}};
+
+const NumberTable kRestriction = {
+    {"no_left_turn", 0}, {"no_right_turn", 1}, {"no_straight_on", 2}, {"no_u_turn", 3},
+    {"only_right_turn", 4}, {"only_left_turn", 5}, {"only_straight_on", 6}, {"no_entry", 7},
+    {"no_exit", 8}, {"no_turn", 9}};
+
+const ValueTable kAccess = {
+    {"yes", "true"}, {"private", "true"}, {"no", "false"}, {"permissive", "true"},
+    {"agricultural", "false"}, {"use_sidepath", "true"}, {"delivery", "true"}, {"designated", "true"},
+    {"dismount", "true"}, {"discouraged", "false"}, {"forestry", "false"}, {"destination", "true"},
+    {"customers", "true"}, {"official", "true"}, {"public", "true"}, {"restricted", "true"},
+    {"allowed", "true"}, {"emergency", "false"}, {"psv", "false"}, {"permit", "true"},
+    {"residents", "true"}};
+
+const ValueTable kPrivate = {
+    {"private", "true"}, {"destination", "true"}, {"customers", "true"}, {"delivery", "true"},
+    {"permit", "true"}, {"residents", "true"}};
+
+const ValueTable kNoThruTraffic = {
+    {"destination", "true"}, {"customers", "true"}, {"delivery", "true"}, {"permit", "true"},
+    {"residents", "true"}};
+
+const NumberTable kUse = {
+    {"driveway", 4}, {"alley", 5}, {"parking_aisle", 6}, {"emergency_access", 7},
+    {"drive-through", 8}};
+
+const ValueTable kMotorVehicle = {
+    {"yes", "true"}, {"private", "true"}, {"no", "false"}, {"permissive", "true"},
+    {"agricultural", "false"}, {"delivery", "true"}, {"designated", "true"}, {"discouraged", "false"},
+    {"forestry", "false"}, {"destination", "true"}, {"customers", "true"}, {"official", "true"},
+    {"public", "true"}, {"restricted", "true"}, {"allowed", "true"}, {"permit", "true"},
+    {"residents", "true"}};
+
+const ValueTable kMoped = {
+    {"yes", "true"}, {"designated", "true"}, {"private", "true"}, {"permissive", "true"},
+    {"destination", "true"}, {"delivery", "true"}, {"dismount", "true"}, {"no", "false"},
+    {"unknown", "false"}, {"agricultural", "false"}, {"permit", "true"}, {"residents", "true"}};
+
+const ValueTable kFoot = {
+    {"yes", "true"}, {"private", "true"}, {"no", "false"}, {"permissive", "true"},
+    {"agricultural", "false"}, {"use_sidepath", "true"}, {"delivery", "true"}, {"designated", "true"},
+    {"discouraged", "false"}, {"forestry", "false"}, {"destination", "true"}, {"customers", "true"},
+    {"official", "true"}, {"public", "true"}, {"restricted", "true"}, {"crossing", "true"},
+    {"sidewalk", "true"}, {"allowed", "true"}, {"passable", "true"}, {"footway", "true"},
+    {"permit", "true"}, {"residents", "true"}};
+
+const ValueTable kWheelchair = {
+    {"no", "false"}, {"yes", "true"}, {"designated", "true"}, {"limited", "true"},
+    {"official", "true"}, {"destination", "true"}, {"public", "true"}, {"permissive", "true"},
+    {"only", "true"}, {"private", "true"}, {"impassable", "false"}, {"partial", "false"},
+    {"bad", "false"}, {"half", "false"}, {"assisted", "true"}, {"permit", "true"},
+    {"residents", "true"}};
+
+const ValueTable kBus = {
+    {"no", "false"}, {"yes", "true"}, {"designated", "true"}, {"urban", "true"},
+    {"permissive", "true"}, {"restricted", "true"}, {"destination", "true"}, {"delivery", "false"},
+    {"official", "true"}, {"permit", "true"}};
+
+const ValueTable kTaxi = {
+    {"no", "false"}, {"yes", "true"}, {"designated", "true"}, {"urban", "true"},
+    {"permissive", "true"}, {"restricted", "true"}, {"destination", "true"}, {"delivery", "false"},
+    {"official", "true"}, {"permit", "true"}};
+
+const ValueTable kPsv = {
+    {"bus", "true"}, {"taxi", "true"}, {"no", "false"}, {"yes", "true"}, {"designated", "true"},
+    {"permissive", "true"}, {"1", "true"}, {"2", "true"}};
+
+const ValueTable kTruck = {
+    {"designated", "true"}, {"yes", "true"}, {"no", "false"}, {"destination", "true"},
+    {"delivery", "true"}, {"local", "true"}, {"agricultural", "false"}, {"private", "true"},
+    {"discouraged", "false"}, {"permissive", "true"}, {"unsuitable", "false"},
+    {"agricultural;forestry", "false"}, {"official", "true"}, {"forestry", "false"},
+    {"destination;delivery", "true"}, {"permit", "true"}, {"residents", "true"}};
+
+const ValueTable kHazmat = {
+    {"designated", "true"}, {"yes", "true"}, {"no", "false"}, {"destination", "false"},
+    {"delivery", "false"}};
+
+const ValueTable kShoulder = {{"yes", "true"}, {"both", "true"}, {"no", "false"}};
+
+const ValueTable kShoulderRight = {{"right", "true"}};
+
+const ValueTable kShoulderLeft = {{"left", "true"}};
+
+const ValueTable kBicycle = {
+    {"yes", "true"}, {"designated", "true"}, {"use_sidepath", "true"}, {"no", "false"},
+    {"permissive", "true"}, {"destination", "true"}, {"dismount", "true"}, {"lane", "true"},
+    {"track", "true"}, {"shared", "true"}, {"shared_lane", "true"}, {"sidepath", "true"},
+    {"share_busway", "true"}, {"none", "false"}, {"allowed", "true"}, {"private", "true"},
+    {"official", "true"}, {"permit", "true"}, {"residents", "true"}};
+
+const ValueTable kCycleway = {
+    {"yes", "true"}, {"designated", "true"}, {"use_sidepath", "true"}, {"permissive", "true"},
+    {"destination", "true"}, {"dismount", "true"}, {"lane", "true"}, {"track", "true"},
+    {"shared", "true"}, {"shared_lane", "true"}, {"sidepath", "true"}, {"share_busway", "true"},
+    {"allowed", "true"}, {"private", "true"}, {"cyclestreet", "true"}, {"crossing", "true"}};
+
+const ValueTable kBikeReverse = {
+    {"opposite", "true"}, {"opposite_lane", "true"}, {"opposite_track", "true"}};
+
+const ValueTable kBusReverse = {{"opposite", "true"}, {"opposite_lane", "true"}};
+
+const NumberTable kShared = {{"shared_lane", 1}, {"share_busway", 1}, {"shared", 1}};
+
+const NumberTable kBuffer = {{"yes", 2}};
+
+const NumberTable kDedicated = {{"opposite_lane", 2}, {"lane", 2}, {"buffered_lane", 2}};
+
+const NumberTable kSeparated = {{"opposite_track", 3}, {"track", 3}};
+
+const ValueTable kOneway = {
+    {"no", "false"}, {"false", "false"}, {"-1", "true"}, {"yes", "true"}, {"true", "true"},
+    {"1", "true"}, {"reversible", "false"}, {"alternating", "false"}};
+
+const ValueTable kBridge = {{"yes", "true"}, {"no", "false"}, {"1", "true"}};
+
+const ValueTable kTunnel = {
+    {"yes", "true"}, {"no", "false"}, {"1", "true"}, {"building_passage", "true"}};
+
+const ValueTable kToll = {
+    {"yes", "true"}, {"no", "false"}, {"true", "true"}, {"false", "false"}, {"1", "true"},
+    {"interval", "true"}, {"snowmobile", "true"}};
+
+const ValueTable kLit = {
+    {"yes", "true"}, {"no", "false"}, {"24/7", "true"}, {"automatic", "true"}, {"limited", "false"},
+    {"disused", "false"}, {"dusk-dawn", "true"}, {"sunset-sunrise", "true"}};
+
+const NumberTable kMotorVehicleNode = {
+    {"yes", 1}, {"private", 1}, {"no", 0}, {"permissive", 1}, {"agricultural", 0}, {"delivery", 1},
+    {"designated", 1}, {"discouraged", 0}, {"forestry", 0}, {"destination", 1}, {"customers", 1},
+    {"official", 1}, {"public", 1}, {"restricted", 1}, {"allowed", 1}, {"permit", 1},
+    {"residents", 1}};
+
+const NumberTable kBicycleNode = {
+    {"yes", 4}, {"designated", 4}, {"use_sidepath", 4}, {"no", 0}, {"permissive", 4},
+    {"destination", 4}, {"dismount", 4}, {"lane", 4}, {"track", 4}, {"shared", 4}, {"shared_lane", 4},
+    {"sidepath", 4}, {"share_busway", 4}, {"none", 0}, {"allowed", 4}, {"private", 4},
+    {"official", 4}, {"permit", 4}, {"residents", 4}};
+
+const NumberTable kFootNode = {
+    {"yes", 2}, {"private", 2}, {"no", 0}, {"permissive", 2}, {"agricultural", 0},
+    {"use_sidepath", 2}, {"delivery", 2}, {"designated", 2}, {"discouraged", 0}, {"forestry", 0},
+    {"destination", 2}, {"customers", 2}, {"official", 2}, {"public", 2}, {"restricted", 2},
+    {"crossing", 2}, {"sidewalk", 2}, {"allowed", 2}, {"passable", 2}, {"footway", 2}, {"permit", 2},
+    {"residents", 2}};
+
+const NumberTable kWheelchairNode = {
+    {"no", 0}, {"yes", 256}, {"designated", 256}, {"limited", 256}, {"official", 256},
+    {"destination", 256}, {"public", 256}, {"permissive", 256}, {"only", 256}, {"private", 256},
+    {"impassable", 0}, {"partial", 0}, {"bad", 0}, {"half", 0}, {"assisted", 256}, {"permit", 256},
+    {"residents", 256}};
+
+const NumberTable kMopedNode = {
+    {"yes", 512}, {"designated", 512}, {"private", 512}, {"permissive", 512}, {"destination", 512},
+    {"delivery", 512}, {"dismount", 512}, {"no", 0}, {"unknown", 0}, {"agricultural", 0},
+    {"permit", 512}, {"residents", 512}};
+
+const NumberTable kMotorCycleNode = {
+    {"yes", 1024}, {"private", 1024}, {"no", 0}, {"permissive", 1024}, {"agricultural", 0},
+    {"delivery", 1024}, {"designated", 1024}, {"discouraged", 0}, {"forestry", 0},
+    {"destination", 1024}, {"customers", 1024}, {"official", 1024}, {"public", 1024},
+    {"restricted", 1024}, {"allowed", 1024}, {"permit", 1024}};
+
+const NumberTable kBusNode = {
+    {"no", 0}, {"yes", 64}, {"designated", 64}, {"urban", 64}, {"permissive", 64}, {"restricted", 64},
+    {"destination", 64}, {"delivery", 0}, {"official", 64}, {"permit", 64}};
+
+const NumberTable kTaxiNode = {
+    {"no", 0}, {"yes", 32}, {"designated", 32}, {"urban", 32}, {"permissive", 32}, {"restricted", 32},
+    {"destination", 32}, {"delivery", 0}, {"official", 32}, {"permit", 32}};
+
+const NumberTable kTruckNode = {
+    {"designated", 8}, {"yes", 8}, {"no", 0}, {"destination", 8}, {"delivery", 8}, {"local", 8},
+    {"agricultural", 0}, {"private", 8}, {"discouraged", 0}, {"permissive", 8}, {"unsuitable", 0},
+    {"agricultural;forestry", 0}, {"official", 8}, {"forestry", 0}, {"destination;delivery", 8},
+    {"permit", 8}, {"residents", 8}};
+
+const NumberTable kPsvBusNode = {
+    {"bus", 64}, {"no", 0}, {"yes", 64}, {"designated", 64}, {"permissive", 64}, {"1", 64},
+    {"2", 64}};
+
+const NumberTable kPsvTaxiNode = {
+    {"taxi", 32}, {"no", 0}, {"yes", 32}, {"designated", 32}, {"permissive", 32}, {"1", 32},
+    {"2", 32}};
+
+// The access keys of all modes in both directions
+const std::array<const char*, 16> kAccessModes =
+    {"auto_forward",       "truck_forward",       "bus_forward",        "taxi_forward",
+     "moped_forward",      "motorcycle_forward",  "pedestrian_forward", "bike_forward",
+     "auto_backward",      "truck_backward",      "bus_backward",       "taxi_backward",
+     "moped_backward",     "motorcycle_backward", "pedestrian_backward", "bike_backward"};
+
+const char* lookup(const ValueTable& table, const char* key) {
+  if (key == nullptr) {
+    return nullptr;
+  }
+  auto found = table.find(key);
+  return found == table.end() ? nullptr : found->second;
+}
+
+std::optional<int> lookup(const NumberTable& table, const char* key) {
+  if (key == nullptr) {
+    return std::nullopt;
+  }
+  auto found = table.find(key);
+  return found == table.end() ? std::nullopt : std::optional<int>(found->second);
+}
+
+// lua's `a or b or ...`
+const char* first(const char* value) {
+  return value;
+}
+
+template <typename... Values> const char* first(const char* value, Values... values) {
+  return value != nullptr ? value : first(values...);
+}
+
+template <typename T> std::optional<T> first(std::optional<T> value, std::optional<T> other) {
+  return value ? value : other;
+}
+
+bool eq(const char* value, const char* other) {
+  return value != nullptr && std::strcmp(value, other) == 0;
+}
+
+bool ends_with(const std::string& value, std::string_view suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// What lua considers a space, ie isspace in the C locale
+bool is_space(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Case insensitive comparison of the start of a string against a lower case word
+bool starts_with_word(const char* value, const char* word) {
+  for (; *word != '\0'; ++value, ++word) {
+    if (std::tolower(static_cast<unsigned char>(*value)) != *word) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// How luajit converts a number to a string, which is "%.14g" with its own inf and nan
+std::string to_string(double number) {
+  if (std::isnan(number)) {
+    return "nan";
+  }
+  if (std::isinf(number)) {
+    return number < 0 ? "-inf" : "inf";
+  }
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.14g", number);
+  return buffer;
+}
+
+// The tonumber function of luajit, which besides decimals takes hexadecimal numbers, binary
+// integers, inf and nan surrounded by spaces
+std::optional<double> to_number(const char* value) {
+  if (value == nullptr) {
+    return std::nullopt;
+  }
+  const char* p = value;
+  bool negative = false;
+  if (!is_digit(*p)) {
+    while (is_space(*p)) {
+      ++p;
+    }
+    if (*p == '+' || *p == '-') {
+      negative = *p++ == '-';
+    }
+    if (*p >= 'A') {
+      double number = NAN;
+      if (starts_with_word(p, "inf")) {
+        number = negative ? -INFINITY : INFINITY;
+        p += 3;
+        if (starts_with_word(p, "inity")) {
+          p += 5;
+        }
+      } else if (starts_with_word(p, "nan")) {
+        p += 3;
+      }
+      while (is_space(*p)) {
+        ++p;
+      }
+      return *p == '\0' ? std::optional<double>(number) : std::nullopt;
+    }
+  }
+
+  // the number has digits of its base with at most one point between them
+  int base = 10;
+  if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+    base = 16;
+    p += 2;
+  } else if (p[0] == '0' && (p[1] == 'b' || p[1] == 'B')) {
+    base = 2;
+    p += 2;
+  }
+  const char* digits = p;
+  const char* point = nullptr;
+  bool has_digits = false;
+  for (;; ++p) {
+    if (base == 16 ? std::isxdigit(static_cast<unsigned char>(*p)) != 0
+                   : is_digit(*p) && (base == 10 || *p <= '1')) {
+      has_digits = true;
+    } else if (*p == '.' && point == nullptr) {
+      point = p;
+    } else if (*p == '.') {
+      return std::nullopt;
+    } else {
+      break;
+    }
+  }
+  if (!has_digits || (base == 2 && point != nullptr)) {
+    return std::nullopt;
+  }
+
+  // followed by an optional exponent, which is binary for hexadecimal numbers
+  if (base != 2 && std::tolower(static_cast<unsigned char>(*p)) == (base == 16 ? 'p' : 'e')) {
+    ++p;
+    if (*p == '+' || *p == '-') {
+      ++p;
+    }
+    if (!is_digit(*p)) {
+      return std::nullopt;
+    }
+    for (uint32_t exponent = 0; is_digit(*p); ++p) {
+      exponent = exponent * 10 + (*p - '0');
+      if (exponent >= (1 << 20)) {
+        return std::nullopt;
+      }
+    }
+  }
+  const char* end = p;
+  while (is_space(*p)) {
+    ++p;
+  }
+  if (*p != '\0') {
+    return std::nullopt;
+  }
+
+  double number = 0;
+  if (base == 2) {
+    for (p = digits; p != end; ++p) {
+      number = number * 2 + (*p - '0');
+    }
+  } else {
+    // strtod reads both the decimal and the hexadecimal numbers the same way
+    number = std::strtod(std::string(base == 16 ? digits - 2 : digits, end).c_str(), nullptr);
+  }
+  return negative ? -number : number;
+}
+
+// The tags as the lua table the script works on, where a missing key is nil
+class Kv {
+public:
+  explicit Kv(Tags& tags) : tags_(tags) {
+  }
+
+  // The value of a key, which stays valid until the key is assigned to again
+  const char* operator[](const std::string& key) const {
+    auto found = tags_.find(key);
+    return found == tags_.end() ? nullptr : found->second.c_str();
+  }
+
+  bool is(const std::string& key, const char* value) const {
+    return eq((*this)[key], value);
+  }
+
+  std::optional<std::string> copy(const std::string& key) const {
+    auto found = tags_.find(key);
+    return found == tags_.end() ? std::nullopt : std::optional<std::string>(found->second);
+  }
+
+  // Assigning nil removes the key. The value is copied first as it may be one of the tags
+  void set(const std::string& key, const char* value) {
+    if (value == nullptr) {
+      tags_.erase(key);
+      return;
+    }
+    std::string copy(value);
+    tags_[key] = std::move(copy);
+  }
+
+  void set(const std::string& key, const std::optional<std::string>& value) {
+    set(key, value ? value->c_str() : nullptr);
+  }
+
+  void set_number(const std::string& key, const std::optional<double>& number) {
+    if (!number) {
+      tags_.erase(key);
+      return;
+    }
+    tags_[key] = to_string(*number);
+  }
+
+  void swap(const std::string& key, const std::string& other) {
+    auto value = copy(key);
+    set(key, copy(other));
+    set(other, value);
+  }
+
+protected:
+  Tags& tags_;
+};
+
+double round(double value, int digits = 0) {
+  const double scale = std::pow(10, digits);
+  return std::floor(value * scale + 0.5) / scale;
+}
+
+std::optional<std::string> restriction_prefix(const char* restriction) {
+  // the restriction type is before the @, the length of which doesn't count the spaces in it
+  // restriction:conditional=no_left_turn @ (07:00-09:00,15:30-17:30)
+  if (restriction == nullptr) {
+    return std::nullopt;
+  }
+  size_t index = 0;
+  const char* c = restriction;
+  for (; *c != '\0' && *c != '@'; ++c) {
+    if (*c != ' ') {
+      ++index;
+    }
+  }
+  if (*c != '@') {
+    return std::nullopt;
+  }
+  return std::string(restriction, index);
+}
+
+std::optional<std::string> restriction_suffix(const char* restriction) {
+  // the date and time of the restriction start at the first non space after the @
+  if (restriction == nullptr) {
+    return std::nullopt;
+  }
+  std::string_view value(restriction);
+  auto at = value.find('@');
+  if (at == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto start = value.find_first_not_of(' ', at + 1);
+  // without anything after the @ the script returns its last character
+  return std::string(value.substr(start == std::string_view::npos ? value.size() - 1 : start));
+}
+
+// The numeric (non negative) number at the start of the string
+std::optional<std::string> numeric_prefix(const char* number, bool allow_decimals) {
+  if (number == nullptr) {
+    return std::nullopt;
+  }
+  size_t index = 0;
+  bool seen_dot = false;
+  for (; number[index] != '\0'; ++index) {
+    if (!is_digit(number[index])) {
+      if (number[index] != '.' || !allow_decimals || seen_dot) {
+        break;
+      }
+      seen_dot = true;
+    }
+  }
+  if (index == 0) {
+    return std::nullopt;
+  }
+  return std::string(number, index);
+}
+
+std::optional<double> normalize_speed(const char* speed) {
+  auto prefix = numeric_prefix(speed, false);
+  if (!prefix) {
+    return std::nullopt;
+  }
+  double number = std::strtod(prefix->c_str(), nullptr);
+
+  // convert mph to kph and toss anything > 150kph or < 10kph
+  if (ends_with(speed, "mph")) {
+    number = round(number * 1.609344);
+  }
+  if (number > 150 || number < 10) {
+    return std::nullopt;
+  }
+  return number;
+}
+
+std::optional<double> normalize_weight(const char* weight) {
+  if (weight == nullptr) {
+    return std::nullopt;
+  }
+  std::string w;
+  for (const char* c = weight; *c != '\0'; ++c) {
+    if (!is_space(*c)) {
+      w.push_back(*c);
+    }
+  }
+  auto num = numeric_prefix(w.c_str(), true);
+  if (!num) {
+    return std::nullopt;
+  }
+  auto number = to_number(num->c_str());
+  if (!number) {
+    // the script does arithmetic on the nil of a lone decimal point
+    throw std::runtime_error("attempt to perform arithmetic on a nil value (weight " +
+                             std::string(weight) + ")");
+  }
+
+  if ((ends_with(w, "t") || ends_with(w, "tonne") || ends_with(w, "tonnes")) &&
+      (*num + "t" == w || *num + "tonne" == w || *num + "tonnes" == w)) {
+    return round(*number, 2);
+  }
+  if ((ends_with(w, "ton") || ends_with(w, "tons")) && (*num + "ton" == w || *num + "tons" == w)) {
+    return round(*number, 2);
+  }
+  if ((ends_with(w, "lb") || ends_with(w, "lbs")) && (*num + "lb" == w || *num + "lbs" == w)) {
+    return round(*number / 2000, 2); // convert to tons
+  }
+  if (ends_with(w, "kg") && *num + "kg" == w) {
+    return round(*number / 1000, 2);
+  }
+  return round(*number, 2);
+}
+
+std::optional<double> normalize_measurement(const char* measurement) {
+  if (measurement == nullptr) {
+    return std::nullopt;
+  }
+
+  // turn commas into dots to handle European-style decimal separators
+  std::string m(measurement);
+  std::replace(m.begin(), m.end(), ',', '.');
+
+  // handle the simple case: it's just a plain number
+  if (auto number = to_number(m.c_str())) {
+    return round(*number, 2);
+  }
+
+  // otherwise sum up each term of a compound expression such as 3ft6in in meters, which are
+  // the matches of the pattern (%d+[.,]?%d*) *([a-zA-Z\"\']*) anywhere in the string
+  double sum = 0;
+  int count = 0;
+  for (size_t i = 0; i < m.size();) {
+    if (!is_digit(m[i])) {
+      ++i;
+      continue;
+    }
+    size_t end = i;
+    while (end < m.size() && is_digit(m[end])) {
+      ++end;
+    }
+    if (end < m.size() && m[end] == '.') {
+      ++end;
+    }
+    while (end < m.size() && is_digit(m[end])) {
+      ++end;
+    }
+    double item = std::strtod(m.substr(i, end - i).c_str(), nullptr);
+    while (end < m.size() && m[end] == ' ') {
+      ++end;
+    }
+    size_t unit_start = end;
+    while (end < m.size() && (std::isalpha(static_cast<unsigned char>(m[end])) ||
+                              m[end] == '"' || m[end] == '\'')) {
+      ++end;
+    }
+    std::string unit = m.substr(unit_start, end - unit_start);
+    std::transform(unit.begin(), unit.end(), unit.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    i = end;
+
+    if (unit == "m" || unit == "meter" || unit == "meters") {
+      sum = sum + item;
+    } else if (unit == "cm") {
+      sum = sum + item * 0.01;
+    } else if (unit == "ft" || unit == "feet" || unit == "foot" || unit == "'") {
+      sum = sum + item * 0.3048;
+    } else if (unit == "in" || unit == "inches" || unit == "inch" || unit == "\"" ||
+               unit == "''") {
+      sum = sum + item * 0.0254;
+    } else {
+      // unknown unit! bail!
+      return std::nullopt;
+    }
+    ++count;
+  }
+  if (count > 0) {
+    return round(sum, 2);
+  }
+  return std::nullopt;
+}
+
+// Whether the only payment types present are cash (cash, notes and coins) where any value other
+// than "no" allows the payment type
+bool is_cash_only_payment(const Tags& tags) {
+  bool allows_cash_payment = false;
+  bool allows_noncash_payment = false;
+  for (const auto& tag : tags) {
+    if (tag.first.compare(0, 8, "payment:") != 0) {
+      continue;
+    }
+    const auto payment_type = std::string_view(tag.first).substr(8);
+    const bool is_cash_payment_type =
+        payment_type == "cash" || payment_type == "notes" || payment_type == "coins";
+    std::string value = tag.second;
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return std::toupper(c); });
+    if (is_cash_payment_type && !allows_cash_payment) {
+      allows_cash_payment = value != "NO";
+    }
+    if (!is_cash_payment_type && !allows_noncash_payment) {
+      allows_noncash_payment = value != "NO";
+    }
+  }
+  return allows_cash_payment && !allows_noncash_payment;
+}
+
+// The lanes of a cycle lane tag, one of shared, dedicated or separated, or nil
+std::optional<int> cycle_lane(const Kv& kv, const std::string& key) {
+  const char* value = kv[key];
+  return first(first(lookup(kShared, value), lookup(kSeparated, value)),
+               lookup(kDedicated, value));
+}
+
+std::optional<double> lane_count(const char* lanes) {
+  auto prefix = numeric_prefix(lanes, false);
+  if (!prefix) {
+    return std::nullopt;
+  }
+  double count = std::strtod(prefix->c_str(), nullptr);
+  return count > 15 ? std::nullopt : std::optional<double>(count);
+}
+
+void set_access(Kv& kv, bool pedestrian) {
+  for (const auto* mode : kAccessModes) {
+    if (pedestrian || std::strncmp(mode, "pedestrian", 10) != 0) {
+      kv.set(mode, "false");
+    }
+  }
+}
+
+// Returns true if you should filter this way, false otherwise
+bool filter_tags_generic(Kv& kv) {
+  if ((kv.is("highway", "construction") && kv["construction"] == nullptr) ||
+      kv.is("highway", "proposed")) {
+    return true;
+  }
+
+  // toss actual areas
+  if (kv.is("area", "yes")) {
+    return true;
+  }
+
+  // figure out what basic type of road it is
+  auto highway_type = [&kv](const char* key) -> const std::array<bool, 8>* {
+    const char* highway = kv[key];
+    if (highway == nullptr) {
+      return nullptr;
+    }
+    auto found = kHighway.find(highway);
+    return found == kHighway.end() ? nullptr : &found->second;
+  };
+  const auto* forward = highway_type("highway");
+  if (kv.is("highway", "construction")) {
+    forward = highway_type("construction");
+  }
+  const bool ferry = kv.is("route", "ferry");
+  const bool rail = kv.is("route", "shuttle_train");
+  const char* access = lookup(kAccess, kv["access"]);
+
+  kv.set("emergency_forward", "false");
+  kv.set("emergency_backward", "false");
+
+  if (ferry || rail || kv["highway"]) {
+    if (kv.is("access", "emergency") || kv.is("emergency", "yes") ||
+        kv.is("service", "emergency_access")) {
+      kv.set("emergency_forward", "true");
+      kv.set("emergency_tag", "true");
+    }
+
+    if (kv.is("emergency", "no")) {
+      kv.set("emergency_tag", "false");
+    }
+  }
+
+  const bool no_access =
+      kv.is("impassable", "yes") || eq(access, "false") ||
+      (kv.is("access", "private") &&
+       (kv.is("emergency", "yes") || kv.is("service", "emergency_access")));
+  if (forward) {
+    for (size_t i = 0; i < kForwardModes.size(); ++i) {
+      kv.set(kForwardModes[i], (*forward)[i] ? "true" : "false");
+    }
+
+    if (no_access) {
+      set_access(kv, true);
+    } else if (kv.is("smoothness", "impassable") || kv.is("vehicle", "no")) {
+      // don't change ped access
+      set_access(kv, false);
+    }
+
+    // check for overrides of each mode
+    kv.set("auto_forward", first(lookup(kMotorVehicle, kv["motorcar"]),
+                                 lookup(kMotorVehicle, kv["motor_vehicle"]), kv["auto_forward"]));
+    kv.set("auto_tag",
+           first(lookup(kMotorVehicle, kv["motorcar"]), lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+    kv.set("truck_forward", first(lookup(kTruck, kv["hgv"]),
+                                  lookup(kMotorVehicle, kv["motor_vehicle"]), kv["truck_forward"]));
+    kv.set("truck_tag",
+           first(lookup(kTruck, kv["hgv"]), lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+    kv.set("bus_forward",
+           first(lookup(kBus, kv["bus"]), lookup(kPsv, kv["psv"]),
+                 lookup(kPsv, kv["lanes:psv:forward"]), lookup(kMotorVehicle, kv["motor_vehicle"]),
+                 kv["bus_forward"]));
+    kv.set("bus_tag", first(lookup(kBus, kv["bus"]), lookup(kPsv, kv["psv"]),
+                            lookup(kPsv, kv["lanes:psv:forward"]),
+                            lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+    kv.set("taxi_forward",
+           first(lookup(kTaxi, kv["taxi"]), lookup(kPsv, kv["psv"]),
+                 lookup(kPsv, kv["lanes:psv:forward"]), lookup(kMotorVehicle, kv["motor_vehicle"]),
+                 kv["taxi_forward"]));
+    kv.set("taxi_tag", first(lookup(kTaxi, kv["taxi"]), lookup(kPsv, kv["psv"]),
+                             lookup(kPsv, kv["lanes:psv:forward"]),
+                             lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+    kv.set("pedestrian_forward", first(lookup(kFoot, kv["foot"]), lookup(kFoot, kv["pedestrian"]),
+                                       kv["pedestrian_forward"]));
+    kv.set("foot_tag", first(lookup(kFoot, kv["foot"]), lookup(kFoot, kv["pedestrian"])));
+
+    kv.set("bike_forward",
+           first(lookup(kBicycle, kv["bicycle"]), lookup(kCycleway, kv["cycleway"]),
+                 lookup(kBicycle, kv["bicycle_road"]), lookup(kBicycle, kv["cyclestreet"]),
+                 kv["bike_forward"]));
+    kv.set("bike_tag", first(lookup(kBicycle, kv["bicycle"]), lookup(kCycleway, kv["cycleway"]),
+                             lookup(kBicycle, kv["bicycle_road"]),
+                             lookup(kBicycle, kv["cyclestreet"])));
+
+    kv.set("moped_forward",
+           first(lookup(kMoped, kv["moped"]), lookup(kMoped, kv["mofa"]),
+                 lookup(kMotorVehicle, kv["motor_vehicle"]), kv["moped_forward"]));
+    kv.set("moped_tag", first(lookup(kMoped, kv["moped"]), lookup(kMoped, kv["mofa"]),
+                              lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+    kv.set("motorcycle_forward",
+           first(lookup(kMotorVehicle, kv["motorcycle"]),
+                 lookup(kMotorVehicle, kv["motor_vehicle"]), kv["motorcycle_forward"]));
+    kv.set("motorcycle_tag", first(lookup(kMotorVehicle, kv["motorcycle"]),
+                                   lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+    if (kv.is("access", "psv")) {
+      kv.set("taxi_forward", "true");
+      kv.set("taxi_tag", "true");
+
+      kv.set("bus_forward", "true");
+      kv.set("bus_tag", "true");
+    }
+
+    if (kv.is("motorroad", "yes")) {
+      kv.set("motorroad_tag", "true");
+    }
+  } // its not a highway type that we know of
+  else {
+    // if its a ferry and these tags dont show up we want to set them to true
+    const char* default_val = ferry || rail ? "true" : "false";
+
+    if ((!ferry && !rail) || no_access) {
+      set_access(kv, true);
+    } else {
+      const char* ped_val = default_val;
+      if (kv.is("smoothness", "impassable") || kv.is("vehicle", "no")) {
+        // don't change ped access
+        default_val = "false";
+      }
+
+      // check for overrides of each mode
+      kv.set("auto_forward", first(lookup(kMotorVehicle, kv["motorcar"]),
+                                   lookup(kMotorVehicle, kv["motor_vehicle"]), default_val));
+      kv.set("auto_tag", first(lookup(kMotorVehicle, kv["motorcar"]),
+                               lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+      kv.set("truck_forward",
+             first(lookup(kTruck, kv["hgv"]), kv["truck_forward"],
+                   lookup(kMotorVehicle, kv["motor_vehicle"]), default_val));
+      kv.set("truck_tag",
+             first(lookup(kTruck, kv["hgv"]), lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+      kv.set("bus_forward", first(lookup(kBus, kv["bus"]), lookup(kPsv, kv["psv"]),
+                                  lookup(kPsv, kv["lanes:psv:forward"]),
+                                  lookup(kMotorVehicle, kv["motor_vehicle"]), default_val));
+      kv.set("bus_tag", first(lookup(kBus, kv["bus"]), lookup(kPsv, kv["psv"]),
+                              lookup(kPsv, kv["lanes:psv:forward"]),
+                              lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+      kv.set("taxi_forward", first(lookup(kTaxi, kv["taxi"]), lookup(kPsv, kv["psv"]),
+                                   lookup(kPsv, kv["lanes:psv:forward"]),
+                                   lookup(kMotorVehicle, kv["motor_vehicle"]), default_val));
+      kv.set("taxi_tag", first(lookup(kTaxi, kv["taxi"]), lookup(kPsv, kv["psv"]),
+                               lookup(kPsv, kv["lanes:psv:forward"]),
+                               lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+      kv.set("pedestrian_forward",
+             first(lookup(kFoot, kv["foot"]), lookup(kFoot, kv["pedestrian"]), ped_val));
+      kv.set("foot_tag", first(lookup(kFoot, kv["foot"]), lookup(kFoot, kv["pedestrian"])));
+
+      kv.set("bike_forward",
+             first(lookup(kBicycle, kv["bicycle"]), lookup(kCycleway, kv["cycleway"]),
+                   lookup(kBicycle, kv["bicycle_road"]), lookup(kBicycle, kv["cyclestreet"]),
+                   default_val));
+      kv.set("bike_tag", first(lookup(kBicycle, kv["bicycle"]), lookup(kCycleway, kv["cycleway"]),
+                               lookup(kBicycle, kv["bicycle_road"]),
+                               lookup(kBicycle, kv["cyclestreet"])));
+
+      kv.set("moped_forward", first(lookup(kMoped, kv["moped"]), lookup(kMoped, kv["mofa"]),
+                                    lookup(kMotorVehicle, kv["motor_vehicle"]), default_val));
+      kv.set("moped_tag", first(lookup(kMoped, kv["moped"]), lookup(kMoped, kv["mofa"]),
+                                lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+      kv.set("motorcycle_forward", first(lookup(kMotorVehicle, kv["motorcycle"]),
+                                         lookup(kMotorVehicle, kv["motor_vehicle"]), default_val));
+      kv.set("motorcycle_tag", first(lookup(kMotorVehicle, kv["motorcycle"]),
+                                     lookup(kMotorVehicle, kv["motor_vehicle"])));
+
+      if (kv["bike_tag"] == nullptr) {
+        if (kv.is("sac_scale", "hiking")) {
+          kv.set("bike_forward", "true");
+          kv.set("bike_tag", "true");
+        } else if (kv["sac_scale"]) {
+          kv.set("bike_forward", "false");
+        }
+      }
+
+      if (kv.is("access", "psv")) {
+        kv.set("taxi_forward", "true");
+        kv.set("taxi_tag", "true");
+
+        kv.set("bus_forward", "true");
+        kv.set("bus_tag", "true");
+      }
+
+      if (kv.is("motorroad", "yes")) {
+        kv.set("motorroad_tag", "true");
+      }
+    }
+  }
+
+  // TODO: handle Time conditional restrictions if available for HOVs with oneway = reversible
+  if ((kv.is("access", "permissive") || kv.is("access", "hov") || kv.is("access", "taxi")) &&
+      kv.is("oneway", "reversible")) {
+    // for now enable only for buses if the tag exists and they are allowed.
+    if (kv.is("bus_forward", "true")) {
+      for (const auto* mode : {"auto_forward", "truck_forward", "pedestrian_forward",
+                               "bike_forward", "moped_forward", "motorcycle_forward"}) {
+        kv.set(mode, "false");
+      }
+    } else {
+      // toss this way
+      return true;
+    }
+  }
+
+  // service=driveway means all are routable
+  if (kv.is("service", "driveway") && kv["access"] == nullptr) {
+    for (const auto* mode : {"auto_forward", "truck_forward", "bus_forward", "taxi_forward",
+                             "pedestrian_forward", "bike_forward", "moped_forward",
+                             "motorcycle_forward"}) {
+      kv.set(mode, "true");
+    }
+  }
+
+  // check the oneway-ness and traversability against the direction of the geom
+  if ((kv.is("oneway", "yes") && kv.is("oneway:bicycle", "no")) ||
+      kv.is("bicycle:backward", "yes") || kv.is("bicycle:backward", "no")) {
+    kv.set("bike_backward", "true");
+  }
+
+  if (kv["bike_backward"] == nullptr || kv.is("bike_backward", "false")) {
+    kv.set("bike_backward",
+           first(lookup(kBikeReverse, kv["cycleway"]), lookup(kBikeReverse, kv["cycleway:left"]),
+                 lookup(kBikeReverse, kv["cycleway:right"]), "false"));
+  }
+
+  const char* oneway_bike = nullptr;
+  if (kv.is("bike_backward", "true")) {
+    oneway_bike = lookup(kOneway, kv["oneway:bicycle"]);
+  }
+
+  if (kv["oneway:bus"] == nullptr && kv["oneway:psv"] != nullptr) {
+    kv.set("oneway:bus", kv["oneway:psv"]);
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:bus", "no")) || kv.is("bus:backward", "yes") ||
+      kv.is("bus:backward", "designated")) {
+    kv.set("bus_backward", "true");
+  }
+
+  if (kv["bus_backward"] == nullptr || kv.is("bus_backward", "false")) {
+    kv.set("bus_backward",
+           first(lookup(kBusReverse, kv["busway"]), lookup(kBusReverse, kv["busway:left"]),
+                 lookup(kBusReverse, kv["busway:right"]), lookup(kPsv, kv["lanes:psv:backward"]),
+                 "false"));
+  }
+
+  const char* oneway_bus = nullptr;
+  if (kv.is("bus_backward", "true")) {
+    oneway_bus = lookup(kOneway, kv["oneway:bus"]);
+    if (eq(oneway_bus, "false") && kv.is("bus:backward", "yes")) {
+      oneway_bus = "true";
+    }
+  }
+
+  if (kv["oneway:taxi"] == nullptr && kv["oneway:psv"] != nullptr) {
+    kv.set("oneway:taxi", kv["oneway:psv"]);
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:taxi", "no")) || kv.is("taxi:backward", "yes") ||
+      kv.is("taxi:backward", "designated")) {
+    kv.set("taxi_backward", "true");
+  }
+
+  if (kv["taxi_backward"] == nullptr || kv.is("taxi_backward", "false")) {
+    kv.set("taxi_backward", first(lookup(kPsv, kv["lanes:psv:backward"]), "false"));
+  }
+
+  const char* oneway_taxi = nullptr;
+  if (kv.is("taxi_backward", "true")) {
+    oneway_taxi = lookup(kOneway, kv["oneway:taxi"]);
+    if (eq(oneway_taxi, "false") && kv.is("taxi:backward", "yes")) {
+      oneway_taxi = "true";
+    }
+  }
+
+  if (kv["moped_backward"] == nullptr) {
+    kv.set("moped_backward", "false");
+  }
+
+  if ((kv.is("oneway", "yes") && (kv.is("oneway:moped", "no") || kv.is("oneway:mofa", "no"))) ||
+      kv.is("moped:backward", "yes") || kv.is("mofa:backward", "yes")) {
+    kv.set("moped_backward", "true");
+  }
+
+  const char* oneway_moped = nullptr;
+  if (kv.is("moped_backward", "true")) {
+    oneway_moped = first(lookup(kOneway, kv["oneway:moped"]), lookup(kOneway, kv["oneway:mofa"]));
+  }
+
+  if (kv["motorcycle_backward"] == nullptr) {
+    kv.set("motorcycle_backward", "false");
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:motorcycle", "no")) ||
+      kv.is("motorcycle:backward", "yes")) {
+    kv.set("motorcycle_backward", "true");
+  }
+
+  const char* oneway_motorcycle = nullptr;
+  if (kv.is("motorcycle_backward", "true")) {
+    oneway_motorcycle = lookup(kOneway, kv["oneway:motorcycle"]);
+  }
+
+  if (kv["pedestrian_backward"] == nullptr) {
+    kv.set("pedestrian_backward", "false");
+  }
+
+  if ((kv.is("oneway", "yes") && kv.is("oneway:foot", "no")) || kv.is("foot:backward", "yes")) {
+    kv.set("pedestrian_backward", "true");
+  }
+
+  const char* oneway_foot = nullptr;
+  if (kv.is("pedestrian_backward", "true")) {
+    oneway_foot = lookup(kOneway, kv["oneway:foot"]);
+  }
+
+  const bool oneway_reverse = kv.is("oneway", "-1");
+  const char* oneway_norm = lookup(kOneway, kv["oneway"]);
+  if (kv.is("junction", "roundabout") || kv.is("junction", "circular")) {
+    oneway_norm = "true";
+    kv.set("roundabout", "true");
+  } else {
+    kv.set("roundabout", "false");
+  }
+  kv.set("oneway", oneway_norm);
+
+  // the mode only goes in reverse on a oneway if its oneway tag says so or both ways if it's not
+  auto oneway_mode = [&kv](const char* mode, const char* oneway_mode) {
+    const std::string name(mode);
+    if (kv.is(name + "_backward", "true")) {
+      if (eq(oneway_mode, "true")) {
+        kv.set(name + "_forward", "false");
+      } else if (eq(oneway_mode, "false")) {
+        kv.set(name + "_forward", "true");
+      }
+    }
+  };
+  if (eq(oneway_norm, "true")) {
+    kv.set("auto_backward", "false");
+    kv.set("truck_backward", "false");
+    kv.set("emergency_backward", "false");
+
+    oneway_mode("bike", oneway_bike);
+    oneway_mode("bus", oneway_bus);
+    oneway_mode("taxi", oneway_taxi);
+    oneway_mode("moped", oneway_moped);
+    oneway_mode("motorcycle", oneway_motorcycle);
+    // don't apply oneway tag unless oneway:foot or pedestrian only way
+    if (kv.is("highway", "footway") || kv.is("highway", "pedestrian") ||
+        kv.is("highway", "steps") || kv.is("highway", "path") || kv["oneway:foot"]) {
+      oneway_mode("pedestrian", oneway_foot);
+    } else {
+      kv.set("pedestrian_backward", kv["pedestrian_forward"]);
+    }
+  } else {
+    // without oneway tagging the way is bidirectional despite the backward tagging above, other
+    // than for modes with their own oneway tags
+    kv.set("auto_backward", kv["auto_forward"]);
+    kv.set("truck_backward", kv["truck_forward"]);
+    kv.set("emergency_backward", kv["emergency_forward"]);
+
+    // note that the oneway table never holds false so the comparisons of it against false in
+    // the script never hold
+    if (kv.is("bike_backward", "false") &&
+        (kv["oneway:bicycle"] == nullptr || kv.is("oneway:bicycle", "no"))) {
+      kv.set("bike_backward", kv["bike_forward"]);
+    }
+
+    if (kv.is("bus_backward", "false") && kv["oneway:bus"] == nullptr) {
+      kv.set("bus_backward", kv["bus_forward"]);
+    }
+
+    if (kv.is("taxi_backward", "false") && kv["oneway:taxi"] == nullptr) {
+      kv.set("taxi_backward", kv["taxi_forward"]);
+    }
+
+    if (kv.is("moped_backward", "false") &&
+        (kv["oneway:moped"] == nullptr || kv.is("oneway:moped", "no")) &&
+        (kv["oneway:mofa"] == nullptr || kv.is("oneway:mofa", "no"))) {
+      kv.set("moped_backward", kv["moped_forward"]);
+    }
+
+    if (kv.is("motorcycle_backward", "false") &&
+        (kv["oneway:motorcycle"] == nullptr || kv.is("oneway:motorcycle", "no"))) {
+      kv.set("motorcycle_backward", kv["motorcycle_forward"]);
+    }
+
+    if (kv.is("pedestrian_backward", "false") &&
+        (kv["oneway:foot"] == nullptr || kv.is("oneway:foot", "no"))) {
+      kv.set("pedestrian_backward", kv["pedestrian_forward"]);
+    }
+  }
+
+  // bike forward / backward overrides
+  if (cycle_lane(kv, "cycleway:both") ||
+      (cycle_lane(kv, "cycleway:right") && cycle_lane(kv, "cycleway:left"))) {
+    kv.set("bike_forward", "true");
+    kv.set("bike_backward", "true");
+  }
+
+  if (kv.is("busway", "lane") || (kv.is("busway:left", "lane") && kv.is("busway:right", "lane"))) {
+    kv.set("bus_forward", "true");
+    kv.set("bus_backward", "true");
+  }
+
+  // let all the :forward and :backward overrides through
+  for (const std::string direction : {"forward", "backward"}) {
+    auto motor_vehicle = kv.copy("motor_vehicle:" + direction);
+    if (!motor_vehicle) {
+      motor_vehicle = kv.copy("vehicle:" + direction);
+    }
+    if (motor_vehicle) {
+      const char* value = lookup(kMotorVehicle, motor_vehicle->c_str());
+      for (const auto* mode : {"auto_", "truck_", "bus_", "taxi_", "moped_", "motorcycle_"}) {
+        kv.set(mode + direction, value);
+      }
+    }
+    if (kv["foot:" + direction] != nullptr) {
+      kv.set("pedestrian_" + direction, lookup(kFoot, kv["foot:" + direction]));
+    }
+    auto bicycle = kv.copy("bicycle:" + direction);
+    if (!bicycle) {
+      bicycle = kv.copy("vehicle:" + direction);
+    }
+    if (bicycle) {
+      kv.set("bike_" + direction, lookup(kBicycle, bicycle->c_str()));
+    }
+  }
+
+  kv.set("oneway_reverse", "false");
+
+  // flip the onewayness
+  if (oneway_reverse) {
+    kv.set("oneway_reverse", "true");
+    for (const std::string mode : {"auto", "truck", "emergency", "bus", "taxi", "bike", "moped",
+                                   "motorcycle", "pedestrian"}) {
+      kv.swap(mode + "_forward", mode + "_backward");
+    }
+  }
+
+  if (kv.is("oneway:bicycle", "-1")) {
+    kv.swap("bike_forward", "bike_backward");
+  }
+
+  if (kv.is("oneway:moped", "-1") || kv.is("oneway:mofa", "-1")) {
+    kv.swap("moped_forward", "moped_backward");
+  }
+
+  if (kv.is("oneway:motorcycle", "-1")) {
+    kv.swap("motorcycle_forward", "motorcycle_backward");
+  }
+
+  if (kv.is("oneway:foot", "-1")) {
+    kv.swap("pedestrian_forward", "pedestrian_backward");
+  }
+
+  if (kv.is("oneway:bus", "-1")) {
+    kv.swap("bus_forward", "bus_backward");
+  }
+
+  // bus only logic
+  if (kv.is("lanes:bus", "1")) {
+    kv.set("bus_forward", "true");
+    kv.set("bus_backward", "false");
+  } else if (kv.is("lanes:bus", "2")) {
+    kv.set("bus_forward", "true");
+    kv.set("bus_backward", "true");
+  }
+
+  if (kv.is("oneway:taxi", "-1")) {
+    kv.swap("taxi_forward", "taxi_backward");
+  }
+
+  if (kv.is("lanes:psv", "1")) {
+    kv.set("taxi_forward", "true");
+    kv.set("taxi_backward", "false");
+  } else if (kv.is("lanes:psv", "2")) {
+    kv.set("taxi_forward", "true");
+    kv.set("taxi_backward", "true");
+  }
+
+  // if none of the modes were set we are done looking at this
+  bool no_modes = true;
+  for (const std::string mode :
+       {"auto", "truck", "bus", "bike", "emergency", "moped", "motorcycle", "pedestrian"}) {
+    no_modes = no_modes && kv.is(mode + "_forward", "false") && kv.is(mode + "_backward", "false");
+  }
+  if (no_modes && !kv.is("highway", "bridleway")) {
+    // save bridleways for country access logic.
+    return true;
+  }
+
+  for (const auto* key : {"FIXME", "note", "source"}) {
+    kv.set(key, nullptr);
+  }
+
+  // set a few flags
+  auto rc = lookup(kRoadClass, kv["highway"]);
+  if (kv.is("highway", "construction")) {
+    rc = lookup(kRoadClass, kv["construction"]);
+  }
+
+  if (kv["highway"] == nullptr && ferry) {
+    rc = 2; // TODO:  can we weight based on ferry types?
+  } else if (kv["highway"] == nullptr && (kv["railway"] || kv.is("route", "shuttle_train"))) {
+    rc = 2; // TODO:  can we weight based on rail types?
+  } else if (!rc) {
+    // service and other = 7
+    rc = 7;
+  }
+
+  kv.set_number("road_class", *rc);
+
+  // lower the default speed for driveways
+  int default_speed = kDefaultSpeed[*rc];
+  if (kv.is("service", "driveway")) {
+    default_speed = std::floor(default_speed * 0.5);
+  }
+  kv.set_number("default_speed", default_speed);
+
+  kv.set("lit", lookup(kLit, kv["lit"]));
+
+  auto use = lookup(kUse, kv["service"]);
+
+  auto only_pedestrians = [&kv]() {
+    if (!kv.is("pedestrian_forward", "true")) {
+      return false;
+    }
+    for (const std::string mode : {"auto", "truck", "bus", "bike", "moped", "motorcycle"}) {
+      if (!kv.is(mode + "_forward", "false") || !kv.is(mode + "_backward", "false")) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (kv["highway"]) {
+    if (kv.is("highway", "construction")) {
+      use = 43;
+    } else if (kv.is("highway", "track")) {
+      use = 3;
+    } else if (kv.is("highway", "living_street")) {
+      use = 10;
+    } else if (!use && kv.is("highway", "service")) {
+      use = 11;
+    } else if (kv.is("highway", "cycleway")) {
+      use = 20;
+    } else if (kv.is("pedestrian_forward", "false") && kv.is("auto_forward", "false") &&
+               kv.is("auto_backward", "false") &&
+               (kv.is("bike_forward", "true") || kv.is("bike_backward", "true"))) {
+      use = 20;
+    } else if (kv.is("highway", "footway") && kv.is("footway", "sidewalk")) {
+      use = 24;
+    } else if (kv.is("highway", "footway") && kv.is("footway", "crossing")) {
+      use = 32;
+    } else if (kv.is("highway", "footway")) {
+      use = 25;
+    } else if (kv.is("highway", "elevator")) {
+      use = 33; // elevator
+    } else if (kv.is("highway", "steps") && kv["conveying"] != nullptr) {
+      use = 34; // escalator
+    } else if (kv.is("highway", "steps")) {
+      use = 26; // steps/stairs
+    } else if (kv.is("highway", "path")) {
+      use = 27;
+    } else if (kv.is("highway", "pedestrian")) {
+      use = 28;
+    } else if (kv.is("highway", "platform")) {
+      use = 35;
+    } else if (only_pedestrians()) {
+      use = 28;
+    } else if (kv.is("highway", "bridleway")) {
+      use = 29;
+    }
+  }
+
+  if (!use && kv["service"]) {
+    use = 40; // other
+  } else if (!use) {
+    use = 0; // general road, no special use
+  }
+
+  // do not override 'construction' use
+  if (*use != 43 && (kv.is("access", "emergency") || kv.is("emergency", "yes"))) {
+    bool no_vehicles = true;
+    for (const std::string mode : {"auto", "truck", "bus", "bike", "moped", "motorcycle"}) {
+      no_vehicles =
+          no_vehicles && kv.is(mode + "_forward", "false") && kv.is(mode + "_backward", "false");
+    }
+    if (no_vehicles) {
+      use = 7;
+    }
+  }
+
+  kv.set_number("use", *use);
+
+  const char* r_shoulder =
+      first(lookup(kShoulder, kv["shoulder"]), lookup(kShoulder, kv["shoulder:both"]));
+  const char* l_shoulder = r_shoulder;
+
+  if (r_shoulder == nullptr) {
+    r_shoulder = first(lookup(kShoulder, kv["shoulder:right"]),
+                       lookup(kShoulderRight, kv["shoulder"]), "false");
+    l_shoulder = first(lookup(kShoulder, kv["shoulder:left"]), lookup(kShoulderLeft, kv["shoulder"]),
+                       "false");
+
+    // If the road is oneway and one shoulder is tagged but not the other, we set both to true so
+    // that when setting the shoulder in graphbuilder, driving on the right side vs the left side
+    // doesn't cause the edge to miss the shoulder tag
+    if (eq(oneway_norm, "true") && eq(r_shoulder, "true") && eq(l_shoulder, "false")) {
+      l_shoulder = "true";
+    } else if (eq(oneway_norm, "true") && eq(r_shoulder, "false") && eq(l_shoulder, "true")) {
+      r_shoulder = "true";
+    }
+  }
+
+  kv.set("shoulder_right", r_shoulder);
+  kv.set("shoulder_left", l_shoulder);
+
+  const char* cycle_lane_right_opposite = "false";
+  const char* cycle_lane_left_opposite = "false";
+
+  int cycle_lane_right = 0;
+  int cycle_lane_left = 0;
+
+  // We have special use cases for cycle lanes when on a cycleway, footway, or path
+  if ((*use == 20 || *use == 25 || *use == 27) &&
+      (kv.is("bike_forward", "true") || kv.is("bike_backward", "true"))) {
+    if (kv.is("pedestrian_forward", "false")) {
+      cycle_lane_right = 3; // separated
+    } else if (kv.is("segregated", "yes")) {
+      cycle_lane_right = 2; // dedicated
+    } else if (kv.is("segregated", "no")) {
+      cycle_lane_right = 1; // shared
+    } else if (*use == 20) {
+      // If no segregated tag but it is tagged as a cycleway then we assume separated lanes
+      cycle_lane_right = 2;
+    } else {
+      // If no segregated tag and it's tagged as a footway or path then we assume shared lanes
+      cycle_lane_right = 1;
+    }
+    cycle_lane_left = cycle_lane_right;
+  } else {
+    // Set flags if any of the lanes are marked "opposite" (contraflow)
+    cycle_lane_right_opposite = first(lookup(kBikeReverse, kv["cycleway"]), "false");
+    cycle_lane_left_opposite = cycle_lane_right_opposite;
+
+    if (eq(cycle_lane_right_opposite, "false")) {
+      cycle_lane_right_opposite = first(lookup(kBikeReverse, kv["cycleway:right"]), "false");
+      cycle_lane_left_opposite = first(lookup(kBikeReverse, kv["cycleway:left"]), "false");
+    }
+
+    // Figure out which side of the road has what cyclelane
+    cycle_lane_right = first(cycle_lane(kv, "cycleway"), lookup(kBuffer, kv["cycleway:both:buffer"]))
+                           .value_or(0);
+    cycle_lane_left = cycle_lane_right;
+
+    if (cycle_lane_right == 0) {
+      cycle_lane_right =
+          first(cycle_lane(kv, "cycleway:right"), lookup(kBuffer, kv["cycleway:right:buffer"]))
+              .value_or(0);
+      cycle_lane_left =
+          first(cycle_lane(kv, "cycleway:left"), lookup(kBuffer, kv["cycleway:left:buffer"]))
+              .value_or(0);
+    }
+
+    // If we have the oneway:bicycle=no tag and there are not "opposite_lane/opposite_track" tags
+    // then there are certain situations where the cyclelane is considered a two-way. (Based off
+    // of some examples on wiki.openstreetmap.org/wiki/Bicycle)
+    if (kv.is("oneway:bicycle", "no") && eq(cycle_lane_right_opposite, "false") &&
+        eq(cycle_lane_left_opposite, "false")) {
+      if (cycle_lane_right == 2 || cycle_lane_right == 3) {
+        if (eq(oneway_norm, "true")) {
+          // Example M1 or M2d but on the right side
+          cycle_lane_left = cycle_lane_right;
+          cycle_lane_left_opposite = "true";
+        } else if (cycle_lane_left == 0) {
+          // Example L1b
+          cycle_lane_left = cycle_lane_right;
+        }
+      } else if (cycle_lane_left == 2 || cycle_lane_left == 3) {
+        if (eq(oneway_norm, "true")) {
+          // Example M2d
+          cycle_lane_right = cycle_lane_left;
+          cycle_lane_right_opposite = "true";
+        } else if (cycle_lane_right == 0) {
+          // Example L1b but on the left side
+          cycle_lane_right = cycle_lane_left;
+        }
+      }
+    }
+  }
+
+  kv.set_number("cycle_lane_right", cycle_lane_right);
+  kv.set_number("cycle_lane_left", cycle_lane_left);
+
+  kv.set("cycle_lane_right_opposite", cycle_lane_right_opposite);
+  kv.set("cycle_lane_left_opposite", cycle_lane_left_opposite);
+
+  const char* highway_type_name =
+      kv.is("highway", "construction") ? kv["construction"] : kv["highway"];
+  if (highway_type_name && std::strstr(highway_type_name, "_link") != nullptr) {
+    kv.set("link", "true"); // do we need to add more?  turnlane?
+  }
+
+  // TODO(nils): "private" also has directionality which we don't parse and handle yet
+  kv.set("private", first(lookup(kPrivate, kv["access"]), lookup(kPrivate, kv["motor_vehicle"]),
+                          lookup(kPrivate, kv["motorcar"]), "false"));
+  kv.set("private_hgv", first(lookup(kPrivate, kv["hgv"]), kv["private"], "false"));
+  kv.set("no_thru_traffic", first(lookup(kNoThruTraffic, kv["access"]), "false"));
+  kv.set("ferry", ferry ? "true" : "false");
+  kv.set("rail", kv.is("auto_forward", "true") &&
+                         (kv.is("railway", "rail") || kv.is("route", "shuttle_train"))
+                     ? "true"
+                     : "false");
+
+  if (kv.is("maxspeed", "none")) {
+    // special case unlimited speed limit (german autobahn)
+    kv.set("max_speed", "unlimited");
+  } else {
+    kv.set_number("max_speed", normalize_speed(kv["maxspeed"]));
+  }
+
+  kv.set_number("advisory_speed", normalize_speed(kv["maxspeed:advisory"]));
+  kv.set_number("average_speed", normalize_speed(kv["maxspeed:practical"]));
+  kv.set_number("backward_speed", normalize_speed(kv["maxspeed:backward"]));
+  kv.set_number("forward_speed", normalize_speed(kv["maxspeed:forward"]));
+  kv.set("wheelchair", lookup(kWheelchair, kv["wheelchair"]));
+
+  // lower the default speed for tracks
+  if (kv.is("highway", "track")) {
+    int track_speed = 5;
+    if (kv.is("tracktype", "grade1")) {
+      track_speed = 20;
+    } else if (kv.is("tracktype", "grade2")) {
+      track_speed = 15;
+    } else if (kv.is("tracktype", "grade3")) {
+      track_speed = 12;
+    } else if (kv.is("tracktype", "grade4")) {
+      track_speed = 10;
+    }
+    kv.set_number("default_speed", track_speed);
+  }
+
+  // use unsigned_ref if all the conditions are met.
+  if (kv["name"] == nullptr && kv["name:en"] == nullptr && kv["alt_name"] == nullptr &&
+      kv["official_name"] == nullptr && kv["ref"] == nullptr && kv["int_ref"] == nullptr &&
+      (kv.is("highway", "motorway") || kv.is("highway", "trunk") || kv.is("highway", "primary")) &&
+      kv["unsigned_ref"] != nullptr) {
+    kv.set("ref", kv["unsigned_ref"]);
+  }
+
+  kv.set_number("lanes", lane_count(kv["lanes"]));
+  kv.set_number("forward_lanes", lane_count(kv["lanes:forward"]));
+  kv.set_number("backward_lanes", lane_count(kv["lanes:backward"]));
+
+  kv.set("bridge", first(lookup(kBridge, kv["bridge"]), "false"));
+
+  kv.set("hov_tag", "true");
+  if (kv.is("hov", "no")) {
+    kv.set("hov_forward", "false");
+    kv.set("hov_backward", "false");
+  } else {
+    kv.set("hov_forward", kv["auto_forward"]);
+    kv.set("hov_backward", kv["auto_backward"]);
+  }
+
+  // hov restrictions
+  if ((kv["hov"] && !kv.is("hov", "no")) || kv["hov:lanes"] || kv["hov:minimum"]) {
+    bool only_hov_allowed = kv.is("hov", "designated");
+
+    // If "hov:lanes" is specified ensure all lanes are tagged "designated"
+    if (only_hov_allowed && kv["hov:lanes"]) {
+      std::string_view lanes(kv["hov:lanes"]);
+      for (size_t start = 0;;) {
+        auto end = lanes.find('|', start);
+        if (lanes.substr(start, end - start) != "designated") {
+          only_hov_allowed = false;
+        }
+        if (end == std::string_view::npos) {
+          break;
+        }
+        start = end + 1;
+      }
+    }
+
+    // Be strict with the "hov:minimum" tag and only accept the values 2 or 3, because routing
+    // onto an HOV lane without the correct number of occupants is illegal.
+    if (only_hov_allowed) {
+      if (kv.is("hov:minimum", "2")) {
+        kv.set("hov_type", "HOV2");
+      } else if (kv.is("hov:minimum", "3")) {
+        kv.set("hov_type", "HOV3");
+      } else {
+        only_hov_allowed = false;
+      }
+    }
+
+    // HOV lanes are sometimes time-conditional and can change direction. We avoid these. Also,
+    // we expect "hov_type" to be set.
+    if (only_hov_allowed) {
+      const bool avoid_these_hovs = kv.is("oneway", "alternating") ||
+                                    kv.is("oneway", "reversible") || kv.is("oneway", "false") ||
+                                    kv["oneway:conditional"] || kv["access:conditional"];
+      only_hov_allowed = !avoid_these_hovs;
+    }
+
+    if (only_hov_allowed) {
+      // If we get here we know the way is a true hov-only-lane (not mixed). As a result, none of
+      // the following costings can use it.
+      for (const auto& mode : std::array<std::array<std::string, 2>, 4>{{{"auto_tag", "auto"},
+                                                                        {"truck_tag", "truck"},
+                                                                        {"foot_tag", "pedestrian"},
+                                                                        {"bike_tag", "bike"}}}) {
+        if (kv[mode[0]] == nullptr) {
+          kv.set(mode[1] + "_forward", "false");
+          kv.set(mode[1] + "_backward", "false");
+        }
+      }
+    } else {
+      // This is not an hov-only lane.
+      kv.set("hov_forward", "false");
+      kv.set("hov_backward", "false");
+    }
+  }
+
+  kv.set("tunnel", first(lookup(kTunnel, kv["tunnel"]), "false"));
+  kv.set("toll", first(lookup(kToll, kv["toll"]), "false"));
+
+  // truck goodies
+  kv.set_number("maxheight", first(normalize_measurement(kv["maxheight"]),
+                                   normalize_measurement(kv["maxheight:physical"])));
+  kv.set_number("maxwidth", first(normalize_measurement(kv["maxwidth"]),
+                                  normalize_measurement(kv["maxwidth:physical"])));
+  kv.set_number("maxlength", normalize_measurement(kv["maxlength"]));
+  kv.set_number("maxweight", normalize_weight(kv["maxweight"]));
+  kv.set_number("maxaxleload", normalize_weight(kv["maxaxleload"]));
+  kv.set_number("maxaxles", to_number(kv["maxaxles"]));
+
+  // forward/backward only tags
+  kv.set_number("maxheight_forward", normalize_measurement(kv["maxheight:forward"]));
+  kv.set_number("maxheight_backward", normalize_measurement(kv["maxheight:backward"]));
+  kv.set_number("maxlength_forward", normalize_measurement(kv["maxlength:forward"]));
+  kv.set_number("maxlength_backward", normalize_measurement(kv["maxlength:backward"]));
+  kv.set_number("maxweight_forward", normalize_weight(kv["maxweight:forward"]));
+  kv.set_number("maxweight_backward", normalize_weight(kv["maxweight:backward"]));
+  kv.set_number("maxwidth_forward", normalize_measurement(kv["maxwidth:forward"]));
+  kv.set_number("maxwidth_backward", normalize_measurement(kv["maxwidth:backward"]));
+
+  // TODO: hazmat really should have subcategories
+  for (const std::string direction : {"", ":forward", ":backward"}) {
+    const char* hazmat = nullptr;
+    for (const std::string type : {"", ":water", ":A", ":B", ":C", ":D", ":E"}) {
+      hazmat = first(hazmat, lookup(kHazmat, kv["hazmat" + type + direction]));
+    }
+    kv.set(direction.empty() ? "hazmat" : "hazmat_" + direction.substr(1), hazmat);
+  }
+
+  kv.set_number("maxspeed:hgv", normalize_speed(kv["maxspeed:hgv"]));
+  kv.set_number("maxspeed:hgv:forward", normalize_speed(kv["maxspeed:hgv:forward"]));
+  kv.set_number("maxspeed:hgv:backward", normalize_speed(kv["maxspeed:hgv:backward"]));
+
+  if (kv["hgv:national_network"] || kv["hgv:state_network"] || kv.is("hgv", "local") ||
+      kv.is("hgv", "designated")) {
+    kv.set("truck_route", "true");
+  }
+
+  const auto nref = kv.copy("ncn_ref");
+  const auto rref = kv.copy("rcn_ref");
+  const auto lref = kv.copy("lcn_ref");
+  int bike_mask = 0;
+  if (nref || kv.is("ncn", "yes")) {
+    bike_mask = 1;
+  }
+  if (rref || kv.is("rcn", "yes")) {
+    bike_mask |= 2;
+  }
+  if (lref || kv.is("lcn", "yes")) {
+    bike_mask |= 4;
+  }
+  if (kv.is("mtb", "yes")) {
+    bike_mask |= 8;
+  }
+
+  kv.set("bike_national_ref", nref);
+  kv.set("bike_regional_ref", rref);
+  kv.set("bike_local_ref", lref);
+  kv.set_number("bike_network_mask", bike_mask);
+
+  // Explicitly turn off access for construction type. It's done for backward compatibility
+  // of valhalla tiles and valhalla routing. In case we allow non-zero access then older
+  // versions of router will work with new tiles incorrectly. They would start to route
+  // on roads under construction because they're not aware about new 'Use::kConstruction'
+  // and use only access mode to check if an edge is routable or not.
+  if (kv.is("highway", "construction")) {
+    set_access(kv, true);
+    for (const auto* mode :
+         {"hov_forward", "hov_backward", "emergency_forward", "emergency_backward"}) {
+      kv.set(mode, "false");
+    }
+  }
+
+  return false;
+}
+
+void nodes_proc(Tags& tags) {
+  Kv kv(tags);
+
+  if (const auto iso = kv.copy("iso:3166_2")) {
+    const auto dash = iso->find('-');
+    if (dash == 2) {
+      if (iso->size() == 6 || iso->size() == 5) {
+        kv.set("state_iso_code", iso->substr(3));
+      }
+    } else if (dash == std::string::npos) {
+      if (iso->size() == 2 || iso->size() == 3) {
+        kv.set("state_iso_code", iso);
+      } else if (iso->size() == 4 || iso->size() == 5) {
+        kv.set("state_iso_code", iso->substr(2));
+      }
+    }
+  }
+
+  // normalize a few tags that we care about
+  const char* initial_access = lookup(kAccess, kv["access"]);
+  const char* access = first(initial_access, "true");
+
+  if (kv.is("impassable", "yes") ||
+      (kv.is("access", "private") &&
+       (kv.is("emergency", "yes") || kv.is("service", "emergency_access")))) {
+    access = "false";
+  }
+
+  std::optional<int> hov_tag;
+  if ((kv["hov"] && !kv.is("hov", "no")) || kv["hov:lanes"] || kv["hov:minimum"]) {
+    hov_tag = 128;
+  }
+
+  auto foot_tag = lookup(kFootNode, kv["foot"]);
+  auto wheelchair_tag = lookup(kWheelchairNode, kv["wheelchair"]);
+  auto bike_tag = lookup(kBicycleNode, kv["bicycle"]);
+  auto truck_tag = lookup(kTruckNode, kv["hgv"]);
+  auto auto_tag = lookup(kMotorVehicleNode, kv["motorcar"]);
+  auto motor_vehicle_tag = lookup(kMotorVehicleNode, kv["motor_vehicle"]);
+  auto moped_tag = first(lookup(kMopedNode, kv["moped"]), lookup(kMopedNode, kv["mofa"]));
+  auto motorcycle_tag = lookup(kMotorCycleNode, kv["motorcycle"]);
+
+  if (!auto_tag) {
+    auto_tag = motor_vehicle_tag;
+  }
+  std::optional<int> bus_tag;
+  std::optional<int> taxi_tag;
+
+  if (kv.is("access", "psv")) {
+    bus_tag = 64;
+    taxi_tag = 32;
+  } else {
+    bus_tag = lookup(kBusNode, kv["bus"]);
+    taxi_tag = lookup(kTaxiNode, kv["taxi"]);
+  }
+
+  if (!bus_tag) {
+    bus_tag = lookup(kPsvBusNode, kv["psv"]);
+  }
+  // if bus was not set and car is
+  if (!bus_tag && auto_tag == 1) {
+    bus_tag = 64;
+  }
+
+  // if wheelchair was not set and foot is
+  if (!wheelchair_tag && foot_tag == 2) {
+    wheelchair_tag = 256;
+  }
+
+  // if hov was not set and car is
+  if (!hov_tag && auto_tag == 1) {
+    hov_tag = 128;
+  }
+
+  if (!taxi_tag) {
+    taxi_tag = lookup(kPsvTaxiNode, kv["psv"]);
+  }
+  // if taxi was not set and car is
+  if (!taxi_tag && auto_tag == 1) {
+    taxi_tag = 32;
+  }
+
+  // if truck was not set and car is
+  if (!truck_tag && auto_tag == 1) {
+    truck_tag = 8;
+  }
+
+  // must shut these off if motor_vehicle = 0
+  if (motor_vehicle_tag == 0) {
+    hov_tag = hov_tag.value_or(0);
+    bus_tag = bus_tag.value_or(0);
+    taxi_tag = taxi_tag.value_or(0);
+    truck_tag = truck_tag.value_or(0);
+    moped_tag = moped_tag.value_or(0);
+    motorcycle_tag = motorcycle_tag.value_or(0);
+  }
+
+  std::optional<int> emergency_tag;
+  if (kv.is("access", "emergency") || kv.is("emergency", "yes") ||
+      kv.is("service", "emergency_access")) {
+    emergency_tag = 16;
+  }
+
+  // do not shut off bike access if there is a highway crossing.
+  if (bike_tag == 0 && kv.is("highway", "crossing")) {
+    bike_tag = 4;
+  }
+
+  // if tag exists use it, otherwise access allowed for all modes unless access = false or
+  // kv["hov"] == "designated" or kv["vehicle"] == "no")
+  // if access=private use allowed modes, but consider private_access tag as true.
+  int auto_mask = auto_tag.value_or(1);
+  int truck = truck_tag.value_or(8);
+  int bus = bus_tag.value_or(64);
+  int taxi = first(taxi_tag, auto_tag).value_or(32);
+  int foot = foot_tag.value_or(2);
+  int wheelchair = wheelchair_tag.value_or(256);
+  int bike = bike_tag.value_or(4);
+  int emergency = emergency_tag.value_or(16);
+  int hov = first(hov_tag, auto_tag).value_or(128);
+  int moped = moped_tag.value_or(512);
+  int motorcycle = motorcycle_tag.value_or(1024);
+
+  // if access = false use tag if exists, otherwise no access for that mode.
+  if (eq(access, "false") || kv.is("vehicle", "no") || kv.is("smoothness", "impassable") ||
+      kv.is("hov", "designated")) {
+    auto_mask = auto_tag.value_or(0);
+    truck = truck_tag.value_or(0);
+    bus = bus_tag.value_or(0);
+    taxi = taxi_tag.value_or(0);
+
+    // don't change ped if kv["vehicle"] == "no"
+    if (eq(access, "false") || kv.is("hov", "designated")) {
+      foot = foot_tag.value_or(0);
+    }
+
+    wheelchair = wheelchair_tag.value_or(0);
+    bike = bike_tag.value_or(0);
+    moped = moped_tag.value_or(0);
+    motorcycle = motorcycle_tag.value_or(0);
+    emergency = emergency_tag.value_or(0);
+    hov = hov_tag.value_or(0);
+  }
+
+  // check for gates, bollards, walls and sump_busters
+  auto barrier = [&kv](std::initializer_list<const char*> barriers) {
+    for (const auto* barrier : barriers) {
+      if (kv.is("barrier", barrier)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  bool gate = barrier({"gate", "yes", "lift_gate", "swing_gate", "sliding_beam"});
+  bool bollard = false;
+  bool sump_buster = false;
+  bool wall = false;
+
+  if (!gate) {
+    // if there was a bollard cars can't get through it
+    bollard = barrier({"bollard", "block", "kissing_gate", "motorcycle_barrier", "cycle_barrier",
+                       "chain", "bar"}) ||
+              kv.is("bollard", "removable");
+
+    // if sump_buster then no access for auto, hov, and taxi unless a tag exists.
+    sump_buster = barrier({"sump_buster"});
+
+    // if there is a kind of wall, there is no access for all profiles unless a tag exists
+    wall = barrier({"fence", "barrier_board", "wall", "jersey_barrier", "debris"});
+
+    // save the following as gates.
+    if (bollard && kv.is("bollard", "rising")) {
+      gate = true;
+      bollard = false;
+    }
+
+    if (bollard && initial_access == nullptr) {
+      // bollard = true shuts off access when access is not originally specified.
+      auto_mask = auto_tag.value_or(0);
+      truck = truck_tag.value_or(0);
+      bus = bus_tag.value_or(0);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(2);
+      wheelchair = wheelchair_tag.value_or(256);
+      bike = bike_tag.value_or(4);
+      moped = moped_tag.value_or(0);
+      motorcycle = motorcycle_tag.value_or(0);
+      emergency = emergency_tag.value_or(0);
+      hov = hov_tag.value_or(0);
+    } else if (sump_buster) {
+      // sump_buster = true shuts off access unless the tag exists.
+      auto_mask = auto_tag.value_or(0);
+      truck = truck_tag.value_or(8);
+      bus = bus_tag.value_or(64);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(2);
+      wheelchair = wheelchair_tag.value_or(256);
+      bike = bike_tag.value_or(4);
+      moped = moped_tag.value_or(512);
+      motorcycle = motorcycle_tag.value_or(1024);
+      emergency = emergency_tag.value_or(16);
+      hov = hov_tag.value_or(0);
+    } else if (wall) {
+      // wall = true shuts off access unless a tag exists.
+      auto_mask = auto_tag.value_or(0);
+      truck = truck_tag.value_or(0);
+      bus = bus_tag.value_or(0);
+      taxi = taxi_tag.value_or(0);
+      foot = foot_tag.value_or(0);
+      wheelchair = wheelchair_tag.value_or(0);
+      bike = bike_tag.value_or(0);
+      moped = moped_tag.value_or(0);
+      motorcycle = motorcycle_tag.value_or(0);
+      emergency = emergency_tag.value_or(0);
+      hov = hov_tag.value_or(0);
+    }
+  }
+
+  // if nothing blocks access at this node assume access is allowed.
+  if (!gate && !bollard && !sump_buster && !wall && eq(access, "true") &&
+      (kv.is("highway", "crossing") || kv.is("railway", "crossing") ||
+       kv.is("footway", "crossing") || kv.is("cycleway", "crossing") ||
+       kv.is("foot", "crossing") || kv.is("bicycle", "crossing") ||
+       kv.is("pedestrian", "crossing") || kv["crossing"])) {
+    auto_mask = auto_tag.value_or(1);
+    truck = truck_tag.value_or(8);
+    bus = bus_tag.value_or(64);
+    taxi = taxi_tag.value_or(32);
+    foot = foot_tag.value_or(2);
+    wheelchair = wheelchair_tag.value_or(256);
+    bike = bike_tag.value_or(4);
+    moped = moped_tag.value_or(512);
+    motorcycle = motorcycle_tag.value_or(1024);
+    emergency = emergency_tag.value_or(16);
+    hov = hov_tag.value_or(128);
+  }
+
+  // store the gate and bollard info
+  kv.set("gate", gate ? "true" : "false");
+  kv.set("bollard", bollard ? "true" : "false");
+  kv.set("sump_buster", sump_buster ? "true" : "false");
+
+  if (kv.is("barrier", "border_control")) {
+    kv.set("border_control", "true");
+  } else if (kv.is("barrier", "toll_booth")) {
+    kv.set("toll_booth", "true");
+    if (is_cash_only_payment(tags)) {
+      kv.set("cash_only_toll", "true");
+    }
+  } else if (kv.is("highway", "toll_gantry")) {
+    kv.set("toll_gantry", "true");
+  } else if (kv.is("entrance", "yes") && kv.is("indoor", "yes")) {
+    kv.set("building_entrance", "true");
+  } else if (kv.is("highway", "elevator")) {
+    kv.set("elevator", "true");
+  }
+
+  if (kv.is("amenity", "bicycle_rental") ||
+      (kv.is("shop", "bicycle") && kv.is("service:bicycle:rental", "yes"))) {
+    kv.set("bicycle_rental", "true");
+  }
+
+  for (const std::string direction : {"forward", "backward"}) {
+    if (kv.is("traffic_signals:direction", direction.c_str())) {
+      kv.set(direction + "_signal", "true");
+
+      if (kv["public_transport"] == nullptr && kv["name"]) {
+        kv.set("junction", "named");
+      }
+    }
+  }
+
+  for (const std::string sign : {"stop", "give_way"}) {
+    if (!kv.is("highway", sign.c_str())) {
+      continue;
+    }
+    const std::string suffix = sign == "stop" ? "_stop" : "_yield";
+    if (kv.is("direction", "both")) {
+      kv.set("forward" + suffix, "true");
+      kv.set("backward" + suffix, "true");
+    } else if (kv.is("direction", "forward")) {
+      kv.set("forward" + suffix, "true");
+    } else if (kv.is("direction", "backward") || kv.is("direction", "reverse")) {
+      kv.set("backward" + suffix, "true");
+    } else if (kv["direction"] != nullptr && kv[sign] == nullptr) {
+      kv.set("highway", nullptr);
+    }
+  }
+
+  if (kv["public_transport"] == nullptr && kv["name"]) {
+    if (kv.is("highway", "traffic_signals")) {
+      if (!kv.is("junction", "yes")) {
+        kv.set("junction", "named");
+      }
+    } else if (kv.is("junction", "yes") || kv.is("reference_point", "yes")) {
+      kv.set("junction", "named");
+    }
+  }
+
+  kv.set("private", first(lookup(kPrivate, kv["access"]), lookup(kPrivate, kv["motor_vehicle"]),
+                          "false"));
+
+  // store a mask denoting access
+  kv.set_number("access_mask", auto_mask | emergency | truck | bike | foot | wheelchair | bus |
+                                   hov | moped | motorcycle | taxi);
+
+  // if no information about access is given.
+  const bool tagged_access = initial_access || auto_tag || truck_tag || bus_tag || taxi_tag ||
+                             foot_tag || wheelchair_tag || bike_tag || moped_tag ||
+                             motorcycle_tag || emergency_tag || hov_tag;
+  kv.set_number("tagged_access", tagged_access ? 1 : 0);
+}
+
+// Returns true if the relation should be filtered
+bool rels_proc(Tags& tags) {
+  Kv kv(tags);
+  if (kv.is("type", "connectivity")) {
+    return false;
+  }
+
+  if (!kv.is("type", "route") && !kv.is("type", "restriction")) {
+    return true;
+  }
+
+  if (kv["restriction:probable"] && (kv["restriction"] || kv["restriction:conditional"])) {
+    kv.set("restriction:probable", nullptr);
+  }
+
+  auto prefix = [&kv](const char* key) {
+    auto type = restriction_prefix(kv[key]);
+    return lookup(kRestriction, type ? type->c_str() : nullptr);
+  };
+  auto restrict = first(first(lookup(kRestriction, kv["restriction"]),
+                              prefix("restriction:conditional")),
+                        prefix("restriction:probable"));
+
+  const std::array<const char*, 9> modes = {"restriction:hgv",       "restriction:emergency",
+                                            "restriction:taxi",      "restriction:motorcar",
+                                            "restriction:bus",       "restriction:bicycle",
+                                            "restriction:hazmat",    "restriction:motorcycle",
+                                            "restriction:foot"};
+  std::optional<int> restrict_type;
+  for (const auto* mode : modes) {
+    restrict_type = first(restrict_type, lookup(kRestriction, kv[mode]));
+  }
+
+  // restrictions with type win over just restriction key.  people enter both.
+  if (restrict_type) {
+    restrict = restrict_type;
+  }
+
+  if (kv.is("type", "restriction") || kv["restriction:conditional"] ||
+      kv["restriction:probable"]) {
+    if (!restrict) {
+      return true;
+    }
+
+    kv.set("restriction:conditional", restriction_suffix(kv["restriction:conditional"]));
+    kv.set("restriction:probable", restriction_suffix(kv["restriction:probable"]));
+    for (const auto* mode : modes) {
+      auto value = lookup(kRestriction, kv[mode]);
+      kv.set_number(mode, value ? std::optional<double>(*value) : std::nullopt);
+    }
+
+    if (!restrict_type) {
+      kv.set_number("restriction", *restrict);
+    } else {
+      kv.set("restriction", nullptr);
+    }
+    return false;
+  }
+
+  if (kv.is("route", "bicycle") || kv.is("route", "mtb")) {
+    int bike_mask = 0;
+    if (kv.is("network", "mtb") || kv.is("route", "mtb")) {
+      bike_mask = 8;
+    }
+
+    if (kv.is("network", "ncn")) {
+      bike_mask |= 1;
+    } else if (kv.is("network", "rcn")) {
+      bike_mask |= 2;
+    } else if (kv.is("network", "lcn")) {
+      bike_mask |= 4;
+    }
+
+    kv.set_number("bike_network_mask", bike_mask);
+  } else if (restrict) {
+    // has a restriction but type is not restriction...ignore
+    return true;
+  }
+
+  kv.set("day_on", nullptr);
+  kv.set("day_off", nullptr);
+  kv.set("restriction", nullptr);
+  return false;
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+Tags TransformGraphTags(OSMType type, const osmium::TagList& tags) {
+  Tags result;
+  for (const auto& tag : tags) {
+    result[tag.key()] = tag.value();
+  }
+
+  bool filter = false;
+  if (type == OSMType::kNode) {
+    nodes_proc(result);
+  } else if (type == OSMType::kWay) {
+    // ways without any tags are of no interest
+    Kv kv(result);
+    filter = result.empty() || filter_tags_generic(kv);
+  } else {
+    filter = rels_proc(result);
+  }
+
+  if (filter) {
+    result.clear();
+  }
+  return result;
+}
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -244,8 +244,13 @@ GraphTileBuilder::GraphTileBuilder(const std::string& tile_dir,
 
 // Output the tile to file. Stores as binary data.
 void GraphTileBuilder::StoreTileData() {
+  StoreTileData(tile_dir_);
+}
+
+// Output the tile to a file in the given tile directory.
+void GraphTileBuilder::StoreTileData(const std::string& tile_dir) {
   // Get the name of the file
-  filesystem::path filename(tile_dir_ + filesystem::path::preferred_separator +
+  filesystem::path filename(tile_dir + filesystem::path::preferred_separator +
                             GraphTile::FileSuffix(header_builder_.graphid()));
 
   // Make sure the directory exists on the system
@@ -426,9 +431,16 @@ void GraphTileBuilder::StoreTileData() {
 // tile contents remains the same.
 void GraphTileBuilder::Update(const std::vector<NodeInfo>& nodes,
                               const std::vector<DirectedEdge>& directededges) {
+  Update(nodes, directededges, tile_dir_);
+}
+
+// Update a graph tile with new nodes and directed edges, storing it in the given tile directory.
+void GraphTileBuilder::Update(const std::vector<NodeInfo>& nodes,
+                              const std::vector<DirectedEdge>& directededges,
+                              const std::string& tile_dir) {
   // Get the name of the file
   filesystem::path filename =
-      tile_dir_ + filesystem::path::preferred_separator + GraphTile::FileSuffix(header_->graphid());
+      tile_dir + filesystem::path::preferred_separator + GraphTile::FileSuffix(header_->graphid());
 
   // Make sure the directory exists on the system
   if (!filesystem::exists(filename.parent_path())) {
@@ -9,10 +9,14 @@
 #include "midgard/pointll.h"
 #include "midgard/sequence.h"
 #include "mjolnir/graphtilebuilder.h"
+#include "mjolnir/tileworkers.h"
 #include "scoped_timer.h"
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
+#include <deque>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -105,77 +109,64 @@ OldToNewNodes find_nodes(sequence<OldToNewNodes>& old_to_new, const GraphId& nod
   }
 }
 
-// Form tiles in the new level.
-void FormTilesInNewLevel(GraphReader& reader,
-                         const std::string& new_to_old_file,
-                         const std::string& old_to_new_file) {
-  SCOPED_TIMER();
-  // Use the sequence that associate new nodes to old nodes
-  sequence<std::pair<GraphId, GraphId>> new_to_old(new_to_old_file, false);
-
-  // Use the sorted sequence that associates old nodes to new nodes
-  sequence<OldToNewNodes> old_to_new(old_to_new_file, false);
+// A tile in one of the new levels and the range of its nodes within the sorted new to old sequence
+struct NewTile {
+  GraphId tile_id;
+  size_t begin;
+  size_t end;
+};
 
-  // lambda to indicate whether a directed edge should be included
-  auto include_edge = [&old_to_new](const DirectedEdge* directededge, const GraphId& base_node,
-                                    const uint8_t current_level) {
-    if (directededge->use() == Use::kTransitConnection ||
-        directededge->use() == Use::kEgressConnection ||
-        directededge->use() == Use::kPlatformConnection) {
-      // Transit connection edges should live on the lowest class level
-      // where a new node exists
-      auto f = find_nodes(old_to_new, base_node);
-      uint8_t lowest_level;
-      if (f.local_node.Is_Valid())
-        lowest_level = 2;
-      else if (f.arterial_node.Is_Valid())
-        lowest_level = 1;
-      else if (f.highway_node.Is_Valid())
-        lowest_level = 0;
-      else
-        throw std::logic_error("Could not find valid node level");
-      return (lowest_level == current_level);
-    } else if (directededge->bss_connection()) {
-      // Despite the road class, Bike Share Stations' connections are always at local level
-      return (2 == current_level);
-    } else {
-      return (get_hierarchy_level(directededge) == current_level);
-    }
-  };
+// Indicates whether a directed edge of the base level should be included in the current level
+bool IncludeEdge(sequence<OldToNewNodes>& old_to_new,
+                 const DirectedEdge* directededge,
+                 const GraphId& base_node,
+                 const uint8_t current_level) {
+  if (directededge->use() == Use::kTransitConnection ||
+      directededge->use() == Use::kEgressConnection ||
+      directededge->use() == Use::kPlatformConnection) {
+    // Transit connection edges should live on the lowest class level
+    // where a new node exists
+    auto f = find_nodes(old_to_new, base_node);
+    uint8_t lowest_level;
+    if (f.local_node.Is_Valid())
+      lowest_level = 2;
+    else if (f.arterial_node.Is_Valid())
+      lowest_level = 1;
+    else if (f.highway_node.Is_Valid())
+      lowest_level = 0;
+    else
+      throw std::logic_error("Could not find valid node level");
+    return (lowest_level == current_level);
+  } else if (directededge->bss_connection()) {
+    // Despite the road class, Bike Share Stations' connections are always at local level
+    return (2 == current_level);
+  } else {
+    return (get_hierarchy_level(directededge) == current_level);
+  }
+}
 
-  // Iterate through the new nodes. They have been sorted by level so that
-  // highway level is done first.
-  reader.Clear();
+// Form a tile in a new level from the base nodes associated to its new nodes. The tile only
+// depends on its own range of the sequences and on the base tiles, so tiles can be formed in any
+// order and on any thread
+void FormTile(GraphReader& reader,
+              sequence<std::pair<GraphId, GraphId>>& new_to_old,
+              sequence<OldToNewNodes>& old_to_new,
+              const NewTile& new_tile) {
+  // New tilebuilder for the tile
   bool added = false;
-  uint8_t current_level = std::numeric_limits<uint8_t>::max();
-  GraphId tile_id;
   std::hash<std::string> hasher;
-  PointLL base_ll;
-  GraphTileBuilder* tilebuilder = nullptr;
-  for (auto new_node = new_to_old.begin(); new_node != new_to_old.end(); new_node++) {
-    // Get the node - check if a new tile
-    GraphId nodea = (*new_node).first;
-    if (nodea.Tile_Base() != tile_id) {
-      // Store the prior tile
-      if (tilebuilder != nullptr) {
-        tilebuilder->StoreTileData();
-        delete tilebuilder;
-      }
+  const GraphId& tile_id = new_tile.tile_id;
+  uint8_t current_level = tile_id.level();
+  GraphTileBuilder tilebuilder(reader.tile_dir(), tile_id, false);
 
-      // New tilebuilder for the next tile. Update current level.
-      tile_id = nodea.Tile_Base();
-      tilebuilder = new GraphTileBuilder(reader.tile_dir(), tile_id, false);
-      current_level = nodea.level();
+  // Set the base ll for this tile
+  PointLL base_ll = TileHierarchy::get_tiling(current_level).Base(tile_id.tileid());
+  tilebuilder.header_builder().set_base_ll(base_ll);
 
-      // Set the base ll for this tile
-      base_ll = TileHierarchy::get_tiling(current_level).Base(tile_id.tileid());
-      tilebuilder->header_builder().set_base_ll(base_ll);
-
-      // Check if we need to clear the base/local tile cache
-      if (reader.OverCommitted()) {
-        reader.Trim();
-      }
-    }
+  // Iterate through the new nodes of the tile
+  for (auto new_node = new_to_old.at(new_tile.begin); new_node != new_to_old.at(new_tile.end);
+       new_node++) {
+    GraphId nodea = (*new_node).first;
 
     // Get the node in the base level
     GraphId base_node = (*new_node).second;
@@ -186,17 +177,17 @@ void FormTilesInNewLevel(GraphReader& reader,
     }
 
     // Copy the data version
-    tilebuilder->header_builder().set_dataset_id(tile->header()->dataset_id());
+    tilebuilder.header_builder().set_dataset_id(tile->header()->dataset_id());
 
     // Copy node information and set the node lat,lon offsets within the new tile
     NodeInfo baseni = *(tile->node(base_node.id()));
-    tilebuilder->nodes().push_back(baseni);
+    tilebuilder.nodes().push_back(baseni);
     const auto& admin = tile->admininfo(baseni.admin_index());
-    NodeInfo& node = tilebuilder->nodes().back();
+    NodeInfo& node = tilebuilder.nodes().back();
     node.set_latlng(base_ll, baseni.latlng(tile->header()->base_ll()));
-    node.set_edge_index(tilebuilder->directededges().size());
+    node.set_edge_index(tilebuilder.directededges().size());
     node.set_timezone(baseni.timezone());
-    node.set_admin_index(tilebuilder->AddAdmin(admin.country_text(), admin.state_text(),
+    node.set_admin_index(tilebuilder.AddAdmin(admin.country_text(), admin.state_text(),
                                                admin.country_iso(), admin.state_iso()));
 
     // Update node LL based on tile base
@@ -204,7 +195,7 @@ void FormTilesInNewLevel(GraphReader& reader,
     uint32_t density1 = baseni.density();
 
     // Current edge count
-    size_t edge_count = tilebuilder->directededges().size();
+    size_t edge_count = tilebuilder.directededges().size();
 
     // Iterate through directed edges of the base node to get remaining
     // directed edges (based on classification/importance cutoff)
@@ -212,7 +203,7 @@ void FormTilesInNewLevel(GraphReader& reader,
     for (uint32_t i = 0; i < baseni.edge_count(); i++, ++base_edge_id) {
       // Check if the directed edge should exist on this level
       const DirectedEdge* directededge = tile->directededge(base_edge_id);
-      if (!include_edge(directededge, base_node, current_level)) {
+      if (!IncludeEdge(old_to_new, directededge, base_node, current_level)) {
         continue;
       }
 
@@ -258,13 +249,13 @@ void FormTilesInNewLevel(GraphReader& reader,
         if (signs.size() == 0) {
           LOG_ERROR("Base edge should have signs, but none found");
         }
-        tilebuilder->AddSigns(tilebuilder->directededges().size(), signs);
+        tilebuilder.AddSigns(tilebuilder.directededges().size(), signs);
       }
 
       // Get turn lanes from the base directed edge
       if (directededge->turnlanes()) {
         uint32_t offset = tile->turnlanes_offset(base_edge_id.id());
-        tilebuilder->AddTurnLanes(tilebuilder->directededges().size(), tile->GetName(offset));
+        tilebuilder.AddTurnLanes(tilebuilder.directededges().size(), tile->GetName(offset));
       }
 
       // Get access restrictions from the base directed edge. Add these to
@@ -273,7 +264,7 @@ void FormTilesInNewLevel(GraphReader& reader,
       if (directededge->access_restriction()) {
         auto restrictions = tile->GetAccessRestrictions(base_edge_id.id(), kAllAccess);
         for (const auto& res : restrictions) {
-          tilebuilder->AddAccessRestriction(AccessRestriction(tilebuilder->directededges().size(),
+          tilebuilder.AddAccessRestriction(AccessRestriction(tilebuilder.directededges().size(),
                                                               res.type(), res.modes(), res.value()));
         }
       }
@@ -285,13 +276,13 @@ void FormTilesInNewLevel(GraphReader& reader,
           LOG_ERROR("Base edge should have lane connectivity, but none found");
         }
         for (auto& lc : laneconnectivity) {
-          lc.set_to(tilebuilder->directededges().size());
+          lc.set_to(tilebuilder.directededges().size());
         }
-        tilebuilder->AddLaneConnectivity(laneconnectivity);
+        tilebuilder.AddLaneConnectivity(laneconnectivity);
       }
 
       // Names can be different in the forward and backward direction
-      bool diff_names = tilebuilder->OpposingEdgeInfoDiffers(tile, directededge);
+      bool diff_names = tilebuilder.OpposingEdgeInfoDiffers(tile, directededge);
 
       // Get edge info, shape, and names from the old tile and add to the
       // new. Cannot use edge info offset since edges in arterial and
@@ -301,7 +292,7 @@ void FormTilesInNewLevel(GraphReader& reader,
       std::string encoded_shape = edgeinfo.encoded_shape();
       uint32_t w = hasher(encoded_shape + std::to_string(edgeinfo.wayid()));
       uint32_t edge_info_offset =
-          tilebuilder->AddEdgeInfo(w, nodea, nodeb, edgeinfo.wayid(), edgeinfo.mean_elevation(),
+          tilebuilder.AddEdgeInfo(w, nodea, nodeb, edgeinfo.wayid(), edgeinfo.mean_elevation(),
                                    edgeinfo.bike_network(), edgeinfo.speed_limit(), encoded_shape,
                                    edgeinfo.GetNames(), edgeinfo.GetTaggedValues(),
                                    edgeinfo.GetLinguisticTaggedValues(), edgeinfo.GetTypes(), added,
@@ -313,34 +304,34 @@ void FormTilesInNewLevel(GraphReader& reader,
       newedge.set_hierarchy_roadclass(RoadClass::kMotorway, true);
 
       // Add directed edge
-      tilebuilder->directededges().emplace_back(std::move(newedge));
+      tilebuilder.directededges().emplace_back(std::move(newedge));
     }
 
     // Add node transitions
-    uint32_t index = tilebuilder->transitions().size();
+    uint32_t index = tilebuilder.transitions().size();
     auto new_nodes = find_nodes(old_to_new, base_node);
     if (current_level == 0) {
-      AddDownwardTransition(new_nodes.arterial_node, tilebuilder);
-      AddDownwardTransition(new_nodes.local_node, tilebuilder);
+      AddDownwardTransition(new_nodes.arterial_node, &tilebuilder);
+      AddDownwardTransition(new_nodes.local_node, &tilebuilder);
     } else if (current_level == 1) {
-      AddUpwardTransition(new_nodes.highway_node, tilebuilder);
-      AddDownwardTransition(new_nodes.local_node, tilebuilder);
+      AddUpwardTransition(new_nodes.highway_node, &tilebuilder);
+      AddDownwardTransition(new_nodes.local_node, &tilebuilder);
     } else if (current_level == 2) {
-      AddUpwardTransition(new_nodes.highway_node, tilebuilder);
-      AddUpwardTransition(new_nodes.arterial_node, tilebuilder);
+      AddUpwardTransition(new_nodes.highway_node, &tilebuilder);
+      AddUpwardTransition(new_nodes.arterial_node, &tilebuilder);
     } else {
       throw std::logic_error("current_level was never set");
     }
 
     // Set the node transition count and index
-    uint32_t count = tilebuilder->transitions().size() - index;
+    uint32_t count = tilebuilder.transitions().size() - index;
     if (count > 0) {
       node.set_transition_count(count);
       node.set_transition_index(index);
     }
 
     // Set the edge count for the new node
-    node.set_edge_count(tilebuilder->directededges().size() - edge_count);
+    node.set_edge_count(tilebuilder.directededges().size() - edge_count);
 
     // Get named signs from the base node
     if (baseni.named_intersection()) {
@@ -349,15 +340,57 @@ void FormTilesInNewLevel(GraphReader& reader,
         LOG_ERROR("Base node should have signs, but none found");
       }
       node.set_named_intersection(true);
-      tilebuilder->AddSigns(tilebuilder->nodes().size() - 1, signs);
+      tilebuilder.AddSigns(tilebuilder.nodes().size() - 1, signs);
     }
   }
 
-  // Delete the tile builder
-  if (tilebuilder != nullptr) {
-    tilebuilder->StoreTileData();
-    delete tilebuilder;
+  tilebuilder.StoreTileData();
+}
+
+// Form the given tiles with the configured number of threads. Each thread has its own reader and
+// sequences
+void FormTilesInParallel(const boost::property_tree::ptree& pt,
+                         const std::string& new_to_old_file,
+                         const std::string& old_to_new_file,
+                         std::deque<NewTile> tilequeue) {
+  RunTileWorkers(pt, std::move(tilequeue), [&](GraphReader& reader) {
+    auto new_to_old =
+        std::make_shared<sequence<std::pair<GraphId, GraphId>>>(new_to_old_file, false);
+    auto old_to_new = std::make_shared<sequence<OldToNewNodes>>(old_to_new_file, false);
+    return [&reader, new_to_old, old_to_new](const NewTile& new_tile) {
+      FormTile(reader, *new_to_old, *old_to_new, new_tile);
+    };
+  });
+}
+
+// Form tiles in the new levels.
+void FormTilesInNewLevel(const boost::property_tree::ptree& pt,
+                         const std::string& new_to_old_file,
+                         const std::string& old_to_new_file) {
+  SCOPED_TIMER();
+  // Find the range of new nodes of each new tile. They have been sorted by level so that
+  // highway level is done first.
+  std::deque<NewTile> upper_tiles, local_tiles;
+  {
+    sequence<std::pair<GraphId, GraphId>> new_to_old(new_to_old_file, false);
+    auto local_level = TileHierarchy::levels().back().level;
+    size_t index = 0;
+    for (auto new_node = new_to_old.begin(); new_node != new_to_old.end(); new_node++, index++) {
+      GraphId tile_id = (*new_node).first.Tile_Base();
+      auto& tiles = tile_id.level() == local_level ? local_tiles : upper_tiles;
+      if (tiles.empty() || tiles.back().tile_id != tile_id) {
+        tiles.push_back({tile_id, index, index});
+      }
+      tiles.back().end = index + 1;
+    }
   }
+
+  // The local tiles replace the base tiles they are formed from, so they must wait until the
+  // highway and arterial tiles, which are formed from all of the base tiles, are done
+  LOG_INFO("Forming " + std::to_string(upper_tiles.size()) + " highway and arterial tiles");
+  FormTilesInParallel(pt, new_to_old_file, old_to_new_file, std::move(upper_tiles));
+  LOG_INFO("Forming " + std::to_string(local_tiles.size()) + " local tiles");
+  FormTilesInParallel(pt, new_to_old_file, old_to_new_file, std::move(local_tiles));
 }
 
 /**
@@ -574,9 +607,6 @@ void HierarchyBuilder::Build(const boost::property_tree::ptree& pt,
                              const std::string& new_to_old_file,
                              const std::string& old_to_new_file) {
 
-  // TODO: thread this. Might be more possible now that we don't create
-  // shortcuts in the HierarchyBuilder
-
   SCOPED_TIMER();
   // Construct GraphReader
   LOG_INFO("HierarchyBuilder");
@@ -590,7 +620,7 @@ void HierarchyBuilder::Build(const boost::property_tree::ptree& pt,
 
   // Iterate through the hierarchy (from highway down to local) and build
   // new tiles
-  FormTilesInNewLevel(reader, new_to_old_file, old_to_new_file);
+  FormTilesInNewLevel(pt, new_to_old_file, old_to_new_file);
 
   // Remove any base tiles that no longer have any data (nodes and edges
   // only exist on arterial and highway levels)
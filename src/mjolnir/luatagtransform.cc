@@ -38,7 +38,12 @@ std::string to_string(OSMType t) {
 
 } // namespace
 
-LuaTagTransform::LuaTagTransform(const std::string& lua) {
+LuaTagTransform::LuaTagTransform(const std::string& lua, bool compiled) : state_(NULL) {
+  // the built in script needs no interpreter
+  if (compiled) {
+    return;
+  }
+
   // create a new lua state
   state_ = luaL_newstate();
   luaL_openlibs(state_);
@@ -63,6 +68,19 @@ Tags LuaTagTransform::Transform(OSMType type, uint64_t osmid, const osmium::TagL
   const std::string& lua_func =
       type == OSMType::kNode ? LUA_NODE_PROC : (type == OSMType::kWay ? LUA_WAY_PROC : LUA_REL_PROC);
 
+  // the built in script compiled to c++, which fails where the script does
+  if (state_ == NULL) {
+    try {
+      result = TransformGraphTags(type, maptags);
+    } catch (std::exception& e) {
+      LOG_ERROR((boost::format("Exception in Lua function: %1%: Failed to transform the tags of "
+                               "%2% %3%: %4%") %
+                 lua_func % to_string(type) % osmid % e.what())
+                    .str());
+    }
+    return result;
+  }
+
   try {
     // grab the function
     lua_getglobal(state_, lua_func.c_str());
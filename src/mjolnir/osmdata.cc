@@ -1,13 +1,16 @@
 #include "mjolnir/osmdata.h"
 #include "filesystem.h"
 #include "midgard/logging.h"
+#include "midgard/sequence.h"
 #include "scoped_timer.h"
 
 #include <boost/algorithm/string.hpp>
 
 #include <cctype>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <memory>
 
 using namespace valhalla::mjolnir;
 using valhalla::baldr::ConditionalSpeedLimit;
@@ -455,16 +458,16 @@ bool read_node_names(const std::string& filename, UniqueNames& names) {
   std::vector<char> namebuf(bufsize);
   file.read(reinterpret_cast<char*>(namebuf.data()), bufsize);
 
-  // Iterate through the temporary data and add the unique names
+  // Iterate through the temporary data and add the unique names. Their lengths are stored rather
+  // than found from the null terminators since names may hold nulls themselves
   uint32_t offset = 0;
   for (uint32_t n = 0; n < count; ++n) {
-    std::string name(&namebuf[offset]);
-    names.index(name);
-    offset += lengths[n];
-
-    if ((name.length() + 1) != lengths[n]) {
-      LOG_ERROR("name " + name + " length should be " + std::to_string(lengths[n]));
+    if (lengths[n] == 0 || static_cast<size_t>(offset) + lengths[n] > namebuf.size()) {
+      LOG_ERROR("read_node_names found a name past the end of the input file: " + filename);
+      return false;
     }
+    names.index(std::string(&namebuf[offset], lengths[n] - 1));
+    offset += lengths[n];
   }
   return true;
 }
@@ -487,20 +490,68 @@ bool read_unique_names(const std::string& filename, UniqueNames& names) {
   std::vector<char> namebuf(bufsize);
   file.read(reinterpret_cast<char*>(namebuf.data()), bufsize);
 
-  // Iterate through the temporary data and add the unique names
+  // Iterate through the temporary data and add the unique names. Their lengths are stored rather
+  // than found from the null terminators since names may hold nulls themselves
   uint32_t offset = 0;
   for (uint32_t n = 0; n < count; ++n) {
-    std::string name(&namebuf[offset]);
-    names.index(name);
+    if (lengths[n] == 0 || static_cast<size_t>(offset) + lengths[n] > namebuf.size()) {
+      LOG_ERROR("read_unique_names found a name past the end of the input file: " + filename);
+      return false;
+    }
+    names.index(std::string(&namebuf[offset], lengths[n] - 1));
     offset += lengths[n];
+  }
+  return true;
+}
 
-    if ((name.length() + 1) != lengths[n]) {
-      LOG_ERROR("name " + name + " length should be " + std::to_string(lengths[n]));
-    }
+// Size of a file in bytes, 0 if it can't be found
+size_t file_size(const std::string& filename) {
+  struct stat s;
+  return stat(filename.c_str(), &s) == 0 ? s.st_size : 0;
+}
+
+bool map_unique_names(const std::string& filename, UniqueNames& names) {
+  // Map the file written by write_unique_names, the names are read straight from it
+  auto file = std::make_shared<valhalla::midgard::mem_map<char>>();
+  try {
+    file->map_readonly(filename, file_size(filename), POSIX_MADV_RANDOM);
+  } catch (const std::exception& e) {
+    LOG_ERROR("map_unique_names failed to map input file: " + std::string(e.what()));
+    return false;
+  }
+  if (!*file) {
+    LOG_ERROR("map_unique_names failed to open input file: " + filename);
+    return false;
+  }
+
+  // Check the counts against the size of the file before pointing into it
+  uint32_t count = 0, bufsize = 0;
+  size_t size = file->size();
+  if (size >= sizeof(uint32_t)) {
+    std::memcpy(&count, file->get(), sizeof(uint32_t));
   }
+  size_t strings_offset = sizeof(uint32_t) * (static_cast<size_t>(count) + 2);
+  if (strings_offset <= size) {
+    std::memcpy(&bufsize, file->get() + strings_offset - sizeof(uint32_t), sizeof(uint32_t));
+  }
+  if (strings_offset > size || strings_offset + bufsize != size) {
+    LOG_ERROR("map_unique_names found a truncated input file: " + filename);
+    return false;
+  }
+
+  const auto* lengths = reinterpret_cast<const uint32_t*>(file->get() + sizeof(uint32_t));
+  const char* strings = file->get() + strings_offset;
+  names.Map(std::move(file), filename, lengths, strings, count);
   return true;
 }
 
+// Rough size of a hashed container, every entry is a node holding the value, a pointer to the next
+// node and the cached hash
+template <typename hashed_t> size_t hashed_memory_use(const hashed_t& container) {
+  return container.size() * (sizeof(typename hashed_t::value_type) + 2 * sizeof(void*)) +
+         container.bucket_count() * sizeof(void*);
+}
+
 bool read_lane_connectivity(const std::string& filename, OSMLaneConnectivityMultiMap& lane_map) {
   // Open file and truncate
   std::ifstream file(filename, std::ios::in | std::ios::binary);
@@ -615,7 +666,7 @@ bool OSMData::write_to_temp_files(const std::string& tile_dir) {
 }
 
 // Read OSMData from temporary files
-bool OSMData::read_from_temp_files(const std::string& tile_dir) {
+bool OSMData::read_from_temp_files(const std::string& tile_dir, size_t mmap_threshold) {
   LOG_INFO("Read OSMData from temp files");
 
   std::string tile_directory = tile_dir;
@@ -651,28 +702,60 @@ bool OSMData::read_from_temp_files(const std::string& tile_dir) {
       read_bike_relations(tile_directory + bike_relations_file, bike_relations) &&
       read_way_refs(tile_directory + way_ref_file, way_ref) &&
       read_way_refs(tile_directory + way_ref_rev_file, way_ref_rev) &&
-      read_node_names(tile_directory + node_names_file, node_names) &&
-      read_unique_names(tile_directory + unique_names_file, name_offset_map) &&
       read_lane_connectivity(tile_directory + lane_connectivity_file, lane_connectivity_map) &&
       read_linguistic(tile_directory + pronunciation_file, pronunciations) &&
       read_linguistic(tile_directory + language_file, langs) &&
       read_conditional_speed_limits(tile_directory + lane_connectivity_file, conditional_speeds);
+
+  // The names take at least as much memory as their files once read, past the threshold they are
+  // read from the mapped files instead
+  if (status && mmap_threshold > 0 &&
+      memory_use() + file_size(tile_directory + node_names_file) +
+              file_size(tile_directory + unique_names_file) >
+          mmap_threshold) {
+    status = map_names(tile_directory);
+  } else {
+    status = status && read_node_names(tile_directory + node_names_file, node_names) &&
+             read_unique_names(tile_directory + unique_names_file, name_offset_map);
+  }
   LOG_INFO("Done");
   initialized = status;
   return status;
 }
 
 // Read OSMData from temporary files
-bool OSMData::read_from_unique_names_file(const std::string& tile_dir) {
+bool OSMData::read_from_unique_names_file(const std::string& tile_dir, size_t mmap_threshold) {
   SCOPED_TIMER();
   LOG_INFO("Read OSMData unique_names from temp file");
 
   // Read the other data
-  bool status = read_unique_names(tile_dir + unique_names_file, name_offset_map);
+  const std::string filename = tile_dir + unique_names_file;
+  bool status = mmap_threshold > 0 && file_size(filename) > mmap_threshold
+                    ? map_unique_names(filename, name_offset_map)
+                    : read_unique_names(filename, name_offset_map);
   LOG_INFO("Done");
   return status;
 }
 
+// Swap the names for views of the temporary files
+bool OSMData::map_names(const std::string& tile_dir) {
+  LOG_INFO("Map OSMData names from temp files");
+  bool status = map_unique_names(tile_dir + node_names_file, node_names) &&
+                map_unique_names(tile_dir + unique_names_file, name_offset_map);
+  LOG_INFO("Done");
+  return status;
+}
+
+// Estimate the memory held by OSMData
+size_t OSMData::memory_use() const {
+  return hashed_memory_use(restrictions) + hashed_memory_use(via_set) +
+         hashed_memory_use(access_restrictions) + hashed_memory_use(bike_relations) +
+         hashed_memory_use(way_ref) + hashed_memory_use(way_ref_rev) +
+         hashed_memory_use(lane_connectivity_map) + hashed_memory_use(pronunciations) +
+         hashed_memory_use(langs) + hashed_memory_use(conditional_speeds) +
+         node_names.MemoryUse() + name_offset_map.MemoryUse();
+}
+
 // add the direction information to the forward or reverse map for relations.
 void OSMData::add_to_name_map(const uint64_t member_id,
                               const std::string& direction,
@@ -16,6 +16,9 @@
 #include <boost/algorithm/string.hpp>
 #include <osmium/io/pbf_input.hpp>
 
+#include <exception>
+#include <future>
+#include <memory>
 #include <thread>
 #include <utility>
 
@@ -25,13 +28,13 @@ using namespace valhalla::mjolnir;
 
 namespace {
 
-// Limits number of Lua workers in `PBFGraphParser::ParseWays()`.
+// Limits number of Lua workers in `parse_in_order()`.
 // Increase this number if downstream processing can handle more.
 constexpr size_t kMaxLuaConcurrency = 8;
-// Number of OSM pbf buffers per Lua worker in `PBFGraphParser::ParseWays()`.
+// Number of OSM pbf buffers per Lua worker in `parse_in_order()`.
 constexpr size_t kOsmBuffersPerLua = 4;
 // Number of processed OSM pbf buffers (buffer has many ways) per Lua worker. That one should be
-// reasonably big because `PBFGraphParser::ParseWays()` keeps original order of OSM ways and this
+// reasonably big because `parse_in_order()` keeps original order of OSM entities and this
 // buffer allows Lua workers not to stuck if next needed buffer takes more time than others.
 constexpr size_t kWaysChunksPerLua = 8;
 
@@ -146,7 +149,7 @@ private:
 // Construct PBFGraphParser based on properties file and input PBF extract
 struct graph_parser {
   graph_parser(const boost::property_tree::ptree& pt, OSMData& osmdata)
-      : lua_(get_lua(pt)), osmdata_(osmdata) {
+      : lua_(get_lua(pt), built_in_lua(pt)), osmdata_(osmdata) {
     current_way_node_index_ = last_node_ = last_way_ = last_relation_ = 0;
 
     highway_cutoff_rc_ = RoadClass::kPrimary;
@@ -1946,32 +1949,125 @@ struct graph_parser {
     return std::string(lua_graph_lua, lua_graph_lua + lua_graph_lua_len);
   }
 
-  // Handle bike share stations separately
-  void bss_node(const osmium::Node& node) {
-    const uint64_t osmid = node.id();
-    // unsorted extracts are just plain nasty, so they can bugger off!
-    if (osmid < last_node_) {
-      throw std::runtime_error("Detected unsorted input data");
+  // Whether the tags are transformed by the built in lua/graph.lua, in which case they are
+  // transformed without running the script
+  static bool built_in_lua(const boost::property_tree::ptree& pt) {
+    return !pt.get_optional<std::string>("graph_lua_name");
+  }
+
+  // Intermediate structure that represents transformed (by Lua) osm node
+  struct Node {
+    uint64_t osmid;
+    double lng;
+    double lat;
+    Tags tags;
+  };
+
+  // The nodes of a pbf buffer that are kept along with what is needed from all of them
+  struct Nodes {
+    std::vector<Node> nodes;
+    uint64_t first_osmid = 0;
+    uint64_t last_osmid = 0;
+    uint64_t max_changeset_id = 0;
+  };
+
+  // Calls `keep` with every node of a buffer after checking that they are sorted
+  template <typename keep_t>
+  static Nodes filter_nodes(const osmium::memory::Buffer& buffer, const keep_t& keep) {
+    Nodes filtered;
+    bool first = true;
+    for (const osmium::memory::Item& item : buffer) {
+      const auto& node = static_cast<const osmium::Node&>(item);
+      const uint64_t osmid = node.id();
+      // unsorted extracts are just plain nasty, so they can bugger off!
+      if (first) {
+        filtered.first_osmid = osmid;
+        first = false;
+      } else if (osmid < filtered.last_osmid) {
+        throw std::runtime_error("Detected unsorted input data");
+      }
+      filtered.last_osmid = osmid;
+      filtered.max_changeset_id =
+          std::max(filtered.max_changeset_id, static_cast<uint64_t>(node.changeset()));
+      keep(node, filtered.nodes);
     }
-    last_node_ = osmid;
+    return filtered;
+  }
 
-    // Get tags - do't bother with Lua callout if the taglist is empty
-    const Tags tags = node.tags().empty() ? empty_node_tags_
-                                          : lua_.Transform(OSMType::kNode, node.id(), node.tags());
+  // Keeps the bike share stations of a buffer of nodes
+  static Nodes
+  transform_bss_nodes(const osmium::memory::Buffer& buffer, LuaTagTransform& lua, const Tags& empty) {
+    return filter_nodes(buffer, [&lua, &empty](const osmium::Node& node, std::vector<Node>& kept) {
+      // Get tags - do't bother with Lua callout if the taglist is empty
+      Tags tags =
+          node.tags().empty() ? empty : lua.Transform(OSMType::kNode, node.id(), node.tags());
+
+      // bail if there is nothing bike related
+      Tags::const_iterator found = tags.find("amenity");
+      if (found == tags.end() || found->second != "bicycle_rental") {
+        return;
+      }
+      kept.emplace_back(Node{static_cast<uint64_t>(node.id()), node.location().lon(),
+                             node.location().lat(), std::move(tags)});
+    });
+  }
 
-    // bail if there is nothing bike related
-    Tags::const_iterator found = tags.find("amenity");
-    if (found == tags.end() || found->second != "bicycle_rental") {
-      return;
+  // Keeps the nodes of a buffer that ways reference. The way nodes are sorted by node id so the
+  // first one at or after each node is found by galloping forward from the last one found
+  static Nodes transform_nodes(const osmium::memory::Buffer& buffer,
+                               LuaTagTransform& lua,
+                               const Tags& empty,
+                               const OSMWayNode* way_nodes_begin,
+                               const OSMWayNode* way_nodes_end) {
+    const auto* way_node = way_nodes_begin;
+    return filter_nodes(buffer, [&](const osmium::Node& node, std::vector<Node>& kept) {
+      const uint64_t osmid = node.id();
+      const auto before = [](const OSMWayNode& a, uint64_t id) { return a.node.osmid_ < id; };
+      size_t step = 1;
+      const auto* bound = way_node;
+      while (bound < way_nodes_end && before(*bound, osmid)) {
+        way_node = bound + 1;
+        bound = way_nodes_end - bound > static_cast<ptrdiff_t>(step) ? bound + step : way_nodes_end;
+        step *= 2;
+      }
+      way_node = std::lower_bound(way_node, bound, osmid, before);
+
+      // skip the nodes no way we kept references
+      if (way_node == way_nodes_end || way_node->node.osmid_ != osmid) {
+        return;
+      }
+
+      // Get tags if not already available.  Don't bother calling Lua if there
+      // are no OSM tags to process.
+      kept.emplace_back(
+          Node{osmid, node.location().lon(), node.location().lat(),
+               node.tags().empty() ? empty : lua.Transform(OSMType::kNode, osmid, node.tags())});
+    });
+  }
+
+  // Takes the changesets and sort order of all nodes of a buffer into account and hands the kept
+  // ones to the node handler
+  template <typename handler_t> void nodes(const Nodes& nodes, const handler_t& handler) {
+    changeset(nodes.max_changeset_id);
+    // unsorted extracts are just plain nasty, so they can bugger off!
+    if (nodes.first_osmid < last_node_) {
+      throw std::runtime_error("Detected unsorted input data");
+    }
+    last_node_ = nodes.last_osmid;
+    for (const auto& node : nodes.nodes) {
+      handler(node);
     }
+  }
 
+  // Handle bike share stations separately
+  void bss_node(const Node& node) {
     // Create a new node and set its attributes
-    OSMNode n{osmid};
-    n.set_latlng(node.location().lon(), node.location().lat());
+    OSMNode n{node.osmid};
+    n.set_latlng(node.lng, node.lat);
     n.set_type(NodeType::kBikeShare);
     valhalla::BikeShareStationInfo bss_info;
 
-    for (auto& key_value : tags) {
+    for (auto& key_value : node.tags) {
       if (key_value.first == "name") {
         bss_info.set_name(key_value.second);
       } else if (key_value.first == "network") {
@@ -1996,15 +2092,8 @@ struct graph_parser {
     bss_nodes_->push_back({n, bss_info_index});
   }
 
-  void node(const osmium::Node& node) {
-    changeset(node.changeset());
-
-    const uint64_t osmid = node.id();
-    // unsorted extracts are just plain nasty, so they can bugger off!
-    if (osmid < last_node_) {
-      throw std::runtime_error("Detected unsorted input data");
-    }
-    last_node_ = osmid;
+  void node(const Node& node) {
+    const uint64_t osmid = node.osmid;
 
     // if we found all of the node ids we were looking for already we can bail
     if (current_way_node_index_ >= way_nodes_->size()) {
@@ -2029,10 +2118,7 @@ struct graph_parser {
       return;
     }
 
-    // Get tags if not already available.  Don't bother calling Lua if there
-    // are no OSM tags to process.
-    const Tags tags =
-        node.tags().empty() ? empty_node_tags_ : lua_.Transform(OSMType::kNode, osmid, node.tags());
+    const Tags& tags = node.tags;
 
     const auto highway = tags.find("highway");
     bool is_highway_junction = ((highway != tags.end()) && (highway->second == "motorway_junction"));
@@ -2056,7 +2142,7 @@ struct graph_parser {
     OSMNode n;
     OSMNodeLinguistic linguistics;
     n.set_id(osmid);
-    n.set_latlng(node.location().lon(), node.location().lat());
+    n.set_latlng(node.lng, node.lat);
     bool intersection = false;
     if (is_highway_junction) {
       n.set_type(NodeType::kMotorWayJunction);
@@ -3775,23 +3861,80 @@ struct graph_parser {
     ways_->push_back(way_);
   }
 
-  void relation(const osmium::Relation& relation) {
-    changeset(relation.changeset());
+  // Intermediate structure that represents transformed (by Lua) osm relation
+  struct Relation {
+    struct Member {
+      osmium::item_type member_type;
+      uint64_t member_id;
+      std::string role;
+    };
+    uint64_t osmid;
+    std::vector<Member> members;
+    Tags tags;
+  };
 
-    const uint64_t osmid = relation.id();
+  // The relations of a pbf buffer that have tags along with what is needed from all of them
+  struct Relations {
+    std::vector<Relation> relations;
+    uint64_t first_osmid = 0;
+    uint64_t last_osmid = 0;
+    uint64_t max_changeset_id = 0;
+  };
+
+  static Relations
+  transform_relations(const osmium::memory::Buffer& buffer, LuaTagTransform& lua, const Tags& empty) {
+    Relations transformed;
+    bool first = true;
+    for (const osmium::memory::Item& item : buffer) {
+      const auto& relation = static_cast<const osmium::Relation&>(item);
+      const uint64_t osmid = relation.id();
+      // unsorted extracts are just plain nasty, so they can bugger off!
+      if (first) {
+        transformed.first_osmid = osmid;
+        first = false;
+      } else if (osmid < transformed.last_osmid) {
+        throw std::runtime_error("Detected unsorted input data");
+      }
+      transformed.last_osmid = osmid;
+      transformed.max_changeset_id =
+          std::max(transformed.max_changeset_id, static_cast<uint64_t>(relation.changeset()));
+
+      // Get tags
+      Tags tags = relation.tags().empty()
+                      ? empty
+                      : lua.Transform(OSMType::kRelation, osmid, relation.tags());
+      if (tags.empty()) {
+        continue;
+      }
+
+      std::vector<Relation::Member> members;
+      members.reserve(relation.members().size());
+      for (const auto& member : relation.members()) {
+        members.push_back(
+            Relation::Member{member.type(), static_cast<uint64_t>(member.ref()), member.role()});
+      }
+      transformed.relations.emplace_back(Relation{osmid, std::move(members), std::move(tags)});
+    }
+    return transformed;
+  }
+
+  // Takes the changesets and sort order of all relations of a buffer into account and handles
+  // the ones with tags
+  void relations(const Relations& relations) {
+    changeset(relations.max_changeset_id);
     // unsorted extracts are just plain nasty, so they can bugger off!
-    if (osmid < last_relation_) {
+    if (relations.first_osmid < last_relation_) {
       throw std::runtime_error("Detected unsorted input data");
     }
-    last_relation_ = osmid;
-
-    // Get tags
-    const Tags tags = relation.tags().empty()
-                          ? empty_relation_tags_
-                          : lua_.Transform(OSMType::kRelation, osmid, relation.tags());
-    if (tags.empty()) {
-      return;
+    last_relation_ = relations.last_osmid;
+    for (const auto& relation : relations.relations) {
+      this->relation(relation);
     }
+  }
+
+  void relation(const Relation& relation) {
+    const uint64_t osmid = relation.osmid;
+    const Tags& tags = relation.tags;
 
     OSMRestriction restriction{};
     OSMRestriction to_restriction{};
@@ -3968,18 +4111,7 @@ struct graph_parser {
         special_network = true;
     }
 
-    // Convert into a vector of helper structs to simplify processing by using
-    // `std::string_view` for `role` instead of original `const char*`.
-    struct Member {
-      osmium::item_type member_type;
-      uint64_t member_id;
-      std::string_view role;
-    };
-    std::vector<Member> members;
-    members.reserve(relation.members().size());
-    for (const auto& member : relation.members()) {
-      members.push_back(Member{member.type(), static_cast<uint64_t>(member.ref()), member.role()});
-    }
+    const auto& members = relation.members;
 
     if (isBicycle && isRoute && !network.empty()) {
       OSMBike bike;
@@ -5070,6 +5202,116 @@ struct graph_parser {
   }
 };
 
+// Parses the entities of a pbf file with asymmetric multithreading (in data flow order):
+// - osmium::thread::pool for parsing PBF file
+// - 1 thread to feed the lua transform pool and guarantee the order of the entities
+// - `lua_concurrency` threads running `transform` on whole buffers, each with its own Lua state
+//   unless the tags are transformed by the built in script
+// - current thread handing the transformed buffers to `handle` in the order of the file
+// None of them will saturate the full CPU core, so total count can be bigger than
+// `std::thread::hardware_concurrency()` or "concurrency" parameter. Errors in any of the threads
+// are rethrown on the current thread once the others are done.
+template <typename transformed_t, typename transform_t, typename handle_t>
+void parse_in_order(const std::string& file,
+                    osmium::osm_entity_bits::type entities,
+                    const std::string& lua_script,
+                    bool built_in_lua,
+                    size_t lua_concurrency,
+                    const transform_t& transform,
+                    const handle_t& handle) {
+  // These two queues maintains the order of processed entities by holding futures that correspond
+  // to the promises sent to the Lua workers. Lua workers take that promises and corresponding
+  // osmium buffers, process them and set the value of the promise.
+  osmium::thread::Queue<std::future<transformed_t>> transformed_queue(lua_concurrency *
+                                                                      kWaysChunksPerLua);
+  osmium::thread::Queue<std::pair<osmium::memory::Buffer, std::promise<transformed_t>>>
+      buffer_queue(lua_concurrency * kOsmBuffersPerLua);
+
+  // Single reader thread that guarantees the order of entities via future/promise magic.
+  std::exception_ptr reader_error;
+  std::thread reader_thread(
+      [&file, entities, &transformed_queue, &buffer_queue, lua_concurrency, &reader_error] {
+        try {
+          osmium::io::Reader reader(file, entities);
+          while (osmium::memory::Buffer buffer = reader.read()) {
+            std::promise<transformed_t> promise;
+            transformed_queue.push(promise.get_future()); // Blocks if queue is full.
+            buffer_queue.push(std::make_pair(std::move(buffer), std::move(promise)));
+          }
+          reader.close(); // Explicit close to get an exception in case of an error.
+        } catch (...) { reader_error = std::current_exception(); }
+
+        // Send stop signals to all threads.
+        transformed_queue.push({});
+        for (size_t i = 0; i < lua_concurrency; ++i) {
+          buffer_queue.push({});
+        }
+      });
+
+  // Thread pool for Lua processing.
+  std::vector<std::thread> lua_pool;
+  lua_pool.reserve(lua_concurrency);
+  for (size_t i = 0; i < lua_concurrency; ++i) {
+    lua_pool.emplace_back(std::thread([&lua_script, built_in_lua, &buffer_queue, &transform] {
+      // If the script can't be loaded every buffer this worker pops fails with that error, it keeps
+      // popping so that the reader isn't left waiting on a full queue
+      std::unique_ptr<LuaTagTransform> lua;
+      std::exception_ptr lua_error;
+      try {
+        lua = std::make_unique<LuaTagTransform>(lua_script, built_in_lua);
+      } catch (...) { lua_error = std::current_exception(); }
+
+      while (true) {
+        std::pair<osmium::memory::Buffer, std::promise<transformed_t>> buffer_promise;
+        buffer_queue.wait_and_pop(buffer_promise);
+        if (!buffer_promise.first) {
+          break; // End of the queue
+        }
+
+        if (lua_error) {
+          buffer_promise.second.set_exception(lua_error);
+          continue;
+        }
+        try {
+          buffer_promise.second.set_value(transform(buffer_promise.first, *lua));
+        } catch (...) { buffer_promise.second.set_exception(std::current_exception()); }
+      }
+    }));
+  }
+
+  // After an error the rest of the file is drained without handling it
+  std::exception_ptr error;
+  while (true) {
+    std::future<transformed_t> future;
+    transformed_queue.wait_and_pop(future);
+    if (!future.valid()) {
+      break; // End of the queue
+    }
+
+    try {
+      transformed_t transformed = future.get();
+      if (!error) {
+        handle(transformed);
+      }
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+
+  reader_thread.join();
+  for (auto& t : lua_pool) {
+    t.join();
+  }
+  if (reader_error) {
+    std::rethrow_exception(reader_error);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 } // namespace
 
 namespace valhalla {
@@ -5085,19 +5327,15 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
   OSMData osmdata{};
   graph_parser parser(pt, osmdata);
   const auto lua_script = graph_parser::get_lua(pt);
+  const bool built_in_lua = graph_parser::built_in_lua(pt);
 
-  // Asymmetric multithreading (in data flow order):
-  // - osmium::thread::pool for parsing PBF file
-  // - 1 thread to feed the lua transform pool and guarantee the order of ways
-  // - `lua_concurrency` threads for lua transform, no more than `kMaxLuaConcurrency`
-  // - current thread for working with OSMData in `graph_parser::way()`
-  // None of them will saturate the full CPU core, so total count can be bigger than
-  // `std::thread::hardware_concurrency()` or "concurrency" parameter.
+  // Ways are parsed by `parse_in_order()`, its threads won't saturate the CPU
   const size_t concurrency =
       std::max(static_cast<size_t>(1),
                pt.get<size_t>("concurrency", std::thread::hardware_concurrency()));
   const size_t lua_concurrency =
       std::clamp(concurrency - 1, static_cast<size_t>(1), kMaxLuaConcurrency);
+  const Tags empty_way_tags = parser.lua_.Transform(OSMType::kWay, 0, {});
 
   LOG_INFO("Parsing files for ways: " + boost::algorithm::join(input_files, ", "));
 
@@ -5109,74 +5347,22 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
   for (auto& file : input_files) {
     parser.current_way_node_index_ = parser.last_node_ = parser.last_way_ = parser.last_relation_ = 0;
 
-    // These two queues maintains the order of processed ways by holding futures that correspond
-    // to the promises sent to the Lua workers. Lua workers take that promises and corresponding
-    // osmium buffers, process them and set the value of the promise.
     using Ways = std::vector<graph_parser::Way>;
-    osmium::thread::Queue<std::future<Ways>> ways_queue(lua_concurrency * kWaysChunksPerLua);
-    osmium::thread::Queue<std::pair<osmium::memory::Buffer, std::promise<Ways>>> buffer_queue(
-        lua_concurrency * kOsmBuffersPerLua);
-
-    // Single reader thread that guarantees the order of ways via future/promise magic.
-    std::thread reader_thread([&file, &ways_queue, &buffer_queue, lua_concurrency] {
-      osmium::io::Reader reader(file, osmium::osm_entity_bits::way);
-      while (osmium::memory::Buffer buffer = reader.read()) {
-        std::promise<Ways> promise;
-        ways_queue.push(promise.get_future()); // Blocks if queue is full.
-        buffer_queue.push(std::make_pair(std::move(buffer), std::move(promise)));
-      }
-
-      // Send stop signals to all threads.
-      ways_queue.push({});
-      for (size_t i = 0; i < lua_concurrency; ++i) {
-        buffer_queue.push({});
-      }
-
-      reader.close(); // Explicit close to get an exception in case of an error.
-    });
-
-    // Thread pool for Lua processing.
-    std::vector<std::thread> lua_pool;
-    lua_pool.reserve(lua_concurrency);
-    for (size_t i = 0; i < lua_concurrency; ++i) {
-      lua_pool.emplace_back(std::thread([&lua_script, &buffer_queue] {
-        LuaTagTransform lua(lua_script);
-        const Tags empty_way_tags = lua.Transform(OSMType::kWay, 0, {});
-
-        while (true) {
-          std::pair<osmium::memory::Buffer, std::promise<Ways>> buffer_promise;
-          buffer_queue.wait_and_pop(buffer_promise);
-          if (!buffer_promise.first) {
-            break; // End of the queue
-          }
-
+    parse_in_order<Ways>(
+        file, osmium::osm_entity_bits::way, lua_script, built_in_lua, lua_concurrency,
+        [&empty_way_tags](const osmium::memory::Buffer& buffer, LuaTagTransform& lua) {
           Ways transformed;
-          for (const osmium::memory::Item& item : buffer_promise.first) {
+          for (const osmium::memory::Item& item : buffer) {
             graph_parser::transform_way(static_cast<const osmium::Way&>(item), lua, empty_way_tags,
                                         transformed);
           }
-          buffer_promise.second.set_value(std::move(transformed));
-        }
-      }));
-    }
-
-    while (true) {
-      std::future<Ways> future;
-      ways_queue.wait_and_pop(future);
-      if (!future.valid()) {
-        break; // End of the queue
-      }
-
-      Ways transformed = future.get();
-      for (const auto& way : transformed) {
-        parser.way(way);
-      }
-    }
-
-    reader_thread.join();
-    for (auto& t : lua_pool) {
-      t.join();
-    }
+          return transformed;
+        },
+        [&parser](const Ways& transformed) {
+          for (const auto& way : transformed) {
+            parser.way(way);
+          }
+        });
   }
 
   // Clarifies types of loop roads and saves fixed ways.
@@ -5191,7 +5377,8 @@ OSMData PBFGraphParser::ParseWays(const boost::property_tree::ptree& pt,
   LOG_INFO("Sorting osm access tags by way id...");
   {
     sequence<OSMAccess> access(access_file, false);
-    access.sort([](const OSMAccess& a, const OSMAccess& b) { return a.way_id() < b.way_id(); });
+    access.sort([](const OSMAccess& a, const OSMAccess& b) { return a.way_id() < b.way_id(); },
+                sequence<OSMAccess>::sort_buffer_size, concurrency);
   }
 
   LOG_INFO("Finished");
@@ -5206,12 +5393,12 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
                                     const std::string& complex_restriction_from_file,
                                     const std::string& complex_restriction_to_file,
                                     OSMData& osmdata) {
-  // TODO: option 1: each one threads makes an osmdata and we splice them together at the end
-  // option 2: synchronize around adding things to a single osmdata. will have to test to see
-  // which is the least expensive (memory and speed). leaning towards option 2
-  //  unsigned int threads =
-  //      std::max(static_cast<unsigned int>(1),
-  //               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  // Relations are parsed by `parse_in_order()`, the intermediate files are sorted with all threads
+  const unsigned int concurrency =
+      std::max(static_cast<unsigned int>(1),
+               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  const size_t lua_concurrency =
+      std::clamp(static_cast<size_t>(concurrency - 1), static_cast<size_t>(1), kMaxLuaConcurrency);
 
   // Create OSM data. Set the member pointer so that the parsing callback methods can use it.
   SCOPED_TIMER();
@@ -5220,6 +5407,8 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
   // Read the OSMData to files if not initialized.
   if (!osmdata.initialized)
     parser.osmdata_.read_from_temp_files(pt.get<std::string>("tile_dir"));
+  const auto lua_script = graph_parser::get_lua(pt);
+  const bool built_in_lua = graph_parser::built_in_lua(pt);
 
   LOG_INFO("Parsing files for relations: " + boost::algorithm::join(input_files, ", "));
 
@@ -5232,13 +5421,13 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
   for (auto& file : input_files) {
     parser.current_way_node_index_ = parser.last_node_ = parser.last_way_ = parser.last_relation_ = 0;
 
-    osmium::io::Reader reader(file, osmium::osm_entity_bits::relation);
-    while (const osmium::memory::Buffer buffer = reader.read()) {
-      for (const osmium::memory::Item& item : buffer) {
-        parser.relation(static_cast<const osmium::Relation&>(item));
-      }
-    }
-    reader.close(); // Explicit close to get an exception in case of an error.
+    const Tags& empty_relation_tags = parser.empty_relation_tags_;
+    parse_in_order<graph_parser::Relations>(
+        file, osmium::osm_entity_bits::relation, lua_script, built_in_lua, lua_concurrency,
+        [&empty_relation_tags](const osmium::memory::Buffer& buffer, LuaTagTransform& lua) {
+          return graph_parser::transform_relations(buffer, lua, empty_relation_tags);
+        },
+        [&parser](const graph_parser::Relations& relations) { parser.relations(relations); });
   }
   LOG_INFO("Finished with " + std::to_string(osmdata.restrictions.size()) +
            " simple turn restrictions");
@@ -5252,7 +5441,8 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
   {
     sequence<OSMRestriction> complex_restrictions_from(complex_restriction_from_file, false);
     complex_restrictions_from.sort(
-        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; });
+        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; },
+        sequence<OSMRestriction>::sort_buffer_size, concurrency);
   }
 
   // Sort complex restrictions. Keep this scoped so the file handles are closed when done sorting.
@@ -5260,7 +5450,8 @@ void PBFGraphParser::ParseRelations(const boost::property_tree::ptree& pt,
   {
     sequence<OSMRestriction> complex_restrictions_to(complex_restriction_to_file, false);
     complex_restrictions_to.sort(
-        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; });
+        [](const OSMRestriction& a, const OSMRestriction& b) { return a < b; },
+        sequence<OSMRestriction>::sort_buffer_size, concurrency);
   }
   LOG_INFO("Finished");
 }
@@ -5271,12 +5462,12 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
                                 const std::string& bss_nodes_file,
                                 const std::string& linguistic_node_file,
                                 OSMData& osmdata) {
-  // TODO: option 1: each one threads makes an osmdata and we splice them together at the end
-  // option 2: synchronize around adding things to a single osmdata. will have to test to see
-  // which is the least expensive (memory and speed). leaning towards option 2
-  //  unsigned int threads =
-  //      std::max(static_cast<unsigned int>(1),
-  //               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  // Nodes are parsed by `parse_in_order()`, the intermediate files are sorted with all threads
+  const unsigned int concurrency =
+      std::max(static_cast<unsigned int>(1),
+               pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+  const size_t lua_concurrency =
+      std::clamp(static_cast<size_t>(concurrency - 1), static_cast<size_t>(1), kMaxLuaConcurrency);
 
   // Create OSM data. Set the member pointer so that the parsing callback methods can use it.
   SCOPED_TIMER();
@@ -5285,9 +5476,12 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
   // Read the OSMData to files if not initialized.
   if (!osmdata.initialized)
     parser.osmdata_.read_from_temp_files(pt.get<std::string>("tile_dir"));
+  const auto lua_script = graph_parser::get_lua(pt);
+  const bool built_in_lua = graph_parser::built_in_lua(pt);
 
   LOG_INFO("Parsing files for nodes: " + boost::algorithm::join(input_files, ", "));
 
+  const Tags& empty_node_tags = parser.empty_node_tags_;
   if (pt.get<bool>("import_bike_share_stations", false)) {
     LOG_INFO("Parsing bss nodes...");
 
@@ -5300,13 +5494,16 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
                    new sequence<OSMBSSNode>(bss_nodes_file, create), nullptr);
       create = false;
 
-      osmium::io::Reader reader(file, osmium::osm_entity_bits::node);
-      while (const osmium::memory::Buffer buffer = reader.read()) {
-        for (const osmium::memory::Item& item : buffer) {
-          parser.bss_node(static_cast<const osmium::Node&>(item));
-        }
-      }
-      reader.close(); // Explicit close to get an exception in case of an error.
+      parse_in_order<graph_parser::Nodes>(
+          file, osmium::osm_entity_bits::node, lua_script, built_in_lua, lua_concurrency,
+          [&empty_node_tags](const osmium::memory::Buffer& buffer, LuaTagTransform& lua) {
+            return graph_parser::transform_bss_nodes(buffer, lua, empty_node_tags);
+          },
+          [&parser](const graph_parser::Nodes& nodes) {
+            parser.nodes(nodes, [&parser](const graph_parser::Node& node) {
+              parser.bss_node(node);
+            });
+          });
     }
     // Since the sequence must be flushed before reading it...
     parser.reset(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
@@ -5322,7 +5519,8 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
   {
     sequence<OSMWayNode> way_nodes(way_nodes_file, false);
     way_nodes.sort(
-        [](const OSMWayNode& a, const OSMWayNode& b) { return a.node.osmid_ < b.node.osmid_; });
+        [](const OSMWayNode& a, const OSMWayNode& b) { return a.node.osmid_ < b.node.osmid_; },
+        sequence<OSMWayNode>::sort_buffer_size, concurrency);
   }
 
   // Parse node in all the input files. Skip any that are not marked from
@@ -5336,13 +5534,23 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
                  nullptr, new sequence<OSMNodeLinguistic>(linguistic_node_file, true));
     parser.current_way_node_index_ = parser.last_node_ = parser.last_way_ = parser.last_relation_ = 0;
 
-    osmium::io::Reader reader(file, osmium::osm_entity_bits::node);
-    while (const osmium::memory::Buffer buffer = reader.read()) {
-      for (const osmium::memory::Item& item : buffer) {
-        parser.node(static_cast<const osmium::Node&>(item));
-      }
-    }
-    reader.close(); // Explicit close to get an exception in case of an error.
+    // The Lua workers look for the nodes in their own read only view of the way nodes. Only the
+    // node ids are read from it, which stay the same while the parser updates the rest in place
+    mem_map<OSMWayNode> way_nodes;
+    way_nodes.map_readonly(way_nodes_file, parser.way_nodes_->size());
+    const OSMWayNode* way_nodes_begin = way_nodes.get();
+    const OSMWayNode* way_nodes_end = way_nodes_begin + way_nodes.size();
+
+    parse_in_order<graph_parser::Nodes>(
+        file, osmium::osm_entity_bits::node, lua_script, built_in_lua, lua_concurrency,
+        [&empty_node_tags, way_nodes_begin,
+         way_nodes_end](const osmium::memory::Buffer& buffer, LuaTagTransform& lua) {
+          return graph_parser::transform_nodes(buffer, lua, empty_node_tags, way_nodes_begin,
+                                               way_nodes_end);
+        },
+        [&parser](const graph_parser::Nodes& nodes) {
+          parser.nodes(nodes, [&parser](const graph_parser::Node& node) { parser.node(node); });
+        });
   }
   uint64_t max_osm_id = parser.last_node_;
   parser.reset(nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
@@ -5354,13 +5562,15 @@ void PBFGraphParser::ParseNodes(const boost::property_tree::ptree& pt,
   LOG_INFO("Sorting osm way node references by way index and node shape index...");
   {
     sequence<OSMWayNode> way_nodes(way_nodes_file, false);
-    way_nodes.sort([](const OSMWayNode& a, const OSMWayNode& b) {
-      if (a.way_index == b.way_index) {
-        // TODO: if its equal we have screwed something up, should we check and throw here?
-        return a.way_shape_node_index < b.way_shape_node_index;
-      }
-      return a.way_index < b.way_index;
-    });
+    way_nodes.sort(
+        [](const OSMWayNode& a, const OSMWayNode& b) {
+          if (a.way_index == b.way_index) {
+            // TODO: if its equal we have screwed something up, should we check and throw here?
+            return a.way_shape_node_index < b.way_shape_node_index;
+          }
+          return a.way_index < b.way_index;
+        },
+        sequence<OSMWayNode>::sort_buffer_size, concurrency);
   }
 
   // Some OSM extracts do not have changeset Ids. For these set the max changeset Id
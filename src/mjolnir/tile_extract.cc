@@ -0,0 +1,406 @@
+#include "mjolnir/tile_extract.h"
+#include "baldr/graphid.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtile.h"
+#include "baldr/graphtileheader.h"
+#include "baldr/tilehierarchy.h"
+#include "baldr/traffictile.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "midgard/sequence.h"
+#include "scoped_timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <future>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+
+namespace {
+
+constexpr size_t kBlockSize = sizeof(tar::header_t);
+const std::string kIndexFile = "index.bin";
+
+// The layout of the index.bin entries the GraphReader expects
+struct tile_index_entry {
+  uint64_t offset;  // byte offset of the tile data from the beginning of the tar
+  uint32_t tile_id; // just level and tileindex hence fitting in 32bits
+  uint32_t size;    // size of the tile in bytes
+};
+static_assert(sizeof(tile_index_entry) == 16, "tile_index_entry has to be packed");
+
+// Everything about a tile needed to place it in the archives
+struct tile_t {
+  GraphId id;
+  // name of the tile in the archive, always with forward slashes
+  std::string name;
+  // either the file in the tile directory or the tile data in the source extract
+  std::string source_path;
+  const char* source = nullptr;
+  size_t size = 0;
+  uint32_t edge_count = 0;
+  // where the headers of the tile go in the tile and traffic extracts and how much padding
+  // precedes them
+  uint64_t offset = 0;
+  size_t padding = 0;
+  uint64_t traffic_offset = 0;
+  size_t traffic_padding = 0;
+
+  size_t traffic_size() const {
+    return sizeof(TrafficTileHeader) + sizeof(TrafficSpeed) * edge_count;
+  }
+};
+
+size_t round_up(size_t bytes, size_t to) {
+  return (bytes + to - 1) / to * to;
+}
+
+// A ustar header, the checksum is computed with the checksum field set to spaces
+tar::header_t make_header(const std::string& name, size_t size, char typeflag, uint64_t mtime) {
+  tar::header_t header{};
+  if (name.size() >= sizeof(header.name)) {
+    throw std::runtime_error("Name is too long for a tar header: " + name);
+  }
+  std::memcpy(header.name, name.data(), name.size());
+  std::snprintf(header.mode, sizeof(header.mode), "%07o", 0644);
+  std::snprintf(header.uid, sizeof(header.uid), "%07o", 0);
+  std::snprintf(header.gid, sizeof(header.gid), "%07o", 0);
+  std::snprintf(header.size, sizeof(header.size), "%011llo", static_cast<unsigned long long>(size));
+  std::snprintf(header.mtime, sizeof(header.mtime), "%011llo",
+                static_cast<unsigned long long>(mtime));
+  header.typeflag = typeflag;
+  std::memcpy(header.magic, "ustar", sizeof(header.magic));
+  std::memcpy(header.version, "00", sizeof(header.version));
+  std::memset(header.chksum, ' ', sizeof(header.chksum));
+  unsigned int sum = 0;
+  for (size_t i = 0; i < sizeof(header); ++i) {
+    sum += reinterpret_cast<const unsigned char*>(&header)[i];
+  }
+  std::snprintf(header.chksum, sizeof(header.chksum), "%06o", sum);
+  return header;
+}
+
+// A pax extended header filling the gap before the next entry with a comment record. Readers
+// apply it to the next entry and ignore the comment
+std::vector<char> make_padding(size_t gap, uint64_t mtime) {
+  std::string record;
+  if (gap > kBlockSize) {
+    auto length = gap - kBlockSize;
+    auto prefix = std::to_string(length) + " comment=";
+    record = prefix + std::string(length - prefix.size() - 1, ' ') + "\n";
+  }
+  std::vector<char> bytes(gap, 0);
+  auto header = make_header("././@PaxHeader", record.size(), 'x', mtime);
+  std::memcpy(bytes.data(), &header, kBlockSize);
+  std::copy(record.begin(), record.end(), bytes.begin() + kBlockSize);
+  return bytes;
+}
+
+// Lays out the entries of an archive after its index, returns where the archive ends
+uint64_t layout(std::vector<tile_t>& tiles, size_t alignment, bool traffic) {
+  uint64_t position = kBlockSize + round_up(sizeof(tile_index_entry) * tiles.size(), kBlockSize);
+  for (auto& tile : tiles) {
+    // the header goes right before the aligned payload
+    auto gap = round_up(position + kBlockSize, alignment) - (position + kBlockSize);
+    auto size = traffic ? tile.traffic_size() : tile.size;
+    (traffic ? tile.traffic_padding : tile.padding) = gap;
+    (traffic ? tile.traffic_offset : tile.offset) = position + gap;
+    position += gap + kBlockSize + round_up(size, kBlockSize);
+  }
+  return position;
+}
+
+void write_at(std::fstream& file, uint64_t offset, const char* data, size_t size) {
+  file.seekp(offset);
+  file.write(data, size);
+  if (!file) {
+    throw std::runtime_error("Could not write " + std::to_string(size) + " bytes at offset " +
+                             std::to_string(offset));
+  }
+}
+
+// Starts an archive with its index and its end of archive marker. Everything in between is
+// written by the workers, the holes they leave read back as zeros
+void start_archive(const std::string& path,
+                   const std::vector<tile_t>& tiles,
+                   uint64_t end,
+                   bool traffic,
+                   uint64_t mtime) {
+  auto parent = filesystem::path(path).parent_path();
+  if (!parent.string().empty() && !filesystem::exists(parent)) {
+    filesystem::create_directories(parent);
+  }
+
+  std::vector<tile_index_entry> index;
+  index.reserve(tiles.size());
+  for (const auto& tile : tiles) {
+    auto size = traffic ? tile.traffic_size() : tile.size;
+    index.push_back({(traffic ? tile.traffic_offset : tile.offset) + kBlockSize,
+                     static_cast<uint32_t>(tile.id.value), static_cast<uint32_t>(size)});
+  }
+  auto index_size = sizeof(tile_index_entry) * index.size();
+
+  std::fstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Could not open " + path + " for writing");
+  }
+  auto header = make_header(kIndexFile, index_size, '0', mtime);
+  write_at(file, 0, reinterpret_cast<const char*>(&header), kBlockSize);
+  write_at(file, kBlockSize, reinterpret_cast<const char*>(index.data()), index_size);
+  const std::vector<char> eof(2 * kBlockSize, 0);
+  write_at(file, end, eof.data(), eof.size());
+}
+
+// Runs the work on all tiles with the given number of threads, each thread gets its own worker
+// from the factory. The first failure is rethrown once all threads are done
+template <typename factory_t>
+void for_each_tile(std::vector<tile_t>& tiles, unsigned int concurrency, const factory_t& factory) {
+  std::atomic<size_t> next(0);
+  std::list<std::promise<void>> results;
+  std::vector<std::shared_ptr<std::thread>> threads(std::min<size_t>(concurrency, tiles.size()));
+  for (auto& thread : threads) {
+    results.emplace_back();
+    thread.reset(new std::thread(
+        [&tiles, &next, &factory](std::promise<void>& result) {
+          try {
+            auto work = factory();
+            for (size_t i = next++; i < tiles.size(); i = next++) {
+              work(tiles[i]);
+            }
+            result.set_value();
+          } catch (...) { result.set_exception(std::current_exception()); }
+        },
+        std::ref(results.back())));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  for (auto& result : results) {
+    result.get_future().get();
+  }
+}
+
+// Collects the tiles from the tile directory or the source extract
+std::vector<tile_t> collect_tiles(const boost::property_tree::ptree& pt,
+                                  const valhalla::mjolnir::TileExtractOptions& options,
+                                  std::shared_ptr<tar>& source) {
+  std::vector<tile_t> tiles;
+  if (!options.source_extract.empty()) {
+    source = std::make_shared<tar>(options.source_extract);
+    for (const auto& content : source->contents) {
+      tile_t tile;
+      try {
+        tile.id = GraphTile::GetTileId(content.first);
+      } catch (...) { continue; }
+      tile.name = GraphTile::FileSuffix(tile.id, SUFFIX_NON_COMPRESSED, false);
+      tile.source = content.second.first;
+      tile.size = content.second.second;
+      tiles.emplace_back(std::move(tile));
+    }
+  } else {
+    // dont let the reader load the extract we are about to overwrite
+    auto config = pt;
+    config.erase("tile_extract");
+    config.erase("traffic_extract");
+    GraphReader reader(config);
+    for (const auto& id : reader.GetTileSet()) {
+      tile_t tile;
+      tile.id = id;
+      tile.name = GraphTile::FileSuffix(id, SUFFIX_NON_COMPRESSED, false);
+      tile.source_path = reader.GetTileSetLocation() + filesystem::path::preferred_separator +
+                         GraphTile::FileSuffix(id);
+      tiles.emplace_back(std::move(tile));
+    }
+  }
+
+  if (options.bbox) {
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+                               [&options](const tile_t& tile) {
+                                 const auto& tiling = TileHierarchy::get_tiling(tile.id.level());
+                                 auto bounds = tiling.TileBounds(tile.id.tileid());
+                                 return !options.bbox->Intersects(bounds);
+                               }),
+                tiles.end());
+  }
+  std::sort(tiles.begin(), tiles.end(),
+            [](const tile_t& a, const tile_t& b) { return a.id < b.id; });
+  return tiles;
+}
+
+// Reads the archive back and checks that every tile is where the index says it is
+void validate(const std::string& path,
+              const std::vector<tile_t>& tiles,
+              size_t alignment,
+              bool traffic) {
+  tar archive(path);
+  if (archive.corrupt_blocks) {
+    throw std::runtime_error(path + " has " + std::to_string(archive.corrupt_blocks) +
+                             " corrupt blocks");
+  }
+  auto index = archive.contents.find(kIndexFile);
+  if (index == archive.contents.cend() ||
+      index->second.second != sizeof(tile_index_entry) * tiles.size()) {
+    throw std::runtime_error(path + " has no index for its " + std::to_string(tiles.size()) +
+                             " tiles");
+  }
+  const auto* entries = reinterpret_cast<const tile_index_entry*>(index->second.first);
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    const auto& tile = tiles[i];
+    const auto& entry = entries[i];
+    auto name = tile.name;
+    std::replace(name.begin(), name.end(), '/', filesystem::path::preferred_separator);
+    auto content = archive.contents.find(name);
+    if (content == archive.contents.cend() || entry.tile_id != tile.id.value ||
+        content->second.first != archive.mm.get() + entry.offset ||
+        content->second.second != entry.size || entry.offset % alignment != 0) {
+      throw std::runtime_error(path + " does not have " + tile.name + " where the index says");
+    }
+
+    // the payload has to be the tile
+    bool matches;
+    if (traffic) {
+      TrafficTileHeader header;
+      std::memcpy(&header, content->second.first, sizeof(header));
+      matches = header.tile_id == tile.id.value && header.directed_edge_count == tile.edge_count;
+    } else {
+      GraphTileHeader header;
+      std::memcpy(&header, content->second.first, sizeof(header));
+      matches = header.graphid() == tile.id;
+    }
+    if (!matches) {
+      throw std::runtime_error(path + " has the wrong data for " + tile.name);
+    }
+  }
+}
+
+} // namespace
+
+namespace valhalla {
+namespace mjolnir {
+
+size_t BuildTileExtract(const boost::property_tree::ptree& pt, const TileExtractOptions& options) {
+  SCOPED_TIMER();
+  auto alignment = std::max(options.alignment, kBlockSize);
+  if (alignment % kBlockSize != 0) {
+    throw std::runtime_error("The alignment has to be a multiple of " + std::to_string(kBlockSize));
+  }
+  const bool traffic = !options.traffic_path.empty();
+  const auto mtime = static_cast<uint64_t>(std::time(nullptr));
+  unsigned int concurrency =
+      std::max(1u, pt.get<unsigned int>("concurrency", std::thread::hardware_concurrency()));
+
+  std::shared_ptr<tar> source;
+  auto tiles = collect_tiles(pt, options, source);
+  if (tiles.empty()) {
+    throw std::runtime_error("Couldn't find usable tiles in " +
+                             (source ? options.source_extract : pt.get<std::string>("tile_dir", "")));
+  }
+  LOG_INFO("Archiving " + std::to_string(tiles.size()) + " tiles");
+
+  // the sizes and edge counts have to be known before anything can be placed
+  for_each_tile(tiles, concurrency, []() {
+    return [](tile_t& tile) {
+      GraphTileHeader header;
+      if (tile.source) {
+        if (tile.size < sizeof(header)) {
+          throw std::runtime_error("Tile " + tile.name + " is too small");
+        }
+        std::memcpy(&header, tile.source, sizeof(header));
+      } else {
+        std::ifstream file(tile.source_path, std::ios::binary | std::ios::ate);
+        tile.size = file ? static_cast<size_t>(file.tellg()) : 0;
+        file.seekg(0);
+        if (!file || tile.size < sizeof(header) ||
+            !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+          throw std::runtime_error("Could not read tile " + tile.source_path);
+        }
+      }
+      tile.edge_count = header.directededgecount();
+    };
+  });
+
+  // place everything and write the parts of the archives that aren't tiles
+  auto end = layout(tiles, alignment, false);
+  start_archive(options.extract_path, tiles, end, false, mtime);
+  if (traffic) {
+    auto traffic_end = layout(tiles, alignment, true);
+    start_archive(options.traffic_path, tiles, traffic_end, true, mtime);
+  }
+
+  // copy the tiles and write the empty traffic tiles into their slots
+  for_each_tile(tiles, concurrency, [&]() {
+    auto extract = std::make_shared<std::fstream>(options.extract_path,
+                                                  std::ios::in | std::ios::out | std::ios::binary);
+    auto traffic_extract = traffic ? std::make_shared<std::fstream>(options.traffic_path,
+                                                                    std::ios::in | std::ios::out |
+                                                                        std::ios::binary)
+                                   : nullptr;
+    if (!*extract || (traffic_extract && !*traffic_extract)) {
+      throw std::runtime_error("Could not open the extracts for writing");
+    }
+    auto buffer = std::make_shared<std::vector<char>>();
+    return [&, extract, traffic_extract, buffer](tile_t& tile) {
+      if (tile.padding) {
+        auto padding = make_padding(tile.padding, mtime);
+        write_at(*extract, tile.offset - tile.padding, padding.data(), padding.size());
+      }
+      auto header = make_header(tile.name, tile.size, '0', mtime);
+      write_at(*extract, tile.offset, reinterpret_cast<const char*>(&header), kBlockSize);
+      const char* data = tile.source;
+      if (!data) {
+        std::ifstream file(tile.source_path, std::ios::binary);
+        buffer->resize(tile.size);
+        if (!file.read(buffer->data(), tile.size)) {
+          throw std::runtime_error("Could not read tile " + tile.source_path);
+        }
+        data = buffer->data();
+      }
+      write_at(*extract, tile.offset + kBlockSize, data, tile.size);
+
+      if (!traffic_extract) {
+        return;
+      }
+      if (tile.traffic_padding) {
+        auto padding = make_padding(tile.traffic_padding, mtime);
+        write_at(*traffic_extract, tile.traffic_offset - tile.traffic_padding, padding.data(),
+                 padding.size());
+      }
+      header = make_header(tile.name, tile.traffic_size(), '0', mtime);
+      write_at(*traffic_extract, tile.traffic_offset, reinterpret_cast<const char*>(&header),
+               kBlockSize);
+      // the speeds are left as the zeros of the hole behind the header
+      TrafficTileHeader traffic_header{tile.id.value, 0, tile.edge_count, TRAFFIC_TILE_VERSION, 0,
+                                       0};
+      write_at(*traffic_extract, tile.traffic_offset + kBlockSize,
+               reinterpret_cast<const char*>(&traffic_header), sizeof(traffic_header));
+    };
+  });
+  source.reset();
+  LOG_INFO("Finished writing " + options.extract_path +
+           (traffic ? " and " + options.traffic_path : std::string()));
+
+  // check both archives at the same time
+  auto traffic_check = std::async(std::launch::async, [&]() {
+    if (traffic) {
+      validate(options.traffic_path, tiles, alignment, true);
+    }
+  });
+  validate(options.extract_path, tiles, alignment, false);
+  traffic_check.get();
+  LOG_INFO("Validated " + std::to_string(tiles.size()) + " tiles");
+
+  return tiles.size();
+}
+
+} // namespace mjolnir
+} // namespace valhalla
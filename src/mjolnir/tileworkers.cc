@@ -0,0 +1,40 @@
+#include "mjolnir/tileworkers.h"
+#include "baldr/graphtile.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+
+using namespace valhalla::baldr;
+
+namespace valhalla {
+namespace mjolnir {
+
+std::string StagingDir(const std::string& tile_dir, const std::string& stage) {
+  auto dir = tile_dir;
+  while (dir.size() > 1 && dir.back() == filesystem::path::preferred_separator) {
+    dir.pop_back();
+  }
+  return dir + "_" + stage;
+}
+
+void PublishStagedTiles(const std::string& tile_dir,
+                        const std::string& staging_dir,
+                        const std::vector<GraphId>& tiles,
+                        bool remove_missing) {
+  for (const auto& tile_id : tiles) {
+    auto suffix = GraphTile::FileSuffix(tile_id);
+    auto staged = staging_dir + filesystem::path::preferred_separator + suffix;
+    auto original = tile_dir + filesystem::path::preferred_separator + suffix;
+    if (!filesystem::exists(staged)) {
+      if (remove_missing) {
+        filesystem::remove(original);
+        LOG_INFO("Remove file: " + original + " all edges were filtered");
+      }
+    } else if (!filesystem::rename(staged, original)) {
+      throw std::runtime_error("Could not move the staged tile " + staged + " to " + original);
+    }
+  }
+  filesystem::remove_all(staging_dir);
+}
+
+} // namespace mjolnir
+} // namespace valhalla
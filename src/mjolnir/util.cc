@@ -3,6 +3,7 @@
 #include "baldr/tilehierarchy.h"
 #include "filesystem.h"
 #include "midgard/logging.h"
+#include "mjolnir/altbuilder.h"
 #include "mjolnir/bssbuilder.h"
 #include "mjolnir/elevationbuilder.h"
 #include "mjolnir/graphbuilder.h"
@@ -257,8 +258,10 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
   std::string new_to_old_bin = tile_dir + new_to_old_file;
   std::string old_to_new_bin = tile_dir + old_to_new_file;
 
-  // OSMData class
+  // OSMData class, the stages after parsing read its names from the memory mapped temp files once
+  // it is larger than this. It is not a memory limit, the parse stages keep all of it in memory
   OSMData osm_data{0};
+  const size_t mmap_threshold = config.get<size_t>("mjolnir.osmdata_mmap_threshold", 0);
 
   // Parse the ways
   if (start_stage <= BuildStage::kParseWays && BuildStage::kParseWays <= end_stage) {
@@ -305,7 +308,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
 
     // Read OSMData from files if construct edges is the first stage
     if (start_stage == BuildStage::kConstructEdges)
-      osm_data.read_from_temp_files(tile_dir);
+      osm_data.read_from_temp_files(tile_dir, mmap_threshold);
 
     tiles = GraphBuilder::BuildEdges(config, ways_bin, way_nodes_bin, nodes_bin, edges_bin);
     // Output manifest
@@ -317,7 +320,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
   if (start_stage <= BuildStage::kBuild && BuildStage::kBuild <= end_stage) {
     if (start_stage == BuildStage::kBuild) {
       // Read OSMData from files if building tiles is the first stage
-      osm_data.read_from_temp_files(tile_dir);
+      osm_data.read_from_temp_files(tile_dir, mmap_threshold);
       if (filesystem::exists(tile_manifest)) {
         tiles = TileManifest::ReadFromFile(tile_manifest).tileset;
       } else {
@@ -326,6 +329,14 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
         LOG_WARN("Tile manifest not found, rebuilding edges and manifest");
         tiles = GraphBuilder::BuildEdges(config, ways_bin, way_nodes_bin, nodes_bin, edges_bin);
       }
+    } else if (mmap_threshold > 0 && osm_data.memory_use() > mmap_threshold) {
+      // Past the threshold the names parsed into memory are swapped for views of their files
+      LOG_INFO("OSMData uses " + std::to_string(osm_data.memory_use()) +
+               " bytes, reading its names from temp files");
+      if (end_stage > BuildStage::kEnhance) {
+        osm_data.write_to_temp_files(tile_dir);
+      }
+      osm_data.map_names(tile_dir);
     }
 
     // Build the graph using the OSMNodes and OSMWays from the parser
@@ -339,7 +350,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
   if (start_stage <= BuildStage::kEnhance && BuildStage::kEnhance <= end_stage) {
     // Read OSMData names from file if enhancing tiles is the first stage
     if (start_stage == BuildStage::kEnhance) {
-      osm_data.read_from_unique_names_file(tile_dir);
+      osm_data.read_from_unique_names_file(tile_dir, mmap_threshold);
     }
     GraphEnhancer::Enhance(config, osm_data, access_bin);
   }
@@ -357,7 +368,7 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
   // Build bike share stations
   if (start_stage <= BuildStage::kBss && BuildStage::kBss <= end_stage) {
     if (start_stage == BuildStage::kBss) {
-      osm_data.read_from_unique_names_file(tile_dir);
+      osm_data.read_from_unique_names_file(tile_dir, mmap_threshold);
     }
     BssBuilder::Build(config, osm_data, bss_nodes_bin);
   }
@@ -419,6 +430,12 @@ bool build_tile_set(const boost::property_tree::ptree& original_config,
     remove_temp_file(tile_manifest);
     OSMData::cleanup_temp_files(tile_dir);
   }
+
+  // Compute landmark distances for the A* heuristic of routes (only if configured). This only reads
+  // the finished graph, so it comes after cleanup to keep the numbers of the older stages stable
+  if (start_stage <= BuildStage::kAlt && BuildStage::kAlt <= end_stage) {
+    AltBuilder::Build(config);
+  }
   return true;
 }
 
@@ -0,0 +1,94 @@
+#include "argparse_utils.h"
+#include "baldr/graphreader.h"
+#include "baldr/graphtile.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "mjolnir/affected_tiles.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace valhalla::baldr;
+namespace vm = valhalla::mjolnir;
+
+// Main application to list the tiles an OSM change affects
+int main(int argc, char** argv) {
+  const auto program = filesystem::path(__FILE__).stem().string();
+  // args
+  std::vector<std::string> change_files;
+  std::vector<std::string> previous_files;
+  boost::property_tree::ptree config;
+
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      program,
+      program + " " + VALHALLA_VERSION + "\n\n"
+      "a program that lists the tiles whose contents may change when the given OSM change (osc)\n"
+      "files are applied and the graph is built again. The tiles are printed one per line as\n"
+      "paths relative to the tile directory. Nothing is rebuilt, the graph still has to be built\n"
+      "in full from the changed data. The OSM extracts the current tiles were built from tell\n"
+      "where the changed nodes were.\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("i,inline-config", "Inline JSON config", cxxopts::value<std::string>())
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("p,previous", "OSM PBF file(s) the current tiles were built from.", cxxopts::value<std::vector<std::string>>(previous_files))
+      ("change_files", "positional arguments", cxxopts::value<std::vector<std::string>>(change_files));
+    // clang-format on
+
+    options.parse_positional({"change_files"});
+    options.positional_help("CHANGE.osc [CHANGE.osc ...]");
+    auto result = options.parse(argc, argv);
+    if (!parse_common_args(program, options, result, config, "mjolnir.logging"))
+      return EXIT_SUCCESS;
+
+    if (!result.count("change_files")) {
+      throw cxxopts::exceptions::exception("Input file is required\n\n" + options.help());
+    }
+    if (!result.count("previous")) {
+      throw cxxopts::exceptions::exception("The previous OSM PBF file is required\n\n" +
+                                           options.help());
+    }
+  } catch (cxxopts::exceptions::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // Read all of the changes
+  vm::OsmChange change;
+  for (const auto& file : change_files) {
+    try {
+      vm::read_osm_change(file, change);
+    } catch (const std::exception& e) {
+      LOG_ERROR("Could not read " + file + ": " + e.what());
+      return EXIT_FAILURE;
+    }
+  }
+  try {
+    vm::read_previous_osm(previous_files, change);
+  } catch (const std::exception& e) {
+    LOG_ERROR("Could not read the previous OSM data: " + std::string(e.what()));
+    return EXIT_FAILURE;
+  }
+  LOG_INFO("Read " + std::to_string(change.locations.size()) + " node locations and " +
+           std::to_string(change.way_ids.size()) + " ways");
+
+  GraphReader reader(config.get_child("mjolnir"));
+  for (const auto& tile_id : vm::collect_affected_tiles(reader, change)) {
+    std::cout << GraphTile::FileSuffix(tile_id) << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
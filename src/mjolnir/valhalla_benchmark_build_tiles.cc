@@ -0,0 +1,340 @@
+#include "argparse_utils.h"
+#include "baldr/rapidjson_utils.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "mjolnir/util.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace valhalla::mjolnir;
+
+namespace {
+
+// The stages in the order build_tile_set runs them, which puts elevation before restrictions
+const std::vector<BuildStage> kStages = {
+    BuildStage::kInitialize, BuildStage::kParseWays,      BuildStage::kParseRelations,
+    BuildStage::kParseNodes, BuildStage::kConstructEdges, BuildStage::kBuild,
+    BuildStage::kEnhance,    BuildStage::kFilter,         BuildStage::kTransit,
+    BuildStage::kBss,        BuildStage::kHierarchy,      BuildStage::kShortcuts,
+    BuildStage::kElevation,  BuildStage::kRestrictions,   BuildStage::kValidate,
+    BuildStage::kCleanup,    BuildStage::kAlt};
+
+// What one stage took, the optional values are only known on systems with a /proc file system
+struct StageStats {
+  std::string stage;
+  double wall_seconds = 0;
+  std::optional<uint64_t> peak_rss_bytes;
+  std::optional<uint64_t> bytes_written;
+  uint64_t tile_dir_bytes = 0;
+};
+
+// A value of /proc/self/status or /proc/self/io such as "VmHWM:    1024 kB" in bytes. Only Linux
+// has these files, elsewhere and when they can't be read the value is unknown
+std::optional<uint64_t> proc_value(const std::string& file, const std::string& key) {
+#ifdef __linux__
+  std::ifstream stream("/proc/self/" + file);
+  if (!stream) {
+    return std::nullopt;
+  }
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.compare(0, key.size() + 1, key + ":") != 0) {
+      continue;
+    }
+    std::istringstream value(line.substr(key.size() + 1));
+    uint64_t number = 0;
+    std::string unit;
+    if (!(value >> number)) {
+      return std::nullopt;
+    }
+    value >> unit;
+    return unit == "kB" ? number * 1024 : number;
+  }
+#endif
+  return std::nullopt;
+}
+
+// Resets the peak resident set size of the process to its current size so that the next stage
+// reports its own peak rather than that of the stages before it. Returns false without
+// /proc/self/clear_refs (before Linux 4.0 or on other systems), the peak is then left alone
+bool reset_peak_rss() {
+#ifdef __linux__
+  if (!filesystem::exists("/proc/self/clear_refs")) {
+    return false;
+  }
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  return static_cast<bool>(clear_refs.flush());
+#else
+  return false;
+#endif
+}
+
+uint64_t directory_bytes(const std::string& dir) {
+  uint64_t bytes = 0;
+  if (!filesystem::exists(dir)) {
+    return bytes;
+  }
+  for (filesystem::recursive_directory_iterator i(dir), end; i != end; ++i) {
+    if (i->is_regular_file()) {
+      bytes += i->file_size();
+    }
+  }
+  return bytes;
+}
+
+// Runs each stage of the build on its own, the way valhalla_build_tiles -s <stage> -e <stage>
+// would, and measures it
+bool run_stages(const boost::property_tree::ptree& config,
+                const std::vector<std::string>& input_files,
+                std::vector<StageStats>& stats) {
+  const auto tile_dir = config.get<std::string>("mjolnir.tile_dir");
+  for (const auto stage : kStages) {
+    StageStats stage_stats;
+    stage_stats.stage = to_string(stage);
+    const bool peak_reset = reset_peak_rss();
+    const auto written = proc_value("io", "write_bytes");
+
+    LOG_INFO("Benchmarking stage " + stage_stats.stage);
+    const auto start = std::chrono::steady_clock::now();
+    if (!build_tile_set(config, input_files, stage, stage)) {
+      LOG_ERROR("Stage " + stage_stats.stage + " failed");
+      return false;
+    }
+    stage_stats.wall_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // the peak of the whole process so far says nothing about this stage
+    if (peak_reset) {
+      stage_stats.peak_rss_bytes = proc_value("status", "VmHWM");
+    }
+    const auto written_after = proc_value("io", "write_bytes");
+    if (written && written_after) {
+      stage_stats.bytes_written = *written_after - *written;
+    }
+    stage_stats.tile_dir_bytes = directory_bytes(tile_dir);
+    stats.push_back(stage_stats);
+  }
+  return true;
+}
+
+std::string serialize(const std::vector<std::string>& input_files,
+                      const boost::property_tree::ptree& config,
+                      unsigned runs,
+                      const std::vector<StageStats>& stats) {
+  rapidjson::writer_wrapper_t writer(4096);
+  writer.set_precision(3);
+  writer.start_object();
+  writer("version", VALHALLA_VERSION);
+  writer.start_array("input_files");
+  for (const auto& file : input_files) {
+    writer(filesystem::path(file).filename().string());
+  }
+  writer.end_array();
+  writer("concurrency", config.get<uint64_t>("mjolnir.concurrency",
+                                             std::max(1U, std::thread::hardware_concurrency())));
+  writer("runs", runs);
+
+  double total_seconds = 0;
+  uint64_t peak_rss_bytes = 0;
+  uint64_t bytes_written = 0;
+  writer.start_array("stages");
+  for (const auto& stage : stats) {
+    writer.start_object();
+    writer("stage", stage.stage);
+    writer("wall_seconds", stage.wall_seconds);
+    if (stage.peak_rss_bytes) {
+      writer("peak_rss_bytes", *stage.peak_rss_bytes);
+    }
+    if (stage.bytes_written) {
+      writer("bytes_written", *stage.bytes_written);
+    }
+    writer("tile_dir_bytes", stage.tile_dir_bytes);
+    writer.end_object();
+    total_seconds += stage.wall_seconds;
+    peak_rss_bytes = std::max(peak_rss_bytes, stage.peak_rss_bytes.value_or(0));
+    bytes_written += stage.bytes_written.value_or(0);
+  }
+  writer.end_array();
+
+  writer.start_object("total");
+  writer("wall_seconds", total_seconds);
+  writer("peak_rss_bytes", peak_rss_bytes);
+  writer("bytes_written", bytes_written);
+  writer.end_object();
+  writer.end_object();
+  return writer.get_buffer();
+}
+
+// Limits of how much worse than the baseline a stage may get
+struct Tolerance {
+  double fraction;
+  double seconds;
+  uint64_t bytes;
+};
+
+// Compares the stages against those of a baseline file written by this program before, returns
+// the number of regressions
+size_t compare(const std::vector<StageStats>& stats,
+               const std::string& baseline_file,
+               const Tolerance& tolerance) {
+  const auto baseline = rapidjson::read_json(baseline_file);
+  std::unordered_map<std::string, const rapidjson::Value*> baseline_stages;
+  if (const auto stages = rapidjson::get_child_optional(baseline, "/stages")) {
+    for (const auto& stage : stages->GetArray()) {
+      baseline_stages[rapidjson::get<std::string>(stage, "/stage")] = &stage;
+    }
+  }
+
+  size_t regressions = 0;
+  auto check = [&](const std::string& stage, const char* metric, double value, double base,
+                   double slack) {
+    const bool regressed = value > base * (1 + tolerance.fraction) && value - base > slack;
+    std::cout << std::left << std::setw(16) << stage << std::setw(16) << metric << std::right
+              << std::setw(16) << std::fixed << std::setprecision(3) << base << std::setw(16)
+              << value << std::setw(10) << std::showpos << std::setprecision(1)
+              << (base > 0 ? (value / base - 1) * 100 : 0.0) << "%" << std::noshowpos
+              << (regressed ? "  REGRESSION" : "") << std::endl;
+    regressions += regressed;
+  };
+
+  std::cout << std::left << std::setw(16) << "stage" << std::setw(16) << "metric" << std::right
+            << std::setw(16) << "baseline" << std::setw(16) << "current" << std::setw(11)
+            << "change" << std::endl;
+  for (const auto& stage : stats) {
+    const auto found = baseline_stages.find(stage.stage);
+    if (found == baseline_stages.end()) {
+      continue;
+    }
+    const auto& base = *found->second;
+    check(stage.stage, "wall_seconds", stage.wall_seconds,
+          rapidjson::get<double>(base, "/wall_seconds"), tolerance.seconds);
+    const auto base_rss = rapidjson::get_optional<uint64_t>(base, "/peak_rss_bytes");
+    if (stage.peak_rss_bytes && base_rss) {
+      check(stage.stage, "peak_rss_bytes", *stage.peak_rss_bytes, *base_rss, tolerance.bytes);
+    }
+    const auto base_written = rapidjson::get_optional<uint64_t>(base, "/bytes_written");
+    if (stage.bytes_written && base_written) {
+      check(stage.stage, "bytes_written", *stage.bytes_written, *base_written, tolerance.bytes);
+    }
+  }
+  return regressions;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = filesystem::path(__FILE__).stem().string();
+  // args
+  std::vector<std::string> input_files;
+  std::string output_file, baseline_file;
+  unsigned runs = 1;
+  Tolerance tolerance{};
+  double min_megabytes = 0;
+  boost::property_tree::ptree config;
+
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      program,
+      program + " " + VALHALLA_VERSION + "\n\n"
+      "a program that builds the route graph from osm.pbf extract(s) one stage at a time and\n"
+      "records the wall time, peak resident memory and bytes written to disk of each stage as\n"
+      "json. The build is done in mjolnir.tile_dir, which is purged first. Given a baseline json\n"
+      "written by an earlier run it reports the stages that got worse and exits with a failure.\n"
+      "The peak memory and bytes written are only measured on systems with a /proc file system.\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the configuration file", cxxopts::value<std::string>())
+      ("i,inline-config", "Inline JSON config", cxxopts::value<std::string>())
+      ("o,output", "Write the json to this file rather than to stdout.", cxxopts::value<std::string>(output_file))
+      ("b,baseline", "Compare the stages to those of this json written by an earlier run.", cxxopts::value<std::string>(baseline_file))
+      ("r,runs", "Number of times to build, the fastest time of each stage is kept.", cxxopts::value<unsigned>(runs)->default_value("1"))
+      ("t,tolerance", "Fraction a stage may get worse than the baseline by.", cxxopts::value<double>(tolerance.fraction)->default_value("0.2"))
+      ("min-seconds", "Seconds a stage may get slower than the baseline by regardless of the tolerance.", cxxopts::value<double>(tolerance.seconds)->default_value("1"))
+      ("min-megabytes", "Megabytes of memory or disk writes a stage may grow by regardless of the tolerance.", cxxopts::value<double>(min_megabytes)->default_value("64"))
+      ("input_files", "positional arguments", cxxopts::value<std::vector<std::string>>(input_files))
+      ("j,concurrency", "Number of threads to use. Defaults to all threads.", cxxopts::value<uint32_t>());
+    // clang-format on
+
+    options.parse_positional({"input_files"});
+    options.positional_help("OSM PBF file(s)");
+    auto result = options.parse(argc, argv);
+    if (!parse_common_args(program, options, result, config, "mjolnir.logging", true))
+      return EXIT_SUCCESS;
+
+    if (input_files.empty()) {
+      throw cxxopts::exceptions::exception("Input file is required\n\n" + options.help() + "\n\n");
+    }
+    if (runs == 0) {
+      throw cxxopts::exceptions::exception("At least one run is required");
+    }
+    tolerance.bytes = static_cast<uint64_t>(min_megabytes * 1024 * 1024);
+  } catch (cxxopts::exceptions::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // build the tiles as often as asked keeping the best of each stage, the disk use and writes
+  // don't change between runs but the memory can when the page cache is under pressure
+  std::vector<StageStats> stats;
+  for (unsigned run = 0; run < runs; ++run) {
+    std::vector<StageStats> run_stats;
+    if (!run_stages(config, input_files, run_stats)) {
+      return EXIT_FAILURE;
+    }
+    if (stats.empty()) {
+      stats = std::move(run_stats);
+      continue;
+    }
+    for (size_t i = 0; i < stats.size(); ++i) {
+      stats[i].wall_seconds = std::min(stats[i].wall_seconds, run_stats[i].wall_seconds);
+      if (stats[i].peak_rss_bytes && run_stats[i].peak_rss_bytes) {
+        stats[i].peak_rss_bytes = std::min(*stats[i].peak_rss_bytes, *run_stats[i].peak_rss_bytes);
+      }
+    }
+  }
+
+  const auto json = serialize(input_files, config, runs, stats);
+  if (output_file.empty()) {
+    std::cout << json << std::endl;
+  } else {
+    std::ofstream(output_file) << json << std::endl;
+    LOG_INFO("Wrote the build benchmark to " + output_file);
+  }
+
+  if (!baseline_file.empty()) {
+    try {
+      const auto regressions = compare(stats, baseline_file, tolerance);
+      if (regressions > 0) {
+        LOG_ERROR(std::to_string(regressions) + " regression(s) compared to " + baseline_file);
+        return EXIT_FAILURE;
+      }
+    } catch (const std::exception& e) {
+      LOG_ERROR("Failed to compare to " + baseline_file + ": " + e.what());
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+#include "argparse_utils.h"
+#include "filesystem.h"
+#include "midgard/aabb2.h"
+#include "midgard/logging.h"
+#include "midgard/pointll.h"
+#include "mjolnir/tile_extract.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace valhalla::midgard;
+namespace vm = valhalla::mjolnir;
+
+// Main application to write the tiles to a tar extract
+int main(int argc, char** argv) {
+  const auto program = filesystem::path(__FILE__).stem().string();
+  // args
+  vm::TileExtractOptions extract_options;
+  std::string bbox;
+  boost::property_tree::ptree config;
+  bool overwrite = false, with_traffic = false;
+
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      program,
+      program + " " + VALHALLA_VERSION + "\n\n"
+      "a program that writes the tiles in mjolnir.tile_dir to the tar at mjolnir.tile_extract,\n"
+      "starting with an index.bin the tile extract is loaded from. The tiles are written by\n"
+      "mjolnir.concurrency threads at once and their data is aligned so they can be memory\n"
+      "mapped one by one. Optionally writes the traffic extract at mjolnir.traffic_extract too.\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("i,inline-config", "Inline JSON config", cxxopts::value<std::string>())
+      ("e,extract-tar", "Build the extract from the tiles of the tar at mjolnir.tile_extract and write it to this path instead.", cxxopts::value<std::string>(extract_options.extract_path))
+      ("O,overwrite", "Overwrite existing extracts.", cxxopts::value<bool>(overwrite))
+      ("t,with-traffic", "Also write an empty traffic extract.", cxxopts::value<bool>(with_traffic))
+      ("b,bbox", "Only archive the tiles intersecting this bounding box, in minx,miny,maxx,maxy format.", cxxopts::value<std::string>(bbox))
+      ("a,alignment", "Byte boundary the tiles start on, a multiple of 512.", cxxopts::value<size_t>(extract_options.alignment)->default_value("4096"));
+    // clang-format on
+
+    auto result = options.parse(argc, argv);
+    if (!parse_common_args(program, options, result, config, "mjolnir.logging"))
+      return EXIT_SUCCESS;
+  } catch (cxxopts::exceptions::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // work out where the tiles come from and where they go
+  const auto& mjolnir = config.get_child("mjolnir");
+  if (!extract_options.extract_path.empty()) {
+    extract_options.source_extract = mjolnir.get<std::string>("tile_extract", "");
+    if (!filesystem::is_regular_file(extract_options.source_extract)) {
+      LOG_ERROR("Can't find the tile extract to extract from at mjolnir.tile_extract");
+      return EXIT_FAILURE;
+    }
+  } else {
+    extract_options.extract_path = mjolnir.get<std::string>("tile_extract", "");
+  }
+  if (extract_options.extract_path.empty()) {
+    LOG_ERROR("No output file path specified in mjolnir.tile_extract or --extract-tar");
+    return EXIT_FAILURE;
+  }
+  if (with_traffic) {
+    auto dir = filesystem::path(extract_options.extract_path).parent_path().string();
+    extract_options.traffic_path =
+        mjolnir.get<std::string>("traffic_extract",
+                                 (dir.empty() ? dir : dir + filesystem::path::preferred_separator) +
+                                     "traffic.tar");
+  }
+  for (const auto& path : {extract_options.extract_path, extract_options.traffic_path}) {
+    if (!overwrite && !path.empty() && filesystem::exists(path)) {
+      LOG_ERROR("File exists. Specify --overwrite to overwrite " + path);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!bbox.empty()) {
+    std::vector<std::string> coords;
+    std::stringstream stream(bbox);
+    for (std::string coord; std::getline(stream, coord, ',');) {
+      coords.push_back(coord);
+    }
+    try {
+      if (coords.size() != 4) {
+        throw std::invalid_argument(bbox);
+      }
+      AABB2<PointLL> box(std::stod(coords[0]), std::stod(coords[1]), std::stod(coords[2]),
+                         std::stod(coords[3]));
+      if (box.minx() >= box.maxx() || box.minx() < -180 || box.maxx() > 180 ||
+          box.miny() >= box.maxy() || box.miny() < -90 || box.maxy() > 90) {
+        throw std::invalid_argument(bbox);
+      }
+      extract_options.bbox = box;
+    } catch (const std::exception&) {
+      LOG_ERROR("Bbox " + bbox + " is not a valid minx,miny,maxx,maxy bounding box");
+      return EXIT_FAILURE;
+    }
+  }
+
+  try {
+    auto count = vm::BuildTileExtract(mjolnir, extract_options);
+    LOG_INFO("Finished tarring " + std::to_string(count) + " tiles to " +
+             extract_options.extract_path);
+  } catch (const std::exception& e) {
+    LOG_ERROR(e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
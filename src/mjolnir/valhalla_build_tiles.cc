@@ -15,7 +15,7 @@ using namespace valhalla::mjolnir;
 // List the build stages
 void list_stages() {
   std::cout << "Build stage strings (in order)" << std::endl;
-  for (int i = static_cast<int>(BuildStage::kInitialize); i <= static_cast<int>(BuildStage::kCleanup);
+  for (int i = static_cast<int>(BuildStage::kInitialize); i <= static_cast<int>(BuildStage::kAlt);
        ++i) {
     std::cout << "    " << to_string(static_cast<BuildStage>(i)) << std::endl;
   }
@@ -26,7 +26,7 @@ int main(int argc, char** argv) {
   // args
   std::vector<std::string> input_files;
   BuildStage start_stage = BuildStage::kInitialize;
-  BuildStage end_stage = BuildStage::kCleanup;
+  BuildStage end_stage = BuildStage::kAlt;
   boost::property_tree::ptree config;
 
   try {
@@ -46,7 +46,7 @@ int main(int argc, char** argv) {
       ("c,config", "Path to the configuration file", cxxopts::value<std::string>())
       ("i,inline-config", "Inline JSON config", cxxopts::value<std::string>())
       ("s,start", "Starting stage of the build pipeline", cxxopts::value<std::string>()->default_value("initialize"))
-      ("e,end", "End stage of the build pipeline", cxxopts::value<std::string>()->default_value("cleanup"))
+      ("e,end", "End stage of the build pipeline", cxxopts::value<std::string>()->default_value("alt"))
       ("input_files", "positional arguments", cxxopts::value<std::vector<std::string>>(input_files))
       ("j,concurrency", "Number of threads to use. Defaults to all threads.", cxxopts::value<uint32_t>());
     // clang-format on
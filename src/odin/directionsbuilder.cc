@@ -7,58 +7,161 @@
 #include "odin/narrativebuilder.h"
 #include "proto/directions.pb.h"
 #include "proto/options.pb.h"
+#include "proto_conversions.h"
 #include "worker.h"
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace {
 // Minimum edge length to verify heading (~3 feet)
 constexpr auto kMinEdgeLength = 0.001f;
 
+// Nanoseconds elapsed since the start
+int64_t elapsed_ns(const std::chrono::steady_clock::time_point& start) {
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+// Adds the time spent in one stage of building the directions to the request statistics
+void add_stage_time(valhalla::Api& api, const std::string& stage, int64_t nanoseconds) {
+  auto* stat = api.mutable_info()->mutable_statistics()->Add();
+  stat->set_key(valhalla::Options_Action_Enum_Name(api.options().action()) + ".info.odin." +
+                stage + "_ms");
+  stat->set_value(nanoseconds / 1e6);
+  stat->set_type(valhalla::timing);
+}
+
 } // namespace
 
 namespace valhalla {
 namespace odin {
 
+DirectionsBuilder::Scope DirectionsBuilder::GetScope(const Options& options) {
+  Scope scope;
+  switch (options.format()) {
+    // gpx is made from the trip path alone
+    case Options::gpx:
+      scope.directions = false;
+      break;
+    // without a field selector the route like actions which get here select the directions
+    case Options::pbf:
+      scope.directions =
+          !options.has_pbf_field_selector() || options.pbf_field_selector().directions();
+      break;
+    // voice instructions are the only part of osrm made from the verbal instructions
+    case Options::osrm:
+      scope.verbal = options.voice_instructions();
+      break;
+    default:
+      break;
+  }
+  return scope;
+}
+
 // Returns the trip directions based on the specified directions options
 // and trip path. This method calls ManeuversBuilder::Build and
 // NarrativeBuilder::Build to form the maneuver list. This method
 // calls PopulateDirectionsLeg to transform the maneuver list into the
 // trip directions.
-void DirectionsBuilder::Build(Api& api, const MarkupFormatter& markup_formatter) {
+void DirectionsBuilder::Build(Api& api,
+                              const MarkupFormatter& markup_formatter,
+                              midgard::ThreadPool* pool) {
   const auto& options = api.options();
+  const auto scope = GetScope(options);
+
+  // When the response has no directions in it we only validate the path and fix up its headings
+  if (!scope.directions) {
+    auto start = std::chrono::steady_clock::now();
+    for (auto& trip_route : *api.mutable_trip()->mutable_routes()) {
+      for (auto& trip_path : *trip_route.mutable_legs()) {
+        if (trip_path.node_size() < 1) {
+          throw valhalla_exception_t{210};
+        }
+        if (options.directions_type() != DirectionsType::none) {
+          EnhancedTripLeg etp(trip_path);
+          UpdateHeading(&etp);
+        }
+      }
+    }
+    // the stages are reported either way so that the statistics look the same for every format
+    add_stage_time(api, "maneuvers", elapsed_ns(start));
+    add_stage_time(api, "narrative", 0);
+    return;
+  }
+
+  // Lay out the directions up front so that the legs can be filled in independently
+  std::vector<std::pair<TripLeg*, DirectionsLeg*>> legs;
   for (auto& trip_route : *api.mutable_trip()->mutable_routes()) {
     auto& directions_route = *api.mutable_directions()->mutable_routes()->Add();
     for (auto& trip_path : *trip_route.mutable_legs()) {
-      auto& trip_directions = *directions_route.mutable_legs()->Add();
-
       // Validate trip path node list
       if (trip_path.node_size() < 1) {
         throw valhalla_exception_t{210};
       }
+      legs.emplace_back(&trip_path, directions_route.mutable_legs()->Add());
+    }
+  }
 
-      // Create an enhanced trip path from the specified trip_path
-      EnhancedTripLeg etp(trip_path);
-
-      // Produce maneuvers if desired
-      std::list<Maneuver> maneuvers;
-      if (options.directions_type() != DirectionsType::none) {
-        // Update the heading of ~0 length edges
-        UpdateHeading(&etp);
-
-        ManeuversBuilder maneuversBuilder(options, &etp);
-        maneuvers = maneuversBuilder.Build();
-
-        // Create the instructions if desired
-        if (options.directions_type() == DirectionsType::instructions) {
-          std::unique_ptr<NarrativeBuilder> narrative_builder =
-              NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
-          narrative_builder->Build(maneuvers);
-        }
-      }
+  // The stages are summed over all the legs, which may be narrated on different threads
+  std::atomic<int64_t> maneuvers_ns{0};
+  std::atomic<int64_t> narrative_ns{0};
+  const auto build_leg = [&](size_t i) {
+    BuildLeg(options, scope, markup_formatter, *legs[i].first, *legs[i].second, maneuvers_ns,
+             narrative_ns);
+  };
+
+  // Spread the legs over the threads of the pool, if there is one, the first failure is rethrown
+  if (pool) {
+    pool->run(legs.size(), build_leg);
+  } else {
+    for (size_t i = 0; i < legs.size(); ++i) {
+      build_leg(i);
+    }
+  }
+  add_stage_time(api, "maneuvers", maneuvers_ns);
+  add_stage_time(api, "narrative", narrative_ns);
+}
 
-      // Return trip directions
-      PopulateDirectionsLeg(options, &etp, maneuvers, trip_directions);
+// Builds the maneuvers and narrative of a single leg
+void DirectionsBuilder::BuildLeg(const Options& options,
+                                 const Scope& scope,
+                                 const MarkupFormatter& markup_formatter,
+                                 TripLeg& trip_path,
+                                 DirectionsLeg& trip_directions,
+                                 std::atomic<int64_t>& maneuvers_ns,
+                                 std::atomic<int64_t>& narrative_ns) {
+  // Create an enhanced trip path from the specified trip_path
+  EnhancedTripLeg etp(trip_path);
+
+  // Produce maneuvers if desired
+  std::list<Maneuver> maneuvers;
+  if (options.directions_type() != DirectionsType::none) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Update the heading of ~0 length edges
+    UpdateHeading(&etp);
+
+    ManeuversBuilder maneuversBuilder(options, &etp);
+    maneuvers = maneuversBuilder.Build();
+    maneuvers_ns += elapsed_ns(start);
+
+    // Create the instructions if desired
+    if (options.directions_type() == DirectionsType::instructions) {
+      start = std::chrono::steady_clock::now();
+      std::unique_ptr<NarrativeBuilder> narrative_builder =
+          NarrativeBuilderFactory::Create(options, &etp, markup_formatter);
+      narrative_builder->Build(maneuvers, scope.verbal);
+      narrative_ns += elapsed_ns(start);
     }
   }
+
+  // Return trip directions
+  PopulateDirectionsLeg(options, &etp, maneuvers, trip_directions);
 }
 
 // Update the heading of ~0 length edges.
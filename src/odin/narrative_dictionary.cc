@@ -338,10 +338,72 @@ void NarrativeDictionary::Load(const boost::property_tree::ptree& narrative_pt)
   Load(exit_building_subset, narrative_pt.get_child(kExitBuildingKey));
 }
 
+PhraseTemplate::PhraseTemplate(const std::string& phrase) : phrase_(phrase) {
+  auto is_tag_char = [](const char c) { return (c >= 'A' && c <= 'Z') || c == '_'; };
+  size_t text_begin = 0;
+  for (size_t i = 0; i < phrase_.size(); ++i) {
+    if (phrase_[i] != '<') {
+      continue;
+    }
+    size_t end = i + 1;
+    while (end < phrase_.size() && is_tag_char(phrase_[end])) {
+      ++end;
+    }
+    // Not a tag so it stays part of the text
+    if (end == i + 1 || end == phrase_.size() || phrase_[end] != '>') {
+      continue;
+    }
+    if (i > text_begin) {
+      segments_.push_back(
+          {static_cast<uint32_t>(text_begin), static_cast<uint32_t>(i - text_begin), false});
+    }
+    segments_.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(end + 1 - i), true});
+    text_begin = end + 1;
+    i = end;
+  }
+  if (text_begin < phrase_.size()) {
+    segments_.push_back({static_cast<uint32_t>(text_begin),
+                         static_cast<uint32_t>(phrase_.size() - text_begin), false});
+  }
+}
+
+std::string PhraseTemplate::Fill(std::initializer_list<slot_t> slots) const {
+  // The value of a segment is its slot if it is a tag with one, otherwise its text
+  auto value = [this, &slots](const Segment& segment) {
+    std::string_view text(phrase_.data() + segment.offset, segment.length);
+    if (segment.tag) {
+      for (const auto& slot : slots) {
+        if (slot.first == text) {
+          return slot.second;
+        }
+      }
+    }
+    return text;
+  };
+
+  // Size the instruction first so that it is allocated once
+  size_t size = 0;
+  for (const auto& segment : segments_) {
+    size += value(segment).size();
+  }
+  std::string instruction;
+  instruction.reserve(size);
+  for (const auto& segment : segments_) {
+    instruction.append(value(segment));
+  }
+  return instruction;
+}
+
 void NarrativeDictionary::Load(PhraseSet& phrase_handle,
                                const boost::property_tree::ptree& phrase_pt) {
 
   phrase_handle.phrases = as_unordered_map<std::string, std::string>(phrase_pt, kPhrasesKey);
+
+  // Split the phrases into text and tags once so that forming instructions does not search them
+  phrase_handle.templates.clear();
+  for (const auto& phrase : phrase_handle.phrases) {
+    phrase_handle.templates.emplace(std::stoul(phrase.first), PhraseTemplate(phrase.second));
+  }
 }
 
 void NarrativeDictionary::Load(StartSubset& start_handle,
@@ -47,7 +47,7 @@ NarrativeBuilder::NarrativeBuilder(const Options& options,
       markup_formatter_(markup_formatter), articulated_preposition_enabled_(false) {
 }
 
-void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
+void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers, bool verbal) {
   Maneuver* prev_maneuver = nullptr;
   for (auto& maneuver : maneuvers) {
     switch (maneuver.type()) {
@@ -59,16 +59,18 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormStartInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctStartTransitionInstruction(maneuver));
+        if (verbal) {
+          // Set verbal succinct transition instruction
+          maneuver.set_verbal_succinct_transition_instruction(
+              FormVerbalSuccinctStartTransitionInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalStartInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalStartInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kDestinationRight:
@@ -77,12 +79,14 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormDestinationInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertDestinationInstruction(maneuver));
+        if (verbal) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              FormVerbalAlertDestinationInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalDestinationInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalDestinationInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kBecomes: {
@@ -90,18 +94,18 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
           // Set instruction
           maneuver.set_instruction(FormBecomesInstruction(maneuver, prev_maneuver));
 
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(
-              FormVerbalBecomesInstruction(maneuver, prev_maneuver));
+          if (verbal) {
+            // Set verbal pre transition instruction
+            maneuver.set_verbal_pre_transition_instruction(
+                FormVerbalBecomesInstruction(maneuver, prev_maneuver));
+          }
         }
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver,
-                                                maneuver
-                                                    .HasBeginStreetNames())); // Set verbal succinct
-                                                                              // transition
-                                                                              // instruction
+        if (verbal) {
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kSlightRight:
@@ -113,19 +117,21 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormTurnInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctTurnTransitionInstruction(maneuver));
+        if (verbal) {
+          // Set verbal succinct transition instruction
+          maneuver.set_verbal_succinct_transition_instruction(
+              FormVerbalSuccinctTurnTransitionInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertTurnInstruction(maneuver));
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertTurnInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalTurnInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalTurnInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kUturnRight:
@@ -133,40 +139,44 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormUturnInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctUturnTransitionInstruction(maneuver));
+        if (verbal) {
+          // Set verbal succinct transition instruction
+          maneuver.set_verbal_succinct_transition_instruction(
+              FormVerbalSuccinctUturnTransitionInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertUturnInstruction(maneuver));
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertUturnInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalUturnInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalUturnInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kRampStraight: {
         // Set instruction
         maneuver.set_instruction(FormRampStraightInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertRampStraightInstruction(maneuver));
+        if (verbal) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              FormVerbalAlertRampStraightInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalRampStraightInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalRampStraightInstruction(maneuver));
 
-        // Only set verbal post if > min ramp length
-        // or contains obvious maneuver
-        // or has collapsed merge maneuver
-        if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
-            maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver));
+          // Only set verbal post if > min ramp length
+          // or contains obvious maneuver
+          // or has collapsed merge maneuver
+          if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
+              maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                FormVerbalPostTransitionInstruction(maneuver));
+          }
         }
         break;
       }
@@ -175,20 +185,22 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormRampInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertRampInstruction(maneuver));
+        if (verbal) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertRampInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalRampInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalRampInstruction(maneuver));
 
-        // Only set verbal post if > min ramp length
-        // or contains obvious maneuver
-        // or has collapsed merge maneuver
-        if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
-            maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver));
+          // Only set verbal post if > min ramp length
+          // or contains obvious maneuver
+          // or has collapsed merge maneuver
+          if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
+              maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                FormVerbalPostTransitionInstruction(maneuver));
+          }
         }
         break;
       }
@@ -197,20 +209,22 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormExitInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertExitInstruction(maneuver));
+        if (verbal) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertExitInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalExitInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalExitInstruction(maneuver));
 
-        // Only set verbal post if > min ramp length
-        // or contains obvious maneuver
-        // or has collapsed merge maneuver
-        if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
-            maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver));
+          // Only set verbal post if > min ramp length
+          // or contains obvious maneuver
+          // or has collapsed merge maneuver
+          if ((maneuver.length() > kVerbalPostMinimumRampLength) ||
+              maneuver.contains_obvious_maneuver() || maneuver.has_collapsed_merge_maneuver()) {
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                FormVerbalPostTransitionInstruction(maneuver));
+          }
         }
         break;
       }
@@ -221,46 +235,52 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
           // Set stay on instruction
           maneuver.set_instruction(FormKeepToStayOnInstruction(maneuver));
 
-          // Set verbal transition alert instruction
-          maneuver.set_verbal_transition_alert_instruction(
-              FormVerbalAlertKeepToStayOnInstruction(maneuver));
-
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(FormVerbalKeepToStayOnInstruction(maneuver));
-
-          // For a ramp - only set verbal post if > min ramp length
-          if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
-            if (maneuver.length() > kVerbalPostMinimumRampLength) {
+          if (verbal) {
+            // Set verbal transition alert instruction
+            maneuver.set_verbal_transition_alert_instruction(
+                FormVerbalAlertKeepToStayOnInstruction(maneuver));
+
+            // Set verbal pre transition instruction
+            maneuver.set_verbal_pre_transition_instruction(
+                FormVerbalKeepToStayOnInstruction(maneuver));
+
+            // For a ramp - only set verbal post if > min ramp length
+            if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
+              if (maneuver.length() > kVerbalPostMinimumRampLength) {
+                // Set verbal post transition instruction
+                maneuver.set_verbal_post_transition_instruction(
+                    FormVerbalPostTransitionInstruction(maneuver));
+              }
+            } else {
               // Set verbal post transition instruction
               maneuver.set_verbal_post_transition_instruction(
                   FormVerbalPostTransitionInstruction(maneuver));
             }
-          } else {
-            // Set verbal post transition instruction
-            maneuver.set_verbal_post_transition_instruction(
-                FormVerbalPostTransitionInstruction(maneuver));
           }
         } else {
           // Set instruction
           maneuver.set_instruction(FormKeepInstruction(maneuver));
 
-          // Set verbal transition alert instruction
-          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertKeepInstruction(maneuver));
-
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(FormVerbalKeepInstruction(maneuver));
-
-          // For a ramp - only set verbal post if > min ramp length
-          if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
-            if (maneuver.length() > kVerbalPostMinimumRampLength) {
+          if (verbal) {
+            // Set verbal transition alert instruction
+            maneuver.set_verbal_transition_alert_instruction(
+                FormVerbalAlertKeepInstruction(maneuver));
+
+            // Set verbal pre transition instruction
+            maneuver.set_verbal_pre_transition_instruction(FormVerbalKeepInstruction(maneuver));
+
+            // For a ramp - only set verbal post if > min ramp length
+            if (maneuver.ramp() && !maneuver.has_collapsed_merge_maneuver()) {
+              if (maneuver.length() > kVerbalPostMinimumRampLength) {
+                // Set verbal post transition instruction
+                maneuver.set_verbal_post_transition_instruction(
+                    FormVerbalPostTransitionInstruction(maneuver));
+              }
+            } else {
               // Set verbal post transition instruction
               maneuver.set_verbal_post_transition_instruction(
                   FormVerbalPostTransitionInstruction(maneuver));
             }
-          } else {
-            // Set verbal post transition instruction
-            maneuver.set_verbal_post_transition_instruction(
-                FormVerbalPostTransitionInstruction(maneuver));
           }
         }
         break;
@@ -271,47 +291,52 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormMergeInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctMergeTransitionInstruction(maneuver));
-
-        // Set verbal transition alert instruction if previous maneuver
-        // is greater than 2 km
-        if (prev_maneuver && (prev_maneuver->length(Options::kilometers) >
-                              kVerbalAlertMergePriorManeuverMinimumLength)) {
-          maneuver.set_verbal_transition_alert_instruction(FormVerbalAlertMergeInstruction(maneuver));
-        }
+        if (verbal) {
+          // Set verbal succinct transition instruction
+          maneuver.set_verbal_succinct_transition_instruction(
+              FormVerbalSuccinctMergeTransitionInstruction(maneuver));
+
+          // Set verbal transition alert instruction if previous maneuver
+          // is greater than 2 km
+          if (prev_maneuver && (prev_maneuver->length(Options::kilometers) >
+                                kVerbalAlertMergePriorManeuverMinimumLength)) {
+            maneuver.set_verbal_transition_alert_instruction(
+                FormVerbalAlertMergeInstruction(maneuver));
+          }
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalMergeInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalMergeInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kRoundaboutEnter: {
         // Set instruction
         maneuver.set_instruction(FormEnterRoundaboutInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctEnterRoundaboutTransitionInstruction(maneuver));
+        if (verbal) {
+          // Set verbal succinct transition instruction
+          maneuver.set_verbal_succinct_transition_instruction(
+              FormVerbalSuccinctEnterRoundaboutTransitionInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertEnterRoundaboutInstruction(maneuver));
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              FormVerbalAlertEnterRoundaboutInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalEnterRoundaboutInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              FormVerbalEnterRoundaboutInstruction(maneuver));
 
-        // If the maneuver has a combined enter exit roundabout instruction
-        // then set verbal post transition instruction
-        if (maneuver.has_combined_enter_exit_roundabout()) {
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver,
-                                                  maneuver.HasRoundaboutExitBeginStreetNames()));
+          // If the maneuver has a combined enter exit roundabout instruction
+          // then set verbal post transition instruction
+          if (maneuver.has_combined_enter_exit_roundabout()) {
+            maneuver.set_verbal_post_transition_instruction(
+                FormVerbalPostTransitionInstruction(maneuver,
+                                                    maneuver.HasRoundaboutExitBeginStreetNames()));
+          }
         }
         break;
       }
@@ -319,147 +344,162 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         maneuver.set_instruction(FormExitRoundaboutInstruction(maneuver));
 
-        // Set verbal succinct transition instruction
-        maneuver.set_verbal_succinct_transition_instruction(
-            FormVerbalSuccinctExitRoundaboutTransitionInstruction(maneuver));
+        if (verbal) {
+          // Set verbal succinct transition instruction
+          maneuver.set_verbal_succinct_transition_instruction(
+              FormVerbalSuccinctExitRoundaboutTransitionInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalExitRoundaboutInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              FormVerbalExitRoundaboutInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver, maneuver.HasBeginStreetNames()));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kFerryEnter: {
         // Set instruction
         maneuver.set_instruction(FormEnterFerryInstruction(maneuver));
 
-        // Set verbal transition alert instruction
-        maneuver.set_verbal_transition_alert_instruction(
-            FormVerbalAlertEnterFerryInstruction(maneuver));
+        if (verbal) {
+          // Set verbal transition alert instruction
+          maneuver.set_verbal_transition_alert_instruction(
+              FormVerbalAlertEnterFerryInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalEnterFerryInstruction(maneuver));
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalEnterFerryInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitConnectionStart: {
         // Set instruction
         maneuver.set_instruction(FormTransitConnectionStartInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitConnectionStartInstruction(maneuver));
+        if (verbal) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              FormVerbalTransitConnectionStartInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitConnectionTransfer: {
         // Set instruction
         maneuver.set_instruction(FormTransitConnectionTransferInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitConnectionTransferInstruction(maneuver));
+        if (verbal) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              FormVerbalTransitConnectionTransferInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitConnectionDestination: {
         // Set instruction
         maneuver.set_instruction(FormTransitConnectionDestinationInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitConnectionDestinationInstruction(maneuver));
+        if (verbal) {
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              FormVerbalTransitConnectionDestinationInstruction(maneuver));
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransit: {
         // Set depart instruction
         maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
-
         // Set instruction
         maneuver.set_instruction(FormTransitInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(FormVerbalTransitInstruction(maneuver));
-
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionTransitInstruction(maneuver));
-
         // Set arrive instruction
         maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+        if (verbal) {
+          // Set verbal depart instruction
+          maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
+
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(FormVerbalTransitInstruction(maneuver));
+
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionTransitInstruction(maneuver));
 
+          // Set verbal arrive instruction
+          maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitRemainOn: {
         // Set depart instruction
         maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
-
         // Set instruction
         maneuver.set_instruction(FormTransitRemainOnInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitRemainOnInstruction(maneuver));
-
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionTransitInstruction(maneuver));
-
         // Set arrive instruction
         maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+        if (verbal) {
+          // Set verbal depart instruction
+          maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
+
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              FormVerbalTransitRemainOnInstruction(maneuver));
+
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionTransitInstruction(maneuver));
 
+          // Set verbal arrive instruction
+          maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kTransitTransfer: {
         // Set depart instruction
         maneuver.set_depart_instruction(FormDepartInstruction(maneuver));
 
-        // Set verbal depart instruction
-        maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
-
         // Set instruction
         maneuver.set_instruction(FormTransitTransferInstruction(maneuver));
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(
-            FormVerbalTransitTransferInstruction(maneuver));
-
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionTransitInstruction(maneuver));
-
         // Set arrive instruction
         maneuver.set_arrive_instruction(FormArriveInstruction(maneuver));
 
-        // Set verbal arrive instruction
-        maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+        if (verbal) {
+          // Set verbal depart instruction
+          maneuver.set_verbal_depart_instruction(FormVerbalDepartInstruction(maneuver));
+
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(
+              FormVerbalTransitTransferInstruction(maneuver));
+
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionTransitInstruction(maneuver));
+
+          // Set verbal arrive instruction
+          maneuver.set_verbal_arrive_instruction(FormVerbalArriveInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kElevatorEnter: {
@@ -467,7 +507,8 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         auto instr = FormElevatorInstruction(maneuver);
         maneuver.set_instruction(instr);
 
-        if (maneuver.has_node_type() && maneuver.node_type() == TripLeg_Node_Type_kElevator) {
+        if (verbal && maneuver.has_node_type() &&
+            maneuver.node_type() == TripLeg_Node_Type_kElevator) {
           maneuver.set_verbal_transition_alert_instruction(instr);
 
           // Set verbal pre transition instruction
@@ -483,14 +524,16 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
         // Set instruction
         auto instr = FormStepsInstruction(maneuver);
         maneuver.set_instruction(instr);
-        maneuver.set_verbal_transition_alert_instruction(instr);
+        if (verbal) {
+          maneuver.set_verbal_transition_alert_instruction(instr);
 
-        // Set verbal pre transition instruction
-        maneuver.set_verbal_pre_transition_instruction(instr);
+          // Set verbal pre transition instruction
+          maneuver.set_verbal_pre_transition_instruction(instr);
 
-        // Set verbal post transition instruction
-        maneuver.set_verbal_post_transition_instruction(
-            FormVerbalPostTransitionInstruction(maneuver));
+          // Set verbal post transition instruction
+          maneuver.set_verbal_post_transition_instruction(
+              FormVerbalPostTransitionInstruction(maneuver));
+        }
         break;
       }
       case DirectionsLeg_Maneuver_Type_kEscalatorEnter: {
@@ -514,22 +557,26 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
           std::string instr = FormPassInstruction(maneuver);
           // Set instruction
           maneuver.set_instruction(instr);
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(instr);
+          if (verbal) {
+            // Set verbal pre transition instruction
+            maneuver.set_verbal_pre_transition_instruction(instr);
+          }
         } else {
           // Set instruction
           maneuver.set_instruction(FormContinueInstruction(maneuver));
 
-          // Set verbal transition alert instruction
-          maneuver.set_verbal_transition_alert_instruction(
-              FormVerbalAlertContinueInstruction(maneuver));
+          if (verbal) {
+            // Set verbal transition alert instruction
+            maneuver.set_verbal_transition_alert_instruction(
+                FormVerbalAlertContinueInstruction(maneuver));
 
-          // Set verbal pre transition instruction
-          maneuver.set_verbal_pre_transition_instruction(FormVerbalContinueInstruction(maneuver));
+            // Set verbal pre transition instruction
+            maneuver.set_verbal_pre_transition_instruction(FormVerbalContinueInstruction(maneuver));
 
-          // Set verbal post transition instruction
-          maneuver.set_verbal_post_transition_instruction(
-              FormVerbalPostTransitionInstruction(maneuver));
+            // Set verbal post transition instruction
+            maneuver.set_verbal_post_transition_instruction(
+                FormVerbalPostTransitionInstruction(maneuver));
+          }
         }
         break;
       }
@@ -542,7 +589,9 @@ void NarrativeBuilder::Build(std::list<Maneuver>& maneuvers) {
   }
 
   // Iterate over maneuvers to form verbal multi-cue instructions
-  FormVerbalMultiCue(maneuvers);
+  if (verbal) {
+    FormVerbalMultiCue(maneuvers);
+  }
 }
 
 std::string NarrativeBuilder::FormVerbalAlertApproachInstruction(float distance,
@@ -551,14 +600,11 @@ std::string NarrativeBuilder::FormVerbalAlertApproachInstruction(float distance,
   instruction.reserve(kInstructionInitialCapacity);
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.approach_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
-                                dictionary_.approach_verbal_alert_subset.us_customary_lengths));
-  boost::replace_all(instruction, kCurrentVerbalCueTag, verbal_cue);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.approach_verbal_alert_subset.templates.at(phrase_id).Fill(
+      {{kLengthTag, FormLength(distance, dictionary_.approach_verbal_alert_subset.metric_lengths,
+                               dictionary_.approach_verbal_alert_subset.us_customary_lengths)},
+       {kCurrentVerbalCueTag, verbal_cue}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -616,13 +662,10 @@ std::string NarrativeBuilder::FormStartInstruction(Maneuver& maneuver) {
     phrase_id += 16;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.start_subset.templates.at(phrase_id).Fill(
+      {{kCardinalDirectionTag, cardinal_direction}, {kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -703,16 +746,12 @@ std::string NarrativeBuilder::FormVerbalStartInstruction(Maneuver& maneuver,
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.start_verbal_subset.templates.at(phrase_id).Fill(
+      {{kCardinalDirectionTag, cardinal_direction}, {kStreetNamesTag, street_names},
+       {kBeginStreetNamesTag, begin_street_names},
+       {kLengthTag, FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                               dictionary_.start_verbal_subset.us_customary_lengths)}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -756,14 +795,9 @@ std::string NarrativeBuilder::FormDestinationInstruction(Maneuver& maneuver) {
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.destination_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction}, {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -812,14 +846,9 @@ std::string NarrativeBuilder::FormVerbalAlertDestinationInstruction(Maneuver& ma
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.destination_verbal_alert_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction}, {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -868,14 +897,9 @@ std::string NarrativeBuilder::FormVerbalDestinationInstruction(Maneuver& maneuve
     relative_direction = dictionary_.destination_subset.relative_directions.at(1);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  if (phrase_id > 0) {
-    // Replace phrase tags with values
-    boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-    boost::replace_all(instruction, kDestinationTag, destination);
-  }
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.destination_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction}, {kDestinationTag, destination}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -898,12 +922,9 @@ std::string NarrativeBuilder::FormBecomesInstruction(Maneuver& maneuver, Maneuve
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.becomes_subset.templates.at(phrase_id).Fill(
+      {{kPreviousStreetNamesTag, prev_street_names}, {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -933,12 +954,9 @@ std::string NarrativeBuilder::FormVerbalBecomesInstruction(Maneuver& maneuver,
   // Determine which phrase to use
   uint8_t phrase_id = 0;
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.becomes_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kPreviousStreetNamesTag, prev_street_names);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.becomes_verbal_subset.templates.at(phrase_id).Fill(
+      {{kPreviousStreetNamesTag, prev_street_names}, {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -984,13 +1002,10 @@ std::string NarrativeBuilder::FormContinueInstruction(Maneuver& maneuver,
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.continue_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}, {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1040,13 +1055,10 @@ std::string NarrativeBuilder::FormVerbalAlertContinueInstruction(Maneuver& maneu
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_alert_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.continue_verbal_alert_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}, {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1105,16 +1117,12 @@ std::string NarrativeBuilder::FormVerbalContinueInstruction(Maneuver& maneuver,
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.continue_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
-                                dictionary_.continue_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.continue_verbal_subset.templates.at(phrase_id).Fill(
+      {{kLengthTag, FormLength(maneuver, dictionary_.continue_verbal_subset.metric_lengths,
+                               dictionary_.continue_verbal_subset.us_customary_lengths)},
+       {kStreetNamesTag, street_names}, {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1190,16 +1198,12 @@ std::string NarrativeBuilder::FormTurnInstruction(Maneuver& maneuver,
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = subset->templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+       {kStreetNamesTag, street_names}, {kBeginStreetNamesTag, begin_street_names},
+       {kJunctionNameTag, junction_name}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1298,16 +1302,12 @@ std::string NarrativeBuilder::FormVerbalTurnInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = subset->templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+       {kStreetNamesTag, street_names}, {kBeginStreetNamesTag, begin_street_names},
+       {kJunctionNameTag, junction_name}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1368,17 +1368,12 @@ std::string NarrativeBuilder::FormUturnInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_subset.relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.uturn_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), dictionary_.uturn_subset.relative_directions)},
+       {kStreetNamesTag, street_names}, {kCrossStreetNamesTag, cross_street_names},
+       {kJunctionNameTag, junction_name}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1523,15 +1518,11 @@ std::string NarrativeBuilder::FormVerbalUturnInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kCrossStreetNamesTag, cross_street_names);
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.uturn_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir}, {kStreetNamesTag, street_names},
+       {kCrossStreetNamesTag, cross_street_names}, {kJunctionNameTag, junction_name},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1577,13 +1568,10 @@ std::string NarrativeBuilder::FormRampStraightInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.ramp_straight_subset.templates.at(phrase_id).Fill(
+      {{kBranchSignTag, exit_branch_sign}, {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1682,13 +1670,10 @@ std::string NarrativeBuilder::FormVerbalRampStraightInstruction(uint8_t phrase_i
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_straight_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.ramp_straight_verbal_subset.templates.at(phrase_id).Fill(
+      {{kBranchSignTag, exit_branch_sign}, {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1756,16 +1741,12 @@ std::string NarrativeBuilder::FormRampInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.ramp_subset.relative_directions));
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.ramp_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, FormRelativeTwoDirection(maneuver.type(),
+                                                        dictionary_.ramp_subset.relative_directions)},
+       {kBranchSignTag, exit_branch_sign}, {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -1916,14 +1897,10 @@ std::string NarrativeBuilder::FormVerbalRampInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.ramp_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.ramp_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir}, {kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign}, {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2001,17 +1978,12 @@ std::string NarrativeBuilder::FormExitInstruction(Maneuver& maneuver,
         maneuver.signs().GetExitNameString(element_max_count, limit_by_consecutive_count);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.exit_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.exit_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, FormRelativeTwoDirection(maneuver.type(),
+                                                        dictionary_.exit_subset.relative_directions)},
+       {kNumberSignTag, exit_number_sign}, {kBranchSignTag, exit_branch_sign},
+       {kTowardSignTag, exit_toward_sign}, {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2172,15 +2144,11 @@ std::string NarrativeBuilder::FormVerbalExitInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kBranchSignTag, exit_branch_sign);
-  boost::replace_all(instruction, kTowardSignTag, exit_toward_sign);
-  boost::replace_all(instruction, kNameSignTag, exit_name_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.exit_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir}, {kNumberSignTag, exit_number_sign},
+       {kBranchSignTag, exit_branch_sign}, {kTowardSignTag, exit_toward_sign},
+       {kNameSignTag, exit_name_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2261,16 +2229,12 @@ std::string NarrativeBuilder::FormKeepInstruction(Maneuver& maneuver,
     phrase_id += 4;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(),
-                                                dictionary_.keep_subset.relative_directions));
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.keep_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_subset.relative_directions)},
+       {kNumberSignTag, exit_number_sign}, {kStreetNamesTag, street_names},
+       {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2452,14 +2416,10 @@ std::string NarrativeBuilder::FormVerbalKeepInstruction(uint8_t phrase_id,
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.keep_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir}, {kNumberSignTag, exit_number_sign},
+       {kStreetNamesTag, street_names}, {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2511,16 +2471,13 @@ std::string NarrativeBuilder::FormKeepToStayOnInstruction(Maneuver& maneuver,
     phrase_id += 2;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeThreeDirection(maneuver.type(), dictionary_.keep_to_stay_on_subset
-                                                                     .relative_directions));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.keep_to_stay_on_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeThreeDirection(maneuver.type(),
+                                   dictionary_.keep_to_stay_on_subset.relative_directions)},
+       {kStreetNamesTag, street_names}, {kNumberSignTag, exit_number_sign},
+       {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2610,14 +2567,10 @@ std::string NarrativeBuilder::FormVerbalKeepToStayOnInstruction(uint8_t phrase_i
   std::string instruction;
   instruction.reserve(kInstructionInitialCapacity);
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.keep_to_stay_on_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_dir);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kNumberSignTag, exit_number_sign);
-  boost::replace_all(instruction, kTowardSignTag, toward_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.keep_to_stay_on_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_dir}, {kStreetNamesTag, street_names},
+       {kNumberSignTag, exit_number_sign}, {kTowardSignTag, toward_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2668,13 +2621,10 @@ std::string NarrativeBuilder::FormMergeInstruction(Maneuver& maneuver,
         FormRelativeTwoDirection(maneuver.type(), dictionary_.merge_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.merge_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction}, {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2743,13 +2693,10 @@ std::string NarrativeBuilder::FormVerbalMergeInstruction(Maneuver& maneuver,
                                  dictionary_.merge_verbal_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.merge_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction}, {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -2866,16 +2813,11 @@ std::string NarrativeBuilder::FormEnterRoundaboutInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.enter_roundabout_subset.templates.at(phrase_id).Fill(
+      {{kOrdinalValueTag, ordinal_value}, {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign}, {kRoundaboutExitStreetNamesTag, roundabout_exit_street_names},
+       {kRoundaboutExitBeginStreetNamesTag, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3018,16 +2960,11 @@ std::string NarrativeBuilder::FormVerbalEnterRoundaboutInstruction(Maneuver& man
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
-  boost::replace_all(instruction, kRoundaboutExitStreetNamesTag, roundabout_exit_street_names);
-  boost::replace_all(instruction, kRoundaboutExitBeginStreetNamesTag,
-                     roundabout_exit_begin_street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.enter_roundabout_verbal_subset.templates.at(phrase_id).Fill(
+      {{kOrdinalValueTag, ordinal_value}, {kStreetNamesTag, street_names},
+       {kTowardSignTag, guide_sign}, {kRoundaboutExitStreetNamesTag, roundabout_exit_street_names},
+       {kRoundaboutExitBeginStreetNamesTag, roundabout_exit_begin_street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3081,13 +3018,10 @@ std::string NarrativeBuilder::FormExitRoundaboutInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.exit_roundabout_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}, {kBeginStreetNamesTag, begin_street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3145,13 +3079,10 @@ std::string NarrativeBuilder::FormVerbalExitRoundaboutInstruction(Maneuver& mane
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kBeginStreetNamesTag, begin_street_names);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.exit_roundabout_verbal_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}, {kBeginStreetNamesTag, begin_street_names},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3195,13 +3126,10 @@ std::string NarrativeBuilder::FormEnterFerryInstruction(Maneuver& maneuver,
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.enter_ferry_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}, {kFerryLabelTag, ferry_label},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3262,13 +3190,10 @@ std::string NarrativeBuilder::FormVerbalEnterFerryInstruction(Maneuver& maneuver
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_ferry_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
-  boost::replace_all(instruction, kFerryLabelTag, ferry_label);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.enter_ferry_verbal_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}, {kFerryLabelTag, ferry_label},
+       {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3301,12 +3226,9 @@ std::string NarrativeBuilder::FormTransitConnectionStartInstruction(Maneuver& ma
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_start_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_connection_start_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop}, {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3339,13 +3261,9 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionStartInstruction(Maneuv
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_connection_start_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop}, {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3378,12 +3296,9 @@ std::string NarrativeBuilder::FormTransitConnectionTransferInstruction(Maneuver&
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_connection_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_connection_transfer_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop}, {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3416,13 +3331,9 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionTransferInstruction(Man
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_connection_transfer_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop}, {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3455,13 +3366,9 @@ std::string NarrativeBuilder::FormTransitConnectionDestinationInstruction(Maneuv
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_connection_destination_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop}, {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3494,13 +3401,9 @@ std::string NarrativeBuilder::FormVerbalTransitConnectionDestinationInstruction(
     }
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.transit_connection_destination_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop);
-  boost::replace_all(instruction, kStationLabelTag, station_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_connection_destination_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop}, {kStationLabelTag, station_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3523,13 +3426,10 @@ std::string NarrativeBuilder::FormDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.depart_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag, get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3552,13 +3452,10 @@ std::string NarrativeBuilder::FormVerbalDepartInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.depart_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.depart_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag, get_localized_time(maneuver.GetTransitDepartureTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3581,13 +3478,10 @@ std::string NarrativeBuilder::FormArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.arrive_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag, get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3610,13 +3504,10 @@ std::string NarrativeBuilder::FormVerbalArriveInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.arrive_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformTag, transit_stop_name);
-  boost::replace_all(instruction, kTimeTag,
-                     get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale()));
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.arrive_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformTag, transit_stop_name},
+       {kTimeTag, get_localized_time(maneuver.GetTransitArrivalTime(), dictionary_.GetLocale())}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3643,16 +3534,13 @@ std::string NarrativeBuilder::FormTransitInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_subset.templates.at(phrase_id).Fill(
+      {{kTransitNameTag, FormTransitName(maneuver,
+                                         dictionary_.transit_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign},
+       {kTransitPlatformCountTag, std::to_string(stop_count)}, // TODO: locale specific numerals
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3675,14 +3563,11 @@ std::string NarrativeBuilder::FormVerbalTransitInstruction(Maneuver& maneuver) {
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_verbal_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver, dictionary_.transit_verbal_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3710,17 +3595,13 @@ std::string NarrativeBuilder::FormTransitRemainOnInstruction(Maneuver& maneuver)
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_remain_on_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_remain_on_subset.templates.at(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver, dictionary_.transit_remain_on_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign},
+       {kTransitPlatformCountTag, std::to_string(stop_count)}, // TODO: locale specific numerals
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3743,14 +3624,12 @@ std::string NarrativeBuilder::FormVerbalTransitRemainOnInstruction(Maneuver& man
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_remain_on_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_remain_on_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_remain_on_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver,
+                        dictionary_.transit_remain_on_verbal_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3778,17 +3657,13 @@ std::string NarrativeBuilder::FormTransitTransferInstruction(Maneuver& maneuver)
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver,
-                                     dictionary_.transit_transfer_subset.empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_transfer_subset.templates.at(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver, dictionary_.transit_transfer_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign},
+       {kTransitPlatformCountTag, std::to_string(stop_count)}, // TODO: locale specific numerals
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3811,14 +3686,12 @@ std::string NarrativeBuilder::FormVerbalTransitTransferInstruction(Maneuver& man
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.transit_transfer_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitNameTag,
-                     FormTransitName(maneuver, dictionary_.transit_transfer_verbal_subset
-                                                   .empty_transit_name_labels));
-  boost::replace_all(instruction, kTransitHeadSignTag, transit_headsign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.transit_transfer_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitNameTag,
+        FormTransitName(maneuver,
+                        dictionary_.transit_transfer_verbal_subset.empty_transit_name_labels)},
+       {kTransitHeadSignTag, transit_headsign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3859,14 +3732,11 @@ std::string NarrativeBuilder::FormVerbalPostTransitionInstruction(Maneuver& mane
     phrase_id = 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.post_transition_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.post_transition_verbal_subset.templates.at(phrase_id).Fill(
+      {{kLengthTag, FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
+                               dictionary_.post_transition_verbal_subset.us_customary_lengths)},
+       {kStreetNamesTag, street_names}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3887,14 +3757,10 @@ std::string NarrativeBuilder::FormVerbalPostTransitionTransitInstruction(Maneuve
       FormTransitPlatformCountLabel(stop_count, dictionary_.post_transition_transit_verbal_subset
                                                     .transit_stop_count_labels);
 
-  // Set instruction to the determined tagged phrase
-  instruction =
-      dictionary_.post_transition_transit_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kTransitPlatformCountTag,
-                     std::to_string(stop_count)); // TODO: locale specific numerals
-  boost::replace_all(instruction, kTransitPlatformCountLabelTag, stop_count_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.post_transition_transit_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTransitPlatformCountTag, std::to_string(stop_count)}, // TODO: locale specific numerals
+       {kTransitPlatformCountLabelTag, stop_count_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -3938,14 +3804,11 @@ std::string NarrativeBuilder::FormVerbalSuccinctStartTransitionInstruction(Maneu
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.start_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCardinalDirectionTag, cardinal_direction);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
-                                dictionary_.start_verbal_subset.us_customary_lengths));
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.start_verbal_subset.templates.at(phrase_id).Fill(
+      {{kCardinalDirectionTag, cardinal_direction},
+       {kLengthTag, FormLength(maneuver, dictionary_.start_verbal_subset.metric_lengths,
+                               dictionary_.start_verbal_subset.us_customary_lengths)}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4004,14 +3867,11 @@ NarrativeBuilder::FormVerbalSuccinctTurnTransitionInstruction(Maneuver& maneuver
                                                maneuver.verbal_formatter(), &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = subset->phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(), subset->relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = subset->templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(), subset->relative_directions)},
+       {kJunctionNameTag, junction_name}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4050,15 +3910,12 @@ NarrativeBuilder::FormVerbalSuccinctUturnTransitionInstruction(Maneuver& maneuve
         maneuver.signs().GetJunctionNameString(element_max_count, limit_by_consecutive_count, delim,
                                                maneuver.verbal_formatter(), &markup_formatter_);
   }
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.uturn_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag,
-                     FormRelativeTwoDirection(maneuver.type(),
-                                              dictionary_.uturn_verbal_subset.relative_directions));
-  boost::replace_all(instruction, kJunctionNameTag, junction_name);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.uturn_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag,
+        FormRelativeTwoDirection(maneuver.type(),
+                                 dictionary_.uturn_verbal_subset.relative_directions)},
+       {kJunctionNameTag, junction_name}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4102,12 +3959,9 @@ NarrativeBuilder::FormVerbalSuccinctMergeTransitionInstruction(Maneuver& maneuve
                                  dictionary_.merge_verbal_subset.relative_directions);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.merge_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kRelativeDirectionTag, relative_direction);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.merge_verbal_subset.templates.at(phrase_id).Fill(
+      {{kRelativeDirectionTag, relative_direction}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4150,12 +4004,9 @@ std::string NarrativeBuilder::FormVerbalSuccinctEnterRoundaboutTransitionInstruc
                                                         &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kOrdinalValueTag, ordinal_value);
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.enter_roundabout_verbal_subset.templates.at(phrase_id).Fill(
+      {{kOrdinalValueTag, ordinal_value}, {kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4186,10 +4037,9 @@ std::string NarrativeBuilder::FormVerbalSuccinctExitRoundaboutTransitionInstruct
                                                  maneuver.verbal_formatter(), &markup_formatter_);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_roundabout_verbal_subset.phrases.at(std::to_string(phrase_id));
-
-  boost::replace_all(instruction, kTowardSignTag, guide_sign);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.exit_roundabout_verbal_subset.templates.at(phrase_id).Fill(
+      {{kTowardSignTag, guide_sign}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4215,11 +4065,8 @@ std::string NarrativeBuilder::FormElevatorInstruction(Maneuver& maneuver) {
     end_level = maneuver.end_level_ref();
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.elevator_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.elevator_subset.templates.at(phrase_id).Fill({{kLevelTag, end_level}});
 
   return instruction;
 }
@@ -4240,11 +4087,8 @@ std::string NarrativeBuilder::FormStepsInstruction(Maneuver& maneuver) {
     end_level = maneuver.end_level_ref();
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.steps_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.steps_subset.templates.at(phrase_id).Fill({{kLevelTag, end_level}});
 
   return instruction;
 }
@@ -4265,11 +4109,8 @@ std::string NarrativeBuilder::FormEscalatorInstruction(Maneuver& maneuver) {
     end_level = maneuver.end_level_ref();
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.escalator_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kLevelTag, end_level);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.escalator_subset.templates.at(phrase_id).Fill({{kLevelTag, end_level}});
 
   return instruction;
 }
@@ -4292,11 +4133,9 @@ std::string NarrativeBuilder::FormEnterBuildingInstruction(Maneuver& maneuver) {
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.enter_building_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.enter_building_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}});
 
   return instruction;
 }
@@ -4319,11 +4158,9 @@ std::string NarrativeBuilder::FormExitBuildingInstruction(Maneuver& maneuver) {
     phrase_id += 1;
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.exit_building_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kStreetNamesTag, street_names);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.exit_building_subset.templates.at(phrase_id).Fill(
+      {{kStreetNamesTag, street_names}});
 
   return instruction;
 }
@@ -4372,11 +4209,9 @@ std::string NarrativeBuilder::FormPassInstruction(Maneuver& maneuver) {
       object_label = dictionary_.pass_subset.object_labels.at(dictionary_object_index);
   }
 
-  // Set instruction to the determined tagged phrase
-  instruction = dictionary_.pass_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kObjectLabelTag, object_label);
+  // Set instruction to the determined phrase with its tags filled in
+  instruction = dictionary_.pass_subset.templates.at(phrase_id).Fill(
+      {{kObjectLabelTag, object_label}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
@@ -4804,14 +4639,10 @@ std::string NarrativeBuilder::FormVerbalMultiCue(Maneuver& maneuver,
   if (maneuver.distant_verbal_multi_cue()) {
     phrase_id = 1;
   }
-  instruction = dictionary_.verbal_multi_cue_subset.phrases.at(std::to_string(phrase_id));
-
-  // Replace phrase tags with values
-  boost::replace_all(instruction, kCurrentVerbalCueTag, first_verbal_cue);
-  boost::replace_all(instruction, kNextVerbalCueTag, second_verbal_cue);
-  boost::replace_all(instruction, kLengthTag,
-                     FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
-                                dictionary_.post_transition_verbal_subset.us_customary_lengths));
+  instruction = dictionary_.verbal_multi_cue_subset.templates.at(phrase_id).Fill(
+      {{kCurrentVerbalCueTag, first_verbal_cue}, {kNextVerbalCueTag, second_verbal_cue},
+       {kLengthTag, FormLength(maneuver, dictionary_.post_transition_verbal_subset.metric_lengths,
+                               dictionary_.post_transition_verbal_subset.us_customary_lengths)}});
 
   // If enabled, form articulated prepositions
   if (articulated_preposition_enabled_) {
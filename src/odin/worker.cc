@@ -1,14 +1,17 @@
 #include "odin/worker.h"
+#include "admission_controller.h"
 #include "baldr/json.h"
 #include "midgard/logging.h"
 #include "midgard/util.h"
 #include "odin/directionsbuilder.h"
 #include "odin/util.h"
 #include "proto/trip.pb.h"
+#include "proto_conversions.h"
 #include "tyr/serializers.h"
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <chrono>
 #include <functional>
 #include <string>
 
@@ -21,7 +24,8 @@ namespace valhalla {
 namespace odin {
 
 odin_worker_t::odin_worker_t(const boost::property_tree::ptree& config)
-    : service_worker_t(config), markup_formatter_(config) {
+    : service_worker_t(config), markup_formatter_(config),
+      narrative_pool_(config.get<uint32_t>("odin.narrative_concurrency", 1)) {
   // signal that the worker started successfully
   started();
 }
@@ -35,11 +39,21 @@ std::string odin_worker_t::narrate(Api& request) const {
 
   // get some annotated directions
   try {
-    odin::DirectionsBuilder().Build(request, markup_formatter_);
+    odin::DirectionsBuilder().Build(request, markup_formatter_, &narrative_pool_);
   } catch (...) { throw valhalla_exception_t{202}; }
 
-  // serialize those to the proper format
-  return tyr::serializeDirections(request);
+  // serialize those to the proper format, keeping track of how long that took on its own. pbf
+  // serialization can clear the options so the key has to be made up front
+  auto key = Options_Action_Enum_Name(request.options().action()) + ".info." + service_name() +
+             ".serialize_ms";
+  auto start = std::chrono::steady_clock::now();
+  auto response = tyr::serializeDirections(request);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto* stat = request.mutable_info()->mutable_statistics()->Add();
+  stat->set_key(key);
+  stat->set_value(std::chrono::duration<double, std::milli>(elapsed).count());
+  stat->set_type(timing);
+  return response;
 }
 
 void odin_worker_t::status(Api&) const {
@@ -60,7 +74,11 @@ odin_worker_t::work(const std::list<zmq::message_t>& job,
                     const std::function<void()>& interrupt_function) {
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Odin Request " + std::to_string(info.id));
-  Api request;
+  // the request lives on an arena which reuses the memory of this worker from request to request
+  google::protobuf::Arena arena(request_arena_options());
+  Api& request = *google::protobuf::Arena::CreateMessage<Api>(&arena);
+  // gives back the slot of a heavy request however we leave, unless it goes on to the next stage
+  admission_guard_t admission_guard(admission, request);
   prime_server::worker_t::result_t result{false, {}, {}};
   try {
     // Set the interrupt function
@@ -84,6 +102,7 @@ odin_worker_t::work(const std::list<zmq::message_t>& job,
       default: {
         // narrate them and serialize them along
         auto response = narrate(request);
+        cache_result(request, response);
         result = to_response(response, info, request);
         break;
       }
@@ -93,6 +112,7 @@ odin_worker_t::work(const std::list<zmq::message_t>& job,
   }
 
   // keep track of the metrics if the request is going back to the client (this should be the case)
+  admission_guard.hand_on(result.intermediate);
   if (!result.intermediate)
     enqueue_statistics(request);
 
@@ -100,9 +100,18 @@ public:
     return rv;
   }
 
-  bool unpack(const char* unpacked) {
+  // swaps in the buffer the tile was unpacked into, or marks the tile corrupt if that failed. only
+  // called with the cache mutex held since other threads read the format and buffer under it
+  inline void publish(const char* unpacked, bool ok) {
     this->unpacked = unpacked;
+    if (!ok) {
+      format = format_t::UNKNOWN;
+    }
+  }
 
+  // decompresses the mapped tile into dst. it only reads the item so that it can run without the
+  // cache mutex, the result is published afterwards with publish()
+  bool unpack(char* dst) const {
     if (format == format_t::GZIP) {
       // for setting where to read compressed data from
       auto src_func = [this](z_stream& s) -> void {
@@ -111,8 +120,8 @@ public:
       };
 
       // for setting where to write the uncompressed data to
-      auto dst_func = [this](z_stream& s) -> int {
-        s.next_out = (Byte*)(this->unpacked);
+      auto dst_func = [dst](z_stream& s) -> int {
+        s.next_out = (Byte*)dst;
         s.avail_out = HGT_BYTES;
         return Z_FINISH; // we know the output will hold all the input
       };
@@ -120,7 +129,6 @@ public:
       // we have to unzip it
       if (!baldr::inflate(src_func, dst_func)) {
         LOG_WARN("Corrupt gzip elevation data");
-        format = format_t::UNKNOWN;
         return false;
       }
     } else if (format == format_t::LZ4) {
@@ -134,12 +142,10 @@ public:
       size_t result;
 
       do {
-        result = LZ4F_decompress(decode, const_cast<char*>(this->unpacked), &dest_size, data.get(),
-                                 &src_size, &options);
+        result = LZ4F_decompress(decode, dst, &dest_size, data.get(), &src_size, &options);
         if (LZ4F_isError(result)) {
           LZ4F_freeDecompressionContext(decode);
           LOG_WARN("Corrupt lz4 elevation data");
-          format = format_t::UNKNOWN;
           return false;
         }
       } while (result != 0);
@@ -147,7 +153,6 @@ public:
       LZ4F_freeDecompressionContext(decode);
     } else {
       LOG_WARN("Corrupt elevation data of unknown type");
-      format = format_t::UNKNOWN;
       return false;
     }
 
@@ -323,8 +328,11 @@ tile_data cache_t::source(uint16_t index) {
     return {};
   }
 
-  // if we don't have anything maybe it's lazy loaded
+  // init can throw when mapping the file so the lock is only ever released through this guard
   auto& item = cache[index];
+  std::unique_lock<std::recursive_mutex> lock(mutex);
+
+  // if we don't have anything maybe it's lazy loaded
   if (item.get_data() == nullptr) {
     auto f = data_source + get_hgt_file_name(index);
     item.init(f, format_t::RAW);
@@ -332,20 +340,23 @@ tile_data cache_t::source(uint16_t index) {
 
   // it wasn't in cache and when we tried to load it the file was of unknown type
   if (item.get_format() == format_t::UNKNOWN) {
+    lock.unlock();
     return {};
   }
 
   // we have it raw or we don't
   if (item.get_format() == format_t::RAW) {
-    return {this, index, false, (const int16_t*)item.get_data()};
+    auto data = (const int16_t*)item.get_data();
+    lock.unlock();
+    return {this, index, false, data};
   }
 
-  // we were able to load it but the format wasn't RAW, which only leaves compressed formats
-  mutex.lock();
+  // we were able to load it but the format wasn't RAW, which only leaves compressed formats. other
+  // threads keep sampling tiles that are already unpacked while this one is being unpacked
   auto it = pending_tiles.find(index);
   if (it != pending_tiles.end()) {
     auto future = it->second;
-    mutex.unlock();
+    lock.unlock();
     return future.get();
   }
 
@@ -353,7 +364,7 @@ tile_data cache_t::source(uint16_t index) {
   const char* unpacked = item.get_unpacked();
   if (unpacked) {
     auto rv = tile_data(this, index, true, (const int16_t*)unpacked);
-    mutex.unlock();
+    lock.unlock();
     return rv;
   }
 
@@ -374,16 +385,20 @@ tile_data cache_t::source(uint16_t index) {
   }
   reusable.insert(index);
   auto rv = tile_data(this, index, true, (const int16_t*)unpacked);
-  mutex.unlock();
+  lock.unlock();
+
+  // nothing writes the item while it is pending so it can be unpacked without the lock, but the
+  // outcome has to be published under it since other threads check the format and buffer under it
+  bool ok = item.unpack(const_cast<char*>(unpacked));
 
-  if (!item.unpack(unpacked)) {
+  lock.lock();
+  item.publish(unpacked, ok);
+  if (!ok) {
     rv = tile_data();
   }
-
-  mutex.lock();
   promise.set_value(rv);
   pending_tiles.erase(it);
-  mutex.unlock();
+  lock.unlock();
   return rv;
 }
 
@@ -443,10 +458,7 @@ template <class coord_t> double sample::get(const coord_t& coord, tile_data& til
 
   // the caller can pass a cached tile, so we only fetch one if its not the one they already have
   if (index != tile.get_index()) {
-    {
-      std::lock_guard<std::mutex> _(cache_lck);
-      tile = cache_->source(index);
-    }
+    tile = cache_->source(index);
     if (!tile) {
       if (!fetch(index))
         return get_no_data_value();
@@ -501,7 +513,6 @@ bool sample::store(const std::string& elev, const std::vector<char>& raw_data) {
   if (!filesystem::save(fpath, raw_data))
     return false;
 
-  std::lock_guard<std::mutex> _(cache_lck);
   return cache_->insert(data->first, fpath, data->second);
 }
 
@@ -538,7 +549,6 @@ template <class coord_t> uint16_t sample::get_tile_index(const coord_t& coord) {
 }
 
 void sample::add_single_tile(const std::string& path) {
-  std::lock_guard<std::mutex> _(cache_lck);
   cache_->insert(0, path, format_t::RAW);
 }
 
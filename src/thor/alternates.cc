@@ -1,5 +1,7 @@
 #include "thor/alternates.h"
 
+#include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 using namespace valhalla::thor;
@@ -18,8 +20,8 @@ float kAtMostLonger = 1.25f; // stretch threshold
 // Alternative route shouldn't contain unreasonable detours. We should skip an alternative
 // if it has a detour longer than 2 x cost of the corresponding path in the optimal route.
 float kAtMostLongerDetour = 2.f;
-float kAtMostShared = 0.75f; // sharing threshold
-// float kAtLeastOptimal = 0.2f; // local optimality threshold
+float kAtMostShared = 0.75f;  // sharing threshold
+float kAtLeastOptimal = 0.2f; // local optimality threshold
 } // namespace
 
 namespace valhalla {
@@ -75,6 +77,28 @@ void filter_alternates_by_stretch(std::vector<CandidateConnection>& connections)
   connections.erase(new_end, connections.end());
 }
 
+// Plateau filter. Connections that lie on the same plateau meet on the same via path, so only the
+// cheapest one per plateau is kept, the others are rejected. Local optimality only ranks what is
+// left: the locally optimal alternates are moved ahead of the others, which stay as fallbacks in
+// case the stretch and sharing checks turn down the former. Expects connections sorted by cost with
+// their plateaus found.
+void filter_alternates_by_plateau(std::vector<CandidateConnection>& connections) {
+  std::unordered_set<GraphId> plateaus;
+  auto new_end = std::remove_if(connections.begin(), connections.end(),
+                                [&plateaus](const CandidateConnection& connection) {
+                                  return !plateaus.insert(connection.plateau_start).second;
+                                });
+  connections.erase(new_end, connections.end());
+  if (connections.size() < 3)
+    return;
+
+  const float optimal_cost = connections.front().cost;
+  std::stable_partition(connections.begin() + 1, connections.end(),
+                        [optimal_cost](const CandidateConnection& connection) {
+                          return validate_alternate_by_local_optimality(connection, optimal_cost);
+                        });
+}
+
 // get a cost of a path between indexes 'first' and 'last'
 inline sif::Cost get_segment_cost(const std::vector<PathInfo>& path, size_t first, size_t last) {
   auto cost = path[last].elapsed_cost - path[first].transition_cost;
@@ -191,9 +215,12 @@ bool validate_alternate_by_sharing(std::vector<std::unordered_set<GraphId>>& sha
   return true;
 }
 
-bool validate_alternate_by_local_optimality(const std::vector<PathInfo>&) {
-  // [TODO] NOT IMPLEMENTED
-  return true;
+// Local optimality. A via path is T-locally optimal if every subpath of cost at most T is a shortest
+// path. Every subpath of a plateau is a shortest path in both search trees, so a plateau costing at
+// least T (a fraction of the optimal cost) is a cheap sufficient test for it.
+bool validate_alternate_by_local_optimality(const CandidateConnection& candidate,
+                                            float optimal_cost) {
+  return candidate.plateau_cost >= kAtLeastOptimal * optimal_cost;
 }
 } // namespace thor
 } // namespace valhalla
@@ -0,0 +1,95 @@
+#include "thor/astarheuristic.h"
+
+using namespace valhalla::baldr;
+
+namespace valhalla {
+namespace thor {
+
+// Find the range of landmark distances around the target so we can bound the distance to it
+void AStarHeuristic::InitLandmarks(const std::shared_ptr<AltLandmarks>& landmarks,
+                                   GraphReader& reader,
+                                   const valhalla::Location& target) {
+  landmarks_.reset();
+  target_bounds_.clear();
+  reader_ = nullptr;
+  ClearAltTiles();
+  if (!landmarks) {
+    return;
+  }
+
+  // Any path to the target goes through one of the nodes at the ends of its edges
+  std::vector<std::pair<uint32_t, uint32_t>> bounds;
+  std::vector<bool> reached;
+  for (const auto& edge : target.correlation().edges()) {
+    GraphId edge_id(edge.graph_id());
+    graph_tile_ptr tile;
+    for (const auto& node :
+         {reader.edge_startnode(edge_id, tile), reader.edge_endnode(edge_id, tile)}) {
+      auto alt_tile = node.Is_Valid() ? landmarks->GetTile(reader.GetGraphTile(node)) : nullptr;
+      if (!alt_tile || node.id() >= alt_tile->node_count()) {
+        return;
+      }
+
+      if (bounds.empty()) {
+        bounds.resize(alt_tile->landmark_count(), {kInvalidAltDistance, 0});
+        reached.resize(alt_tile->landmark_count(), true);
+      }
+      for (uint32_t i = 0; i < std::min<size_t>(bounds.size(), alt_tile->landmark_count()); ++i) {
+        auto distance = alt_tile->distance(i, node.id());
+        reached[i] = reached[i] && distance != kInvalidAltDistance;
+        bounds[i].first = std::min(bounds[i].first, distance);
+        bounds[i].second = std::max(bounds[i].second, distance);
+      }
+    }
+  }
+
+  // A landmark which does not reach every node around the target cannot bound the distance to it
+  for (size_t i = 0; i < bounds.size(); ++i) {
+    if (!reached[i]) {
+      bounds[i] = {kInvalidAltDistance, 0};
+    }
+  }
+
+  landmarks_ = landmarks;
+  target_bounds_ = std::move(bounds);
+  reader_ = &reader;
+}
+
+// The triangle inequality gives |d(L, target) - d(L, node)| <= d(node, target) for every landmark L
+float AStarHeuristic::LandmarkDistance(const GraphId& node) const {
+  const AltTile* alt_tile = nullptr;
+  const auto tile_id = node.Tile_Base();
+  auto recent = std::find_if(recent_alt_tiles_.begin(), recent_alt_tiles_.end(),
+                             [&tile_id](const auto& entry) { return entry.first == tile_id; });
+  if (recent != recent_alt_tiles_.end()) {
+    alt_tile = recent->second.get();
+  } else {
+    // replace the tiles round robin, the oldest one is the least likely to be needed again
+    auto& entry = recent_alt_tiles_[next_alt_tile_];
+    next_alt_tile_ = (next_alt_tile_ + 1) % kRecentAltTiles;
+    entry = {tile_id, landmarks_->GetTile(reader_->GetGraphTile(node))};
+    alt_tile = entry.second.get();
+  }
+  if (!alt_tile || node.id() >= alt_tile->node_count()) {
+    return 0.0f;
+  }
+
+  uint32_t bound = 0;
+  const auto count = std::min<size_t>(target_bounds_.size(), alt_tile->landmark_count());
+  for (uint32_t i = 0; i < count; ++i) {
+    const auto& target = target_bounds_[i];
+    auto distance = alt_tile->distance(i, node.id());
+    if (target.first > target.second || distance == kInvalidAltDistance) {
+      continue;
+    }
+    if (distance < target.first) {
+      bound = std::max(bound, target.first - distance);
+    } else if (distance > target.second) {
+      bound = std::max(bound, distance - target.second);
+    }
+  }
+  return static_cast<float>(bound);
+}
+
+} // namespace thor
+} // namespace valhalla
@@ -34,6 +34,9 @@ constexpr float kAlternativeCostExtend = 1.2f;
 // may lead to a significant increase in the number of iterations (~time). So, we should limit
 // iterations in order no to drop performance too much.
 constexpr uint32_t kAlternativeIterationsDelta = 100000;
+// Minimum number of candidate connections handed to each thread when finding plateaus. Below
+// this the cost of handing them to another thread outweighs the tree walks.
+constexpr size_t kMinPlateausPerThread = 256;
 
 inline float find_percent_along(const valhalla::Location& location, const GraphId& edge_id) {
   for (const auto& e : location.correlation().edges()) {
@@ -53,6 +56,8 @@ BidirectionalAStar::BidirectionalAStar(const boost::property_tree::ptree& config
     : PathAlgorithm(config.get<uint32_t>("max_reserved_labels_count_bidir_astar",
                                          kInitialEdgeLabelCountBidirAstar),
                     config.get<bool>("clear_reserved_memory", false)),
+      alternates_concurrency_(config.get<uint32_t>("alternates_concurrency", 1)),
+      alternates_pool_(alternates_concurrency_),
       extended_search_(config.get<bool>("extended_search", false)) {
   cost_threshold_ = 0;
   iterations_threshold_ = 0;
@@ -64,6 +69,7 @@ BidirectionalAStar::BidirectionalAStar(const boost::property_tree::ptree& config
   pruning_disabled_at_origin_ = false;
   pruning_disabled_at_destination_ = false;
   ignore_hierarchy_limits_ = false;
+  reuse_reverse_tree_ = false;
 }
 
 // Destructor
@@ -97,6 +103,19 @@ void BidirectionalAStar::Clear() {
   pruning_disabled_at_origin_ = false;
   pruning_disabled_at_destination_ = false;
   ignore_hierarchy_limits_ = false;
+  // Drop any reverse tree that was provided but not used
+  reverse_tree_.reset();
+  reuse_reverse_tree_ = false;
+}
+
+// Hand over the reverse search tree so it can be reused by a later search
+std::unique_ptr<ReverseSearchTree> BidirectionalAStar::ReleaseReverseTree() {
+  auto tree = std::make_unique<ReverseSearchTree>();
+  tree->edgelabels = std::move(edgelabels_reverse_);
+  tree->edgestatus = std::move(edgestatus_reverse_);
+  edgelabels_reverse_.clear();
+  adjacencylist_reverse_.clear();
+  return tree;
 }
 
 // Initialize the A* heuristic and adjacency lists for both the forward
@@ -307,9 +326,11 @@ inline bool BidirectionalAStar::ExpandInner(baldr::GraphReader& graphreader,
   // end node of the directed edge.
   float dist = 0.0f;
   float sortcost =
-      newcost.cost + (FORWARD
-                          ? astarheuristic_forward_.Get(t2->get_node_ll(meta.edge->endnode()), dist)
-                          : astarheuristic_reverse_.Get(t2->get_node_ll(meta.edge->endnode()), dist));
+      newcost.cost +
+      (FORWARD ? astarheuristic_forward_.Get(t2->get_node_ll(meta.edge->endnode()),
+                                             meta.edge->endnode(), dist)
+               : astarheuristic_reverse_.Get(t2->get_node_ll(meta.edge->endnode()),
+                                             meta.edge->endnode(), dist));
 
   // not_thru_pruning_ is only set to false on the 2nd pass in route_action.
   // We allow settling not_thru edges so we can connect both trees on them.
@@ -516,6 +537,18 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
   PointLL destination_new(destination.correlation().edges(0).ll().lng(),
                           destination.correlation().edges(0).ll().lat());
   Init(origin_new, destination_new);
+  astarheuristic_forward_.InitLandmarks(landmarks_, graphreader, destination);
+  astarheuristic_reverse_.InitLandmarks(landmarks_, graphreader, origin);
+
+  // Connect into the reverse tree of an earlier search if we were given one. It is complete as far
+  // as it goes, so there is no reverse search to balance against.
+  reuse_reverse_tree_ = reverse_tree_ != nullptr && desired_paths_count_ == 1;
+  if (reuse_reverse_tree_) {
+    edgelabels_reverse_ = std::move(reverse_tree_->edgelabels);
+    edgestatus_reverse_ = std::move(reverse_tree_->edgestatus);
+    cost_diff_ = 0.0f;
+  }
+  reverse_tree_.reset();
 
   // we use a non varying time for all time dependent routes until we can figure out how to vary the
   // time during the path computation in the bidirectional algorithm
@@ -542,7 +575,9 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
   // heuristics to one of them alternate paths using the other correlated
   // points to may be harder to find
   SetOrigin(graphreader, origin, forward_time_info);
-  SetDestination(graphreader, destination, reverse_time_info);
+  if (!reuse_reverse_tree_) {
+    SetDestination(graphreader, destination, reverse_time_info);
+  }
 
   // Find shortest path. Switch between a forward direction and a reverse
   // direction search based on the current costs. Alternating like this
@@ -550,10 +585,11 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
   // portion of the graph) rather than strictly alternating.
   // TODO - CostMatrix alternates, maybe should try alternating here?
   int n = 0;
-  uint32_t forward_pred_idx{0}, reverse_pred_idx{0};
+  // When reusing a reverse tree the reverse search is treated as exhausted from the start
+  uint32_t forward_pred_idx{0}, reverse_pred_idx{reuse_reverse_tree_ ? kInvalidLabel : 0};
   BDEdgeLabel fwd_pred, rev_pred;
   bool expand_forward = true;
-  bool expand_reverse = true;
+  bool expand_reverse = !reuse_reverse_tree_;
   while (true) {
     // Allow this process to be aborted
     if (interrupt && (++n % kInterruptIterationsInterval) == 0) {
@@ -573,6 +609,7 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
 
         // Forward path to this edge can't be improved, so we can settle it right now.
         edgestatus_forward_.Update(fwd_pred.edgeid(), EdgeSet::kPermanent);
+        ++settled_edges_;
 
         // Terminate if the cost threshold has been exceeded.
         if (fwd_pred.sortcost() + cost_diff_ > cost_threshold_) {
@@ -622,6 +659,7 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
 
         // Reverse path to this edge can't be improved, so we can settle it right now.
         edgestatus_reverse_.Update(rev_pred.edgeid(), EdgeSet::kPermanent);
+        ++settled_edges_;
 
         // Terminate if the cost threshold has been exceeded.
         if (rev_pred.sortcost() > cost_threshold_) {
@@ -681,7 +719,7 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
     // the origin and destination and provides valid conditions for the reach-based pruning.
     bool force_forward = false;
     bool force_reverse = false;
-    if (!ignore_hierarchy_limits_) {
+    if (!ignore_hierarchy_limits_ && !reuse_reverse_tree_) {
       for (size_t level = TileHierarchy::levels().size() - 1; level > 0; --level) {
         if (StopExpanding(hierarchy_limits_reverse_[level], rev_pred.distance()) &&
             !StopExpanding(hierarchy_limits_forward_[level], fwd_pred.distance())) {
@@ -727,7 +765,7 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
 
       // Check if this branch can be pruned. It's implementation of the reach-based pruning technique
       // for bidirectional astar: https://repub.eur.nl/pub/16100/ei2009-10.pdf .
-      if (cost_threshold_ != std::numeric_limits<float>::max() &&
+      if (!reuse_reverse_tree_ && cost_threshold_ != std::numeric_limits<float>::max() &&
           fwd_pred.predecessor() != kInvalidLabel) {
         const auto tile = graphreader.GetGraphTile(fwd_pred.endnode());
         if (tile != nullptr) {
@@ -735,7 +773,8 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
           float route_lower_bound =
               edgelabels_forward_[fwd_pred.predecessor()].cost().cost +
               fwd_pred.transition_cost().cost + rev_pred.sortcost() -
-              astarheuristic_reverse_.Get(tile->get_node_ll(fwd_pred.endnode()));
+              astarheuristic_reverse_.Get(tile->get_node_ll(fwd_pred.endnode()),
+                                          fwd_pred.endnode());
           // Prune this edge if estimated lower bound cost exceeds the cost threshold.
           if (route_lower_bound > cost_threshold_) {
             continue;
@@ -791,7 +830,8 @@ BidirectionalAStar::GetBestPath(valhalla::Location& origin,
           float route_lower_bound =
               edgelabels_reverse_[rev_pred.predecessor()].cost().cost +
               rev_pred.transition_cost().cost + fwd_pred.sortcost() -
-              astarheuristic_forward_.Get(tile->get_node_ll(rev_pred.endnode()));
+              astarheuristic_forward_.Get(tile->get_node_ll(rev_pred.endnode()),
+                                          rev_pred.endnode());
           // Prune this edge if estimated lower bound cost exceeds the cost threshold.
           if (route_lower_bound > cost_threshold_) {
             continue;
@@ -853,7 +893,11 @@ bool BidirectionalAStar::SetForwardConnection(GraphReader& graphreader, const BD
 
   // Set thresholds to extend search
   if (cost_threshold_ == std::numeric_limits<float>::max() || c < best_connections_.front().cost) {
-    if (desired_paths_count_ == 1) {
+    if (reuse_reverse_tree_) {
+      // The reverse tree is settled so the connection cost is exact, the forward search can stop
+      // as soon as it cannot find anything cheaper
+      cost_threshold_ = c;
+    } else if (desired_paths_count_ == 1) {
       cost_threshold_ = c + kThresholdDelta;
     } else {
       // For short routes it may be not enough to use just scale to extend the cost threshold.
@@ -958,6 +1002,70 @@ bool BidirectionalAStar::SetReverseConnection(GraphReader& graphreader, const BD
   return true;
 }
 
+// Find the plateau the connection lies on, i.e. the edges around it where the forward and
+// reverse trees agree on the path.
+void BidirectionalAStar::FindPlateau(CandidateConnection& connection) const {
+  // Cost of the edge itself, excluding what the search accumulated before it
+  const auto edge_cost = [](const std::vector<BDEdgeLabel>& labels, const uint32_t idx) {
+    const auto pred_idx = labels[idx].predecessor();
+    return labels[idx].cost().cost - (pred_idx == kInvalidLabel ? 0.f : labels[pred_idx].cost().cost);
+  };
+
+  uint32_t fwd_idx = edgestatus_forward_.Get(connection.edgeid).index();
+  float cost = edge_cost(edgelabels_forward_, fwd_idx);
+
+  // Walk back along the forward tree as long as the reverse tree reaches the predecessor edge
+  // from the edge we are on
+  for (auto pred_idx = edgelabels_forward_[fwd_idx].predecessor(); pred_idx != kInvalidLabel;
+       pred_idx = edgelabels_forward_[fwd_idx].predecessor()) {
+    const auto rev_status = edgestatus_reverse_.Get(edgelabels_forward_[pred_idx].opp_edgeid());
+    if (rev_status.set() == EdgeSet::kUnreachedOrReset) {
+      break;
+    }
+    const auto rev_pred_idx = edgelabels_reverse_[rev_status.index()].predecessor();
+    if (rev_pred_idx == kInvalidLabel ||
+        edgelabels_reverse_[rev_pred_idx].edgeid() != edgelabels_forward_[fwd_idx].opp_edgeid()) {
+      break;
+    }
+    cost += edge_cost(edgelabels_forward_, pred_idx);
+    fwd_idx = pred_idx;
+  }
+  connection.plateau_start = edgelabels_forward_[fwd_idx].edgeid();
+
+  // Walk ahead along the reverse tree as long as the forward tree reaches the next edge from the
+  // edge we are on
+  uint32_t rev_idx = edgestatus_reverse_.Get(connection.opp_edgeid).index();
+  for (auto next_idx = edgelabels_reverse_[rev_idx].predecessor(); next_idx != kInvalidLabel;
+       next_idx = edgelabels_reverse_[rev_idx].predecessor()) {
+    const auto fwd_status = edgestatus_forward_.Get(edgelabels_reverse_[next_idx].opp_edgeid());
+    if (fwd_status.set() == EdgeSet::kUnreachedOrReset) {
+      break;
+    }
+    const auto fwd_pred_idx = edgelabels_forward_[fwd_status.index()].predecessor();
+    if (fwd_pred_idx == kInvalidLabel ||
+        edgelabels_forward_[fwd_pred_idx].edgeid() != edgelabels_reverse_[rev_idx].opp_edgeid()) {
+      break;
+    }
+    cost += edge_cost(edgelabels_reverse_, next_idx);
+    rev_idx = next_idx;
+  }
+  connection.plateau_cost = cost;
+}
+
+// Find the plateaus of all the candidate connections. The search trees are read only at this point
+// so large candidate sets are split over the threads of the pool.
+void BidirectionalAStar::FindPlateaus() {
+  const size_t count = best_connections_.size();
+  const size_t chunks =
+      std::max<size_t>(std::min<size_t>(alternates_pool_.size(), count / kMinPlateausPerThread), 1);
+  const size_t chunk = (count + chunks - 1) / chunks;
+  alternates_pool_.run(chunks, [this, chunk, count](size_t index) {
+    for (size_t i = index * chunk; i < std::min((index + 1) * chunk, count); ++i) {
+      FindPlateau(best_connections_[i]);
+    }
+  });
+}
+
 // Add edges at the origin to the forward adjacency list.
 void BidirectionalAStar::SetOrigin(GraphReader& graphreader,
                                    valhalla::Location& origin,
@@ -1012,8 +1120,10 @@ void BidirectionalAStar::SetOrigin(GraphReader& graphreader,
     // We assume the slowest speed you could travel to cover that distance to start/end the route
     // TODO: assumes 1m/s which is a maximum penalty this could vary per costing model
     cost.cost += edge.distance();
-    float dist = astarheuristic_forward_.GetDistance(nodeinfo->latlng(endtile->header()->base_ll()));
-    float sortcost = cost.cost + astarheuristic_forward_.Get(dist);
+    float dist = 0.0f;
+    float sortcost =
+        cost.cost + astarheuristic_forward_.Get(nodeinfo->latlng(endtile->header()->base_ll()),
+                                                directededge->endnode(), dist);
 
     // Add EdgeLabel to the adjacency list. Set the predecessor edge index
     // to invalid to indicate the origin of the path.
@@ -1109,8 +1219,10 @@ void BidirectionalAStar::SetDestination(GraphReader& graphreader,
     // We assume the slowest speed you could travel to cover that distance to start/end the route
     // TODO: assumes 1m/s which is a maximum penalty this could vary per costing model
     cost.cost += edge.distance();
-    float dist = astarheuristic_reverse_.GetDistance(tile->get_node_ll(opp_dir_edge->endnode()));
-    float sortcost = cost.cost + astarheuristic_reverse_.Get(dist);
+    float dist = 0.0f;
+    float sortcost =
+        cost.cost + astarheuristic_reverse_.Get(tile->get_node_ll(opp_dir_edge->endnode()),
+                                                opp_dir_edge->endnode(), dist);
 
     // Add EdgeLabel to the adjacency list. Set the predecessor edge index
     // to invalid to indicate the origin of the path. Make sure the opposing
@@ -1163,6 +1275,10 @@ std::vector<std::vector<PathInfo>> BidirectionalAStar::FormPath(GraphReader& gra
     // Cull alternate paths longer than maximum stretch
     // TODO: we should skip adding the connection at all if it's greater than stretch
     filter_alternates_by_stretch(best_connections_);
+    // Collapse connections that are on the same plateau since they make the same path. The others
+    // are only ranked, locally optimal ones are tried first but none is rejected for not being so
+    FindPlateaus();
+    filter_alternates_by_plateau(best_connections_);
   }
   // For looking up edge ids on previously chosen best paths
   std::vector<std::unordered_set<GraphId>> shared_edgeids;
@@ -1170,7 +1286,8 @@ std::vector<std::vector<PathInfo>> BidirectionalAStar::FormPath(GraphReader& gra
   // get maximum amount of sharing parameter based on origin->destination distance
   float max_sharing = desired_paths_count_ > 1 ? get_max_sharing(origin, dest) : 0.f;
 
-  LOG_DEBUG("Connections after stretch filter: " + std::to_string(best_connections_.size()));
+  LOG_DEBUG("Connections after stretch and plateau filters: " +
+            std::to_string(best_connections_.size()));
 
 #ifdef LOGGING_LEVEL_TRACE
   LOG_TRACE("CONNECTIONS FOUND " + std::to_string(best_connections_.size()));
@@ -1323,8 +1440,7 @@ std::vector<std::vector<PathInfo>> BidirectionalAStar::FormPath(GraphReader& gra
 
     // For the first path just add it for subsequent paths only add if it passes viability tests
     if (paths.empty() || (validate_alternate_by_sharing(shared_edgeids, paths, path, max_sharing) &&
-                          validate_alternate_by_stretch(paths.front(), path) &&
-                          validate_alternate_by_local_optimality(path))) {
+                          validate_alternate_by_stretch(paths.front(), path))) {
       paths.emplace_back(std::move(path));
     }
   }
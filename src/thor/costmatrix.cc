@@ -610,6 +610,7 @@ bool CostMatrix::Expand(const uint32_t index,
     locs_status_[FORWARD][index].threshold = 0;
     return false;
   }
+  ++settled_edges_;
 
   // Get edge label and check cost threshold
   auto pred = edgelabels[pred_idx];
@@ -44,7 +44,8 @@ Dijkstras::Dijkstras(const boost::property_tree::ptree& config)
     : mode_(travel_mode_t::kDrive), access_mode_(kAutoAccess),
       max_reserved_labels_count_(config.get<uint32_t>("max_reserved_labels_count_dijkstras",
                                                       kInitialEdgeLabelCountDijkstras)),
-      clear_reserved_memory_(config.get<bool>("clear_reserved_memory", false)), multipath_(false) {
+      clear_reserved_memory_(config.get<bool>("clear_reserved_memory", false)), multipath_(false),
+      interrupt_(nullptr), settled_edges_(0) {
 }
 
 // Clear the temporary information generated during path construction.
@@ -359,6 +360,8 @@ void Dijkstras::Compute(google::protobuf::RepeatedPtrField<valhalla::Location>&
       break;
     }
 
+    Settled();
+
     // Copy the EdgeLabel for use in costing and settle the edge.
     sif::BDEdgeLabel pred = bdedgelabels_[predindex];
     edgestatus_.Update(pred.edgeid(), EdgeSet::kPermanent, pred.path_id());
@@ -747,6 +750,8 @@ void Dijkstras::ComputeMultiModal(
       break;
     }
 
+    Settled();
+
     // Copy the EdgeLabel for use in costing and settle the edge.
     MMEdgeLabel pred = mmedgelabels_[predindex];
     edgestatus_.Update(pred.edgeid(), EdgeSet::kPermanent, pred.path_id());
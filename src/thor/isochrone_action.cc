@@ -11,6 +11,7 @@ namespace thor {
 std::string thor_worker_t::isochrones(Api& request) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
+  auto budget = enforce_budget();
 
   auto& options = *request.mutable_options();
   adjust_scores(options);
@@ -37,6 +38,7 @@ std::string thor_worker_t::isochrones(Api& request) {
   auto expansion_type = costing == "multimodal" || costing == "transit"
                             ? ExpansionType::multimodal
                             : (reverse ? ExpansionType::reverse : ExpansionType::forward);
+  isochrone_gen.set_interrupt(interrupt);
   auto grid = isochrone_gen.Expand(expansion_type, request, *reader, mode_costing, mode);
 
   // e.g. in case of /expansion request
@@ -7,6 +7,8 @@
 #include "thor/worker.h"
 #include "tyr/serializers.h"
 
+#include <memory>
+
 using namespace valhalla;
 using namespace valhalla::tyr;
 using namespace valhalla::midgard;
@@ -92,6 +94,7 @@ thor_worker_t::get_matrix_algorithm(Api& request, const bool has_time, const std
 std::string thor_worker_t::matrix(Api& request) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
+  auto budget = enforce_budget();
 
   auto& options = *request.mutable_options();
   adjust_scores(options);
@@ -121,11 +124,24 @@ std::string thor_worker_t::matrix(Api& request) {
   }
   LOG_INFO("matrix::" + std::string(algo->name()));
 
+  // serialize rows as soon as they are done if the output format allows it
+  std::unique_ptr<tyr::MatrixRowWriter> row_writer;
+  if (tyr::MatrixRowWriter::Supports(request)) {
+    row_writer = std::make_unique<tyr::MatrixRowWriter>(request);
+    algo->set_row_callback([&row_writer](const valhalla::Matrix& matrix, uint32_t source_index) {
+      row_writer->WriteRow(matrix, source_index);
+    });
+  }
+  auto serialize = [&]() {
+    algo->set_row_callback(nullptr);
+    return row_writer ? row_writer->Finish(request) : tyr::serializeMatrix(request);
+  };
+
   // TODO(nils): TDMatrix doesn't care about either destonly or no_thru
   if (algo->name() != "costmatrix") {
     algo->SourceToTarget(request, *reader, mode_costing, mode,
                          max_matrix_distance.find(costing)->second);
-    return tyr::serializeMatrix(request);
+    return serialize();
   }
 
   // for costmatrix try a second pass if the first didn't work out
@@ -152,7 +168,7 @@ std::string thor_worker_t::matrix(Api& request) {
     add_warning(request, 400, get_unfound_indices(request.matrix().second_pass()));
   };
 
-  return tyr::serializeMatrix(request);
+  return serialize();
 }
 } // namespace thor
 } // namespace valhalla
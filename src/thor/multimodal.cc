@@ -184,6 +184,7 @@ MultiModalPathAlgorithm::GetBestPath(valhalla::Location& origin,
       LOG_ERROR("Route failed after iterations = " + std::to_string(edgelabels_.size()));
       return {};
     }
+    ++settled_edges_;
 
     // Copy the EdgeLabel for use in costing. Check if this is a destination
     // edge and potentially complete the path.
@@ -0,0 +1,211 @@
+#include "thor/one_to_many.h"
+#include "midgard/logging.h"
+
+#include <algorithm>
+
+using namespace valhalla::baldr;
+using namespace valhalla::midgard;
+using namespace valhalla::sif;
+
+namespace {
+
+// The expansion is bounded by this factor of the furthest crow fly distance to a destination so that
+// an unreachable destination does not make us expand the whole graph
+constexpr float kMaxDetourFactor = 4.f;
+
+// Lower bound of the expansion distance so that nearby destinations still tolerate large detours
+constexpr float kMinExpansionDistance = 25000.f;
+
+} // namespace
+
+namespace valhalla {
+namespace thor {
+
+OneToMany::OneToMany(const boost::property_tree::ptree& config)
+    : Dijkstras(config), settled_count_(0), max_distance_(0.f), time_info_(TimeInfo::invalid()) {
+}
+
+// main entry point to the functionality
+std::vector<std::vector<PathInfo>> OneToMany::Expand(valhalla::Api& api,
+                                                     baldr::GraphReader& reader,
+                                                     const sif::mode_costing_t& costings,
+                                                     const sif::TravelMode mode) {
+  auto& locations = *api.mutable_options()->mutable_locations();
+  if (locations.size() < 2)
+    throw std::runtime_error("One to many requires an origin and at least one destination");
+
+  // figure out where the destinations are and how far we are willing to go to find them
+  SetDestinations(locations, costings[static_cast<uint32_t>(mode)]);
+
+  // expand from the origin only
+  google::protobuf::RepeatedPtrField<valhalla::Location> origin;
+  origin.Add()->CopyFrom(locations.Get(0));
+  for (const auto& edge : origin.Get(0).correlation().edges()) {
+    origin_edges_.emplace(edge.graph_id(), edge.percent_along());
+  }
+  time_info_ = TimeInfo::make(*origin.Mutable(0), reader, &tz_cache_);
+  if (settled_count_ < destinations_.size())
+    Compute<ExpansionType::forward>(origin, reader, costings, mode);
+
+  // create the paths from the labelset
+  return FormPaths();
+}
+
+// index the destination edges so that we can quickly tell when one is settled
+void OneToMany::SetDestinations(
+    const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+    const std::shared_ptr<sif::DynamicCost>& costing) {
+  const auto& origin_ll = locations.Get(0).ll();
+  PointLL origin(origin_ll.lng(), origin_ll.lat());
+  float max_crow_distance = 0.f;
+
+  destinations_.resize(locations.size() - 1);
+  for (int i = 1; i < locations.size(); ++i) {
+    const auto& location = locations.Get(i);
+    auto& destination = destinations_[i - 1];
+    PointLL ll(location.ll().lng(), location.ll().lat());
+    max_crow_distance = std::max(max_crow_distance, static_cast<float>(origin.Distance(ll)));
+
+    // Only skip outbound edges if we have other options
+    bool has_other_edges =
+        std::any_of(location.correlation().edges().begin(), location.correlation().edges().end(),
+                    [](const valhalla::PathEdge& e) { return !e.begin_node(); });
+
+    for (const auto& edge : location.correlation().edges()) {
+      // If the destination is at a node, skip any outbound edges
+      if (has_other_edges && edge.begin_node()) {
+        continue;
+      }
+
+      // Disallow any user avoided edges if the avoid location is behind the destination
+      if (costing->AvoidAsDestinationEdge(GraphId(edge.graph_id()), edge.percent_along())) {
+        continue;
+      }
+
+      destination_edges_[edge.graph_id()].emplace_back(i - 1, edge.percent_along());
+      ++destination.remaining_edges;
+    }
+
+    // nothing to wait for if the destination has no usable edges
+    if (destination.remaining_edges == 0)
+      ++settled_count_;
+  }
+
+  max_distance_ = std::max(kMinExpansionDistance, max_crow_distance * kMaxDetourFactor);
+}
+
+// this is fired when the edge in the label has been settled (shortest path found) so we check if
+// any of the destinations are along it
+thor::ExpansionRecommendation OneToMany::ShouldExpand(baldr::GraphReader& reader,
+                                                      const sif::EdgeLabel& pred,
+                                                      const thor::ExpansionType) {
+  auto found = destination_edges_.find(pred.edgeid());
+  if (found != destination_edges_.end()) {
+    graph_tile_ptr tile;
+    const auto* edge = reader.directededge(pred.edgeid(), tile);
+    auto label_index = edgestatus_.Get(pred.edgeid()).index();
+
+    // the origin label only covers the part of the edge past the origin
+    auto origin = origin_edges_.find(pred.edgeid());
+    bool is_origin = pred.predecessor() == kInvalidLabel && origin != origin_edges_.end();
+    float origin_percent = is_origin ? origin->second : 0.f;
+
+    // cost the edge at the time we entered it, like the expansion did. the origin label was costed
+    // without a time so we do the same to take off the right part of it
+    auto time_info = TimeInfo::invalid();
+    if (pred.predecessor() != kInvalidLabel) {
+      const auto& prev = bdedgelabels_[pred.predecessor()];
+      graph_tile_ptr node_tile;
+      const auto* node = reader.nodeinfo(prev.endnode(), node_tile);
+      if (node) {
+        time_info = time_info_.forward(prev.cost().secs, static_cast<int>(node->timezone()));
+      }
+    }
+
+    for (const auto& candidate : found->second) {
+      auto& destination = destinations_[candidate.first];
+      if (destination.remaining_edges == 0) {
+        continue;
+      }
+
+      // a destination behind the origin on the same edge can only be reached by going around and
+      // coming back onto the edge, which this expansion cannot do as the edge is already settled.
+      // we leave it without a path so that it gets routed on its own
+      if (is_origin && candidate.second < origin_percent) {
+        destination.behind_origin = true;
+      }
+
+      // the label cost is to the end of the edge so take off the part after the destination
+      if (edge && candidate.second >= origin_percent) {
+        uint8_t flow_sources;
+        auto remainder =
+            costing_->EdgeCost(edge, tile, time_info, flow_sources) * (1.f - candidate.second);
+        auto cost = pred.cost() - remainder;
+        if (cost.cost < destination.cost.cost) {
+          destination.label_index = label_index;
+          destination.cost = cost;
+          destination.path_distance =
+              std::max(0.f, pred.path_distance() - edge->length() * (1.f - candidate.second));
+        }
+      }
+
+      // once all of its edges are settled the destination cannot get any cheaper
+      if (--destination.remaining_edges == 0 && ++settled_count_ == destinations_.size()) {
+        return thor::ExpansionRecommendation::stop_expansion;
+      }
+    }
+  }
+
+  // dont go further than any reasonable path to the destinations would
+  if (pred.path_distance() > max_distance_) {
+    return thor::ExpansionRecommendation::prune_expansion;
+  }
+  return thor::ExpansionRecommendation::continue_expansion;
+}
+
+// tell the expansion how many labels to expect and how many buckets to use
+void OneToMany::GetExpansionHints(uint32_t& bucket_count, uint32_t& edge_label_reservation) const {
+  bucket_count = 20000;
+  edge_label_reservation = kInitialEdgeLabelCountDijkstras;
+}
+
+// deallocate and prepare for next request
+void OneToMany::Clear() {
+  destinations_.clear();
+  destination_edges_.clear();
+  origin_edges_.clear();
+  settled_count_ = 0;
+  max_distance_ = 0.f;
+  time_info_ = TimeInfo::invalid();
+  Dijkstras::Clear();
+}
+
+// walk edge labels to form paths from the origin to each destination
+std::vector<std::vector<PathInfo>> OneToMany::FormPaths() const {
+  std::vector<std::vector<PathInfo>> paths(destinations_.size());
+  for (size_t i = 0; i < destinations_.size(); ++i) {
+    const auto& destination = destinations_[i];
+    if (destination.label_index == kInvalidLabel || destination.behind_origin) {
+      LOG_DEBUG("One to many could not reach destination " + std::to_string(i + 1));
+      continue;
+    }
+
+    // recover the path from the destination back to the origin
+    auto& path = paths[i];
+    for (auto l = destination.label_index; l != kInvalidLabel; l = bdedgelabels_[l].predecessor()) {
+      const auto& label = bdedgelabels_[l];
+      path.emplace_back(label.mode(), label.cost(), label.edgeid(), 0, label.path_distance(),
+                        label.restriction_idx(), label.transition_cost());
+    }
+    std::reverse(path.begin(), path.end());
+
+    // the last edge ends at the destination rather than at the end of the edge
+    path.back().elapsed_cost = destination.cost;
+    path.back().path_distance = destination.path_distance;
+  }
+
+  return paths;
+}
+
+} // namespace thor
+} // namespace valhalla
@@ -20,6 +20,8 @@ namespace thor {
 void thor_worker_t::optimized_route(Api& request) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
+  auto search = measure_search(request);
+  auto budget = enforce_budget();
 
   auto& options = *request.mutable_options();
   adjust_scores(options);
@@ -0,0 +1,116 @@
+#include "thor/reverse_tree_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace valhalla {
+namespace thor {
+
+ReverseTreeCache::ReverseTreeCache(size_t max_trees, uint32_t max_age, uint32_t check_interval)
+    : max_trees_(max_trees), max_age_(max_age), check_interval_(check_interval), refreshing_(false) {
+}
+
+std::shared_ptr<ReverseTreeCache>
+ReverseTreeCache::shared(const boost::property_tree::ptree& config) {
+  const auto max_trees = config.get<size_t>("reroute_cache.max_trees", 0);
+  if (max_trees == 0) {
+    return nullptr;
+  }
+
+  // workers come and go with their actors, so keep the cache alive only while one of them uses it
+  static std::mutex mutex;
+  static std::weak_ptr<ReverseTreeCache> instance;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto cache = instance.lock();
+  if (!cache) {
+    const auto max_age = config.get<uint32_t>("reroute_cache.max_age", 600);
+    const auto check_interval = config.get<uint32_t>("reroute_cache.check_interval", 10);
+    cache = std::make_shared<ReverseTreeCache>(max_trees, max_age, check_interval);
+    instance = cache;
+  }
+  return cache;
+}
+
+std::string ReverseTreeCache::version(const baldr::GraphReader& reader) {
+  // looking at every traffic tile isn't free so we only do it every so often and never under the
+  // lock, the other workers keep using the old version until the new one is swapped in
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto now = std::chrono::steady_clock::now();
+  if (!refreshing_ && (version_.empty() || now - checked_ >= check_interval_)) {
+    refreshing_ = true;
+    lock.unlock();
+    std::string version;
+    try {
+      version = std::to_string(reader.GetTileSetVersion()) + '_' +
+                std::to_string(reader.GetTrafficLastUpdate()) + '_';
+    } catch (...) {}
+    lock.lock();
+    if (!version.empty()) {
+      version_ = std::move(version);
+    }
+    checked_ = now;
+    refreshing_ = false;
+  }
+  return version_;
+}
+
+std::unique_ptr<ReverseSearchTree> ReverseTreeCache::take(const std::string& token,
+                                                          const std::string& fingerprint) {
+  entry_t entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = trees_.find(token);
+    if (found == trees_.end()) {
+      return nullptr;
+    }
+    entry = std::move(found->second);
+    trees_.erase(found);
+  }
+
+  // a stale or mismatching tree is dropped here, outside of the lock
+  if (entry.fingerprint != fingerprint ||
+      std::chrono::steady_clock::now() - entry.stored > max_age_) {
+    return nullptr;
+  }
+  return std::move(entry.tree);
+}
+
+void ReverseTreeCache::put(const std::string& token,
+                           const std::string& fingerprint,
+                           std::unique_ptr<ReverseSearchTree> tree) {
+  const auto now = std::chrono::steady_clock::now();
+  // trees we push out are freed once we leave, outside of the lock
+  std::vector<std::unique_ptr<ReverseSearchTree>> evicted;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // forget the trees of sessions that went quiet
+  for (auto itr = trees_.begin(); itr != trees_.end();) {
+    if (now - itr->second.stored > max_age_) {
+      evicted.emplace_back(std::move(itr->second.tree));
+      itr = trees_.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+
+  // make room by evicting the oldest tree
+  if (trees_.size() >= max_trees_ && trees_.find(token) == trees_.end()) {
+    auto oldest = std::min_element(trees_.begin(), trees_.end(), [](const auto& a, const auto& b) {
+      return a.second.stored < b.second.stored;
+    });
+    evicted.emplace_back(std::move(oldest->second.tree));
+    trees_.erase(oldest);
+  }
+
+  auto& entry = trees_[token];
+  evicted.emplace_back(std::move(entry.tree));
+  entry = {fingerprint, std::move(tree), now};
+}
+
+size_t ReverseTreeCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return trees_.size();
+}
+
+} // namespace thor
+} // namespace valhalla
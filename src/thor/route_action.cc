@@ -6,7 +6,10 @@
 #include "sif/pedestriancost.h"
 #include "thor/worker.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <exception>
 
 using namespace valhalla;
 using namespace valhalla::midgard;
@@ -106,6 +109,20 @@ inline bool is_highly_reachable(const valhalla::Location& loc, const valhalla::P
          static_cast<google::protobuf::uint32>(edge.outbound_reach()) >= loc.minimum_reachability();
 }
 
+// Identifies what a reverse search tree was built for: the destination candidates, the costing and
+// the versions of the data it was computed on
+std::string reverse_tree_fingerprint(const std::string& version,
+                                     const valhalla::Location& destination,
+                                     const Options& options) {
+  std::string fingerprint =
+      version +
+      options.costings().find(options.costing_type())->second.options().SerializeAsString();
+  for (const auto& edge : destination.correlation().edges()) {
+    fingerprint += std::to_string(edge.graph_id()) + ':' + std::to_string(edge.percent_along()) + ';';
+  }
+  return fingerprint;
+}
+
 template <typename Predicate> inline void remove_path_edges(valhalla::Location& loc, Predicate pred) {
   auto new_end = std::remove_if(loc.mutable_correlation()->mutable_edges()->begin(),
                                 loc.mutable_correlation()->mutable_edges()->end(), pred);
@@ -166,6 +183,47 @@ opposing) { loc.mutable_correlation()->mutable_edges()->SwapElements(i, loc.path
   }
 }*/
 
+/**
+ * Whether any of the candidate edges of the origin and destination are the same or connected. A*
+ * has to be used in that case because bidirectional A* does not handle such trivial cases.
+ */
+bool has_connected_edges(GraphReader& reader,
+                         const valhalla::Location& origin,
+                         const valhalla::Location& destination) {
+  for (auto& edge1 : origin.correlation().edges()) {
+    for (auto& edge2 : destination.correlation().edges()) {
+      bool same_graph_id = edge1.graph_id() == edge2.graph_id();
+      bool are_connected =
+          reader.AreEdgesConnected(GraphId(edge1.graph_id()), GraphId(edge2.graph_id()));
+      if (same_graph_id || are_connected) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * A rough guess of how fast (in meters per second) a leg of a route is travelled. Only used to guess
+ * the departure times of the legs of a multipoint route so that they can be computed concurrently.
+ */
+float guess_speed(const sif::TravelMode mode) {
+  switch (mode) {
+    case sif::TravelMode::kPedestrian:
+      return 3.f * kMPHtoMetersPerSec;
+    case sif::TravelMode::kBicycle:
+      return 10.f * kMPHtoMetersPerSec;
+    default:
+      return 35.f * kMPHtoMetersPerSec;
+  }
+}
+
+// Roads are not straight so the crow fly distance of a leg underestimates its length
+constexpr float kLegDetourFactor = 1.3f;
+
+// How often the interrupt of a request is checked while its legs are computed concurrently
+constexpr std::chrono::milliseconds kLegInterruptInterval(10);
+
 } // namespace
 
 namespace valhalla {
@@ -174,6 +232,8 @@ namespace thor {
 void thor_worker_t::centroid(Api& request) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
+  auto search = measure_search(request);
+  auto budget = enforce_budget();
 
   auto& options = *request.mutable_options();
   adjust_scores(options);
@@ -183,6 +243,7 @@ void thor_worker_t::centroid(Api& request) {
   valhalla::Location destination;
 
   // get all the routes
+  centroid_gen.set_interrupt(interrupt);
   auto paths =
       centroid_gen.Expand(ExpansionType::forward, request, *reader, mode_costing, mode, destination);
 
@@ -196,8 +257,10 @@ void thor_worker_t::centroid(Api& request) {
     // actually build the route object
     auto* route = request.mutable_trip()->mutable_routes()->Add();
     auto& leg = *route->mutable_legs()->Add();
+    auto build_start = std::chrono::steady_clock::now();
     thor::TripLegBuilder::Build(options, controller, *reader, mode_costing, path.begin(), path.end(),
                                 *origin, dest, leg, {"centroid"}, interrupt);
+    trip_build_time += std::chrono::steady_clock::now() - build_start;
 
     // TODO: set the time at the destination if time dependent
 
@@ -209,6 +272,8 @@ void thor_worker_t::centroid(Api& request) {
 void thor_worker_t::route(Api& request) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
+  auto search = measure_search(request);
+  auto budget = enforce_budget();
 
   auto& options = *request.mutable_options();
   adjust_scores(options);
@@ -216,13 +281,70 @@ void thor_worker_t::route(Api& request) {
   auto costing = parse_costing(request);
 
   // get all the legs
-  if (options.date_time_type() == Options::arrive_by) {
+  if (options.one_to_many()) {
+    path_one_to_many(request, costing);
+  } else if (options.date_time_type() == Options::arrive_by) {
     path_arrive_by(request, costing);
   } else {
     path_depart_at(request, costing);
   }
 }
 
+void thor_worker_t::path_one_to_many(Api& api, const std::string& costing) {
+  // a single expansion from the origin finds the paths to all the destinations
+  one_to_many_gen.Clear();
+  one_to_many_gen.set_interrupt(interrupt);
+  auto paths = one_to_many_gen.Expand(api, *reader, mode_costing, mode);
+
+  const Options& options = api.options();
+  valhalla::Trip& trip = *api.mutable_trip();
+  trip.mutable_routes()->Reserve(paths.size());
+  const std::vector<std::string> algorithms{"one_to_many"};
+  graph_tile_ptr tile = nullptr;
+
+  // serialize path information of each destination into its own route
+  for (size_t i = 0; i < paths.size(); ++i) {
+    auto& path = paths[i];
+    auto origin = options.locations(0);
+    auto destination = options.locations(i + 1);
+
+    // a destination the shared expansion did not find (eg behind the origin on the origin edge) is
+    // routed on its own so that route i always goes to destination i, or the request fails
+    if (path.empty()) {
+      auto* path_algorithm = get_path_algorithm(costing, origin, destination, options);
+      path_algorithm->Clear();
+      auto found = get_path(path_algorithm, origin, destination, costing, options);
+      if (found.empty() || found.front().empty())
+        throw valhalla_exception_t{442};
+      path = std::move(found.front());
+    }
+
+    // forward propagate time information
+    auto in_tz = reader->GetTimezoneFromEdge(path.front().edgeid, tile);
+    auto out_tz = reader->GetTimezoneFromEdge(path.back().edgeid, tile);
+    if (!origin.date_time().empty() && (in_tz || out_tz)) {
+      auto origin_dt = DateTime::offset_date(origin.date_time(), in_tz, in_tz, 0);
+      origin.set_date_time(origin_dt.date_time);
+      origin.set_time_zone_offset(origin_dt.time_zone_offset);
+      origin.set_time_zone_name(origin_dt.time_zone_name);
+
+      float offset = options.date_time_type() != valhalla::Options::invariant
+                         ? path.back().elapsed_cost.secs
+                         : 0.0f;
+      auto destination_dt = DateTime::offset_date(origin.date_time(), in_tz, out_tz, offset);
+      destination.set_date_time(destination_dt.date_time);
+      destination.set_time_zone_offset(destination_dt.time_zone_offset);
+      destination.set_time_zone_name(destination_dt.time_zone_name);
+    }
+
+    auto& leg = *trip.mutable_routes()->Add()->mutable_legs()->Add();
+    auto build_start = std::chrono::steady_clock::now();
+    thor::TripLegBuilder::Build(options, controller, *reader, mode_costing, path.begin(), path.end(),
+                                origin, destination, leg, algorithms, interrupt);
+    trip_build_time += std::chrono::steady_clock::now() - build_start;
+  }
+}
+
 thor::PathAlgorithm* thor_worker_t::get_path_algorithm(const std::string& routetype,
                                                        const valhalla::Location& origin,
                                                        const valhalla::Location& destination,
@@ -273,15 +395,8 @@ thor::PathAlgorithm* thor_worker_t::get_path_algorithm(const std::string& routet
   // use bidirectional A*. Bidirectional A* does not handle trivial cases with oneways and
   // has issues when cost of origin or destination edge is high (needs a high threshold to
   // find the proper connection).
-  for (auto& edge1 : origin.correlation().edges()) {
-    for (auto& edge2 : destination.correlation().edges()) {
-      bool same_graph_id = edge1.graph_id() == edge2.graph_id();
-      bool are_connected =
-          reader->AreEdgesConnected(GraphId(edge1.graph_id()), GraphId(edge2.graph_id()));
-      if (same_graph_id || are_connected) {
-        return &timedep_forward;
-      }
-    }
+  if (has_connected_edges(*reader, origin, destination)) {
+    return &timedep_forward;
   }
 
   // No other special cases we land on bidirectional a*
@@ -292,18 +407,44 @@ std::vector<std::vector<thor::PathInfo>> thor_worker_t::get_path(PathAlgorithm*
                                                                  valhalla::Location& origin,
                                                                  valhalla::Location& destination,
                                                                  const std::string& costing,
-                                                                 const Options& options) {
+                                                                 const Options& options,
+                                                                 leg_slot_t* slot) {
+  // When computing a leg on another thread we use its reader and costing
+  auto& graph_reader = slot ? *slot->reader : *reader;
+  auto& costings = slot ? slot->mode_costing : mode_costing;
+  const bool using_bd =
+      path_algorithm == &bidir_astar || (slot && path_algorithm == &slot->bidir_astar);
+
   // Find the path.
-  valhalla::sif::cost_ptr_t cost = mode_costing[static_cast<uint32_t>(mode)];
+  valhalla::sif::cost_ptr_t cost = costings[static_cast<uint32_t>(mode)];
 
   // If bidirectional A* disable use of destination-only edges on the
   // first pass. If there is a failure, we allow them on the second pass.
   // Other path algorithms can use destination-only edges on the first pass.
   // TODO(nils): why not others with destonly pruning? it gets a 2nd pass as well
-  cost->set_allow_destination_only(path_algorithm == &bidir_astar ? false : true);
+  cost->set_allow_destination_only(using_bd ? false : true);
+
+  // Rerouting within a session reuses the reverse tree of the previous route to the destination.
+  // Only time independent routes without alternates or intermediate locations qualify.
+  std::string fingerprint;
+  if (reroute_cache && path_algorithm == &bidir_astar && !options.reroute_token().empty() &&
+      options.date_time_type() == Options::no_time && options.alternates() == 0 &&
+      options.locations_size() == 2) {
+    const auto version = reroute_cache->version(graph_reader);
+    if (!version.empty()) {
+      fingerprint = reverse_tree_fingerprint(version, destination, options);
+      bidir_astar.SetReverseTree(reroute_cache->take(options.reroute_token(), fingerprint));
+    }
+  }
 
   cost->set_pass(0);
-  auto paths = path_algorithm->GetBestPath(origin, destination, *reader, mode_costing, mode, options);
+  auto paths =
+      path_algorithm->GetBestPath(origin, destination, graph_reader, costings, mode, options);
+
+  // Keep the reverse tree for the next reroute of this session
+  if (!fingerprint.empty() && !paths.empty()) {
+    reroute_cache->put(options.reroute_token(), fingerprint, bidir_astar.ReleaseReverseTree());
+  }
 
   // Check if we should run a second pass pedestrian route with different A*
   // (to look for better routes where a ferry is taken)
@@ -329,14 +470,13 @@ std::vector<std::vector<thor::PathInfo>> thor_worker_t::get_path(PathAlgorithm*
 
     path_algorithm->Clear();
     cost->set_pass(1);
-    const bool using_bd = path_algorithm == &bidir_astar;
     cost->RelaxHierarchyLimits(using_bd);
     cost->set_allow_destination_only(true);
     cost->set_allow_conditional_destination(true);
     path_algorithm->set_not_thru_pruning(false);
     // Get the best path. Return if not empty (else return the original path)
     auto relaxed_paths =
-        path_algorithm->GetBestPath(origin, destination, *reader, mode_costing, mode, options);
+        path_algorithm->GetBestPath(origin, destination, graph_reader, costings, mode, options);
     if (!relaxed_paths.empty()) {
       return relaxed_paths;
     }
@@ -494,9 +634,11 @@ void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
           route->mutable_legs()->Reserve(options.locations_size());
         }
         auto& leg = *route->mutable_legs()->Add();
+        auto build_start = std::chrono::steady_clock::now();
         TripLegBuilder::Build(options, controller, *reader, mode_costing, path.begin(), path.end(),
                               *origin, *destination, leg, algorithms, interrupt, edge_trimming,
                               intermediates);
+        trip_build_time += std::chrono::steady_clock::now() - build_start;
 
         // advance the time for the next destination (i.e. algo origin) by the waiting_secs
         // of this origin (i.e. algo destination)
@@ -571,6 +713,145 @@ void thor_worker_t::path_arrive_by(Api& api, const std::string& costing) {
   *api.mutable_options()->mutable_locations() = std::move(correlated);
 }
 
+std::vector<thor_worker_t::speculative_leg_t>
+thor_worker_t::compute_legs(const Options& options,
+                            google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+                            const std::string& costing) {
+  // Only worth it for more than one leg and only possible if the legs do not depend on each other
+  std::vector<speculative_leg_t> legs;
+  if (leg_slots.empty() || locations.size() < 3 || costing == "multimodal" ||
+      costing == "transit" || costing == "bikeshare" ||
+      std::any_of(std::next(locations.begin()), std::prev(locations.end()),
+                  [](const valhalla::Location& location) { return is_through_point(location); })) {
+    return legs;
+  }
+  legs.resize(locations.size() - 1);
+
+  // The departure of a leg depends on the arrival of the previous one which we do not know yet. So
+  // we guess it from the distance travelled so far, the guess is checked when the legs are merged
+  if (!locations.Get(0).date_time().empty()) {
+    try {
+      // resolve "current" once so that all the legs agree on it
+      TimeInfo::make(*locations.Mutable(0), *reader);
+      graph_tile_ptr tile;
+      auto timezone = [&](const valhalla::Location& location) -> uint32_t {
+        if (location.correlation().edges_size() == 0)
+          return 0;
+        return reader->GetTimezoneFromEdge(GraphId(location.correlation().edges(0).graph_id()),
+                                           tile);
+      };
+      const auto in_tz = timezone(locations.Get(0));
+      legs.front().date_time = locations.Get(0).date_time();
+      float offset = 0.f;
+      for (size_t i = 1; i < legs.size(); ++i) {
+        if (options.date_time_type() != Options::invariant) {
+          const auto& a = locations.Get(i - 1).ll();
+          const auto& b = locations.Get(i).ll();
+          offset += PointLL(a.lng(), a.lat()).Distance(PointLL(b.lng(), b.lat())) *
+                        kLegDetourFactor / guess_speed(mode) +
+                    locations.Get(i).waiting_secs();
+        }
+        legs[i].date_time =
+            DateTime::offset_date(legs.front().date_time, in_tz, timezone(locations.Get(i)), offset)
+                .date_time;
+        if (legs[i].date_time.empty())
+          return {};
+      }
+    } catch (...) { return {}; }
+  }
+
+  // Each thread gets its own costing because they keep per request state
+  for (auto& slot : leg_slots) {
+    auto slot_mode = mode;
+    slot->mode_costing = factory.CreateModeCosting(options, slot_mode);
+  }
+
+  // Compute the legs, each slot taking every nth one. The first error of a leg cancels the others
+  const Costing_Options& costing_options =
+      options.costings().find(options.costing_type())->second.options();
+  std::vector<std::exception_ptr> failures(legs.size());
+  legs_cancelled = false;
+  for (size_t t = 0; t < leg_slots.size(); ++t) {
+    leg_slots[t]->run([&, t]() {
+      auto& slot = *leg_slots[t];
+      auto& cost = slot.mode_costing[static_cast<uint32_t>(mode)];
+      const auto user_hierarchy_limits = cost->GetHierarchyLimits();
+      for (size_t i = t; i < legs.size(); i += leg_slots.size()) {
+        try {
+          auto origin = locations.Get(i);
+          auto destination = locations.Get(i + 1);
+          if (!legs[i].date_time.empty())
+            origin.set_date_time(legs[i].date_time);
+
+          // Same choice of algorithm as get_path_algorithm
+          PathAlgorithm* path_algorithm = &slot.bidir_astar;
+          PointLL ll1(origin.ll().lng(), origin.ll().lat());
+          PointLL ll2(destination.ll().lng(), destination.ll().lat());
+          if ((!origin.date_time().empty() && options.date_time_type() != Options::invariant &&
+               !options.prioritize_bidirectional() && ll1.Distance(ll2) < max_timedep_distance) ||
+              has_connected_edges(*slot.reader, origin, destination)) {
+            path_algorithm = &slot.timedep_forward;
+          }
+          path_algorithm->Clear();
+
+          // Same hierarchy limits as the leg would get when computed sequentially
+          const bool is_bidir = path_algorithm == &slot.bidir_astar;
+          auto hierarchy_limits = user_hierarchy_limits;
+          check_hierarchy_limits(hierarchy_limits, cost, costing_options,
+                                 is_bidir ? hierarchy_limits_config_bidirectional_astar
+                                          : hierarchy_limits_config_astar,
+                                 allow_hierarchy_limits_modifications, cost->UseHierarchyLimits());
+          cost->SetHierarchyLimits(hierarchy_limits);
+
+          auto paths = get_path(path_algorithm, origin, destination, costing, options, &slot);
+          // A second pass adds candidate edges to the locations which the sequential merge of the
+          // legs has to see, so those legs are left to it
+          if (cost->pass() == 0)
+            legs[i].paths = std::move(paths);
+        } catch (const leg_cancelled_t&) { break; } catch (...) {
+          failures[i] = std::current_exception();
+          legs_cancelled = true;
+          break;
+        }
+      }
+    });
+  }
+
+  // Wait for the legs, meanwhile checking the interrupt of the request on this thread. If it
+  // throws the slots are cancelled and we rethrow once they have all stopped
+  std::exception_ptr interrupted;
+  auto check_interrupt = [&]() {
+    if (interrupt && !interrupted) {
+      try {
+        (*interrupt)();
+      } catch (...) {
+        interrupted = std::current_exception();
+        legs_cancelled = true;
+      }
+    }
+  };
+  for (auto& slot : leg_slots) {
+    while (!slot->wait_for(kLegInterruptInterval)) {
+      check_interrupt();
+    }
+  }
+
+  // Legs quicker than the first check still count towards the work budget of the request
+  check_interrupt();
+  if (interrupted) {
+    std::rethrow_exception(interrupted);
+  }
+
+  // The failure of the first leg is the one computing them one after another would have reported
+  for (const auto& failure : failures) {
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+
+  return legs;
+}
+
 void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
   // Things we'll need
   TripRoute* route = nullptr;
@@ -595,6 +876,10 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
   bool used_bidir = false;
   bool add_hierarchy_limits_warning = false;
 
+  // the legs may be computed concurrently ahead of merging them
+  auto correlated = options.locations();
+  auto legs = compute_legs(options, correlated, costing);
+
   graph_tile_ptr tile = nullptr;
   auto route_two_locations = [&, this](auto& origin, auto& destination) -> bool {
     // Get the algorithm type for this location pair
@@ -629,8 +914,21 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
       remove_path_edges(*origin,
                         [&last_edge](const auto& edge) { return edge.graph_id() != last_edge; });
     }
-    // Get best path and keep it
-    auto temp_paths = this->get_path(path_algorithm, *origin, *destination, costing, options);
+    // Get best path and keep it, the leg may already be computed if it departs about when expected
+    const size_t leg_index = std::distance(correlated.begin(), origin);
+    std::vector<std::vector<thor::PathInfo>> temp_paths;
+    if (leg_index < legs.size() && !legs[leg_index].paths.empty() &&
+        (legs[leg_index].date_time.empty() ||
+         std::abs((DateTime::get_formatted_date(origin->date_time()) -
+                   DateTime::get_formatted_date(legs[leg_index].date_time))
+                      .count()) <= max_leg_departure_drift)) {
+      temp_paths = std::move(legs[leg_index].paths);
+    } else {
+      temp_paths = this->get_path(path_algorithm, *origin, *destination, costing, options);
+      // a second pass adds candidate edges to the destination which the next leg did not see
+      if (mode_costing[static_cast<uint32_t>(mode)]->pass() != 0 && leg_index + 1 < legs.size())
+        legs[leg_index + 1].paths.clear();
+    }
     if (temp_paths.empty())
       return false;
 
@@ -699,9 +997,11 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
           route->mutable_legs()->Reserve(options.locations_size());
         }
         auto& leg = *route->mutable_legs()->Add();
+        auto build_start = std::chrono::steady_clock::now();
         thor::TripLegBuilder::Build(options, controller, *reader, mode_costing, path.begin(),
                                     path.end(), *origin, *destination, leg, algorithms, interrupt,
                                     edge_trimming, {std::next(origin), destination});
+        trip_build_time += std::chrono::steady_clock::now() - build_start;
 
         path.clear();
         edge_trimming.clear();
@@ -715,7 +1015,6 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
     return true;
   };
 
-  auto correlated = options.locations();
   bool allow_retry = true;
 
   // For each pair of locations
@@ -747,6 +1046,7 @@ void thor_worker_t::path_depart_at(Api& api, const std::string& costing) {
         edge_trimming.clear();
         path.clear();
         algorithms.clear();
+        legs.clear();
         trip.mutable_routes()->Clear();
         destination = ++correlated.begin();
         continue;
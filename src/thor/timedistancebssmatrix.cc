@@ -211,6 +211,7 @@ bool TimeDistanceBSSMatrix::ComputeMatrix(Api& request,
         FormTimeDistanceMatrix(request, FORWARD, origin_index);
         break;
       }
+      ++settled_edges_;
 
       // Remove label from adjacency list, mark it as permanently labeled.
       // Copy the EdgeLabel for use in costing
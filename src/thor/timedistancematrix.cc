@@ -241,6 +241,7 @@ bool TimeDistanceMatrix::ComputeMatrix(Api& request,
                                time_info.timezone_index, dest_edge_ids);
         break;
       }
+      ++settled_edges_;
 
       // Copy the EdgeLabel for use in costing
       EdgeLabel pred = edgelabels_[predindex];
@@ -290,6 +291,11 @@ bool TimeDistanceMatrix::ComputeMatrix(Api& request,
     }
 
     reset();
+
+    // going forward each origin is a source and its row is done
+    if (FORWARD && row_callback_) {
+      row_callback_(request.matrix(), origin_index);
+    }
   }
 
   // TODO(nils): implement second pass here too
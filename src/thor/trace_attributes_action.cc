@@ -42,6 +42,7 @@ namespace thor {
 std::string thor_worker_t::trace_attributes(Api& request) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
+  auto budget = enforce_budget();
 
   // Parse request
   adjust_scores(*request.mutable_options());
@@ -67,6 +67,7 @@ namespace thor {
 void thor_worker_t::trace_route(Api& request) {
   // time this whole method and save that statistic
   auto _ = measure_scope_time(request);
+  auto budget = enforce_budget();
 
   // Parse request
   auto& options = *request.mutable_options();
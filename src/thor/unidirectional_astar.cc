@@ -255,7 +255,8 @@ inline bool UnidirectionalAStar<expansion_direction, FORWARD>::ExpandInner(
 
     auto dist = 0.0f;
     auto sortcost =
-        cost.cost + (dest_path_edge ? astarheuristic_.Get(0) : astarheuristic_.Get(endpoint, dist));
+        cost.cost + (dest_path_edge ? astarheuristic_.Get(0)
+                                    : astarheuristic_.Get(endpoint, meta.edge->endnode(), dist));
 
     auto path_distance =
         static_cast<uint32_t>(pred.path_distance() + meta.edge->length() * percent_traversed + .5f);
@@ -472,6 +473,7 @@ std::vector<std::vector<PathInfo>> UnidirectionalAStar<expansion_direction, FORW
   midgard::PointLL destination_new(destination.correlation().edges(0).ll().lng(),
                                    destination.correlation().edges(0).ll().lat());
   Init(origin_new, destination_new);
+  astarheuristic_.InitLandmarks(landmarks_, graphreader, FORWARD ? destination : origin);
   float mindist = astarheuristic_.GetDistance(FORWARD ? origin_new : destination_new);
 
   auto& startpoint = FORWARD ? origin : destination;
@@ -506,6 +508,7 @@ std::vector<std::vector<PathInfo>> UnidirectionalAStar<expansion_direction, FORW
       LOG_ERROR("Route failed after iterations = " + std::to_string(edgelabels_.size()));
       return {};
     }
+    ++settled_edges_;
 
     // Copy the EdgeLabel for use in costing. Check if this is a destination
     // edge and potentially complete the path.
@@ -718,12 +721,14 @@ void UnidirectionalAStar<expansion_direction, FORWARD>::SetOrigin(
     GraphId opp_edge_id;
     const DirectedEdge* opp_dir_edge;
     midgard::PointLL endpoint;
+    GraphId endnode;
     if (FORWARD) {
       const auto endtile = graphreader.GetGraphTile(directededge->endnode());
       if (endtile == nullptr) {
         continue;
       }
-      endpoint = endtile->get_node_ll(directededge->endnode());
+      endnode = directededge->endnode();
+      endpoint = endtile->get_node_ll(endnode);
     } else {
       // Get the opposing directed edge, continue if we cannot get it
       opp_edge_id = graphreader.GetOpposingEdgeId(edgeid);
@@ -731,7 +736,8 @@ void UnidirectionalAStar<expansion_direction, FORWARD>::SetOrigin(
         continue;
       }
       opp_dir_edge = graphreader.GetOpposingEdge(edgeid);
-      endpoint = tile->get_node_ll(opp_dir_edge->endnode());
+      endnode = opp_dir_edge->endnode();
+      endpoint = tile->get_node_ll(endnode);
     }
 
     uint8_t flow_sources;
@@ -754,7 +760,8 @@ void UnidirectionalAStar<expansion_direction, FORWARD>::SetOrigin(
 
       auto dist = 0.0f;
       auto sortcost =
-          cost.cost + (dest_path_edge ? astarheuristic_.Get(0) : astarheuristic_.Get(endpoint, dist));
+          cost.cost + (dest_path_edge ? astarheuristic_.Get(0)
+                                      : astarheuristic_.Get(endpoint, endnode, dist));
 
       auto path_distance = static_cast<uint32_t>(directededge->length() * percent_traversed + .5f);
 
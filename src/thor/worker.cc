@@ -1,4 +1,5 @@
 #include "thor/worker.h"
+#include "admission_controller.h"
 #include "midgard/constants.h"
 #include "midgard/logging.h"
 #include "midgard/util.h"
@@ -7,6 +8,7 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <chrono>
 #include <functional>
 #include <stdexcept>
 #include <string>
@@ -68,10 +70,12 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
       multi_modal_astar(config.get_child("thor")), timedep_forward(config.get_child("thor")),
       timedep_reverse(config.get_child("thor")), costmatrix_(config.get_child("thor")),
       time_distance_matrix_(config.get_child("thor")),
-      time_distance_bss_matrix_(config.get_child("thor")), isochrone_gen(config.get_child("thor")),
+      time_distance_bss_matrix_(config.get_child("thor")),
+      reroute_cache(ReverseTreeCache::shared(config.get_child("thor"))),
+      isochrone_gen(config.get_child("thor")),
       reader(graph_reader ? graph_reader
                           : std::make_shared<baldr::GraphReader>(config.get_child("mjolnir"))),
-      matcher_factory(config, reader), controller{},
+      matcher_factory(config, reader), controller{}, one_to_many_gen(config.get_child("thor")),
       allow_hierarchy_limits_modifications(
           config.get<bool>("service_limits.hierarchy_limits.allow_modification", false)) {
 
@@ -106,6 +110,45 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
   max_timedep_distance =
       config.get<float>("service_limits.max_timedep_distance", kDefaultMaxTimeDependentDistance);
 
+  // multipoint routes may compute their legs concurrently
+  auto leg_concurrency = config.get<uint32_t>("thor.leg_concurrency", 1);
+  for (uint32_t i = 0; leg_concurrency > 1 && i < leg_concurrency; ++i) {
+    leg_slots.emplace_back(new leg_slot_t(config));
+    auto* slot = leg_slots.back().get();
+    slot->interrupt = [this, slot]() {
+      slot->publish();
+      if (legs_cancelled) {
+        throw leg_cancelled_t{};
+      }
+      // the budget covers the work of all the slots, the other searches are idle meanwhile
+      if (budget_check) {
+        budget_check();
+      }
+    };
+    slot->bidir_astar.set_interrupt(&slot->interrupt);
+    slot->timedep_forward.set_interrupt(&slot->interrupt);
+    slot->reader->SetInterrupt(&slot->interrupt);
+  }
+  max_leg_departure_drift = config.get<float>("thor.max_leg_departure_drift", 300.f);
+
+  // pathological requests are cut off rather than allowed to occupy the worker
+  budget.max_settled_edges = config.get<uint64_t>("thor.budget.max_settled_edges", 0);
+  budget.max_tiles_loaded = config.get<uint64_t>("thor.budget.max_tiles_loaded", 0);
+  budget.max_time = std::chrono::milliseconds(config.get<uint32_t>("thor.budget.max_time_ms", 0));
+
+  // landmark distances built next to the tiles tighten the A* heuristic of routes
+  if (!config.get<std::string>("mjolnir.alt_dir", "").empty()) {
+    auto landmarks = std::make_shared<baldr::AltLandmarks>(config.get_child("mjolnir"));
+    std::vector<PathAlgorithm*> algorithms{&bidir_astar, &timedep_forward, &timedep_reverse};
+    for (auto& slot : leg_slots) {
+      algorithms.push_back(&slot->bidir_astar);
+      algorithms.push_back(&slot->timedep_forward);
+    }
+    for (auto* algorithm : algorithms) {
+      algorithm->set_landmarks(landmarks);
+    }
+  }
+
   hierarchy_limits_config_costmatrix =
       parse_hierarchy_limits_from_config(config, "costmatrix", false);
   hierarchy_limits_config_astar =
@@ -120,6 +163,59 @@ thor_worker_t::thor_worker_t(const boost::property_tree::ptree& config,
 thor_worker_t::~thor_worker_t() {
 }
 
+thor_worker_t::leg_slot_t::leg_slot_t(const boost::property_tree::ptree& config)
+    : bidir_astar(config.get_child("thor")), timedep_forward(config.get_child("thor")) {
+  // all the leg readers share one tile cache
+  auto reader_config = config.get_child("mjolnir");
+  reader_config.put("global_synchronized_cache", true);
+  reader = std::make_shared<baldr::GraphReader>(reader_config);
+
+  // the thread stays around for the jobs of all the requests of the worker
+  thread = std::thread([this]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      condition.wait(lock, [this]() { return stop || job; });
+      if (stop) {
+        return;
+      }
+      lock.unlock();
+      try {
+        job();
+      } catch (...) {}
+      publish();
+      lock.lock();
+      job = nullptr;
+      condition.notify_all();
+    }
+  });
+}
+
+thor_worker_t::leg_slot_t::~leg_slot_t() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  condition.notify_all();
+  thread.join();
+}
+
+void thor_worker_t::leg_slot_t::run(std::function<void()> work) {
+  std::lock_guard<std::mutex> lock(mutex);
+  job = std::move(work);
+  condition.notify_all();
+}
+
+bool thor_worker_t::leg_slot_t::wait_for(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex);
+  return condition.wait_for(lock, timeout, [this]() { return !job; });
+}
+
+void thor_worker_t::leg_slot_t::publish() {
+  settled_edges = bidir_astar.settled_edges() + timedep_forward.settled_edges();
+  tile_cache_hits = reader->TileStats().cache_hits;
+  tile_cache_misses = reader->TileStats().cache_misses;
+}
+
 #ifdef ENABLE_SERVICES
 prime_server::worker_t::result_t
 thor_worker_t::work(const std::list<zmq::message_t>& job,
@@ -129,7 +225,11 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
   // get request info and make sure to record any metrics before we are done
   auto& info = *static_cast<prime_server::http_request_info_t*>(request_info);
   LOG_INFO("Got Thor Request " + std::to_string(info.id));
-  Api request;
+  // the request lives on an arena which reuses the memory of this worker from request to request
+  google::protobuf::Arena arena(request_arena_options());
+  Api& request = *google::protobuf::Arena::CreateMessage<Api>(&arena);
+  // gives back the slot of a heavy request however we leave, unless it goes on to the next stage
+  admission_guard_t admission_guard(admission, request);
   prime_server::worker_t::result_t result{true, {}, {}};
   try {
     // crack open the original request
@@ -145,17 +245,23 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
 
     // do request specific processing
     switch (options.action()) {
-      case Options::sources_to_targets:
-        result = to_response(matrix(request), info, request);
+      case Options::sources_to_targets: {
+        auto response = matrix(request);
+        cache_result(request, response);
+        result = to_response(response, info, request);
         break;
+      }
       case Options::optimized_route: {
         optimized_route(request);
         result.messages.emplace_back(serialize_to_pbf(request));
         break;
       }
-      case Options::isochrone:
-        result = to_response(isochrones(request), info, request);
+      case Options::isochrone: {
+        auto response = isochrones(request);
+        cache_result(request, response);
+        result = to_response(response, info, request);
         break;
+      }
       case Options::route: {
         route(request);
         result.messages.emplace_back(serialize_to_pbf(request));
@@ -195,6 +301,7 @@ thor_worker_t::work(const std::list<zmq::message_t>& job,
   }
 
   // keep track of the metrics if the request is going back to the client
+  admission_guard.hand_on(result.intermediate);
   if (!result.intermediate)
     enqueue_statistics(request);
 
@@ -315,6 +422,97 @@ void thor_worker_t::log_admin(const valhalla::TripLeg& trip_path) {
   }
 }
 
+thor_worker_t::search_counters_t thor_worker_t::search_counters() const {
+  search_counters_t counters{};
+  auto add = [&counters](const PathAlgorithm& algorithm) {
+    counters.settled_edges += algorithm.settled_edges();
+  };
+  auto add_reader = [&counters](const baldr::GraphReader& graph_reader) {
+    counters.tile_cache_hits += graph_reader.TileStats().cache_hits;
+    counters.tile_cache_misses += graph_reader.TileStats().cache_misses;
+  };
+  add(bidir_astar);
+  add(bss_astar);
+  add(multi_modal_astar);
+  add(timedep_forward);
+  add(timedep_reverse);
+  for (const auto* matrix : std::vector<const MatrixAlgorithm*>{&costmatrix_, &time_distance_matrix_,
+                                                                 &time_distance_bss_matrix_}) {
+    counters.settled_edges += matrix->settled_edges();
+  }
+  for (const auto* expansion :
+       std::vector<const Dijkstras*>{&isochrone_gen, &centroid_gen, &one_to_many_gen}) {
+    counters.settled_edges += expansion->settled_edges();
+  }
+  add_reader(*reader);
+  // the slots may be busy on their own threads so we read what they published
+  for (const auto& slot : leg_slots) {
+    counters.settled_edges += slot->settled_edges;
+    counters.tile_cache_hits += slot->tile_cache_hits;
+    counters.tile_cache_misses += slot->tile_cache_misses;
+  }
+  return counters;
+}
+
+midgard::Finally<std::function<void()>> thor_worker_t::measure_search(Api& api) {
+  // the counters only ever grow so the work of this request is the difference at the end
+  trip_build_time = {};
+  auto start = search_counters();
+  return midgard::Finally<std::function<void()>>([this, &api, start]() {
+    auto end = search_counters();
+    add_statistic(api, "edges_settled", end.settled_edges - start.settled_edges);
+    add_statistic(api, "tile_cache_hits", end.tile_cache_hits - start.tile_cache_hits);
+    add_statistic(api, "tile_cache_misses", end.tile_cache_misses - start.tile_cache_misses);
+    add_statistic(api, "trip_build_ms",
+                  std::chrono::duration<double, std::milli>(trip_build_time).count());
+  });
+}
+
+midgard::Finally<std::function<void()>> thor_worker_t::enforce_budget() {
+  // nothing to enforce or an outer call already does
+  if ((budget.max_settled_edges == 0 && budget.max_tiles_loaded == 0 &&
+       budget.max_time.count() == 0) ||
+      interrupt == &budget_interrupt) {
+    return midgard::Finally<std::function<void()>>([]() {});
+  }
+
+  // the counters only ever grow so the work of this request is the difference to the start
+  const auto* outer = interrupt;
+  const auto start = search_counters();
+  const auto started = std::chrono::steady_clock::now();
+  budget_check = [this, start, started]() {
+    if (budget.max_time.count() && std::chrono::steady_clock::now() - started > budget.max_time) {
+      throw valhalla_exception_t{446, ": more than " + std::to_string(budget.max_time.count()) +
+                                          " ms"};
+    }
+    if (budget.max_settled_edges == 0 && budget.max_tiles_loaded == 0) {
+      return;
+    }
+    const auto now = search_counters();
+    if (budget.max_settled_edges &&
+        now.settled_edges - start.settled_edges > budget.max_settled_edges) {
+      throw valhalla_exception_t{446, ": more than " + std::to_string(budget.max_settled_edges) +
+                                          " edges settled"};
+    }
+    if (budget.max_tiles_loaded &&
+        now.tile_cache_misses - start.tile_cache_misses > budget.max_tiles_loaded) {
+      throw valhalla_exception_t{446, ": more than " + std::to_string(budget.max_tiles_loaded) +
+                                          " tiles loaded"};
+    }
+  };
+  budget_interrupt = [this, outer]() {
+    if (outer) {
+      (*outer)();
+    }
+    budget_check();
+  };
+  set_interrupt(&budget_interrupt);
+  return midgard::Finally<std::function<void()>>([this, outer]() {
+    set_interrupt(outer);
+    budget_check = nullptr;
+  });
+}
+
 void thor_worker_t::cleanup() {
   service_worker_t::cleanup();
   bidir_astar.Clear();
@@ -326,8 +524,19 @@ void thor_worker_t::cleanup() {
   costmatrix_.Clear();
   time_distance_matrix_.Clear();
   time_distance_bss_matrix_.Clear();
+  // a failed matrix request may not have unset its row writer
+  for (auto* alg : std::vector<MatrixAlgorithm*>{&costmatrix_, &time_distance_matrix_,
+                                                 &time_distance_bss_matrix_}) {
+    alg->set_row_callback(nullptr);
+  }
   isochrone_gen.Clear();
   centroid_gen.Clear();
+  one_to_many_gen.Clear();
+  for (auto& slot : leg_slots) {
+    slot->bidir_astar.Clear();
+    slot->timedep_forward.Clear();
+    slot->mode_costing = {};
+  }
   matcher_factory.ClearFullCache();
   if (reader->OverCommitted()) {
     reader->Trim();
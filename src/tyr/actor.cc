@@ -89,19 +89,25 @@ std::string
 actor_t::route(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
-  if (!api) {
-    api = &dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
+  const bool wanted = api != nullptr;
+  if (!wanted) {
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::route, *api);
-  // check the request and locate the locations in the graph
-  pimpl->loki_worker.route(*api);
-  // route between the locations in the graph to find the best path
-  pimpl->thor_worker.route(*api);
-  // get some directions back from them and serialize
-  auto bytes = pimpl->odin_worker.narrate(*api);
+  // a cached response comes without the intermediate results, only use it if they aren't wanted
+  std::string bytes;
+  if (wanted || !pimpl->loki_worker.cached_result(*api, bytes)) {
+    // check the request and locate the locations in the graph
+    pimpl->loki_worker.route(*api);
+    // route between the locations in the graph to find the best path
+    pimpl->thor_worker.route(*api);
+    // get some directions back from them and serialize
+    bytes = pimpl->odin_worker.narrate(*api);
+    pimpl->odin_worker.cache_result(*api, bytes);
+  }
   // if they want you do to do the cleanup automatically
   if (auto_cleanup) {
     cleanup();
@@ -113,10 +119,10 @@ std::string
 actor_t::locate(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::locate, *api);
@@ -133,17 +139,23 @@ std::string
 actor_t::matrix(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
-  if (!api) {
-    api = &dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
+  const bool wanted = api != nullptr;
+  if (!wanted) {
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::sources_to_targets, *api);
-  // check the request and locate the locations in the graph
-  pimpl->loki_worker.matrix(*api);
-  // compute the matrix
-  auto bytes = pimpl->thor_worker.matrix(*api);
+  // a cached response comes without the intermediate results, only use it if they aren't wanted
+  std::string bytes;
+  if (wanted || !pimpl->loki_worker.cached_result(*api, bytes)) {
+    // check the request and locate the locations in the graph
+    pimpl->loki_worker.matrix(*api);
+    // compute the matrix
+    bytes = pimpl->thor_worker.matrix(*api);
+    pimpl->thor_worker.cache_result(*api, bytes);
+  }
   // if they want you do to do the cleanup automatically
   if (auto_cleanup) {
     cleanup();
@@ -156,19 +168,25 @@ std::string actor_t::optimized_route(const std::string& request_str,
                                      Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
-  if (!api) {
-    api = &dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
+  const bool wanted = api != nullptr;
+  if (!wanted) {
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::optimized_route, *api);
-  // check the request and locate the locations in the graph
-  pimpl->loki_worker.matrix(*api);
-  // compute compute all pairs and then the shortest path through them all
-  pimpl->thor_worker.optimized_route(*api);
-  // get some directions back from them and serialize
-  auto bytes = pimpl->odin_worker.narrate(*api);
+  // a cached response comes without the intermediate results, only use it if they aren't wanted
+  std::string bytes;
+  if (wanted || !pimpl->loki_worker.cached_result(*api, bytes)) {
+    // check the request and locate the locations in the graph
+    pimpl->loki_worker.matrix(*api);
+    // compute compute all pairs and then the shortest path through them all
+    pimpl->thor_worker.optimized_route(*api);
+    // get some directions back from them and serialize
+    bytes = pimpl->odin_worker.narrate(*api);
+    pimpl->odin_worker.cache_result(*api, bytes);
+  }
   // if they want you do to do the cleanup automatically
   if (auto_cleanup) {
     cleanup();
@@ -180,22 +198,28 @@ std::string
 actor_t::isochrone(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
-  if (!api) {
-    api = &dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
+  const bool wanted = api != nullptr;
+  if (!wanted) {
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::isochrone, *api);
-  // check the request and locate the locations in the graph
-  pimpl->loki_worker.isochrones(*api);
-  // compute the isochrones
-  auto json = pimpl->thor_worker.isochrones(*api);
+  // a cached response comes without the intermediate results, only use it if they aren't wanted
+  std::string bytes;
+  if (wanted || !pimpl->loki_worker.cached_result(*api, bytes)) {
+    // check the request and locate the locations in the graph
+    pimpl->loki_worker.isochrones(*api);
+    // compute the isochrones
+    bytes = pimpl->thor_worker.isochrones(*api);
+    pimpl->thor_worker.cache_result(*api, bytes);
+  }
   // if they want you do to do the cleanup automatically
   if (auto_cleanup) {
     cleanup();
   }
-  return json;
+  return bytes;
 }
 
 std::string actor_t::trace_route(const std::string& request_str,
@@ -203,10 +227,10 @@ std::string actor_t::trace_route(const std::string& request_str,
                                  Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::trace_route, *api);
@@ -228,10 +252,10 @@ std::string actor_t::trace_attributes(const std::string& request_str,
                                       Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::trace_attributes, *api);
@@ -250,10 +274,10 @@ std::string
 actor_t::height(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::height, *api);
@@ -271,10 +295,10 @@ std::string actor_t::transit_available(const std::string& request_str,
                                        Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::transit_available, *api);
@@ -291,10 +315,10 @@ std::string
 actor_t::expansion(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::expansion, *api);
@@ -319,10 +343,10 @@ std::string
 actor_t::centroid(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::centroid, *api);
@@ -343,10 +367,10 @@ std::string
 actor_t::status(const std::string& request_str, const std::function<void()>* interrupt, Api* api) {
   // set the interrupts
   pimpl->set_interrupts(interrupt);
-  // if the caller doesn't want a copy we'll use this dummy
-  Api dummy;
+  // if the caller doesn't want a copy we'll use a throwaway one on an arena
+  google::protobuf::Arena arena(pimpl->loki_worker.request_arena_options());
   if (!api) {
-    api = &dummy;
+    api = google::protobuf::Arena::CreateMessage<Api>(&arena);
   }
   // parse the request
   ParseApi(request_str, Options::status, *api);
@@ -1,8 +1,8 @@
-#include "baldr/json.h"
+#include "baldr/rapidjson_utils.h"
 #include "skadi/sample.h"
 #include "tyr/serializers.h"
 
-#include <sstream>
+#include <cmath>
 
 using namespace valhalla;
 using namespace valhalla::midgard;
@@ -10,51 +10,70 @@ using namespace valhalla::baldr;
 
 namespace {
 
-json::ArrayPtr serialize_range_height(const std::vector<double>& ranges,
-                                      const std::vector<double>& heights,
-                                      const uint32_t precision,
-                                      const double no_data_value) {
-  auto array = json::array({});
+// heights without decimals are written as integers
+void serialize_value(rapidjson::writer_wrapper_t& writer,
+                     const double value,
+                     const uint32_t precision) {
+  if (precision == 0) {
+    writer(static_cast<int64_t>(std::round(value)));
+  } else {
+    writer(value);
+  }
+}
+
+void serialize_range_height(rapidjson::writer_wrapper_t& writer,
+                            const std::vector<double>& ranges,
+                            const std::vector<double>& heights,
+                            const uint32_t precision,
+                            const double no_data_value) {
+  writer.start_array("range_height");
   // for each posting
   auto range = ranges.cbegin();
 
   for (const auto height : heights) {
-    auto element = json::array({json::fixed_t{*range, 0}});
+    writer.start_array();
+    serialize_value(writer, *range, 0);
     if (height == no_data_value) {
-      element->push_back(nullptr);
+      writer(nullptr);
     } else {
-      element->push_back({json::fixed_t{height, precision}});
+      serialize_value(writer, height, precision);
     }
-    array->push_back(element);
+    writer.end_array();
     ++range;
   }
-  return array;
+  writer.end_array();
 }
 
-json::ArrayPtr serialize_height(const std::vector<double>& heights,
-                                const uint32_t precision,
-                                const double no_data_value) {
-  auto array = json::array({});
+void serialize_height(rapidjson::writer_wrapper_t& writer,
+                      const std::vector<double>& heights,
+                      const uint32_t precision,
+                      const double no_data_value) {
+  writer.start_array("height");
 
   for (const auto height : heights) {
     // add all heights's to an array
     if (height == no_data_value) {
-      array->push_back(nullptr);
+      writer(nullptr);
     } else {
-      array->push_back({json::fixed_t{height, precision}});
+      serialize_value(writer, height, precision);
     }
   }
 
-  return array;
+  writer.end_array();
 }
 
-json::ArrayPtr serialize_shape(const google::protobuf::RepeatedPtrField<valhalla::Location>& shape) {
-  auto array = json::array({});
+void serialize_shape(rapidjson::writer_wrapper_t& writer,
+                     const google::protobuf::RepeatedPtrField<valhalla::Location>& shape) {
+  writer.start_array("shape");
+  writer.set_precision(tyr::kCoordinatePrecision);
   for (const auto& p : shape) {
-    array->emplace_back(json::map(
-        {{"lon", json::fixed_t{p.ll().lng(), 6}}, {"lat", json::fixed_t{p.ll().lat(), 6}}}));
+    writer.start_object();
+    writer("lat", p.ll().lat());
+    writer("lon", p.ll().lng());
+    writer.end_object();
   }
-  return array;
+  writer.set_precision(tyr::kDefaultPrecision);
+  writer.end_array();
 }
 
 } // namespace
@@ -71,37 +90,45 @@ namespace tyr {
 std::string serializeHeight(const Api& request,
                             const std::vector<double>& heights,
                             const std::vector<double>& ranges) {
-  auto json = json::map({});
+  rapidjson::writer_wrapper_t writer(4096);
+  writer.start_object();
+
+  // send back the shape as well
+  if (request.options().has_encoded_polyline_case()) {
+    writer("encoded_polyline", request.options().encoded_polyline());
+  } else {
+    serialize_shape(writer, request.options().shape());
+  }
 
   // get the precision to use for returned heights
   uint32_t precision = request.options().height_precision();
+  writer.set_precision(precision);
 
   // get the distances between the postings
   if (ranges.size()) {
-    json = json::map({{"range_height", serialize_range_height(ranges, heights, precision,
-                                                              skadi::get_no_data_value())}});
+    serialize_range_height(writer, ranges, heights, precision, skadi::get_no_data_value());
   } // just the postings
   else {
-    json = json::map({{"height", serialize_height(heights, precision, skadi::get_no_data_value())}});
-  }
-  // send back the shape as well
-  if (request.options().has_encoded_polyline_case()) {
-    json->emplace("encoded_polyline", request.options().encoded_polyline());
-  } else {
-    json->emplace("shape", serialize_shape(request.options().shape()));
+    serialize_height(writer, heights, precision, skadi::get_no_data_value());
   }
+  writer.set_precision(kDefaultPrecision);
+
   if (request.options().has_id_case()) {
-    json->emplace("id", request.options().id());
+    writer("id", request.options().id());
   }
 
   // add warnings to json response
   if (request.info().warnings_size() >= 1) {
-    json->emplace("warnings", serializeWarnings(request));
+    serializeWarnings(request, writer);
+  }
+
+  // add the statistics collected along the pipeline if they were asked for
+  if (request.options().statistics()) {
+    serializeStatistics(request, writer);
   }
 
-  std::stringstream ss;
-  ss << *json;
-  return ss.str();
+  writer.end_object();
+  return writer.get_buffer();
 }
 } // namespace tyr
 } // namespace valhalla
@@ -1,5 +1,5 @@
 
-#include "baldr/json.h"
+#include "baldr/rapidjson_utils.h"
 #include "midgard/point2.h"
 #include "midgard/pointll.h"
 #include "thor/worker.h"
@@ -13,8 +13,6 @@
 #include <gdal_priv.h>
 #endif
 
-using namespace valhalla::baldr::json;
-
 namespace {
 
 // allows us to only ever register the driver once per process without having to put it
@@ -125,34 +123,51 @@ std::string getIntervalColor(std::vector<contour_interval_t>& intervals, size_t
   return hex.str();
 }
 
-void addLocations(Api& request, valhalla::baldr::json::ArrayPtr& features) {
+void addLocations(Api& request, rapidjson::writer_wrapper_t& writer) {
   int idx = 0;
   for (const auto& location : request.options().locations()) {
     // first add all snapped points as MultiPoint feature per origin point
-    auto snapped_points_array = array({});
+    writer.start_object();
+    writer("type", "Feature");
+    writer.start_object("properties");
+    writer("type", "snapped");
+    writer("location_index", static_cast<uint64_t>(idx));
+    writer.end_object();
+    writer.start_object("geometry");
+    writer("type", "MultiPoint");
+    writer.start_array("coordinates");
+    writer.set_precision(6);
     std::unordered_set<PointLL> snapped_points;
     for (const auto& path_edge : location.correlation().edges()) {
       const PointLL& snapped_current = PointLL(path_edge.ll().lng(), path_edge.ll().lat());
       // remove duplicates of path_edges in case the snapped object is a node
       if (snapped_points.insert(snapped_current).second) {
-        snapped_points_array->push_back(
-            array({fixed_t{snapped_current.lng(), 6}, fixed_t{snapped_current.lat(), 6}}));
+        writer.start_array();
+        writer(snapped_current.lng());
+        writer(snapped_current.lat());
+        writer.end_array();
       }
     };
-    features->emplace_back(map({{"type", std::string("Feature")},
-                                {"properties", map({{"type", std::string("snapped")},
-                                                    {"location_index", static_cast<uint64_t>(idx)}})},
-                                {"geometry", map({{"type", std::string("MultiPoint")},
-                                                  {"coordinates", snapped_points_array}})}}));
+    writer.end_array();
+    writer.end_object();
+    writer.end_object();
 
     // then each user input point as separate Point feature
     const valhalla::LatLng& input_latlng = location.ll();
-    const auto input_array = array({fixed_t{input_latlng.lng(), 6}, fixed_t{input_latlng.lat(), 6}});
-    features->emplace_back(
-        map({{"type", std::string("Feature")},
-             {"properties",
-              map({{"type", std::string("input")}, {"location_index", static_cast<uint64_t>(idx)}})},
-             {"geometry", map({{"type", std::string("Point")}, {"coordinates", input_array}})}}));
+    writer.start_object();
+    writer("type", "Feature");
+    writer.start_object("properties");
+    writer("type", "input");
+    writer("location_index", static_cast<uint64_t>(idx));
+    writer.end_object();
+    writer.start_object("geometry");
+    writer("type", "Point");
+    writer.start_array("coordinates");
+    writer(input_latlng.lng());
+    writer(input_latlng.lat());
+    writer.end_array();
+    writer.end_object();
+    writer.end_object();
     idx++;
   }
 }
@@ -242,14 +257,29 @@ std::string serializeGeoTIFF(Api& request, const std::shared_ptr<const GriddedDa
 };
 #endif
 
+void writeRing(rapidjson::writer_wrapper_t& writer, const contour_t& ring) {
+  writer.start_array();
+  for (const auto& pair : ring) {
+    writer.start_array();
+    writer(pair.lng());
+    writer(pair.lat());
+    writer.end_array();
+  }
+  writer.end_array();
+}
+
 std::string serializeIsochroneJson(Api& request,
                                    std::vector<contour_interval_t>& intervals,
                                    contours_t& contours,
                                    bool show_locations,
                                    bool polygons) {
+  rapidjson::writer_wrapper_t writer(4096);
+  writer.start_object();
+  writer("type", "FeatureCollection");
+  writer.start_array("features");
+
   // for each contour interval
   int i = 0;
-  auto features = array({});
   assert(intervals.size() == contours.size());
   for (size_t contour_index = 0; contour_index < intervals.size(); ++contour_index) {
     const auto& interval = intervals[contour_index];
@@ -261,70 +291,79 @@ std::string serializeIsochroneJson(Api& request,
     // for each feature on that interval
     for (const auto& feature : interval_contours) {
       grouped_contours_t groups = GroupContours(polygons, feature);
-      auto geom = array({});
-      // each group is a polygon consisting of an exterior ring and possibly inner rings
-      for (const auto& group : groups) {
-        auto poly = array({});
-        for (const auto& ring : group) {
-          auto ring_coords = array({});
-          for (const auto& pair : *ring) {
-            ring_coords->push_back(array({fixed_t{pair.lng(), 6}, fixed_t{pair.lat(), 6}}));
-          }
-          if (polygons) {
-            poly->emplace_back(ring_coords);
-          } else {
-            poly = ring_coords;
-          }
-        }
-        geom->emplace_back(poly);
-      }
+      if (groups.empty())
+        continue;
 
       // add a feature
-      features->emplace_back(map({
-          {"type", std::string("Feature")},
-          {"geometry",
-           map({
-               {"type", std::string(polygons ? groups.size() > 1 ? "MultiPolygon" : "Polygon"
-                                             : "LineString")},
-               {"coordinates",
-                polygons && geom->size() > 1 ? geom : geom->at(0)}, // unwrap linestring, or polygon
-                                                                    // if there's only one
-           })},
-          {"properties", map({
-                             {"metric", std::get<2>(interval)},
-                             {"contour", baldr::json::float_t{std::get<1>(interval)}},
-                             {"color", hex},                     // lines
-                             {"fill", hex},                      // geojson.io polys
-                             {"fillColor", hex},                 // leaflet polys
-                             {"opacity", fixed_t{.33f, 2}},      // lines
-                             {"fill-opacity", fixed_t{.33f, 2}}, // geojson.io polys
-                             {"fillOpacity", fixed_t{.33f, 2}},  // leaflet polys
-                         })},
-      }));
+      writer.start_object();
+      writer("type", "Feature");
+      writer.start_object("geometry");
+      writer("type", polygons ? groups.size() > 1 ? "MultiPolygon" : "Polygon" : "LineString");
+      writer.set_precision(6);
+      writer.start_array("coordinates");
+      // each group is a polygon consisting of an exterior ring and possibly inner rings,
+      // unwrap linestrings, or polygons if there's only one
+      if (!polygons) {
+        // there is only ever one ring per group
+        const auto& ring = *groups.front().front();
+        for (const auto& pair : ring) {
+          writer.start_array();
+          writer(pair.lng());
+          writer(pair.lat());
+          writer.end_array();
+        }
+      } else if (groups.size() == 1) {
+        for (const auto* ring : groups.front())
+          writeRing(writer, *ring);
+      } else {
+        for (const auto& group : groups) {
+          writer.start_array();
+          for (const auto* ring : group)
+            writeRing(writer, *ring);
+          writer.end_array();
+        }
+      }
+      writer.end_array();
+      writer.end_object();
+
+      writer.start_object("properties");
+      writer("metric", std::get<2>(interval));
+      // round away the float noise so that e.g. 9.1 doesn't come out as 9.100000381
+      writer("contour", std::round(static_cast<double>(std::get<1>(interval)) * 1e6) / 1e6);
+      writer("color", hex);     // lines
+      writer("fill", hex);      // geojson.io polys
+      writer("fillColor", hex); // leaflet polys
+      writer.set_precision(2);
+      writer("opacity", .33);      // lines
+      writer("fill-opacity", .33); // geojson.io polys
+      writer("fillOpacity", .33);  // leaflet polys
+      writer.end_object();
+      writer.end_object();
     }
   }
 
-  if (show_locations)
-    addLocations(request, features);
-
-  auto feature_collection = map({
-      {"type", std::string("FeatureCollection")},
-      {"features", features},
-  });
+  if (show_locations) {
+    writer.set_precision(6);
+    addLocations(request, writer);
+  }
+  writer.end_array();
 
   if (request.options().has_id_case()) {
-    feature_collection->emplace("id", request.options().id());
+    writer("id", request.options().id());
   }
 
   // add warnings to json response
   if (request.info().warnings_size() >= 1) {
-    feature_collection->emplace("warnings", serializeWarnings(request));
+    serializeWarnings(request, writer);
   }
 
-  std::stringstream ss;
-  ss << *feature_collection;
+  // add the statistics collected along the pipeline if they were asked for
+  if (request.options().statistics()) {
+    serializeStatistics(request, writer);
+  }
 
-  return ss.str();
+  writer.end_object();
+  return writer.get_buffer();
 }
 
 std::string serializeIsochronePbf(Api& request,
@@ -1,8 +1,10 @@
 #include "baldr/json.h"
 #include "baldr/openlr.h"
+#include "baldr/rapidjson_utils.h"
 #include "tyr/serializers.h"
 
 #include <cstdint>
+#include <sstream>
 
 using namespace valhalla;
 using namespace valhalla::midgard;
@@ -26,13 +28,22 @@ OpenLR::LocationReferencePoint::FormOfWay get_fow(const baldr::DirectedEdge* de)
   return OpenLR::LocationReferencePoint::OTHER;
 }
 
-json::ArrayPtr get_access_restrictions(const graph_tile_ptr& tile, uint32_t edge_idx) {
-  auto arr = json::array({});
+// the verbose parts of the response come from the graph objects themselves as json maps so we
+// render those once and splice them into the stream
+std::string dump(const json::Value& value) {
+  std::stringstream ss;
+  json::applyOutputVisitor(ss, value);
+  return ss.str();
+}
+
+void get_access_restrictions(rapidjson::writer_wrapper_t& writer,
+                             const graph_tile_ptr& tile,
+                             uint32_t edge_idx) {
+  writer.start_array("access_restrictions");
   for (const auto& res : tile->GetAccessRestrictions(edge_idx, kAllAccess)) {
-    arr->emplace_back(res.json());
+    writer.raw(dump(res.json()), rapidjson::kObjectType);
   };
-
-  return arr;
+  writer.end_array();
 }
 
 std::string
@@ -62,78 +73,93 @@ linear_reference(const baldr::DirectedEdge* de, float percent_along, const EdgeI
       .toBase64();
 }
 
-json::ArrayPtr serialize_edges(const PathLocation& location, GraphReader& reader, bool verbose) {
-  auto array = json::array({});
+const char* side_of_street(const PathLocation::PathEdge& edge) {
+  return edge.sos == PathLocation::LEFT ? "left"
+                                        : (edge.sos == PathLocation::RIGHT ? "right" : "neither");
+}
+
+void serialize_edges(rapidjson::writer_wrapper_t& writer,
+                     const PathLocation& location,
+                     GraphReader& reader,
+                     bool verbose) {
+  writer.start_array("edges");
   for (const auto& edge : location.edges) {
     try {
       // get the osm way id
       auto tile = reader.GetGraphTile(edge.id);
       auto* directed_edge = tile->directededge(edge.id);
       auto edge_info = tile->edgeinfo(directed_edge);
-      // they want MOAR!
+      // render the pieces that can throw before we start writing this edge
+      std::string edge_id, edge_json, edge_info_json, live_speed;
       if (verbose) {
+        edge_id = dump(edge.id.json());
+        edge_json = dump(directed_edge->json());
+        edge_info_json = dump(edge_info.json());
         // live traffic information
         const volatile auto& traffic = tile->trafficspeed(directed_edge);
-        auto live_speed = traffic.json();
+        live_speed = dump(traffic.json());
 
         // incident information
         if (traffic.has_incidents) {
           // TODO: incidents
         }
+      }
+
+      writer.start_object();
+      // they want MOAR!
+      if (verbose) {
+        // basic rest of it plus edge metadata
+        writer.set_precision(6);
+        writer("correlated_lat", edge.projected.lat());
+        writer("correlated_lon", edge.projected.lng());
+        writer("side_of_street", side_of_street(edge));
+        writer.set_precision(5);
+        writer("percent_along", edge.percent_along);
+        writer.set_precision(1);
+        writer("distance", edge.distance);
+        writer("heading", edge.projected_heading);
+        writer("outbound_reach", static_cast<int64_t>(edge.outbound_reach));
+        writer("inbound_reach", static_cast<int64_t>(edge.inbound_reach));
+        writer.raw("edge_id", edge_id,
+                   edge.id.Is_Valid() ? rapidjson::kObjectType : rapidjson::kNullType);
+        writer.raw("edge", edge_json, rapidjson::kObjectType);
+        writer.raw("edge_info", edge_info_json, rapidjson::kObjectType);
+        writer("linear_reference", linear_reference(directed_edge, edge.percent_along, edge_info));
 
         // historical traffic information
-        auto predicted_speeds = json::array({});
+        writer.start_array("predicted_speeds");
         if (directed_edge->has_predicted_speed()) {
           for (auto sec = 0; sec < midgard::kSecondsPerWeek; sec += 5 * midgard::kSecPerMinute) {
-            predicted_speeds->emplace_back(
-                static_cast<uint64_t>(tile->GetSpeed(directed_edge, kPredictedFlowMask, sec)));
+            writer(static_cast<uint64_t>(tile->GetSpeed(directed_edge, kPredictedFlowMask, sec)));
           }
         }
-
-        // basic rest of it plus edge metadata
-        array->emplace_back(json::map({
-            {"correlated_lat", json::fixed_t{edge.projected.lat(), 6}},
-            {"correlated_lon", json::fixed_t{edge.projected.lng(), 6}},
-            {"side_of_street",
-             edge.sos == PathLocation::LEFT
-                 ? std::string("left")
-                 : (edge.sos == PathLocation::RIGHT ? std::string("right") : std::string("neither"))},
-            {"percent_along", json::fixed_t{edge.percent_along, 5}},
-            {"distance", json::fixed_t{edge.distance, 1}},
-            {"heading", json::fixed_t{edge.projected_heading, 1}},
-            {"outbound_reach", static_cast<int64_t>(edge.outbound_reach)},
-            {"inbound_reach", static_cast<int64_t>(edge.inbound_reach)},
-            {"edge_id", edge.id.json()},
-            {"edge", directed_edge->json()},
-            {"edge_info", edge_info.json()},
-            {"linear_reference", linear_reference(directed_edge, edge.percent_along, edge_info)},
-            {"predicted_speeds", predicted_speeds},
-            {"live_speed", live_speed},
-            {"access_restrictions", get_access_restrictions(tile, edge.id.id())},
-            {"shoulder", directed_edge->shoulder()},
-        }));
+        writer.end_array();
+        writer.raw("live_speed", live_speed, rapidjson::kObjectType);
+        get_access_restrictions(writer, tile, edge.id.id());
+        writer("shoulder", directed_edge->shoulder());
       } // they want it lean and mean
       else {
-        array->emplace_back(json::map({
-            {"way_id", static_cast<uint64_t>(edge_info.wayid())},
-            {"correlated_lat", json::fixed_t{edge.projected.lat(), 6}},
-            {"correlated_lon", json::fixed_t{edge.projected.lng(), 6}},
-            {"side_of_street",
-             edge.sos == PathLocation::LEFT
-                 ? std::string("left")
-                 : (edge.sos == PathLocation::RIGHT ? std::string("right") : std::string("neither"))},
-            {"percent_along", json::fixed_t{edge.percent_along, 5}},
-        }));
+        writer("way_id", static_cast<uint64_t>(edge_info.wayid()));
+        writer.set_precision(6);
+        writer("correlated_lat", edge.projected.lat());
+        writer("correlated_lon", edge.projected.lng());
+        writer("side_of_street", side_of_street(edge));
+        writer.set_precision(5);
+        writer("percent_along", edge.percent_along);
       }
+      writer.end_object();
     } catch (...) {
       // this really shouldnt ever get hit
       LOG_WARN("Expected edge not found in graph but found by loki::search!");
     }
   }
-  return array;
+  writer.end_array();
 }
 
-json::ArrayPtr serialize_nodes(const PathLocation& location, GraphReader& reader, bool verbose) {
+void serialize_nodes(rapidjson::writer_wrapper_t& writer,
+                     const PathLocation& location,
+                     GraphReader& reader,
+                     bool verbose) {
   // get the nodes we need
   std::unordered_set<uint64_t> nodes;
   for (const auto& e : location.edges) {
@@ -141,52 +167,58 @@ json::ArrayPtr serialize_nodes(const PathLocation& location, GraphReader& reader
       nodes.emplace(reader.GetGraphTile(e.id)->directededge(e.id)->endnode());
     }
   }
-  // ad them into an array of json
-  auto array = json::array({});
+  // add them into an array of json
+  writer.start_array("nodes");
   for (auto node_id : nodes) {
     GraphId n(node_id);
     graph_tile_ptr tile = reader.GetGraphTile(n);
     auto* node_info = tile->node(n);
-    json::MapPtr node;
     if (verbose) {
-      node = node_info->json(tile);
+      auto node = node_info->json(tile);
       node->emplace("node_id", n.json());
+      writer.raw(dump(node), rapidjson::kObjectType);
     } else {
       midgard::PointLL node_ll = tile->get_node_ll(n);
-      node = json::map({
-          {"lon", json::fixed_t{node_ll.first, 6}}, {"lat", json::fixed_t{node_ll.second, 6}},
-          // TODO: osm_id
-      });
+      writer.start_object();
+      writer.set_precision(6);
+      writer("lon", node_ll.first);
+      writer("lat", node_ll.second);
+      // TODO: osm_id
+      writer.end_object();
     }
-    array->emplace_back(node);
   }
   // give them back
-  return array;
+  writer.end_array();
 }
 
-json::MapPtr serialize(const PathLocation& location, GraphReader& reader, bool verbose) {
+void serialize(rapidjson::writer_wrapper_t& writer,
+               const PathLocation& location,
+               GraphReader& reader,
+               bool verbose) {
   // serialze all the edges
-  auto m = json::map({
-      {"edges", serialize_edges(location, reader, verbose)},
-      {"nodes", serialize_nodes(location, reader, verbose)},
-      {"input_lat", json::fixed_t{location.latlng_.lat(), 6}},
-      {"input_lon", json::fixed_t{location.latlng_.lng(), 6}},
-  });
-  return m;
+  writer.start_object();
+  serialize_edges(writer, location, reader, verbose);
+  serialize_nodes(writer, location, reader, verbose);
+  writer.set_precision(6);
+  writer("input_lat", location.latlng_.lat());
+  writer("input_lon", location.latlng_.lng());
+  writer.end_object();
 }
 
-json::MapPtr serialize(const midgard::PointLL& ll, const std::string& reason, bool verbose) {
-  auto m = json::map({
-      {"edges", static_cast<std::nullptr_t>(nullptr)},
-      {"nodes", static_cast<std::nullptr_t>(nullptr)},
-      {"input_lat", json::fixed_t{ll.lat(), 6}},
-      {"input_lon", json::fixed_t{ll.lng(), 6}},
-  });
+void serialize(rapidjson::writer_wrapper_t& writer,
+               const midgard::PointLL& ll,
+               const std::string& reason,
+               bool verbose) {
+  writer.start_object();
+  writer("edges", nullptr);
+  writer("nodes", nullptr);
+  writer.set_precision(6);
+  writer("input_lat", ll.lat());
+  writer("input_lon", ll.lng());
   if (verbose) {
-    m->emplace("reason", reason);
+    writer("reason", reason);
   }
-
-  return m;
+  writer.end_object();
 }
 } // namespace
 
@@ -197,19 +229,18 @@ std::string serializeLocate(const Api& request,
                             const std::vector<baldr::Location>& locations,
                             const std::unordered_map<baldr::Location, PathLocation>& projections,
                             GraphReader& reader) {
-  auto json = json::array({});
+  rapidjson::writer_wrapper_t writer(1024 * locations.size());
+  writer.start_array();
   for (const auto& location : locations) {
-    try {
-      json->emplace_back(serialize(projections.at(location), reader, request.options().verbose()));
-    } catch (const std::exception& e) {
-      json->emplace_back(
-          serialize(location.latlng_, "No data found for location", request.options().verbose()));
+    auto projection = projections.find(location);
+    if (projection != projections.end()) {
+      serialize(writer, projection->second, reader, request.options().verbose());
+    } else {
+      serialize(writer, location.latlng_, "No data found for location", request.options().verbose());
     }
   }
-
-  std::stringstream ss;
-  ss << *json;
-  return ss.str();
+  writer.end_array();
+  return writer.get_buffer();
 }
 
 } // namespace tyr
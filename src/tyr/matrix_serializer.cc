@@ -3,7 +3,11 @@
 #include "thor/matrixalgorithm.h"
 #include "tyr/serializers.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 
 using namespace valhalla;
 using namespace valhalla::midgard;
@@ -12,6 +16,26 @@ using namespace valhalla::thor;
 
 namespace {
 
+// Leads the dense binary matrix format, see MatrixRowWriter
+constexpr char kBinaryMatrixMagic[] = {'V', 'M', 'T', 'X'};
+constexpr uint16_t kBinaryMatrixVersion = 1;
+constexpr uint16_t kBinaryMatrixMiles = 1;
+constexpr size_t kBinaryMatrixHeaderSize = sizeof(kBinaryMatrixMagic) + 2 * sizeof(uint16_t) +
+                                           2 * sizeof(uint32_t);
+
+// append in little-endian whatever the byte order of the machine
+template <typename T> void append_le(std::string& bytes, const T value) {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void append_le(std::string& bytes, const float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  append_le(bytes, bits);
+}
+
 void serialize_duration(const valhalla::Matrix& matrix,
                         rapidjson::writer_wrapper_t& writer,
                         size_t start_td,
@@ -284,6 +308,11 @@ std::string serialize(const Api& request, double distance_scale) {
     tyr::serializeWarnings(request, writer);
   }
 
+  // add the statistics collected along the pipeline if they were asked for
+  if (request.options().statistics()) {
+    tyr::serializeStatistics(request, writer);
+  }
+
   writer.end_object();
   return writer.get_buffer();
 }
@@ -311,10 +340,132 @@ std::string serializeMatrix(Api& request) {
       return valhalla_serializers::serialize(request, distance_scale);
     case Options_Format_pbf:
       return serializePbf(request);
+    case Options_Format_binary:
+      return MatrixRowWriter(request).Finish(request);
     default:
       throw;
   }
 }
 
+MatrixRowWriter::MatrixRowWriter(const Api& request)
+    : sources_(request.options().sources_size()), targets_(request.options().targets_size()),
+      next_row_(0), distance_scale_(request.options().units() == Options::miles ? kMilePerMeter
+                                                                                 : kKmPerMeter),
+      binary_(request.options().format() == Options::binary), found_(false) {
+  const size_t cells = static_cast<size_t>(sources_) * targets_;
+  if (binary_) {
+    binary_durations_.reserve(cells * sizeof(uint32_t));
+    binary_distances_.reserve(cells * sizeof(float));
+    return;
+  }
+
+  // the rows are arrays of arrays which get spliced into the response at the end
+  for (auto* json : {&json_durations_, &json_distances_}) {
+    *json = std::make_unique<rapidjson::writer_wrapper_t>(std::max<size_t>(4096, cells * 8));
+    (*json)->set_precision(kDefaultPrecision);
+    (*json)->start_array();
+  }
+}
+
+MatrixRowWriter::~MatrixRowWriter() = default;
+
+bool MatrixRowWriter::Supports(const Api& request) {
+  const auto& options = request.options();
+  if (options.action() != Options::sources_to_targets) {
+    return false;
+  }
+  return options.format() == Options::binary ||
+         (options.format() == Options::json && !options.verbose() &&
+          options.shape_format() == no_shape);
+}
+
+void MatrixRowWriter::WriteRow(const valhalla::Matrix& matrix, uint32_t source_index) {
+  if (source_index != next_row_ || source_index >= sources_) {
+    return;
+  }
+
+  const size_t first_td = static_cast<size_t>(source_index) * targets_;
+  for (size_t i = first_td; i < first_td + targets_; ++i) {
+    found_ = found_ || matrix.times()[i] != kMaxCost;
+  }
+
+  if (binary_) {
+    for (size_t i = first_td; i < first_td + targets_; ++i) {
+      const auto time = matrix.times()[i];
+      append_le(binary_durations_, time != kMaxCost ? static_cast<uint32_t>(time)
+                                                    : std::numeric_limits<uint32_t>::max());
+      const auto distance = matrix.distances()[i];
+      append_le(binary_distances_,
+                distance != kMaxCost
+                    ? static_cast<float>(static_cast<uint64_t>(distance) * distance_scale_)
+                    : std::numeric_limits<float>::quiet_NaN());
+    }
+  } else {
+    json_durations_->start_array();
+    serialize_duration(matrix, *json_durations_, first_td, targets_);
+    json_durations_->end_array();
+    json_distances_->start_array();
+    serialize_distance(matrix, *json_distances_, first_td, targets_, distance_scale_);
+    json_distances_->end_array();
+  }
+  ++next_row_;
+}
+
+std::string MatrixRowWriter::Finish(Api& request) {
+  // rows which the algorithm only finished at the end
+  while (next_row_ < sources_) {
+    WriteRow(request.matrix(), next_row_);
+  }
+
+  // error if we failed finding any connection
+  if (!found_) {
+    throw valhalla_exception_t(442);
+  }
+
+  const auto& options = request.options();
+  if (binary_) {
+    std::string bytes;
+    bytes.reserve(kBinaryMatrixHeaderSize + binary_durations_.size() + binary_distances_.size());
+    bytes.append(kBinaryMatrixMagic, sizeof(kBinaryMatrixMagic));
+    append_le(bytes, kBinaryMatrixVersion);
+    append_le(bytes, options.units() == Options::miles ? kBinaryMatrixMiles : uint16_t(0));
+    append_le(bytes, sources_);
+    append_le(bytes, targets_);
+    bytes.append(binary_durations_);
+    bytes.append(binary_distances_);
+    return bytes;
+  }
+
+  json_durations_->end_array();
+  json_distances_->end_array();
+  rapidjson::writer_wrapper_t writer(4096 + json_durations_->get_size() +
+                                     json_distances_->get_size());
+  writer.set_precision(kDefaultPrecision);
+  writer.start_object();
+  writer.start_object("sources_to_targets");
+  writer.raw("durations", *json_durations_, rapidjson::kArrayType);
+  writer.raw("distances", *json_distances_, rapidjson::kArrayType);
+  writer.end_object(); // sources_to_targets
+  writer("units", Options_Units_Enum_Name(options.units()));
+  writer("algorithm", MatrixAlgoToString(request.matrix().algorithm()));
+
+  if (options.has_id_case()) {
+    writer("id", options.id());
+  }
+
+  // add warnings to json response
+  if (request.info().warnings_size() >= 1) {
+    serializeWarnings(request, writer);
+  }
+
+  // add the statistics collected along the pipeline if they were asked for
+  if (request.options().statistics()) {
+    serializeStatistics(request, writer);
+  }
+
+  writer.end_object();
+  return writer.get_buffer();
+}
+
 } // namespace tyr
 } // namespace valhalla
@@ -0,0 +1,132 @@
+#include "tyr/result_cache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace valhalla {
+namespace tyr {
+
+ResultCache::ResultCache(size_t max_size, uint32_t max_age, uint32_t check_interval)
+    : max_size_(max_size), max_age_(max_age), check_interval_(check_interval), size_(0),
+      refreshing_(false) {
+}
+
+std::shared_ptr<ResultCache> ResultCache::shared(const boost::property_tree::ptree& config) {
+  const auto max_size = config.get<size_t>("result_cache.max_size", 0);
+  if (max_size == 0) {
+    return nullptr;
+  }
+
+  // workers come and go with their actors, so keep the cache alive only while one of them uses it
+  static std::mutex mutex;
+  static std::weak_ptr<ResultCache> instance;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto cache = instance.lock();
+  if (!cache) {
+    cache =
+        std::make_shared<ResultCache>(max_size, config.get<uint32_t>("result_cache.max_age", 300),
+                                      config.get<uint32_t>("result_cache.check_interval", 10));
+    instance = cache;
+  }
+  return cache;
+}
+
+std::string ResultCache::key(const Api& api, const baldr::GraphReader& reader) {
+  const auto& options = api.options();
+  switch (options.action()) {
+    case Options::route:
+    case Options::sources_to_targets:
+    case Options::optimized_route:
+    case Options::isochrone:
+      break;
+    default:
+      return "";
+  }
+  // the answer depends on the time of the request or carries its timings
+  if (options.date_time_type() == Options::current || options.statistics()) {
+    return "";
+  }
+
+  std::string key;
+  {
+    // the costings are a map, their order is only stable when asked for
+    google::protobuf::io::StringOutputStream stream(&key);
+    google::protobuf::io::CodedOutputStream coded(&stream);
+    coded.SetSerializationDeterministic(true);
+    options.SerializeToCodedStream(&coded);
+  }
+
+  // looking at every traffic tile isn't free so we only do it every so often and never under the
+  // lock, the other workers keep using the old version until the new one is swapped in
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto now = std::chrono::steady_clock::now();
+  if (!refreshing_ && (version_.empty() || now - checked_ >= check_interval_)) {
+    refreshing_ = true;
+    lock.unlock();
+    std::string version;
+    try {
+      version = std::to_string(reader.GetTileSetVersion()) + '_' +
+                std::to_string(reader.GetTrafficLastUpdate()) + '_';
+    } catch (...) {}
+    lock.lock();
+    if (!version.empty()) {
+      version_ = std::move(version);
+    }
+    checked_ = now;
+    refreshing_ = false;
+  }
+  // until the versions are known for the first time nothing can be cached
+  if (version_.empty()) {
+    return "";
+  }
+  return version_ + key;
+}
+
+bool ResultCache::get(const std::string& key, std::string& response) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = entries_.find(key);
+  if (found == entries_.end()) {
+    return false;
+  }
+  if (std::chrono::steady_clock::now() - found->second.stored > max_age_) {
+    erase(found);
+    return false;
+  }
+  recency_.splice(recency_.begin(), recency_, found->second.recency);
+  response = found->second.response;
+  return true;
+}
+
+void ResultCache::put(const std::string& key, const std::string& response) {
+  // one huge response shouldn't flush everything else
+  const auto bytes = key.size() + response.size();
+  if (bytes > max_size_ / 10) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = entries_.find(key);
+  if (found != entries_.end()) {
+    erase(found);
+  }
+  while (!recency_.empty() && size_ + bytes > max_size_) {
+    erase(entries_.find(recency_.back()));
+  }
+  recency_.push_front(key);
+  entries_.emplace(key, entry_t{response, std::chrono::steady_clock::now(), recency_.begin()});
+  size_ += bytes;
+}
+
+size_t ResultCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+void ResultCache::erase(std::unordered_map<std::string, entry_t>::iterator itr) {
+  size_ -= itr->first.size() + itr->second.response.size();
+  recency_.erase(itr->second.recency);
+  entries_.erase(itr);
+}
+
+} // namespace tyr
+} // namespace valhalla
@@ -722,6 +722,11 @@ std::string serialize(Api& api) {
     writer("id", api.options().id());
   }
 
+  // add the statistics collected along the pipeline if they were asked for
+  if (api.options().statistics()) {
+    valhalla::tyr::serializeStatistics(api, writer);
+  }
+
   writer.end_object(); // outer object
 
   return writer.get_buffer();
@@ -6,6 +6,10 @@
 #include "tyr/serializers.h"
 
 #include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace valhalla;
 using namespace valhalla::midgard;
@@ -41,6 +45,152 @@ void serialize_admins(const TripLeg& trip_path, rapidjson::writer_wrapper_t& wri
   writer.end_array();
 }
 
+// starts an array as the value of a key or, without a name, as the element of an enclosing array
+void start_array(rapidjson::writer_wrapper_t& writer, const char* name) {
+  if (name) {
+    writer.start_array(name);
+  } else {
+    writer.start_array();
+  }
+}
+
+// starts an object as the value of a key or, without a name, as the element of an enclosing array
+void start_object(rapidjson::writer_wrapper_t& writer, const char* name) {
+  if (name) {
+    writer.start_object(name);
+  } else {
+    writer.start_object();
+  }
+}
+
+void serialize_lane_connectivity(const TripLeg::Edge& edge,
+                                 rapidjson::writer_wrapper_t& writer,
+                                 const char* name) {
+  start_array(writer, name);
+  for (const auto& l : edge.lane_connectivity()) {
+    writer.start_object();
+    writer("from", l.from_way_id());
+    writer("to_lanes", l.to_lanes());
+    writer("from_lanes", l.from_lanes());
+    writer.end_object();
+  }
+  writer.end_array();
+}
+
+void serialize_levels(const TripLeg::Edge& edge,
+                      rapidjson::writer_wrapper_t& writer,
+                      const char* name) {
+  start_array(writer, name);
+  writer.set_precision(edge.level_precision());
+  for (const auto& level : edge.levels()) {
+    writer.start_array();
+    writer(level.start());
+    writer(level.end());
+    writer.end_array();
+  }
+  writer.end_array();
+  writer.set_precision(tyr::kDefaultPrecision);
+}
+
+void serialize_traffic_segments(const TripLeg::Edge& edge,
+                                rapidjson::writer_wrapper_t& writer,
+                                const char* name) {
+  start_array(writer, name);
+  for (const auto& segment : edge.traffic_segment()) {
+    writer.start_object();
+    writer.set_precision(tyr::kDefaultPrecision);
+    writer("segment_id", segment.segment_id());
+    writer("begin_percent", segment.begin_percent());
+    writer("end_percent", segment.end_percent());
+    writer("starts_segment", segment.starts_segment());
+    writer("ends_segment", segment.ends_segment());
+    writer.end_object();
+  }
+  writer.end_array();
+}
+
+void serialize_sign(const TripLeg::Edge& edge,
+                    rapidjson::writer_wrapper_t& writer,
+                    const char* name) {
+  start_object(writer, name);
+
+  // Populate exit number array
+  if (edge.sign().exit_numbers_size() > 0) {
+    writer.start_array("exit_number");
+    for (const auto& exit_number : edge.sign().exit_numbers()) {
+      writer(exit_number.text());
+    }
+    writer.end_array();
+  }
+
+  // Populate exit branch array
+  if (edge.sign().exit_onto_streets_size() > 0) {
+    writer.start_array("exit_branch");
+    for (const auto& exit_onto_street : edge.sign().exit_onto_streets()) {
+      writer(exit_onto_street.text());
+    }
+    writer.end_array();
+  }
+
+  // Populate exit toward array
+  if (edge.sign().exit_toward_locations_size() > 0) {
+    writer.start_array("exit_toward");
+    for (const auto& exit_toward_location : edge.sign().exit_toward_locations()) {
+      writer(exit_toward_location.text());
+    }
+    writer.end_array();
+  }
+
+  // Populate exit name array
+  if (edge.sign().exit_names_size() > 0) {
+    writer.start_array("exit_name");
+    for (const auto& exit_name : edge.sign().exit_names()) {
+      writer(exit_name.text());
+    }
+    writer.end_array();
+  }
+  writer.end_object();
+}
+
+void serialize_intersecting_edges(const AttributesController& controller,
+                                  const TripLeg::Node& node,
+                                  rapidjson::writer_wrapper_t& writer,
+                                  const char* name) {
+  start_array(writer, name);
+  for (const auto& xedge : node.intersecting_edge()) {
+    writer.start_object();
+    if (controller(kNodeIntersectingEdgeWalkability) &&
+        (xedge.walkability() != TripLeg_Traversability_kNone)) {
+      writer("walkability", to_string(xedge.walkability()));
+    }
+    if (controller(kNodeIntersectingEdgeCyclability) &&
+        (xedge.cyclability() != TripLeg_Traversability_kNone)) {
+      writer("cyclability", to_string(xedge.cyclability()));
+    }
+    if (controller(kNodeIntersectingEdgeDriveability) &&
+        (xedge.driveability() != TripLeg_Traversability_kNone)) {
+      writer("driveability", to_string(xedge.driveability()));
+    }
+    if (controller(kNodeIntersectingEdgeFromEdgeNameConsistency)) {
+      writer("from_edge_name_consistency", xedge.prev_name_consistency());
+    }
+    if (controller(kNodeIntersectingEdgeToEdgeNameConsistency)) {
+      writer("to_edge_name_consistency", xedge.curr_name_consistency());
+    }
+    if (controller(kNodeIntersectingEdgeBeginHeading)) {
+      writer("begin_heading", xedge.begin_heading());
+    }
+    if (controller(kNodeIntersectingEdgeUse)) {
+      writer("use", to_string(static_cast<baldr::Use>(xedge.use())));
+    }
+    if (controller(kNodeIntersectingEdgeRoadClass)) {
+      writer("road_class", to_string(static_cast<baldr::RoadClass>(xedge.road_class())));
+    }
+    writer.end_object();
+  }
+  writer.end_array();
+}
+
 void serialize_edges(const AttributesController& controller,
                      const Options& options,
                      const TripLeg& trip_path,
@@ -94,15 +244,7 @@ void serialize_edges(const AttributesController& controller,
         writer("lane_count", edge.lane_count());
       }
       if (edge.lane_connectivity_size()) {
-        writer.start_array("lane_connectivity");
-        for (const auto& l : edge.lane_connectivity()) {
-          writer.start_object();
-          writer("from", l.from_way_id());
-          writer("to_lanes", l.to_lanes());
-          writer("from_lanes", l.from_lanes());
-          writer.end_object();
-        }
-        writer.end_array();
+        serialize_lane_connectivity(edge, writer, "lane_connectivity");
       }
       if (controller(kEdgeMaxDownwardGrade)) {
         writer("max_downward_grade", edge.max_downward_grade());
@@ -198,16 +340,7 @@ void serialize_edges(const AttributesController& controller,
       }
       if (controller(kEdgeLevels)) {
         if (edge.levels_size()) {
-          writer.start_array("levels");
-          writer.set_precision(edge.level_precision());
-          for (const auto& level : edge.levels()) {
-            writer.start_array();
-            writer(level.start());
-            writer(level.end());
-            writer.end_array();
-          }
-          writer.end_array();
-          writer.set_precision(tyr::kDefaultPrecision);
+          serialize_levels(edge, writer, "levels");
         }
       }
       if (controller(kEdgeLength)) {
@@ -229,61 +362,13 @@ void serialize_edges(const AttributesController& controller,
         writer.end_array();
       }
       if (edge.traffic_segment().size() > 0) {
-        writer.start_array("traffic_segments");
-        for (const auto& segment : edge.traffic_segment()) {
-          writer.start_object();
-          writer.set_precision(tyr::kDefaultPrecision);
-          writer("segment_id", segment.segment_id());
-          writer("begin_percent", segment.begin_percent());
-          writer("end_percent", segment.end_percent());
-          writer("starts_segment", segment.starts_segment());
-          writer("ends_segment", segment.ends_segment());
-          writer.end_object();
-        }
-        writer.end_array();
+        serialize_traffic_segments(edge, writer, "traffic_segments");
       }
 
       // Process edge sign
       // TODO: do we want to output 'is_route_number'?
       if (edge.has_sign()) {
-        writer.start_object("sign");
-
-        // Populate exit number array
-        if (edge.sign().exit_numbers_size() > 0) {
-          writer.start_array("exit_number");
-          for (const auto& exit_number : edge.sign().exit_numbers()) {
-            writer(exit_number.text());
-          }
-          writer.end_array();
-        }
-
-        // Populate exit branch array
-        if (edge.sign().exit_onto_streets_size() > 0) {
-          writer.start_array("exit_branch");
-          for (const auto& exit_onto_street : edge.sign().exit_onto_streets()) {
-            writer(exit_onto_street.text());
-          }
-          writer.end_array();
-        }
-
-        // Populate exit toward array
-        if (edge.sign().exit_toward_locations_size() > 0) {
-          writer.start_array("exit_toward");
-          for (const auto& exit_toward_location : edge.sign().exit_toward_locations()) {
-            writer(exit_toward_location.text());
-          }
-          writer.end_array();
-        }
-
-        // Populate exit name array
-        if (edge.sign().exit_names_size() > 0) {
-          writer.start_array("exit_name");
-          for (const auto& exit_name : edge.sign().exit_names()) {
-            writer(exit_name.text());
-          }
-          writer.end_array();
-        }
-        writer.end_object();
+        serialize_sign(edge, writer, "sign");
       }
 
       // Process edge end node only if any node items are enabled
@@ -291,39 +376,7 @@ void serialize_edges(const AttributesController& controller,
         const auto& node = trip_path.node(i);
         writer.start_object("end_node");
         if (node.intersecting_edge_size() > 0) {
-          writer.start_array("intersecting_edges");
-          for (const auto& xedge : node.intersecting_edge()) {
-            writer.start_object();
-            if (controller(kNodeIntersectingEdgeWalkability) &&
-                (xedge.walkability() != TripLeg_Traversability_kNone)) {
-              writer("walkability", to_string(xedge.walkability()));
-            }
-            if (controller(kNodeIntersectingEdgeCyclability) &&
-                (xedge.cyclability() != TripLeg_Traversability_kNone)) {
-              writer("cyclability", to_string(xedge.cyclability()));
-            }
-            if (controller(kNodeIntersectingEdgeDriveability) &&
-                (xedge.driveability() != TripLeg_Traversability_kNone)) {
-              writer("driveability", to_string(xedge.driveability()));
-            }
-            if (controller(kNodeIntersectingEdgeFromEdgeNameConsistency)) {
-              writer("from_edge_name_consistency", xedge.prev_name_consistency());
-            }
-            if (controller(kNodeIntersectingEdgeToEdgeNameConsistency)) {
-              writer("to_edge_name_consistency", xedge.curr_name_consistency());
-            }
-            if (controller(kNodeIntersectingEdgeBeginHeading)) {
-              writer("begin_heading", xedge.begin_heading());
-            }
-            if (controller(kNodeIntersectingEdgeUse)) {
-              writer("use", to_string(static_cast<baldr::Use>(xedge.use())));
-            }
-            if (controller(kNodeIntersectingEdgeRoadClass)) {
-              writer("road_class", to_string(static_cast<baldr::RoadClass>(xedge.road_class())));
-            }
-            writer.end_object();
-          }
-          writer.end_array();
+          serialize_intersecting_edges(controller, node, writer, "intersecting_edges");
         }
 
         if (controller(kNodeElapsedTime)) {
@@ -384,6 +437,390 @@ void serialize_edges(const AttributesController& controller,
   writer.end_array();
 }
 
+/**
+ * Writes the edges of a trip leg one attribute at a time instead of one edge at a time. Each column
+ * is an array with one value per edge, null where the row layout would leave the attribute out.
+ * Strings are replaced by their index into a dictionary, which is written once at the end, and the
+ * identifiers and shape indices, which mostly grow along the path, are written as the difference to
+ * the previous edge.
+ */
+class edge_columns_t {
+public:
+  edge_columns_t(const TripLeg& trip_path, rapidjson::writer_wrapper_t& writer) : writer(writer) {
+    for (int i = 1; i < trip_path.node().size(); i++) {
+      if (trip_path.node(i - 1).has_edge()) {
+        edges.emplace_back(&trip_path.node(i - 1).edge(), &trip_path.node(i));
+      }
+    }
+  }
+
+  size_t size() const {
+    return edges.size();
+  }
+
+  // writes the column, calling the function to write the value of each edge
+  template <typename Write> void column(const char* name, const Write& write) {
+    writer.start_array(name);
+    for (const auto& edge : edges) {
+      write(*edge.first, *edge.second);
+    }
+    writer.end_array();
+  }
+
+  // writes the column of the integer the function returns, the first edge as is, the rest as deltas
+  template <typename Value> void delta_column(const char* name, const Value& value) {
+    writer.start_array(name);
+    int64_t previous = 0;
+    for (const auto& edge : edges) {
+      int64_t current = static_cast<int64_t>(value(*edge.first, *edge.second));
+      writer(current - previous);
+      previous = current;
+    }
+    writer.end_array();
+    delta_encoded.push_back(name);
+  }
+
+  // writes the index of the string in the dictionary, adding it if its not there yet
+  void string(const std::string& value) {
+    auto inserted = indices.emplace(value, static_cast<uint32_t>(strings.size()));
+    if (inserted.second) {
+      strings.push_back(&inserted.first->first);
+    }
+    writer(inserted.first->second);
+  }
+
+  // writes the names of the delta encoded columns and the dictionary of strings
+  void finish() {
+    writer.start_array("delta_encoded");
+    for (const auto* name : delta_encoded) {
+      writer(name);
+    }
+    writer.end_array();
+    writer.start_array("strings");
+    for (const auto* value : strings) {
+      writer(*value);
+    }
+    writer.end_array();
+  }
+
+protected:
+  rapidjson::writer_wrapper_t& writer;
+  // each edge along with the node it ends at
+  std::vector<std::pair<const TripLeg::Edge*, const TripLeg::Node*>> edges;
+  std::vector<const char*> delta_encoded;
+  // the dictionary, node based so the pointers stay valid while it grows
+  std::unordered_map<std::string, uint32_t> indices;
+  std::vector<const std::string*> strings;
+};
+
+void serialize_edge_columns(const AttributesController& controller,
+                            const Options& options,
+                            const TripLeg& trip_path,
+                            rapidjson::writer_wrapper_t& writer) {
+  writer.start_object("edges");
+  edge_columns_t columns(trip_path, writer);
+  writer("count", static_cast<uint64_t>(columns.size()));
+
+  // Length and speed default to kilometers
+  double scale = 1;
+  if (options.units() == Options::miles) {
+    scale = kMilePerKm;
+  }
+
+  using Edge = TripLeg::Edge;
+  using Node = TripLeg::Node;
+  if (controller(kEdgeTruckRoute)) {
+    columns.column("truck_route", [&](const Edge& edge, const Node&) { writer(edge.truck_route()); });
+  }
+  if (controller(kEdgeTruckSpeed)) {
+    columns.column("truck_speed", [&](const Edge& edge, const Node&) {
+      if (edge.truck_speed() > 0) {
+        writer(static_cast<uint64_t>(std::round(edge.truck_speed() * scale)));
+      } else {
+        writer(nullptr);
+      }
+    });
+  }
+  if (controller(kEdgeSpeedLimit)) {
+    columns.column("speed_limit", [&](const Edge& edge, const Node&) {
+      if (edge.speed_limit() == kUnlimitedSpeedLimit) {
+        writer(std::string("unlimited"));
+      } else if (edge.speed_limit() > 0) {
+        writer(static_cast<uint64_t>(std::round(edge.speed_limit() * scale)));
+      } else {
+        writer(nullptr);
+      }
+    });
+  }
+  if (controller(kEdgeDensity)) {
+    columns.column("density", [&](const Edge& edge, const Node&) { writer(edge.density()); });
+  }
+  if (controller(kEdgeSacScale)) {
+    columns.column("sac_scale", [&](const Edge& edge, const Node&) {
+      writer(static_cast<uint64_t>(edge.sac_scale()));
+    });
+  }
+  if (controller(kEdgeShoulder)) {
+    columns.column("shoulder", [&](const Edge& edge, const Node&) { writer(edge.shoulder()); });
+  }
+  if (controller(kEdgeSidewalk)) {
+    columns.column("sidewalk", [&](const Edge& edge, const Node&) {
+      columns.string(to_string(edge.sidewalk()));
+    });
+  }
+  if (controller(kEdgeBicycleNetwork)) {
+    columns.column("bicycle_network", [&](const Edge& edge, const Node&) {
+      writer(static_cast<uint64_t>(edge.bicycle_network()));
+    });
+  }
+  if (controller(kEdgeCycleLane)) {
+    columns.column("cycle_lane", [&](const Edge& edge, const Node&) {
+      columns.string(to_string(static_cast<CycleLane>(edge.cycle_lane())));
+    });
+  }
+  if (controller(kEdgeLaneCount)) {
+    columns.column("lane_count", [&](const Edge& edge, const Node&) { writer(edge.lane_count()); });
+  }
+  columns.column("lane_connectivity", [&](const Edge& edge, const Node&) {
+    if (edge.lane_connectivity_size()) {
+      serialize_lane_connectivity(edge, writer, nullptr);
+    } else {
+      writer(nullptr);
+    }
+  });
+  if (controller(kEdgeMaxDownwardGrade)) {
+    columns.column("max_downward_grade",
+                   [&](const Edge& edge, const Node&) { writer(edge.max_downward_grade()); });
+  }
+  if (controller(kEdgeMaxUpwardGrade)) {
+    columns.column("max_upward_grade",
+                   [&](const Edge& edge, const Node&) { writer(edge.max_upward_grade()); });
+  }
+  if (controller(kEdgeWeightedGrade)) {
+    writer.set_precision(tyr::kDefaultPrecision);
+    columns.column("weighted_grade",
+                   [&](const Edge& edge, const Node&) { writer(edge.weighted_grade()); });
+  }
+  if (controller(kEdgeMeanElevation)) {
+    columns.column("mean_elevation", [&](const Edge& edge, const Node&) {
+      float mean = edge.mean_elevation();
+      if (mean == kNoElevationData) {
+        writer(nullptr);
+        return;
+      }
+      // Convert to feet if a valid elevation and units are miles
+      if (options.units() == Options::miles) {
+        mean *= kFeetPerMeter;
+      }
+      writer(static_cast<int64_t>(mean));
+    });
+  }
+  if (controller(kEdgeWayId)) {
+    columns.delta_column("way_id", [](const Edge& edge, const Node&) { return edge.way_id(); });
+  }
+  if (controller(kEdgeId)) {
+    columns.delta_column("id", [](const Edge& edge, const Node&) { return edge.id(); });
+  }
+  if (controller(kEdgeTravelMode)) {
+    columns.column("travel_mode", [&](const Edge& edge, const Node&) {
+      columns.string(to_string(edge.travel_mode()));
+    });
+  }
+  if (controller(kEdgeVehicleType)) {
+    columns.column("vehicle_type", [&](const Edge& edge, const Node&) {
+      if (edge.travel_mode() == valhalla::kDrive) {
+        columns.string(to_string(edge.vehicle_type()));
+      } else {
+        writer(nullptr);
+      }
+    });
+  }
+  if (controller(kEdgePedestrianType)) {
+    columns.column("pedestrian_type", [&](const Edge& edge, const Node&) {
+      if (edge.travel_mode() == valhalla::kPedestrian) {
+        columns.string(to_string(edge.pedestrian_type()));
+      } else {
+        writer(nullptr);
+      }
+    });
+  }
+  if (controller(kEdgeBicycleType)) {
+    columns.column("bicycle_type", [&](const Edge& edge, const Node&) {
+      if (edge.travel_mode() == valhalla::kBicycle) {
+        columns.string(to_string(edge.bicycle_type()));
+      } else {
+        writer(nullptr);
+      }
+    });
+  }
+  if (controller(kEdgeSurface)) {
+    columns.column("surface", [&](const Edge& edge, const Node&) {
+      columns.string(to_string(static_cast<baldr::Surface>(edge.surface())));
+    });
+  }
+  if (controller(kEdgeDriveOnRight)) {
+    columns.column("drive_on_right", [&](const Edge& edge, const Node&) {
+      writer(static_cast<bool>(!edge.drive_on_left()));
+    });
+  }
+  if (controller(kEdgeInternalIntersection)) {
+    columns.column("internal_intersection",
+                   [&](const Edge& edge, const Node&) { writer(edge.internal_intersection()); });
+  }
+  if (controller(kEdgeRoundabout)) {
+    columns.column("roundabout", [&](const Edge& edge, const Node&) { writer(edge.roundabout()); });
+  }
+  if (controller(kEdgeBridge)) {
+    columns.column("bridge", [&](const Edge& edge, const Node&) { writer(edge.bridge()); });
+  }
+  if (controller(kEdgeTunnel)) {
+    columns.column("tunnel", [&](const Edge& edge, const Node&) { writer(edge.tunnel()); });
+  }
+  if (controller(kEdgeUnpaved)) {
+    columns.column("unpaved", [&](const Edge& edge, const Node&) { writer(edge.unpaved()); });
+  }
+  if (controller(kEdgeToll)) {
+    columns.column("toll", [&](const Edge& edge, const Node&) { writer(edge.toll()); });
+  }
+  if (controller(kEdgeUse)) {
+    columns.column("use", [&](const Edge& edge, const Node&) {
+      columns.string(to_string(static_cast<baldr::Use>(edge.use())));
+    });
+  }
+  if (controller(kEdgeTraversability)) {
+    columns.column("traversability", [&](const Edge& edge, const Node&) {
+      columns.string(to_string(edge.traversability()));
+    });
+  }
+  if (controller(kEdgeEndShapeIndex)) {
+    columns.delta_column("end_shape_index",
+                         [](const Edge& edge, const Node&) { return edge.end_shape_index(); });
+  }
+  if (controller(kEdgeBeginShapeIndex)) {
+    columns.delta_column("begin_shape_index",
+                         [](const Edge& edge, const Node&) { return edge.begin_shape_index(); });
+  }
+  if (controller(kEdgeEndHeading)) {
+    columns.column("end_heading", [&](const Edge& edge, const Node&) { writer(edge.end_heading()); });
+  }
+  if (controller(kEdgeBeginHeading)) {
+    columns.column("begin_heading",
+                   [&](const Edge& edge, const Node&) { writer(edge.begin_heading()); });
+  }
+  if (controller(kEdgeRoadClass)) {
+    columns.column("road_class", [&](const Edge& edge, const Node&) {
+      columns.string(to_string(static_cast<baldr::RoadClass>(edge.road_class())));
+    });
+  }
+  if (controller(kEdgeSpeed)) {
+    columns.column("speed", [&](const Edge& edge, const Node&) {
+      writer(static_cast<uint64_t>(std::round(edge.speed() * scale)));
+    });
+  }
+  if (controller(kEdgeCountryCrossing)) {
+    columns.column("country_crossing",
+                   [&](const Edge& edge, const Node&) { writer(edge.country_crossing()); });
+  }
+  if (controller(kEdgeForward)) {
+    columns.column("forward", [&](const Edge& edge, const Node&) { writer(edge.forward()); });
+  }
+  if (controller(kEdgeLevels)) {
+    columns.column("levels", [&](const Edge& edge, const Node&) {
+      if (edge.levels_size()) {
+        serialize_levels(edge, writer, nullptr);
+      } else {
+        writer(nullptr);
+      }
+    });
+  }
+  if (controller(kEdgeLength)) {
+    writer.set_precision(tyr::kDefaultPrecision);
+    columns.column("length",
+                   [&](const Edge& edge, const Node&) { writer(edge.length_km() * scale); });
+    columns.column("source_percent_along",
+                   [&](const Edge& edge, const Node&) { writer(edge.source_along_edge()); });
+    columns.column("target_percent_along",
+                   [&](const Edge& edge, const Node&) { writer(edge.target_along_edge()); });
+  }
+  columns.column("names", [&](const Edge& edge, const Node&) {
+    writer.start_array();
+    for (const auto& name : edge.name()) {
+      columns.string(name.value());
+    }
+    writer.end_array();
+  });
+  columns.column("traffic_segments", [&](const Edge& edge, const Node&) {
+    if (edge.traffic_segment().size() > 0) {
+      serialize_traffic_segments(edge, writer, nullptr);
+    } else {
+      writer(nullptr);
+    }
+  });
+  columns.column("sign", [&](const Edge& edge, const Node&) {
+    if (edge.has_sign()) {
+      serialize_sign(edge, writer, nullptr);
+    } else {
+      writer(nullptr);
+    }
+  });
+
+  // Process edge end node only if any node items are enabled
+  if (controller.category_attribute_enabled(kNodeCategory)) {
+    writer.start_object("end_node");
+    columns.column("intersecting_edges", [&](const Edge&, const Node& node) {
+      if (node.intersecting_edge_size() > 0) {
+        serialize_intersecting_edges(controller, node, writer, nullptr);
+      } else {
+        writer(nullptr);
+      }
+    });
+    if (controller(kNodeElapsedTime)) {
+      writer.set_precision(tyr::kDefaultPrecision);
+      columns.column("elapsed_time", [&](const Edge&, const Node& node) {
+        writer(node.cost().elapsed_cost().seconds());
+      });
+      columns.column("elapsed_cost", [&](const Edge&, const Node& node) {
+        writer(node.cost().elapsed_cost().cost());
+      });
+    }
+    if (controller(kNodeAdminIndex)) {
+      columns.column("admin_index",
+                     [&](const Edge&, const Node& node) { writer(node.admin_index()); });
+    }
+    if (controller(kNodeType)) {
+      columns.column("type", [&](const Edge&, const Node& node) {
+        columns.string(to_string(static_cast<baldr::NodeType>(node.type())));
+      });
+    }
+    if (controller(kNodeTrafficSignal)) {
+      columns.column("traffic_signal",
+                     [&](const Edge&, const Node& node) { writer(node.traffic_signal()); });
+    }
+    if (controller(kNodeFork)) {
+      columns.column("fork", [&](const Edge&, const Node& node) { writer(node.fork()); });
+    }
+    if (controller(kNodeTimeZone)) {
+      columns.column("time_zone", [&](const Edge&, const Node& node) {
+        if (node.time_zone().empty()) {
+          writer(nullptr);
+        } else {
+          columns.string(node.time_zone());
+        }
+      });
+    }
+    if (controller(kNodeTransitionTime)) {
+      writer.set_precision(tyr::kDefaultPrecision);
+      columns.column("transition_time", [&](const Edge&, const Node& node) {
+        writer(node.cost().transition_cost().seconds());
+      });
+    }
+    writer.end_object();
+  }
+
+  columns.finish();
+  writer.end_object();
+}
+
 void serialize_matched_points(const AttributesController& controller,
                               const std::vector<meili::MatchResult>& match_results,
                               rapidjson::writer_wrapper_t& writer) {
@@ -516,8 +953,12 @@ void append_trace_info(
     serialize_admins(trip_path, writer);
   }
 
-  // Add edges
-  serialize_edges(controller, options, trip_path, writer);
+  // Add edges, one attribute at a time if asked for
+  if (options.columnar()) {
+    serialize_edge_columns(controller, options, trip_path, writer);
+  } else {
+    serialize_edges(controller, options, trip_path, writer);
+  }
 
   // Add elevation at the specified interval
   if (options.elevation_interval() > 0.0f) {
@@ -594,6 +1035,11 @@ std::string serializeTraceAttributes(
     valhalla::tyr::serializeWarnings(request, writer);
   }
 
+  // add the statistics collected along the pipeline if they were asked for
+  if (request.options().statistics()) {
+    valhalla::tyr::serializeStatistics(request, writer);
+  }
+
   writer.end_object();
   return writer.get_buffer();
 }
@@ -1,4 +1,4 @@
-#include "baldr/json.h"
+#include "baldr/rapidjson_utils.h"
 #include "tyr/serializers.h"
 
 #include <cstdint>
@@ -9,13 +9,15 @@ using namespace valhalla::baldr;
 
 namespace {
 
-json::MapPtr serialize(const PathLocation& location, bool istransit) {
-  // serialze all the edges
-  auto json = json::map({{"input_lat", json::fixed_t{location.latlng_.lat(), 6}},
-                         {"input_lon", json::fixed_t{location.latlng_.lng(), 6}},
-                         {"radius", static_cast<uint64_t>(location.radius_)}});
-  json->emplace("istransit", istransit);
-  return json;
+void serialize(rapidjson::writer_wrapper_t& writer, const PathLocation& location, bool istransit) {
+  writer.start_object();
+  writer.set_precision(valhalla::tyr::kCoordinatePrecision);
+  writer("input_lat", location.latlng_.lat());
+  writer("input_lon", location.latlng_.lng());
+  writer.set_precision(valhalla::tyr::kDefaultPrecision);
+  writer("radius", static_cast<uint64_t>(location.radius_));
+  writer("istransit", istransit);
+  writer.end_object();
 }
 } // namespace
 
@@ -25,13 +27,13 @@ namespace tyr {
 std::string serializeTransitAvailable(const Api& /* request */,
                                       const std::vector<baldr::Location>& locations,
                                       const std::unordered_set<baldr::Location>& found) {
-  auto json = json::array({});
+  rapidjson::writer_wrapper_t writer(64 * locations.size());
+  writer.start_array();
   for (const auto& location : locations) {
-    json->emplace_back(serialize(location, found.find(location) != found.cend()));
+    serialize(writer, location, found.find(location) != found.cend());
   }
-  std::stringstream ss;
-  ss << *json;
-  return ss.str();
+  writer.end_array();
+  return writer.get_buffer();
 }
 
 } // namespace tyr
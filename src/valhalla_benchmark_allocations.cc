@@ -0,0 +1,158 @@
+#include "argparse_utils.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "tyr/actor.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+// every allocation made by this program, counted by the replaced global operator new below
+std::atomic<size_t> allocations(0);
+std::atomic<size_t> allocated_bytes(0);
+
+// the request files in test_requests are lines of the form: -j '{...}'
+std::string extract_request(const std::string& line) {
+  auto begin = line.find('{');
+  auto end = line.rfind('}');
+  if (begin == std::string::npos || end == std::string::npos || end < begin)
+    return "";
+  return line.substr(begin, end - begin + 1);
+}
+
+struct tally_t {
+  size_t routes = 0;
+  size_t allocations = 0;
+  size_t bytes = 0;
+};
+
+void report(const std::string& name, const tally_t& tally) {
+  std::cout << std::fixed << std::setprecision(1) << name << ": " << tally.routes << " routes, "
+            << static_cast<double>(tally.allocations) / tally.routes << " allocations avg, "
+            << static_cast<double>(tally.bytes) / tally.routes << " bytes avg" << std::endl;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+int main(int argc, char** argv) {
+  const auto program = filesystem::path(__FILE__).stem().string();
+  // args
+  size_t warmup;
+  std::vector<std::string> input_files;
+  boost::property_tree::ptree config;
+
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      program,
+      program + " " + VALHALLA_VERSION + "\n\n"
+      "a program that counts the heap allocations made while computing routes.\n"
+      "Each route request is computed with the request object on the heap, the way callers\n"
+      "that keep the request around do, and then with it on the arena of the worker, the\n"
+      "way the service does. The input is a text file of route requests in the form used\n"
+      "in test_requests, one per line\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("w,warmup", "How many times to compute each route before counting, to fill the tile cache", cxxopts::value<size_t>(warmup)->default_value("1"))
+      ("input_files", "positional arguments", cxxopts::value<std::vector<std::string>>(input_files));
+    // clang-format on
+
+    options.parse_positional({"input_files"});
+    options.positional_help("REQUESTS.TXT");
+    auto result = options.parse(argc, argv);
+    if (!parse_common_args(program, options, result, config, "mjolnir.logging"))
+      return EXIT_SUCCESS;
+
+    if (!result.count("input_files")) {
+      throw cxxopts::exceptions::exception("Input file is required\n\n" + options.help());
+    }
+  } catch (cxxopts::exceptions::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // load up the requests
+  std::vector<std::string> requests;
+  for (const auto& file : input_files) {
+    std::ifstream stream(file);
+    std::string line;
+    while (std::getline(stream, line)) {
+      auto request = extract_request(line);
+      if (!request.empty())
+        requests.emplace_back(std::move(request));
+    }
+  }
+  LOG_INFO("Loaded " + std::to_string(requests.size()) + " requests");
+
+  // responses are not cached so that every request is really computed
+  config.put("loki.result_cache.max_size", 0);
+  valhalla::tyr::actor_t actor(config, true);
+  tally_t heap, arena;
+  for (const auto& request : requests) {
+    try {
+      for (size_t i = 0; i < warmup; ++i) {
+        actor.route(request);
+      }
+
+      size_t count = allocations.load(), bytes = allocated_bytes.load();
+      {
+        valhalla::Api api;
+        actor.route(request, nullptr, &api);
+      }
+      heap.allocations += allocations.load() - count;
+      heap.bytes += allocated_bytes.load() - bytes;
+      ++heap.routes;
+
+      count = allocations.load();
+      bytes = allocated_bytes.load();
+      actor.route(request);
+      arena.allocations += allocations.load() - count;
+      arena.bytes += allocated_bytes.load() - bytes;
+      ++arena.routes;
+    } catch (const std::exception& e) {
+      LOG_WARN("Skipping request: " + std::string(e.what()));
+    }
+  }
+
+  if (heap.routes == 0 || arena.routes == 0) {
+    LOG_WARN("No routes were found");
+    return EXIT_FAILURE;
+  }
+  report("heap", heap);
+  report("arena", arena);
+
+  return EXIT_SUCCESS;
+}
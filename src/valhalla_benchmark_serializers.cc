@@ -0,0 +1,129 @@
+#include "argparse_utils.h"
+#include "filesystem.h"
+#include "midgard/logging.h"
+#include "tyr/actor.h"
+#include "tyr/serializers.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cxxopts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// the request files in test_requests are lines of the form: -j '{...}'
+std::string extract_request(const std::string& line) {
+  auto begin = line.find('{');
+  auto end = line.rfind('}');
+  if (begin == std::string::npos || end == std::string::npos || end < begin)
+    return "";
+  return line.substr(begin, end - begin + 1);
+}
+
+// force the response format without having to round trip the request through a json document
+std::string with_format(const std::string& request, const std::string& format) {
+  return "{\"format\":\"" + format + "\"," + request.substr(1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto program = filesystem::path(__FILE__).stem().string();
+  // args
+  size_t iterations;
+  std::vector<std::string> formats, input_files;
+  boost::property_tree::ptree config;
+
+  try {
+    // clang-format off
+    cxxopts::Options options(
+      program,
+      program + " " + VALHALLA_VERSION + "\n\n"
+      "a program that times the serialization of route responses.\n"
+      "Each route request is computed once and then its response is serialized repeatedly\n"
+      "in each of the requested formats. The input is a text file of route requests in the\n"
+      "form used in test_requests, one per line\n\n");
+
+    options.add_options()
+      ("h,help", "Print this help message.")
+      ("v,version", "Print the version of this software.")
+      ("c,config", "Path to the json configuration file.", cxxopts::value<std::string>())
+      ("i,iterations", "How many times to serialize each response", cxxopts::value<size_t>(iterations)->default_value("100"))
+      ("f,formats", "Comma separated response formats to time", cxxopts::value<std::vector<std::string>>(formats)->default_value("json,osrm"))
+      ("input_files", "positional arguments", cxxopts::value<std::vector<std::string>>(input_files));
+    // clang-format on
+
+    options.parse_positional({"input_files"});
+    options.positional_help("REQUESTS.TXT");
+    auto result = options.parse(argc, argv);
+    if (!parse_common_args(program, options, result, config, "mjolnir.logging"))
+      return EXIT_SUCCESS;
+
+    if (!result.count("input_files")) {
+      throw cxxopts::exceptions::exception("Input file is required\n\n" + options.help());
+    }
+  } catch (cxxopts::exceptions::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "Unable to parse command line options because: " << e.what() << "\n"
+              << "This is a bug, please report it at " PACKAGE_BUGREPORT << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // load up the requests
+  std::vector<std::string> requests;
+  for (const auto& file : input_files) {
+    std::ifstream stream(file);
+    std::string line;
+    while (std::getline(stream, line)) {
+      auto request = extract_request(line);
+      if (!request.empty())
+        requests.emplace_back(std::move(request));
+    }
+  }
+  LOG_INFO("Loaded " + std::to_string(requests.size()) + " requests");
+
+  valhalla::tyr::actor_t actor(config, true);
+  for (const auto& format : formats) {
+    size_t routes = 0, bytes = 0;
+    std::chrono::duration<double, std::milli> elapsed(0), worst(0);
+    for (const auto& request : requests) {
+      // compute the route once, only the serialization is timed
+      valhalla::Api api;
+      try {
+        actor.route(with_format(request, format), nullptr, &api);
+      } catch (const std::exception& e) {
+        LOG_WARN("Skipping request: " + std::string(e.what()));
+        continue;
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i) {
+        bytes += valhalla::tyr::serializeDirections(api).size();
+      }
+      std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - start;
+      elapsed += took;
+      worst = std::max(worst, took / iterations);
+      ++routes;
+    }
+
+    if (routes == 0) {
+      LOG_WARN("No routes were found for format " + format);
+      continue;
+    }
+    auto count = routes * iterations;
+    std::cout << std::fixed << std::setprecision(3) << format << ": " << routes << " routes, "
+              << elapsed.count() / count << " ms avg, " << worst.count() << " ms worst, "
+              << bytes / count << " bytes avg, "
+              << (bytes / (1024.0 * 1024.0)) / (elapsed.count() / 1000.0) << " MiB/s" << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -11,6 +11,7 @@
 using namespace prime_server;
 #endif
 
+#include "admission_controller.h"
 #include "config.h"
 #include "loki/worker.h"
 #include "midgard/logging.h"
@@ -171,6 +172,26 @@ int main(int argc, char** argv) {
 
   uint32_t request_timeout = config.get<uint32_t>("httpd.service.timeout_seconds");
 
+  // all stages run in this process so they can share the slots for heavy requests, a request which
+  // is still holding one after the service timeout has been dropped somewhere along the way
+  if (config.get<float>("loki.admission.heavy_cost", 0.f) > 0.f) {
+    auto admission = config.get_child("loki.admission");
+    if (!admission.get_optional<uint32_t>("lease_seconds")) {
+      admission.put("lease_seconds", request_timeout);
+    }
+    // waiting requests block their loki worker, at least one is always left for cheap requests
+    const uint32_t most_waiting = worker_concurrency > 0 ? worker_concurrency - 1 : 0;
+    auto max_waiting = admission.get<uint32_t>("max_waiting", worker_concurrency / 2);
+    if (max_waiting > most_waiting) {
+      LOG_WARN("loki.admission.max_waiting must be less than the number of workers, using " +
+               std::to_string(most_waiting));
+      max_waiting = most_waiting;
+    }
+    admission.put("max_waiting", max_waiting);
+    valhalla::admission_controller_t::install(
+        std::make_shared<valhalla::admission_controller_t>(admission));
+  }
+
   // setup the cluster within this process
   zmq::context_t context;
   std::thread server_thread =
@@ -1,4 +1,5 @@
 #include "loki/worker.h"
+#include "admission_controller.h"
 #include "baldr/datetime.h"
 #include "baldr/graphconstants.h"
 #include "baldr/location.h"
@@ -11,6 +12,7 @@
 #include "proto_conversions.h"
 #include "sif/costfactory.h"
 #include "thor/worker.h"
+#include "tyr/result_cache.h"
 #include "worker.h"
 
 #include <boost/optional.hpp>
@@ -42,6 +44,7 @@ constexpr const char* OSRM_INVALID_VALUE = R"({"code":"InvalidValue","message":"
 constexpr const char* OSRM_NO_ROUTE = R"({"code":"NoRoute","message":"Impossible route between points"})";
 constexpr const char* OSRM_NO_SEGMENT = R"({"code":"NoSegment","message":"One of the supplied input coordinates could not snap to street segment."})";
 constexpr const char* OSRM_SHUTDOWN = R"({"code":"ServiceUnavailable","message":"The service is shutting down."})";
+constexpr const char* OSRM_BUSY = R"({"code":"ServiceUnavailable","message":"Too many expensive requests, try again later."})";
 constexpr const char* OSRM_SERVER_ERROR = R"({"code":"InvalidUrl","message":"Failed to serialize route."})";
 constexpr const char* OSRM_DISTANCE_EXCEEDED = R"({"code":"DistanceExceeded","message":"Path distance exceeds the max distance limit."})";
 constexpr const char* OSRM_PERIMETER_EXCEEDED = R"({"code":"PerimeterExceeded","message":"Perimeter of avoid polygons exceeds the max limit."})";
@@ -55,6 +58,7 @@ const std::unordered_map<unsigned, valhalla::valhalla_exception_t> error_codes{
     {103, {103, "Failed to parse pbf request", 400, HTTP_400, OSRM_INVALID_URL, "pbf_parse_failed"}},
     {106, {106, "Try any of", 404, HTTP_404, OSRM_INVALID_SERVICE, "wrong_action"}},
     {107, {107, "Not Implemented", 501, HTTP_501, OSRM_INVALID_SERVICE, "empty_action"}},
+    {108, {108, "Too many expensive requests, try again later", 503, HTTP_503, OSRM_BUSY, "too_busy"}},
     {110, {110, "Insufficiently specified required parameter 'locations'", 400, HTTP_400, OSRM_INVALID_OPTIONS, "locations_parse_failed"}},
     {111, {111, "Insufficiently specified required parameter 'time'", 400, HTTP_400, OSRM_INVALID_OPTIONS, "time_parse_failed"}},
     {112, {112, "Insufficiently specified required parameter 'locations' or 'sources & targets'", 400, HTTP_400, OSRM_INVALID_OPTIONS, "matrix_locations_parse_failed"}},
@@ -101,6 +105,7 @@ const std::unordered_map<unsigned, valhalla::valhalla_exception_t> error_codes{
     {165, {165, "Date and time required for destination for date_type of invariant", 400, HTTP_400, OSRM_INVALID_OPTIONS, "missing_invariant_date"}},
     {167, {167, "Exceeded maximum circumference for exclude_polygons", 400, HTTP_400, OSRM_PERIMETER_EXCEEDED, "too_large_polygon"}},
     {168, {168, "Invalid expansion property type", 400, HTTP_400, OSRM_INVALID_OPTIONS, "invalid_expansion_property"}},
+    {169, {169, "Arrive by not implemented for one to many routes", 501, HTTP_501, OSRM_INVALID_VALUE, "no_arrive_by_one_to_many"}},
     {170, {170, "Locations are in unconnected regions. Go check/edit the map at osm.org", 400, HTTP_400, OSRM_NO_ROUTE, "impossible_route"}},
     {171, {171, "No suitable edges near location", 400, HTTP_400, OSRM_NO_SEGMENT, "no_edges_near"}},
     {172, {172, "Exceeded breakage distance for all pairs", 400, HTTP_400, OSRM_BREAKAGE_EXCEEDED, "too_large_breakage_distance"}},
@@ -136,6 +141,7 @@ const std::unordered_map<unsigned, valhalla::valhalla_exception_t> error_codes{
     {443, {443, "Exact route match algorithm failed to find path", 400, HTTP_400, OSRM_NO_SEGMENT, "shape_match_failed"}},
     {444, {444, "Map Match algorithm failed to find path", 400, HTTP_400, OSRM_NO_SEGMENT, "map_match_failed"}},
     {445, {445, "Shape match algorithm specification in api request is incorrect. Please see documentation for valid shape_match input.", 400, HTTP_400, OSRM_INVALID_URL, "wrong_match_type"}},
+    {446, {446, "Exceeded the work budget of the request", 400, HTTP_400, OSRM_INVALID_VALUE, "too_much_work"}},
     {499, {499, "Unknown", 400, HTTP_400, OSRM_INVALID_URL, "unknown"}},
     {503, {503, "Leg count mismatch", 400, HTTP_400, OSRM_INVALID_URL, "wrong_number_of_legs"}},
     {504, {504, "This service does not support GeoTIFF serialization.", 400, HTTP_400, OSRM_INVALID_VALUE, "unknown"}},
@@ -712,6 +718,13 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
     else {
       options.clear_jsonp();
     }
+  } // the dense binary format only makes sense for matrices
+  else if (options.format() == Options::binary) {
+    if (options.action() != Options::sources_to_targets) {
+      options.set_format(Options::json);
+    } else {
+      options.clear_jsonp();
+    }
   }
 #ifndef ENABLE_GDAL
   else if (options.format() == Options::geotiff) {
@@ -993,6 +1006,23 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
   options.set_prioritize_bidirectional(
       rapidjson::get<bool>(doc, "/prioritize_bidirectional", options.prioritize_bidirectional()));
 
+  // Token of the navigation session, lets thor reuse the reverse search tree when rerouting
+  options.set_reroute_token(
+      rapidjson::get<std::string>(doc, "/reroute_token", options.reroute_token()));
+
+  // Route from the first location to each of the others rather than through all of them
+  if (action == Options::route) {
+    options.set_one_to_many(rapidjson::get<bool>(doc, "/one_to_many", options.one_to_many()));
+    if (options.one_to_many()) {
+      if (options.costing_type() == Costing::multimodal ||
+          options.costing_type() == Costing::transit ||
+          options.costing_type() == Costing::bikeshare)
+        throw valhalla_exception_t{140};
+      if (options.date_time_type() == Options::arrive_by)
+        throw valhalla_exception_t{169};
+    }
+  }
+
   // Throw an error if use_timestamps is set to true but there are no timestamps in the
   // trace (or no durations present)
   if (options.use_timestamps()) {
@@ -1253,6 +1283,12 @@ void from_json(rapidjson::Document& doc, Options::Action action, Api& api) {
 
   options.set_turn_lanes(rapidjson::get<bool>(doc, "/turn_lanes", options.turn_lanes()));
 
+  // whether to return the timings and counters collected along the pipeline, default false
+  options.set_statistics(rapidjson::get<bool>(doc, "/statistics", options.statistics()));
+
+  // whether to return the edges of trace_attributes as columns rather than rows, default false
+  options.set_columnar(rapidjson::get<bool>(doc, "/columnar", options.columnar()));
+
   // whether to include roundabout_exit maneuvers, default true
   auto roundabout_exits =
       rapidjson::get<bool>(doc, "/roundabout_exits",
@@ -1570,9 +1606,10 @@ worker_t::result_t
 to_response(const std::string& data, http_request_info_t& request_info, const Api& request) {
   // try to get all the proper headers
   auto fmt = request.options().format();
-  const auto& mime = fmt == Options::json || fmt == Options::osrm
-                         ? worker::JSON_MIME
-                         : (fmt == Options::pbf ? worker::PBF_MIME : worker::GPX_MIME);
+  const auto& mime = fmt == Options::json || fmt == Options::osrm ? worker::JSON_MIME
+                     : fmt == Options::pbf                           ? worker::PBF_MIME
+                     : fmt == Options::binary                        ? worker::BINARY_MIME
+                                                                     : worker::GPX_MIME;
   headers_t headers{CORS, mime};
   if (fmt == Options::gpx)
     headers.insert(ATTACHMENT);
@@ -1629,12 +1666,32 @@ service_worker_t::service_worker_t(const boost::property_tree::ptree& conf) : in
   if (conf.count("statsd")) {
     statsd_client = std::make_unique<statsd_client_t>(conf);
   }
+  if (auto loki = conf.get_child_optional("loki")) {
+    result_cache = tyr::ResultCache::shared(*loki);
+  }
+  admission = admission_controller_t::installed();
 }
 service_worker_t::~service_worker_t() {
 }
 void service_worker_t::set_interrupt(const std::function<void()>* interrupt_function) {
   interrupt = interrupt_function;
 }
+void service_worker_t::cache_result(const Api& api, const std::string& response) const {
+  if (result_cache && !api.info().result_cache_key().empty()) {
+    result_cache->put(api.info().result_cache_key(), response);
+  }
+}
+google::protobuf::ArenaOptions service_worker_t::request_arena_options() {
+  // big enough for the directions of most routes, larger requests continue in growing blocks
+  constexpr size_t kRequestArenaBlockSize = 256 * 1024;
+  constexpr size_t kRequestArenaMaxBlockSize = 4 * 1024 * 1024;
+  request_arena_block.resize(kRequestArenaBlockSize);
+  google::protobuf::ArenaOptions options;
+  options.initial_block = request_arena_block.data();
+  options.initial_block_size = request_arena_block.size();
+  options.max_block_size = kRequestArenaMaxBlockSize;
+  return options;
+}
 void service_worker_t::cleanup() {
   if (statsd_client) {
     // sends metrics to statsd server over udp
@@ -1676,21 +1733,28 @@ void service_worker_t::enqueue_statistics(Api& api) const {
   }
 }
 
-midgard::Finally<std::function<void()>> service_worker_t::measure_scope_time(Api& api) const {
+midgard::Finally<std::function<void()>>
+service_worker_t::measure_scope_time(Api& api, const std::string& metric) const {
   // we copy the captures that could go out of scope
   auto start = std::chrono::steady_clock::now();
-  return midgard::Finally<std::function<void()>>([this, &api, start]() {
+  return midgard::Finally<std::function<void()>>([this, &api, start, metric]() {
     auto elapsed = std::chrono::steady_clock::now() - start;
     auto e = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(elapsed).count();
-    const auto& action = Options_Action_Enum_Name(api.options().action());
-
-    auto* stat = api.mutable_info()->mutable_statistics()->Add();
-    stat->set_key(action + ".info." + service_name() + ".latency_ms");
-    stat->set_value(e);
-    stat->set_type(timing);
+    add_statistic(api, metric, e);
   });
 }
 
+void service_worker_t::add_statistic(Api& api,
+                                     const std::string& metric,
+                                     double value,
+                                     StatisticType type) const {
+  const auto& action = Options_Action_Enum_Name(api.options().action());
+  auto* stat = api.mutable_info()->mutable_statistics()->Add();
+  stat->set_key(action + ".info." + service_name() + "." + metric);
+  stat->set_value(value);
+  stat->set_type(type);
+}
+
 void service_worker_t::started() {
   if (statsd_client) {
     statsd_client->count("none.info." + service_name() + ".worker_started", 1, 1.f,
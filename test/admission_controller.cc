@@ -0,0 +1,305 @@
+#include "admission_controller.h"
+#include "test.h"
+#include "worker.h"
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace valhalla;
+
+namespace {
+
+Api parse(const std::string& json, Options::Action action) {
+  Api api;
+  ParseApi(json, action, api);
+  return api;
+}
+
+boost::property_tree::ptree config(float heavy_cost,
+                                   uint32_t max_heavy_matrices,
+                                   uint32_t max_wait_ms = 0,
+                                   uint32_t max_waiting = 0) {
+  boost::property_tree::ptree config;
+  config.put("heavy_cost", heavy_cost);
+  config.put("max_heavy.sources_to_targets", max_heavy_matrices);
+  config.put("max_wait_ms", max_wait_ms);
+  config.put("max_waiting", max_waiting);
+  return config;
+}
+
+void wait_for(const std::function<bool()>& condition) {
+  for (int i = 0; i < 1000 && !condition(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_TRUE(condition());
+}
+
+const std::string kShortRoute =
+    R"({"costing":"auto","locations":[{"lat":52.50,"lon":13.40},{"lat":52.51,"lon":13.41}]})";
+const std::string kLongRoute =
+    R"({"costing":"auto","locations":[{"lat":52.50,"lon":13.40},{"lat":48.13,"lon":11.57}]})";
+const std::string kMatrix = R"({"costing":"auto",
+  "sources":[{"lat":52.50,"lon":13.40},{"lat":52.51,"lon":13.41},{"lat":52.52,"lon":13.42}],
+  "targets":[{"lat":52.50,"lon":13.40},{"lat":52.51,"lon":13.41},{"lat":52.52,"lon":13.42}]})";
+
+TEST(AdmissionController, estimate_cost) {
+  auto locate =
+      parse(R"({"costing":"auto","locations":[{"lat":52.50,"lon":13.40}]})", Options::locate);
+  EXPECT_EQ(admission_controller_t::estimate_cost(locate), 0.f);
+
+  // routes cost about their length
+  auto short_route = admission_controller_t::estimate_cost(parse(kShortRoute, Options::route));
+  auto long_route = admission_controller_t::estimate_cost(parse(kLongRoute, Options::route));
+  EXPECT_NEAR(short_route, 1.3f, 0.1f);
+  EXPECT_NEAR(long_route, 504.f, 5.f);
+
+  // matrices cost at least as much as their number of connections
+  auto matrix = admission_controller_t::estimate_cost(parse(kMatrix, Options::sources_to_targets));
+  EXPECT_GE(matrix, 9.f);
+
+  // isochrones grow with the square of their contours
+  auto isochrone = [](int minutes) {
+    return admission_controller_t::estimate_cost(
+        parse(R"({"costing":"auto","locations":[{"lat":52.50,"lon":13.40}],"contours":[{"time":)" +
+                  std::to_string(minutes) + "}]}",
+              Options::isochrone));
+  };
+  EXPECT_FLOAT_EQ(isochrone(20), 4 * isochrone(10));
+}
+
+TEST(AdmissionController, heavy_requests_need_a_slot) {
+  admission_controller_t controller(config(5, 2));
+
+  // cheap requests always get in without taking a slot
+  auto cheap = parse(kShortRoute, Options::route);
+  EXPECT_TRUE(controller.admit(cheap, admission_controller_t::estimate_cost(cheap)));
+  EXPECT_FALSE(cheap.info().admission_slot());
+
+  // heavy requests of an action without a limit get in too
+  auto long_route = parse(kLongRoute, Options::route);
+  EXPECT_TRUE(controller.admit(long_route, admission_controller_t::estimate_cost(long_route)));
+  EXPECT_FALSE(long_route.info().admission_slot());
+
+  // until the slots are taken
+  auto first = parse(kMatrix, Options::sources_to_targets);
+  auto second = first, third = first;
+  const auto cost = admission_controller_t::estimate_cost(first);
+  ASSERT_GE(cost, 5.f);
+  EXPECT_TRUE(controller.admit(first, cost));
+  EXPECT_TRUE(controller.admit(second, cost));
+  EXPECT_FALSE(controller.admit(third, cost));
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 2u);
+
+  // releasing more than once only gives the slot back once
+  controller.release(first);
+  controller.release(first);
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 1u);
+  EXPECT_TRUE(controller.admit(third, cost));
+  EXPECT_TRUE(third.info().admission_slot());
+}
+
+TEST(AdmissionController, cheapest_waiting_request_goes_first) {
+  admission_controller_t controller(config(5, 1, 60000, 2));
+  auto first = parse(kMatrix, Options::sources_to_targets);
+  auto expensive = first, cheap = first;
+  ASSERT_TRUE(controller.admit(first, 10));
+
+  // the expensive request starts waiting before the cheap one
+  std::atomic<bool> expensive_in{false}, cheap_in{false};
+  std::thread expensive_thread([&]() { expensive_in = controller.admit(expensive, 100); });
+  wait_for([&]() { return controller.waiting(Options::sources_to_targets) == 1; });
+  std::thread cheap_thread([&]() { cheap_in = controller.admit(cheap, 50); });
+  wait_for([&]() { return controller.waiting(Options::sources_to_targets) == 2; });
+
+  // but the cheap one gets the slot first
+  controller.release(first);
+  wait_for([&]() { return cheap_in.load(); });
+  EXPECT_FALSE(expensive_in);
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 1u);
+
+  controller.release(cheap);
+  wait_for([&]() { return expensive_in.load(); });
+  cheap_thread.join();
+  expensive_thread.join();
+  EXPECT_EQ(controller.waiting(Options::sources_to_targets), 0u);
+  controller.release(expensive);
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 0u);
+}
+
+TEST(AdmissionController, waiting_times_out) {
+  admission_controller_t controller(config(5, 1, 20, 1));
+  auto first = parse(kMatrix, Options::sources_to_targets);
+  auto second = first;
+  ASSERT_TRUE(controller.admit(first, 10));
+  EXPECT_FALSE(controller.admit(second, 10));
+  EXPECT_FALSE(second.info().admission_slot());
+  EXPECT_EQ(controller.waiting(Options::sources_to_targets), 0u);
+}
+
+TEST(AdmissionController, cheap_requests_get_through_while_heavy_ones_wait) {
+  // a pool of workers like loki's, each of them admits the next request and holds a heavy one's
+  // slot until the test is done with it
+  const size_t worker_count = 3;
+  admission_controller_t controller(config(5, 1, 60000, worker_count - 1));
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<Api> jobs;
+  std::vector<Api> answered;
+  size_t rejected = 0;
+  bool done = false;
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back([&]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        changed.wait(lock, [&]() { return done || !jobs.empty(); });
+        if (done)
+          return;
+        auto job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        bool admitted = controller.admit(job, admission_controller_t::estimate_cost(job));
+        lock.lock();
+        if (admitted)
+          answered.push_back(std::move(job));
+        else
+          ++rejected;
+        changed.notify_all();
+      }
+    });
+  }
+  auto submit = [&](const Api& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back(job);
+    changed.notify_all();
+  };
+
+  // a burst of heavy matrices larger than the pool takes the slot and fills up the waiting room,
+  // the rest is turned away instead of blocking more workers
+  const auto heavy = parse(kMatrix, Options::sources_to_targets);
+  ASSERT_GE(admission_controller_t::estimate_cost(heavy), 5.f);
+  for (size_t i = 0; i < worker_count * 2; ++i) {
+    submit(heavy);
+  }
+  wait_for([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.empty() && answered.size() + rejected == worker_count + 1;
+  });
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 1u);
+  EXPECT_EQ(controller.waiting(Options::sources_to_targets), worker_count - 1);
+
+  // the one worker left over still answers a cheap request
+  submit(parse(kShortRoute, Options::route));
+  wait_for([&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !answered.empty() && answered.back().options().action() == Options::route;
+  });
+  EXPECT_EQ(controller.waiting(Options::sources_to_targets), worker_count - 1);
+
+  // giving back the slot lets the waiting requests in one after the other, the first heavy request
+  // and the two waiting ones each get it once
+  auto holding_slot = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::count_if(answered.begin(), answered.end(),
+                         [](const Api& job) { return job.info().admission_slot() != 0; });
+  };
+  for (size_t slot = 0; slot < worker_count; ++slot) {
+    wait_for([&]() { return holding_slot() == 1; });
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& job : answered) {
+      controller.release(job);
+    }
+  }
+  EXPECT_EQ(controller.waiting(Options::sources_to_targets), 0u);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    changed.notify_all();
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  EXPECT_EQ(rejected, worker_count);
+  EXPECT_EQ(answered.size(), worker_count + 1);
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 0u);
+}
+
+TEST(AdmissionController, dropped_requests_lose_their_slot) {
+  auto conf = config(5, 1);
+  conf.put("lease_seconds", 0);
+  admission_controller_t controller(conf);
+
+  // the first request never comes back so its lease runs out
+  auto dropped = parse(kMatrix, Options::sources_to_targets);
+  auto next = dropped;
+  ASSERT_TRUE(controller.admit(dropped, 10));
+  EXPECT_TRUE(controller.admit(next, 10));
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 1u);
+
+  // releasing an expired lease does not give back someone else's slot
+  controller.release(dropped);
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 1u);
+}
+
+TEST(AdmissionController, guard_releases_on_every_exit) {
+  auto controller = std::make_shared<admission_controller_t>(config(5, 1));
+  auto matrix = parse(kMatrix, Options::sources_to_targets);
+
+  // an error leaving the stage gives the slot back
+  try {
+    admission_guard_t guard(controller, matrix);
+    ASSERT_TRUE(controller->admit(matrix, 10));
+    throw std::runtime_error("stage failed");
+  } catch (const std::runtime_error&) {}
+  EXPECT_EQ(controller->in_flight(Options::sources_to_targets), 0u);
+
+  // handing the request on to the next stage keeps it
+  {
+    admission_guard_t guard(controller, matrix);
+    ASSERT_TRUE(controller->admit(matrix, 10));
+    guard.hand_on();
+  }
+  EXPECT_EQ(controller->in_flight(Options::sources_to_targets), 1u);
+
+  // until the stage that answers it is done
+  {
+    admission_guard_t guard(controller, matrix);
+    guard.hand_on(false);
+  }
+  EXPECT_EQ(controller->in_flight(Options::sources_to_targets), 0u);
+}
+
+TEST(AdmissionController, disabled) {
+  admission_controller_t controller(config(0, 1));
+  auto matrix = parse(kMatrix, Options::sources_to_targets);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(controller.admit(matrix, 1000));
+  }
+  EXPECT_EQ(controller.in_flight(Options::sources_to_targets), 0u);
+}
+
+TEST(AdmissionController, installed) {
+  EXPECT_EQ(admission_controller_t::installed(), nullptr);
+  auto controller = std::make_shared<admission_controller_t>(config(5, 1));
+  admission_controller_t::install(controller);
+  EXPECT_EQ(admission_controller_t::installed(), controller);
+  admission_controller_t::install(nullptr);
+  EXPECT_EQ(admission_controller_t::installed(), nullptr);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -4,6 +4,7 @@
 #include "midgard/util.h"
 #include "odin/worker.h"
 #include "test.h"
+#include "thor/alternates.h"
 #include "thor/worker.h"
 #include "tyr/serializers.h"
 
@@ -82,3 +83,22 @@ TEST(Alternates, test_one_alternate) {
 TEST(Alternates, test_two_alternates) {
   test_alternates(2);
 }
+
+TEST(Alternates, test_filter_by_plateau) {
+  const GraphId a(1, 2, 3), b(1, 2, 4), c(1, 2, 5);
+  // connections sorted by cost, the 2nd and 4th meet on the same plateau as the 1st and 3rd
+  std::vector<CandidateConnection> connections = {
+      {GraphId(1, 2, 10), GraphId(1, 2, 11), 100.f, a, 60.f},
+      {GraphId(1, 2, 12), GraphId(1, 2, 13), 100.5f, a, 60.f},
+      {GraphId(1, 2, 14), GraphId(1, 2, 15), 110.f, b, 5.f},
+      {GraphId(1, 2, 16), GraphId(1, 2, 17), 111.f, b, 5.f},
+      {GraphId(1, 2, 18), GraphId(1, 2, 19), 120.f, c, 50.f},
+  };
+  filter_alternates_by_plateau(connections);
+
+  // one connection per plateau, the optimal one first and then the locally optimal alternates
+  ASSERT_EQ(connections.size(), 3);
+  EXPECT_EQ(connections[0].edgeid, GraphId(1, 2, 10));
+  EXPECT_EQ(connections[1].edgeid, GraphId(1, 2, 18));
+  EXPECT_EQ(connections[2].edgeid, GraphId(1, 2, 14));
+}
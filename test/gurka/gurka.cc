@@ -456,6 +456,8 @@ map buildtiles(const nodelayout& layout,
 
   mjolnir::build_tile_set(result.config, {pbf_filename}, mjolnir::BuildStage::kInitialize,
                           mjolnir::BuildStage::kValidate);
+  mjolnir::build_tile_set(result.config, {pbf_filename}, mjolnir::BuildStage::kAlt,
+                          mjolnir::BuildStage::kAlt);
 
   return result;
 }
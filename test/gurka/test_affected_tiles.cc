@@ -0,0 +1,245 @@
+#include "gurka.h"
+#include "baldr/tilehierarchy.h"
+#include "mjolnir/affected_tiles.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace valhalla;
+
+class AffectedTiles : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    // two roads a couple hundred kilometers apart so that they are in different tiles on all levels
+    const std::string ascii_map = R"(
+      A-B                                     C-D
+    )";
+
+    const gurka::ways ways = {{"AB", {{"highway", "residential"}}},
+                              {"CD", {{"highway", "residential"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, 10000, {5.1, 52.0});
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_affected_tiles");
+  }
+
+  static std::string write_change(const std::string& name, const std::string& contents) {
+    auto filename = map.config.get<std::string>("mjolnir.tile_dir") + "/" + name;
+    std::ofstream(filename) << contents;
+    return filename;
+  }
+
+  // gurka numbers the nodes in the order of their names
+  static uint64_t osm_id(const gurka::nodelayout& layout, const std::string& node) {
+    return std::distance(layout.begin(), layout.find(node));
+  }
+
+  static baldr::GraphId local_tile(const std::string& node) {
+    const auto& level = baldr::TileHierarchy::levels().back();
+    return {static_cast<uint32_t>(level.tiles.TileId(map.nodes.at(node))), level.level, 0};
+  }
+};
+
+gurka::map AffectedTiles::map = {};
+
+TEST_F(AffectedTiles, changed_way) {
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  auto edge = gurka::findEdgeByNodes(reader, map.nodes, "A", "B");
+  auto way_id = reader.edgeinfo(std::get<0>(edge)).wayid();
+
+  mjolnir::OsmChange change;
+  mjolnir::read_osm_change(write_change("way.osc", R"(<?xml version="1.0" encoding="UTF-8"?>
+<osmChange version="0.6" generator="test">
+  <modify>
+    <way id=")" + std::to_string(way_id) + R"(" version="2">
+      <nd ref=")" + std::to_string(osm_id(map.nodes, "A")) + R"("/>
+      <nd ref=")" + std::to_string(osm_id(map.nodes, "B")) + R"("/>
+      <tag k="highway" v="primary"/>
+    </way>
+  </modify>
+</osmChange>
+)"),
+                           change);
+  ASSERT_EQ(change.way_ids.count(way_id), 1);
+  ASSERT_EQ(change.way_node_ids.size(), 2);
+
+  // the road becomes a primary one so it moves up the hierarchy, where its nodes are tells where
+  mjolnir::read_previous_osm({map.config.get<std::string>("mjolnir.tile_dir") + "/map.pbf"}, change);
+  ASSERT_EQ(change.locations.size(), 2);
+
+  auto tiles = mjolnir::collect_affected_tiles(reader, change);
+  EXPECT_EQ(tiles.count(local_tile("A")), 1);
+  EXPECT_EQ(tiles.count(local_tile("D")), 0);
+  // the upper levels are formed from the local level
+  for (const auto& level : baldr::TileHierarchy::levels()) {
+    baldr::GraphId tile(level.tiles.TileId(map.nodes.at("A")), level.level, 0);
+    EXPECT_EQ(tiles.count(tile), 1) << "level " << static_cast<int>(level.level);
+  }
+}
+
+TEST_F(AffectedTiles, changed_nodes_and_relations) {
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  auto edge = gurka::findEdgeByNodes(reader, map.nodes, "C", "D");
+  auto way_id = reader.edgeinfo(std::get<0>(edge)).wayid();
+  const auto& d = map.nodes.at("D");
+
+  mjolnir::OsmChange change;
+  mjolnir::read_osm_change(write_change("nodes.osc", R"(<?xml version="1.0" encoding="UTF-8"?>
+<osmChange version="0.6" generator="test">
+  <create>
+    <node id="1000" version="1" lat=")" + std::to_string(d.lat()) + R"(" lon=")" +
+                                                          std::to_string(d.lng()) + R"("/>
+    <relation id="1001" version="1">
+      <member type="way" ref=")" + std::to_string(way_id) + R"(" role="from"/>
+      <member type="node" ref="1000" role="via"/>
+      <tag k="type" v="restriction"/>
+    </relation>
+  </create>
+  <delete>
+    <node id="1002" version="3"/>
+  </delete>
+</osmChange>
+)"),
+                           change);
+  ASSERT_EQ(change.locations.size(), 1);
+  ASSERT_EQ(change.way_ids.count(way_id), 1);
+
+  auto tiles = mjolnir::collect_affected_tiles(reader, change);
+  EXPECT_EQ(tiles.count(local_tile("D")), 1);
+  EXPECT_EQ(tiles.count(local_tile("A")), 0);
+}
+
+TEST_F(AffectedTiles, via_node) {
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  auto edge = gurka::findEdgeByNodes(reader, map.nodes, "C", "D");
+  auto way_id = reader.edgeinfo(std::get<0>(edge)).wayid();
+
+  // the via node of the restriction is not part of the change, where it is comes from the data
+  mjolnir::OsmChange change;
+  mjolnir::read_osm_change(write_change("via.osc", R"(<?xml version="1.0" encoding="UTF-8"?>
+<osmChange version="0.6" generator="test">
+  <modify>
+    <relation id="1003" version="2">
+      <member type="way" ref=")" + std::to_string(way_id) + R"(" role="from"/>
+      <member type="node" ref=")" + std::to_string(osm_id(map.nodes, "A")) + R"(" role="via"/>
+      <tag k="type" v="restriction"/>
+    </relation>
+  </modify>
+</osmChange>
+)"),
+                           change);
+  ASSERT_EQ(change.member_node_ids.count(osm_id(map.nodes, "A")), 1);
+  mjolnir::read_previous_osm({map.config.get<std::string>("mjolnir.tile_dir") + "/map.pbf"}, change);
+  ASSERT_EQ(change.locations.size(), 1);
+
+  auto tiles = mjolnir::collect_affected_tiles(reader, change);
+  EXPECT_EQ(tiles.count(local_tile("A")), 1);
+  EXPECT_EQ(tiles.count(local_tile("D")), 1);
+}
+
+namespace {
+
+// the relative paths and contents of the graph tiles in a tile directory
+std::map<std::string, std::string> read_tiles(const std::string& tile_dir) {
+  std::map<std::string, std::string> tiles;
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(tile_dir)) {
+    if (entry.path().extension() != ".gph") {
+      continue;
+    }
+    std::ifstream file(entry.path(), std::ios::binary);
+    tiles[std::filesystem::relative(entry.path(), tile_dir).string()] =
+        std::string(std::istreambuf_iterator<char>(file), {});
+  }
+  return tiles;
+}
+
+} // namespace
+
+TEST(AffectedTilesRebuild, affected_tiles_of_full_build_match_it) {
+  // B is only a shape point of ABC, it is moved into another tile far away while CDE is promoted
+  // to a tertiary road, which moves it to the arterial level. GH is not touched at all
+  const std::string ascii_map = R"(
+      A---B---C                   G---H
+              |
+              D---E
+    )";
+  const gurka::ways before_ways = {{"ABC", {{"highway", "primary"}, {"osm_id", "100"}}},
+                                   {"CDE", {{"highway", "residential"}, {"osm_id", "101"}}},
+                                   {"GH", {{"highway", "residential"}, {"osm_id", "102"}}}};
+  auto after_ways = before_ways;
+  after_ways["CDE"]["highway"] = "tertiary";
+
+  const auto before_layout = gurka::detail::map_to_coordinates(ascii_map, 10000, {5.1, 52.0});
+  auto after_layout = before_layout;
+  after_layout["B"] = {before_layout.at("B").lng() + 0.1, before_layout.at("B").lat() - 0.6};
+
+  const std::string before_dir = "test/data/gurka_affected_tiles_before";
+  const std::string after_dir = "test/data/gurka_affected_tiles_after";
+  auto before = gurka::buildtiles(before_layout, before_ways, {}, {}, before_dir);
+  gurka::buildtiles(after_layout, after_ways, {}, {}, after_dir);
+
+  auto node_id = [&](const std::string& node) {
+    return std::to_string(std::distance(before_layout.begin(), before_layout.find(node)));
+  };
+  const auto& b = after_layout.at("B");
+  std::ofstream(before_dir + "/change.osc") << R"(<?xml version="1.0" encoding="UTF-8"?>
+<osmChange version="0.6" generator="test">
+  <modify>
+    <node id=")" + node_id("B") + R"(" version="2" lat=")" + std::to_string(b.lat()) + R"(" lon=")" +
+                                                 std::to_string(b.lng()) + R"("/>
+    <way id="101" version="2">
+      <nd ref=")" + node_id("C") + R"("/>
+      <nd ref=")" + node_id("D") + R"("/>
+      <nd ref=")" + node_id("E") + R"("/>
+      <tag k="highway" v="tertiary"/>
+    </way>
+  </modify>
+</osmChange>
+)";
+
+  // the affected tiles are found from the graph before the change and the data it was built from
+  mjolnir::OsmChange change;
+  mjolnir::read_osm_change(before_dir + "/change.osc", change);
+  mjolnir::read_previous_osm({before_dir + "/map.pbf"}, change);
+  // B's way goes through B so it is found through the previous data
+  EXPECT_EQ(change.way_ids.count(100), 1);
+  baldr::GraphReader reader(before.config.get_child("mjolnir"));
+  std::set<std::string> affected;
+  for (const auto& tile_id : mjolnir::collect_affected_tiles(reader, change)) {
+    affected.insert(baldr::GraphTile::FileSuffix(tile_id));
+  }
+
+  // replacing the affected tiles of the previous build with those of the full build of the changed
+  // data gives the full build, i.e. every tile which differs between the two builds is affected
+  auto before_tiles = read_tiles(before_dir);
+  auto after_tiles = read_tiles(after_dir);
+  size_t differing = 0;
+  for (const auto& tiles : {before_tiles, after_tiles}) {
+    for (const auto& tile : tiles) {
+      auto in_before = before_tiles.find(tile.first);
+      auto in_after = after_tiles.find(tile.first);
+      if (in_before == before_tiles.end() || in_after == after_tiles.end() ||
+          in_before->second != in_after->second) {
+        ++differing;
+        EXPECT_EQ(affected.count(tile.first), 1) << tile.first << " differs but is not affected";
+      }
+    }
+  }
+  EXPECT_GT(differing, 0);
+
+  // the tile where B used to be and the tile it moved to are among them, GH is left alone
+  const auto& local_level = baldr::TileHierarchy::levels().back();
+  auto local_path = [&](const midgard::PointLL& ll) {
+    return baldr::GraphTile::FileSuffix(
+        {static_cast<uint32_t>(local_level.tiles.TileId(ll)), local_level.level, 0});
+  };
+  EXPECT_EQ(affected.count(local_path(before_layout.at("B"))), 1);
+  EXPECT_EQ(affected.count(local_path(b)), 1);
+  EXPECT_EQ(affected.count(local_path(before_layout.at("G"))), 0);
+  EXPECT_EQ(before_tiles.at(local_path(before_layout.at("G"))),
+            after_tiles.at(local_path(before_layout.at("G"))));
+}
@@ -0,0 +1,179 @@
+#include "baldr/alttile.h"
+#include "filesystem.h"
+#include "gurka.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+using namespace valhalla;
+
+class AltLandmarks : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    // nothing crosses the middle which makes the straight line a poor estimate
+    const std::string ascii_map = R"(
+      A-----B-----C-----D
+      |                 |
+      E                 F
+      |                 |
+      G                 H
+      |                 |
+      I-----J-----K-----L
+    )";
+
+    const gurka::ways ways = {{"ABCD", {{"highway", "primary"}}},
+                              {"AEGI", {{"highway", "secondary"}}},
+                              {"DFHL", {{"highway", "secondary"}}},
+                              {"IJKL", {{"highway", "residential"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_alt_landmarks",
+                            {{"mjolnir.alt_dir", "test/data/gurka_alt_landmarks/alt"},
+                             {"mjolnir.alt_landmark_count", "3"}});
+  }
+};
+
+gurka::map AltLandmarks::map = {};
+
+TEST_F(AltLandmarks, side_tiles) {
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  for (const auto& tile_id : reader.GetTileSet()) {
+    auto tile = reader.GetGraphTile(tile_id);
+    auto alt_tile = baldr::AltTile::Create("test/data/gurka_alt_landmarks/alt", *tile);
+    ASSERT_NE(alt_tile, nullptr) << tile_id;
+    EXPECT_EQ(alt_tile->landmark_count(), 3);
+    ASSERT_EQ(alt_tile->node_count(), tile->header()->nodecount());
+
+    // the graph is connected so every node has a distance to every landmark
+    for (uint32_t l = 0; l < alt_tile->landmark_count(); ++l) {
+      for (uint32_t n = 0; n < alt_tile->node_count(); ++n) {
+        EXPECT_NE(alt_tile->distance(l, n), baldr::kInvalidAltDistance);
+      }
+    }
+  }
+}
+
+TEST_F(AltLandmarks, distances_bound_routes) {
+  // the difference of the distances to a landmark is never more than the route between two nodes
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  baldr::AltLandmarks landmarks(map.config.get_child("mjolnir"));
+  for (const auto& from : {"A", "D", "F", "J"}) {
+    for (const auto& to : {"I", "L", "C", "G"}) {
+      auto result = gurka::do_action(Options::route, map, {from, to}, "auto");
+      auto route_length = result.directions().routes(0).legs(0).summary().length() * 1000.0;
+
+      auto a = gurka::findNode(reader, map.nodes, from);
+      auto b = gurka::findNode(reader, map.nodes, to);
+      auto a_tile = landmarks.GetTile(reader.GetGraphTile(a));
+      auto b_tile = landmarks.GetTile(reader.GetGraphTile(b));
+      ASSERT_NE(a_tile, nullptr);
+      ASSERT_NE(b_tile, nullptr);
+      for (uint32_t l = 0; l < a_tile->landmark_count(); ++l) {
+        double da = a_tile->distance(l, a.id());
+        double db = b_tile->distance(l, b.id());
+        EXPECT_LE(std::abs(da - db), route_length + 1.0) << from << " to " << to;
+      }
+    }
+  }
+}
+
+TEST_F(AltLandmarks, other_build_rejected) {
+  baldr::GraphReader reader(map.config.get_child("mjolnir"));
+  const std::string alt_dir = "test/data/gurka_alt_landmarks/alt_other_build";
+  for (const auto& tile_id : reader.GetTileSet()) {
+    auto tile = reader.GetGraphTile(tile_id);
+    auto file_name = baldr::AltTile::FileName(alt_dir, tile_id);
+    filesystem::create_directories(filesystem::path(file_name).parent_path());
+
+    // side tiles of another dataset or with another number of nodes are not used
+    for (const auto& change : std::vector<std::pair<uint64_t, uint32_t>>{{1, 0}, {0, 1}}) {
+      std::ifstream in(baldr::AltTile::FileName("test/data/gurka_alt_landmarks/alt", tile_id),
+                       std::ios::binary);
+      std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      auto* header = reinterpret_cast<baldr::AltTileHeader*>(&bytes[0]);
+      header->dataset_id += change.first;
+      header->node_count += change.second;
+      std::ofstream(file_name, std::ios::binary | std::ios::trunc) << bytes;
+      EXPECT_EQ(baldr::AltTile::Create(alt_dir, *tile), nullptr) << tile_id;
+    }
+  }
+}
+
+TEST_F(AltLandmarks, same_routes_as_straight_line_heuristic) {
+  auto straight_line = map;
+  straight_line.config.get_child("mjolnir").erase("alt_dir");
+
+  for (const auto& waypoints : std::vector<std::vector<std::string>>{{"E", "H"},
+                                                                     {"B", "K"},
+                                                                     {"G", "F"},
+                                                                     {"J", "C"}}) {
+    for (const auto& options : std::vector<std::unordered_map<std::string, std::string>>{
+             {},
+             {{"/date_time/type", "1"}, {"/date_time/value", "2020-10-10T13:00"}}}) {
+      auto with = gurka::do_action(Options::route, map, waypoints, "auto", options);
+      auto without = gurka::do_action(Options::route, straight_line, waypoints, "auto", options);
+      EXPECT_EQ(gurka::detail::get_paths(with), gurka::detail::get_paths(without));
+      EXPECT_EQ(with.trip().routes(0).legs(0).shape(), without.trip().routes(0).legs(0).shape());
+    }
+  }
+}
+
+TEST(AltLandmarksSearch, fewer_edges_settled) {
+  constexpr double gridsize = 100;
+
+  // the grid lies along the straight line from C to N but the only way out of it is back past C
+  const std::string ascii_map = R"(
+      A-------------------B
+      |                   |
+      C---D---E---F---G   |
+      |   |   |   |   |   |
+      H---I---J---K---L   |
+                          |
+      M-------------------N
+    )";
+
+  const gurka::ways ways = {{"AB", {{"highway", "primary"}}},
+                            {"BN", {{"highway", "primary"}}},
+                            {"NM", {{"highway", "primary"}}},
+                            {"AC", {{"highway", "primary"}}},
+                            {"CH", {{"highway", "residential"}}},
+                            {"CDEFG", {{"highway", "residential"}}},
+                            {"HIJKL", {{"highway", "residential"}}},
+                            {"DI", {{"highway", "residential"}}},
+                            {"EJ", {{"highway", "residential"}}},
+                            {"FK", {{"highway", "residential"}}},
+                            {"GL", {{"highway", "residential"}}}};
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_alt_landmarks_search",
+                               {{"mjolnir.alt_dir", "test/data/gurka_alt_landmarks_search/alt"},
+                                {"mjolnir.alt_landmark_count", "4"}});
+  auto straight_line = map;
+  straight_line.config.get_child("mjolnir").erase("alt_dir");
+
+  auto edges_settled = [](const Api& api) {
+    for (const auto& stat : api.info().statistics()) {
+      if (stat.key() == "route.info.thor.edges_settled") {
+        return stat.value();
+      }
+    }
+    return 0.0;
+  };
+
+  // the landmarks show that the grid leads away from the destination so the search leaves it be
+  double settled_with = 0, settled_without = 0;
+  for (const auto& waypoints : std::vector<std::vector<std::string>>{{"C", "N"}, {"N", "C"}}) {
+    auto with = gurka::do_action(Options::route, map, waypoints, "auto");
+    auto without = gurka::do_action(Options::route, straight_line, waypoints, "auto");
+    EXPECT_EQ(gurka::detail::get_paths(with), gurka::detail::get_paths(without));
+    settled_with += edges_settled(with);
+    settled_without += edges_settled(without);
+  }
+  EXPECT_GT(settled_with, 0);
+  EXPECT_LT(settled_with, settled_without);
+}
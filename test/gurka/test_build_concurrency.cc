@@ -0,0 +1,163 @@
+#include "gurka.h"
+#include "mjolnir/util.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+using namespace valhalla;
+
+namespace {
+
+// builds the tiles up to the serial stage with one thread, the remaining stages with the given
+// number of threads and returns the contents of every tile keyed by its path in the tile dir
+std::map<std::string, std::string> build(const gurka::nodelayout& layout,
+                                         const gurka::ways& ways,
+                                         const std::string& tile_dir,
+                                         mjolnir::BuildStage serial_end,
+                                         mjolnir::BuildStage parallel_start,
+                                         mjolnir::BuildStage parallel_end,
+                                         unsigned int concurrency,
+                                         const std::unordered_map<std::string, std::string>&
+                                             options = {},
+                                         const gurka::nodes& nodes = {},
+                                         const gurka::relations& relations = {}) {
+  auto overrides = options;
+  overrides["mjolnir.concurrency"] = "1";
+  auto config = test::make_config(tile_dir, overrides);
+  if (filesystem::exists(tile_dir))
+    filesystem::remove_all(tile_dir);
+  filesystem::create_directories(tile_dir);
+  auto pbf_filename = tile_dir + "/map.pbf";
+  gurka::detail::build_pbf(layout, ways, nodes, relations, pbf_filename);
+  mjolnir::build_tile_set(config, {pbf_filename}, mjolnir::BuildStage::kInitialize, serial_end);
+  config.put("mjolnir.concurrency", concurrency);
+  mjolnir::build_tile_set(config, {pbf_filename}, parallel_start, parallel_end);
+
+  std::map<std::string, std::string> tiles;
+  for (const auto& file : filesystem::get_files(tile_dir)) {
+    if (filesystem::path(file).extension().string() != ".gph") {
+      continue;
+    }
+    std::ifstream stream(file, std::ios::binary);
+    std::stringstream contents;
+    contents << stream.rdbuf();
+    tiles.emplace(file.substr(file.find(tile_dir) + tile_dir.size()), contents.str());
+  }
+  return tiles;
+}
+
+} // namespace
+
+TEST(BuildConcurrency, hierarchy_and_shortcuts_match_serial_build) {
+  // long enough to span several tiles on every level with a chain of contractable nodes
+  const std::string ascii_map = R"(
+    A----B----C----D----E----F----I
+         |              |
+         G              H
+  )";
+
+  const gurka::ways ways = {{"ABCDEFI", {{"highway", "motorway"}}},
+                            {"BG", {{"highway", "primary"}}},
+                            {"EH", {{"highway", "residential"}}}};
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 10000);
+  auto serial = build(layout, ways, "test/data/build_concurrency_serial",
+                      mjolnir::BuildStage::kBss, mjolnir::BuildStage::kHierarchy,
+                      mjolnir::BuildStage::kShortcuts, 1);
+  auto parallel = build(layout, ways, "test/data/build_concurrency_parallel",
+                        mjolnir::BuildStage::kBss, mjolnir::BuildStage::kHierarchy,
+                        mjolnir::BuildStage::kShortcuts, 4);
+
+  ASSERT_GT(serial.size(), 2);
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (const auto& tile : serial) {
+    auto found = parallel.find(tile.first);
+    ASSERT_NE(found, parallel.end()) << tile.first;
+    EXPECT_TRUE(found->second == tile.second) << tile.first << " differs";
+  }
+}
+
+TEST(BuildConcurrency, filter_matches_serial_build) {
+  // footways split the roads so that the filter drops them and aggregates the remaining edges,
+  // some of them across tile boundaries
+  const std::string ascii_map = R"(
+    A----B----C----D----E----F----I
+         |    |         |    |
+         J    K         L    M
+  )";
+
+  const gurka::ways ways = {{"ABCDEFI", {{"highway", "primary"}}},
+                            {"BJ", {{"highway", "footway"}}},
+                            {"CK", {{"highway", "footway"}}},
+                            {"EL", {{"highway", "footway"}}},
+                            {"FM", {{"highway", "footway"}}}};
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 1000);
+  const std::unordered_map<std::string, std::string> options = {
+      {"mjolnir.include_pedestrian", "false"}};
+  auto serial = build(layout, ways, "test/data/build_concurrency_filter_serial",
+                      mjolnir::BuildStage::kEnhance, mjolnir::BuildStage::kFilter,
+                      mjolnir::BuildStage::kFilter, 1, options);
+  auto parallel = build(layout, ways, "test/data/build_concurrency_filter_parallel",
+                        mjolnir::BuildStage::kEnhance, mjolnir::BuildStage::kFilter,
+                        mjolnir::BuildStage::kFilter, 4, options);
+
+  ASSERT_GT(serial.size(), 1);
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (const auto& tile : serial) {
+    auto found = parallel.find(tile.first);
+    ASSERT_NE(found, parallel.end()) << tile.first;
+    EXPECT_TRUE(found->second == tile.second) << tile.first << " differs";
+  }
+}
+
+TEST(BuildConcurrency, parse_matches_serial_build) {
+  // tagged nodes and relations of every kind the parser looks at
+  const std::string ascii_map = R"(
+    A----B----C----D
+         |    |
+         E----F----G
+  )";
+
+  const gurka::ways ways = {{"ABCD", {{"highway", "motorway"}, {"ref", "I 95"}}},
+                            {"BE", {{"highway", "motorway_link"}}},
+                            {"CF", {{"highway", "primary"}, {"name", "Main Street"}}},
+                            {"EFG", {{"highway", "residential"}, {"name", "Side Street"}}}};
+  const gurka::nodes nodes = {{"B", {{"highway", "motorway_junction"}, {"ref", "4"}}},
+                              {"F", {{"highway", "traffic_signals"}}},
+                              {"G", {{"barrier", "gate"}}}};
+  const gurka::relations relations = {
+      {{{gurka::way_member, "CF", "from"},
+        {gurka::node_member, "F", "via"},
+        {gurka::way_member, "EFG", "to"}},
+       {{"type", "restriction"}, {"restriction", "no_right_turn"}}},
+      {{{gurka::way_member, "ABCD", "from"},
+        {gurka::way_member, "CF", "via"},
+        {gurka::way_member, "EFG", "to"}},
+       {{"type", "restriction"}, {"restriction", "no_left_turn"}}},
+      {{{gurka::way_member, "ABCD", "forward"}},
+       {{"type", "route"}, {"route", "road"}, {"ref", "95"}, {"network", "US:I"},
+        {"direction", "north"}}},
+  };
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto serial = build(layout, ways, "test/data/build_concurrency_parse_serial",
+                      mjolnir::BuildStage::kInitialize, mjolnir::BuildStage::kParseWays,
+                      mjolnir::BuildStage::kBuild, 1, {}, nodes, relations);
+  auto parallel = build(layout, ways, "test/data/build_concurrency_parse_parallel",
+                        mjolnir::BuildStage::kInitialize, mjolnir::BuildStage::kParseWays,
+                        mjolnir::BuildStage::kBuild, 4, {}, nodes, relations);
+
+  ASSERT_GT(serial.size(), 0);
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (const auto& tile : serial) {
+    auto found = parallel.find(tile.first);
+    ASSERT_NE(found, parallel.end()) << tile.first;
+    EXPECT_TRUE(found->second == tile.second) << tile.first << " differs";
+  }
+}
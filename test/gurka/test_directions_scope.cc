@@ -0,0 +1,163 @@
+#include "gurka.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class DirectionsScope : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    const std::string ascii_map = R"(
+      A----B----C
+           |
+           D----E
+    )";
+
+    const gurka::ways ways = {{"AB", {{"highway", "primary"}, {"name", "First Street"}}},
+                              {"BC", {{"highway", "primary"}, {"name", "Second Street"}}},
+                              {"BD", {{"highway", "secondary"}, {"name", "Third Street"}}},
+                              {"DE", {{"highway", "secondary"}, {"name", "Fourth Street"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_directions_scope");
+  }
+
+  static bool has_verbal(const Api& api) {
+    for (const auto& maneuver : api.directions().routes(0).legs(0).maneuver()) {
+      if (!maneuver.verbal_pre_transition_instruction().empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // runs the route through the pbf api, optionally with a field selector
+  static Api do_pbf(const PbfFieldSelector* selector) {
+    std::string request_json;
+    gurka::do_action(Options::route, map, {"A", "E"}, "auto", {}, {}, nullptr, "break",
+                     &request_json);
+    Api request;
+    ParseApi(request_json, Options::route, request);
+    request.mutable_options()->clear_costings();
+    request.mutable_options()->set_format(Options::pbf);
+    if (selector) {
+      request.mutable_options()->mutable_pbf_field_selector()->CopyFrom(*selector);
+    }
+    Api response;
+    EXPECT_TRUE(response.ParseFromString(gurka::do_action(map, request)));
+    return response;
+  }
+
+  static bool has_statistic(const Api& api, const std::string& key) {
+    for (const auto& stat : api.info().statistics()) {
+      if (stat.key() == key) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+gurka::map DirectionsScope::map = {};
+
+TEST_F(DirectionsScope, json_has_everything) {
+  auto result = gurka::do_action(Options::route, map, {"A", "E"}, "auto");
+  gurka::assert::raw::expect_maneuvers(result, {DirectionsLeg_Maneuver_Type_kStart,
+                                                DirectionsLeg_Maneuver_Type_kRight,
+                                                DirectionsLeg_Maneuver_Type_kLeft,
+                                                DirectionsLeg_Maneuver_Type_kDestination});
+  EXPECT_TRUE(has_verbal(result));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.maneuvers_ms"));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.narrative_ms"));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.serialize_ms"));
+}
+
+TEST_F(DirectionsScope, osrm_verbal_only_with_voice_instructions) {
+  auto without = gurka::do_action(Options::route, map, {"A", "E"}, "auto", {{"/format", "osrm"}});
+  EXPECT_FALSE(has_verbal(without));
+
+  auto with = gurka::do_action(Options::route, map, {"A", "E"}, "auto",
+                               {{"/format", "osrm"}, {"/voice_instructions", "true"}});
+  EXPECT_TRUE(has_verbal(with));
+
+  // the text instructions are the same either way
+  ASSERT_EQ(without.directions().routes(0).legs(0).maneuver_size(),
+            with.directions().routes(0).legs(0).maneuver_size());
+  for (int i = 0; i < with.directions().routes(0).legs(0).maneuver_size(); ++i) {
+    EXPECT_EQ(without.directions().routes(0).legs(0).maneuver(i).text_instruction(),
+              with.directions().routes(0).legs(0).maneuver(i).text_instruction());
+  }
+}
+
+TEST_F(DirectionsScope, gpx_has_no_directions) {
+  std::string response;
+  auto result = gurka::do_action(Options::route, map, {"A", "E"}, "auto", {{"/format", "gpx"}},
+                                 nullptr, &response);
+  EXPECT_EQ(result.directions().routes_size(), 0);
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.maneuvers_ms"));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.narrative_ms"));
+  EXPECT_NE(response.find("<rtept"), std::string::npos);
+}
+
+TEST_F(DirectionsScope, pbf_without_selector_has_directions) {
+  auto result = do_pbf(nullptr);
+  EXPECT_FALSE(result.has_trip());
+  ASSERT_EQ(result.directions().routes_size(), 1);
+  EXPECT_EQ(result.directions().routes(0).legs(0).maneuver_size(), 4);
+  EXPECT_TRUE(has_verbal(result));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.maneuvers_ms"));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.narrative_ms"));
+}
+
+TEST_F(DirectionsScope, pbf_selecting_directions) {
+  PbfFieldSelector selector;
+  selector.set_directions(true);
+  auto result = do_pbf(&selector);
+  ASSERT_EQ(result.directions().routes_size(), 1);
+  EXPECT_EQ(result.directions().routes(0).legs(0).maneuver_size(), 4);
+  EXPECT_TRUE(has_verbal(result));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.narrative_ms"));
+}
+
+TEST_F(DirectionsScope, pbf_not_selecting_directions) {
+  PbfFieldSelector selector;
+  selector.set_trip(true);
+  auto result = do_pbf(&selector);
+  EXPECT_EQ(result.directions().routes_size(), 0);
+  ASSERT_EQ(result.trip().routes_size(), 1);
+  EXPECT_GT(result.trip().routes(0).legs(0).node_size(), 0);
+  // the stages are still timed even though there was nothing to build
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.maneuvers_ms"));
+  EXPECT_TRUE(has_statistic(result, "route.info.odin.narrative_ms"));
+}
+
+TEST_F(DirectionsScope, narrative_concurrency) {
+  auto concurrent = map;
+  concurrent.config.put("odin.narrative_concurrency", 3);
+
+  // several legs so that there is something to spread over the threads
+  const std::vector<std::string> waypoints = {"A", "C", "E", "A", "E"};
+  auto expected = gurka::do_action(Options::route, map, waypoints, "auto");
+  // the same worker threads narrate one request after the other
+  for (int i = 0; i < 2; ++i) {
+    auto result = gurka::do_action(Options::route, concurrent, waypoints, "auto");
+    ASSERT_EQ(result.directions().routes(0).legs_size(),
+              expected.directions().routes(0).legs_size());
+    for (int j = 0; j < expected.directions().routes(0).legs_size(); ++j) {
+      const auto& expected_leg = expected.directions().routes(0).legs(j);
+      const auto& leg = result.directions().routes(0).legs(j);
+      ASSERT_EQ(leg.maneuver_size(), expected_leg.maneuver_size());
+      for (int k = 0; k < leg.maneuver_size(); ++k) {
+        EXPECT_EQ(leg.maneuver(k).text_instruction(), expected_leg.maneuver(k).text_instruction());
+        EXPECT_EQ(leg.maneuver(k).verbal_pre_transition_instruction(),
+                  expected_leg.maneuver(k).verbal_pre_transition_instruction());
+      }
+    }
+    EXPECT_TRUE(has_statistic(result, "route.info.odin.maneuvers_ms"));
+    EXPECT_TRUE(has_statistic(result, "route.info.odin.narrative_ms"));
+  }
+}
@@ -0,0 +1,129 @@
+#include "gurka.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class LegConcurrency : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    const std::string ascii_map = R"(
+      A----B----C
+      |    |    |
+      D----E----F
+      |    |    |
+      G----H----I
+    )";
+
+    const gurka::ways ways = {{"ABC", {{"highway", "primary"}}},
+                              {"DEF", {{"highway", "residential"}}},
+                              {"GHI", {{"highway", "secondary"}}},
+                              {"ADG", {{"highway", "secondary"}}},
+                              {"BEH", {{"highway", "tertiary"}}},
+                              {"CFI", {{"highway", "primary"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_leg_concurrency",
+                            {{"thor.leg_concurrency", "3"}});
+  }
+
+  // the same route with all of its legs computed one after the other
+  static void expect_sequential(const std::vector<std::string>& waypoints,
+                                const std::unordered_map<std::string, std::string>& options = {}) {
+    auto concurrent = gurka::do_action(Options::route, map, waypoints, "auto", options);
+    auto sequential_map = map;
+    sequential_map.config.put("thor.leg_concurrency", 1);
+    auto sequential = gurka::do_action(Options::route, sequential_map, waypoints, "auto", options);
+
+    ASSERT_EQ(concurrent.trip().routes_size(), 1);
+    ASSERT_EQ(sequential.trip().routes_size(), 1);
+    EXPECT_EQ(gurka::detail::get_paths(concurrent), gurka::detail::get_paths(sequential));
+
+    const auto& concurrent_legs = concurrent.trip().routes(0).legs();
+    const auto& sequential_legs = sequential.trip().routes(0).legs();
+    ASSERT_EQ(concurrent_legs.size(), sequential_legs.size());
+    for (int i = 0; i < concurrent_legs.size(); ++i) {
+      EXPECT_EQ(concurrent_legs.Get(i).shape(), sequential_legs.Get(i).shape());
+      EXPECT_NEAR(concurrent_legs.Get(i).node().rbegin()->cost().elapsed_cost().seconds(),
+                  sequential_legs.Get(i).node().rbegin()->cost().elapsed_cost().seconds(), 1e-3);
+      EXPECT_EQ(concurrent_legs.Get(i).location(0).date_time(),
+                sequential_legs.Get(i).location(0).date_time());
+    }
+  }
+};
+
+gurka::map LegConcurrency::map = {};
+
+TEST_F(LegConcurrency, matches_sequential_legs) {
+  expect_sequential({"A", "I", "D", "C", "G", "E"});
+}
+
+TEST_F(LegConcurrency, matches_sequential_time_dependent_legs) {
+  expect_sequential({"A", "I", "D", "C", "G", "E"},
+                    {{"/date_time/type", "1"}, {"/date_time/value", "2020-10-10T13:00"}});
+}
+
+TEST_F(LegConcurrency, through_locations_stay_sequential) {
+  auto result = gurka::do_action(Options::route, map, {"A", "E", "I"}, "auto",
+                                 {{"/locations/1/type", "through"}});
+  ASSERT_EQ(result.trip().routes(0).legs_size(), 1);
+  expect_sequential({"A", "E", "I"}, {{"/locations/1/type", "through"}});
+}
+
+TEST_F(LegConcurrency, interrupt_reaches_concurrent_legs) {
+  std::vector<midgard::PointLL> points;
+  for (const auto& name : {"A", "I", "D", "C", "G", "E"}) {
+    points.push_back(map.nodes[name]);
+  }
+  auto request = gurka::detail::build_valhalla_request({"locations"}, {points});
+
+  // the legs are computed on the threads of the worker but the request is still interrupted
+  struct interrupted_t {};
+  const std::function<void()> interrupt = []() { throw interrupted_t{}; };
+  auto reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  tyr::actor_t actor(map.config, *reader, true);
+  EXPECT_THROW(actor.route(request, &interrupt), interrupted_t);
+
+  // and the worker is fine for the next request
+  const std::function<void()> carry_on = []() {};
+  Api api;
+  actor.route(request, &carry_on, &api);
+  EXPECT_EQ(api.trip().routes(0).legs_size(), 5);
+}
+
+TEST(LegConcurrencyStandalone, leg_failure_reports_error) {
+  const std::string ascii_map = R"(
+    A----B----C
+
+    D----E
+  )";
+  const gurka::ways ways = {{"ABC", {{"highway", "primary"}}}, {"DE", {{"highway", "primary"}}}};
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_leg_concurrency_failure",
+                               {{"thor.leg_concurrency", "2"}});
+
+  // a leg that can't be computed fails the route the same way it does without concurrency
+  for (auto concurrency : {"2", "1"}) {
+    map.config.put("thor.leg_concurrency", concurrency);
+    try {
+      gurka::do_action(Options::route, map, {"A", "C", "E", "B"}, "auto",
+                       {{"/locations/2/minimum_reachability", "0"}});
+      FAIL() << "Expected the leg to E to fail with concurrency " << concurrency;
+    } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 442) << concurrency; }
+  }
+}
+
+TEST_F(LegConcurrency, work_budget_covers_concurrent_legs) {
+  // the edges the legs settle on the threads of the worker count towards the budget
+  auto budget_map = map;
+  budget_map.config.put("thor.budget.max_settled_edges", 1);
+  try {
+    gurka::do_action(Options::route, budget_map, {"A", "I", "D", "C", "G", "E"}, "auto");
+    FAIL() << "Expected the route to exceed its work budget";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 446); }
+}
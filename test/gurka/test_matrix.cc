@@ -6,6 +6,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 using namespace valhalla;
 using namespace valhalla::thor;
 using namespace valhalla::midgard;
@@ -1138,4 +1142,85 @@ TEST_P(TestConnectionCheck, MultipleTrivialRoutes) {
   check_trivial_matrix(map, layout);
 }
 
-INSTANTIATE_TEST_SUITE_P(connection_check, TestConnectionCheck, ::testing::Values("1", "0"));
\ No newline at end of file
+INSTANTIATE_TEST_SUITE_P(connection_check, TestConnectionCheck, ::testing::Values("1", "0"));
+TEST(StandAlone, ConciseAndBinaryFormats) {
+  const std::string ascii_map = R"(
+    A---B---C---D
+    |       |
+    E---F---G   H
+  )";
+
+  const gurka::ways ways = {{"ABCD", {{"highway", "residential"}}},
+                            {"AEFG", {{"highway", "residential"}}},
+                            {"GC", {{"highway", "residential"}}},
+                            {"DH", {{"highway", "residential"}, {"oneway", "yes"}}}};
+
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/matrix_binary_format");
+
+  auto read_le = [](const std::string& bytes, size_t offset, size_t size) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+      value |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[offset + i])) << (8 * i);
+    }
+    return value;
+  };
+
+  // forward and reverse timedistancematrix as well as costmatrix, with a target that is unreachable
+  for (const auto& bidirectional : {"0", "1"}) {
+    for (const auto& locations : std::vector<std::pair<std::vector<std::string>,
+                                                       std::vector<std::string>>>{
+             {{"A", "F"}, {"B", "G", "H"}},
+             {{"B", "G", "H"}, {"A", "E"}},
+         }) {
+      const auto& sources = locations.first;
+      const auto& targets = locations.second;
+      std::string json, binary;
+      auto api = gurka::do_action(Options::sources_to_targets, map, sources, targets, "auto",
+                                  {{"/verbose", "0"}, {"/prioritize_bidirectional", bidirectional}},
+                                  nullptr, &json);
+      gurka::do_action(Options::sources_to_targets, map, sources, targets, "auto",
+                       {{"/format", "binary"}, {"/prioritize_bidirectional", bidirectional}},
+                       nullptr, &binary);
+
+      rapidjson::Document doc;
+      doc.Parse(json.c_str());
+      ASSERT_FALSE(doc.HasParseError()) << json;
+      const auto& durations = doc["sources_to_targets"]["durations"];
+      const auto& distances = doc["sources_to_targets"]["distances"];
+      ASSERT_EQ(durations.Size(), sources.size());
+      ASSERT_EQ(distances.Size(), sources.size());
+
+      const size_t cells = sources.size() * targets.size();
+      ASSERT_EQ(binary.size(), 16 + cells * 8);
+      EXPECT_EQ(binary.substr(0, 4), "VMTX");
+      EXPECT_EQ(read_le(binary, 4, 2), 1);
+      EXPECT_EQ(read_le(binary, 6, 2), 0);
+      EXPECT_EQ(read_le(binary, 8, 4), sources.size());
+      EXPECT_EQ(read_le(binary, 12, 4), targets.size());
+
+      for (size_t i = 0; i < sources.size(); ++i) {
+        ASSERT_EQ(durations[i].Size(), targets.size());
+        for (size_t j = 0; j < targets.size(); ++j) {
+          const size_t cell = i * targets.size() + j;
+          const auto time = read_le(binary, 16 + cell * 4, 4);
+          const auto distance_bits = read_le(binary, 16 + cells * 4 + cell * 4, 4);
+          float distance;
+          std::memcpy(&distance, &distance_bits, sizeof(distance));
+
+          if (api.matrix().times(cell) == kMaxCost) {
+            EXPECT_TRUE(durations[i][j].IsNull());
+            EXPECT_EQ(time, std::numeric_limits<uint32_t>::max());
+            EXPECT_TRUE(std::isnan(distance));
+            continue;
+          }
+          EXPECT_EQ(durations[i][j].GetUint64(),
+                    static_cast<uint64_t>(api.matrix().times(cell)));
+          EXPECT_EQ(time, static_cast<uint32_t>(api.matrix().times(cell)));
+          EXPECT_NEAR(distances[i][j].GetDouble(), api.matrix().distances(cell) / 1000.0, 0.001);
+          EXPECT_NEAR(distance, distances[i][j].GetDouble(), 0.001);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,198 @@
+#include "gurka.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class OneToMany : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    const std::string ascii_map = R"(
+      A----B----C
+      |    |    |
+      D----E----F
+      |         |
+      G---------H
+    )";
+
+    const gurka::ways ways = {{"ABC", {{"highway", "primary"}}},
+                              {"DEF", {{"highway", "residential"}}},
+                              {"GH", {{"highway", "motorway"}}},
+                              {"ADG", {{"highway", "secondary"}}},
+                              {"BE", {{"highway", "tertiary"}}},
+                              {"CFH", {{"highway", "secondary"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_one_to_many");
+  }
+};
+
+gurka::map OneToMany::map = {};
+
+TEST_F(OneToMany, matches_individual_routes) {
+  const std::vector<std::string> destinations = {"C", "E", "H", "D"};
+  std::vector<std::string> locations = {"A"};
+  locations.insert(locations.end(), destinations.begin(), destinations.end());
+
+  auto result =
+      gurka::do_action(valhalla::Options::route, map, locations, "auto", {{"/one_to_many", "1"}});
+  ASSERT_EQ(result.trip().routes_size(), destinations.size());
+  ASSERT_EQ(result.directions().routes_size(), destinations.size());
+
+  // every route has a single leg from the origin to its destination
+  auto paths = gurka::detail::get_paths(result);
+  for (size_t i = 0; i < destinations.size(); ++i) {
+    const auto& leg = result.trip().routes(i).legs(0);
+    ASSERT_EQ(result.trip().routes(i).legs_size(), 1);
+    EXPECT_NEAR(leg.location(1).ll().lng(), map.nodes[destinations[i]].lng(), 1e-6);
+    EXPECT_NEAR(leg.location(1).ll().lat(), map.nodes[destinations[i]].lat(), 1e-6);
+
+    // and takes the same way as a route to that destination alone
+    auto single = gurka::do_action(valhalla::Options::route, map, {"A", destinations[i]}, "auto");
+    EXPECT_EQ(paths[i], gurka::detail::get_paths(single).front()) << destinations[i];
+  }
+}
+
+TEST_F(OneToMany, destination_along_origin_edge) {
+  auto result = gurka::do_action(valhalla::Options::route, map, {"A", "B", "C"}, "auto",
+                                 {{"/one_to_many", "1"}});
+  auto paths = gurka::detail::get_paths(result);
+  ASSERT_EQ(paths.size(), 2);
+  EXPECT_EQ(paths[0], std::vector<std::string>({"ABC"}));
+  EXPECT_EQ(paths[1], std::vector<std::string>({"ABC", "ABC"}));
+}
+
+TEST_F(OneToMany, arrive_by_not_supported) {
+  try {
+    gurka::do_action(valhalla::Options::route, map, {"A", "C", "E"}, "auto",
+                     {{"/one_to_many", "1"},
+                      {"/date_time/type", "2"},
+                      {"/date_time/value", "2020-10-10T13:00"}});
+    FAIL() << "Expected arrive_by one to many routes to be rejected";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 169); }
+}
+
+TEST(OneToManyStandalone, matrix_limits) {
+  const std::string ascii_map = R"(
+    A----B----C----D
+  )";
+  const gurka::ways ways = {{"ABCD", {{"highway", "primary"}}}};
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_one_to_many_limits",
+                               {{"service_limits.auto.max_matrix_distance", "1200"},
+                                {"service_limits.auto.max_matrix_location_pairs", "2"}});
+
+  // an ordinary route may go further than a matrix
+  auto route = gurka::do_action(valhalla::Options::route, map, {"A", "D"}, "auto");
+  EXPECT_EQ(route.trip().routes_size(), 1);
+
+  // but the destinations of one to many routes are held to the matrix limits
+  auto result = gurka::do_action(valhalla::Options::route, map, {"A", "B", "C"}, "auto",
+                                 {{"/one_to_many", "1"}});
+  EXPECT_EQ(result.trip().routes_size(), 2);
+  try {
+    gurka::do_action(valhalla::Options::route, map, {"A", "B", "D"}, "auto",
+                     {{"/one_to_many", "1"}});
+    FAIL() << "Expected a destination past max_matrix_distance to be rejected";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 154); }
+  try {
+    gurka::do_action(valhalla::Options::route, map, {"A", "B", "C", "B"}, "auto",
+                     {{"/one_to_many", "1"}});
+    FAIL() << "Expected more destinations than max_matrix_location_pairs to be rejected";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 150); }
+}
+
+TEST(OneToManyStandalone, destination_behind_origin_on_origin_edge) {
+  const std::string ascii_map = R"(
+    A--1--2--B
+    |        |
+    D--------C
+  )";
+  const gurka::ways ways = {{"A12B", {{"highway", "primary"}, {"oneway", "yes"}}},
+                            {"BC", {{"highway", "primary"}}},
+                            {"CD", {{"highway", "primary"}}},
+                            {"DA", {{"highway", "primary"}}}};
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_one_to_many_behind");
+
+  // the destination behind the origin has to go around the block rather than be reached for free
+  auto result = gurka::do_action(valhalla::Options::route, map, {"2", "1", "C"}, "auto",
+                                 {{"/one_to_many", "1"}});
+  auto paths = gurka::detail::get_paths(result);
+  ASSERT_EQ(paths.size(), 2);
+  EXPECT_EQ(paths[0], std::vector<std::string>({"A12B", "BC", "CD", "DA", "A12B"}));
+  EXPECT_EQ(paths[1], std::vector<std::string>({"A12B", "BC"}));
+  EXPECT_GT(result.trip().routes(0).legs(0).node().rbegin()->cost().elapsed_cost().seconds(), 0);
+}
+
+TEST(OneToManyStandalone, unreachable_destination_fails) {
+  const std::string ascii_map = R"(
+    A----B----C
+         |
+         D----E
+  )";
+  const gurka::ways ways = {{"ABC", {{"highway", "secondary"}}},
+                            {"BD", {{"highway", "secondary"}}},
+                            {"DE",
+                             {{"highway", "secondary"},
+                              {"motor_vehicle:conditional", "no @ (09:00-18:00)"}}}};
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_one_to_many_unreachable",
+                               {{"mjolnir.timezone", {VALHALLA_BUILD_DIR "test/data/tz.sqlite"}}});
+
+  // outside of the restricted hours every destination has its route, in the order requested
+  auto result = gurka::do_action(valhalla::Options::route, map, {"A", "E", "C"}, "auto",
+                                 {{"/one_to_many", "1"},
+                                  {"/date_time/type", "1"},
+                                  {"/date_time/value", "2020-10-10T20:00"}});
+  auto paths = gurka::detail::get_paths(result);
+  ASSERT_EQ(paths.size(), 2);
+  EXPECT_EQ(paths[0], std::vector<std::string>({"ABC", "BD", "DE"}));
+  EXPECT_EQ(paths[1], std::vector<std::string>({"ABC", "ABC"}));
+
+  // during them the request fails rather than leave out the route to E and shift the others
+  try {
+    gurka::do_action(valhalla::Options::route, map, {"A", "E", "C"}, "auto",
+                     {{"/one_to_many", "1"},
+                      {"/date_time/type", "1"},
+                      {"/date_time/value", "2020-10-10T13:00"}});
+    FAIL() << "Expected the unreachable destination to fail the request";
+  } catch (const valhalla_exception_t& e) { EXPECT_EQ(e.code, 442); }
+}
+
+TEST(OneToManyStandalone, time_dependent_partial_edge) {
+  const std::string ascii_map = R"(
+    A-------B---1---C
+  )";
+  const gurka::ways ways = {{"AB", {{"highway", "primary"}}}, {"B1C", {{"highway", "primary"}}}};
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, 100);
+  auto map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_one_to_many_time",
+                               {{"mjolnir.shortcuts", "false"}});
+
+  // fast at night and slow during the day (and when there is no time)
+  test::customize_historical_traffic(map.config, [](baldr::DirectedEdge& e) {
+    e.set_free_flow_speed(80);
+    e.set_constrained_flow_speed(10);
+    return std::nullopt;
+  });
+
+  auto result = gurka::do_action(valhalla::Options::route, map, {"A", "1", "B"}, "auto",
+                                 {{"/one_to_many", "1"},
+                                  {"/date_time/type", "1"},
+                                  {"/date_time/value", "2020-10-10T02:00"}});
+  ASSERT_EQ(result.trip().routes_size(), 2);
+
+  // the part of B1C up to the destination is costed at the night time speed like the rest
+  const auto& nodes = result.trip().routes(0).legs(0).node();
+  ASSERT_EQ(nodes.size(), 3);
+  auto edge_seconds =
+      nodes.Get(2).cost().elapsed_cost().seconds() - nodes.Get(1).cost().elapsed_cost().seconds();
+  auto night_seconds = nodes.Get(1).edge().length_km() * 3600. / 80.;
+  EXPECT_GT(edge_seconds, 0);
+  EXPECT_NEAR(edge_seconds, night_seconds, 2);
+}
@@ -0,0 +1,84 @@
+#include "gurka.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class RequestStatistics : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    const std::string ascii_map = R"(
+      A----B----C
+           |
+           D----E
+    )";
+
+    const gurka::ways ways = {{"AB", {{"highway", "primary"}}},
+                              {"BC", {{"highway", "primary"}}},
+                              {"BD", {{"highway", "secondary"}}},
+                              {"DE", {{"highway", "secondary"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_request_statistics");
+  }
+
+  static const Statistic* find(const Api& api, const std::string& key) {
+    for (const auto& stat : api.info().statistics()) {
+      if (stat.key() == key) {
+        return &stat;
+      }
+    }
+    return nullptr;
+  }
+};
+
+gurka::map RequestStatistics::map = {};
+
+TEST_F(RequestStatistics, phases_are_recorded) {
+  auto result = gurka::do_action(Options::route, map, {"A", "E"}, "auto");
+
+  ASSERT_NE(find(result, "route.info.loki.correlate_ms"), nullptr);
+  ASSERT_NE(find(result, "route.info.thor.trip_build_ms"), nullptr);
+
+  const auto* settled = find(result, "route.info.thor.edges_settled");
+  ASSERT_NE(settled, nullptr);
+  EXPECT_GT(settled->value(), 0);
+
+  // the first route has to load its tiles
+  const auto* hits = find(result, "route.info.thor.tile_cache_hits");
+  const auto* misses = find(result, "route.info.thor.tile_cache_misses");
+  ASSERT_NE(hits, nullptr);
+  ASSERT_NE(misses, nullptr);
+  EXPECT_GT(hits->value() + misses->value(), 0);
+}
+
+TEST_F(RequestStatistics, only_returned_when_asked_for) {
+  std::string json;
+  gurka::do_action(Options::route, map, {"A", "E"}, "auto", {}, {}, &json);
+  rapidjson::Document response;
+  response.Parse(json.c_str());
+  EXPECT_FALSE(response.HasMember("statistics"));
+
+  gurka::do_action(Options::route, map, {"A", "E"}, "auto", {{"/statistics", "true"}}, {}, &json);
+  response.Parse(json.c_str());
+  ASSERT_TRUE(response.HasMember("statistics"));
+  bool found_settled = false;
+  for (const auto& stat : response["statistics"].GetArray()) {
+    ASSERT_TRUE(stat.HasMember("key"));
+    ASSERT_TRUE(stat.HasMember("value"));
+    ASSERT_TRUE(stat.HasMember("type"));
+    found_settled = found_settled ||
+                    std::string(stat["key"].GetString()) == "route.info.thor.edges_settled";
+  }
+  EXPECT_TRUE(found_settled);
+
+  // osrm responses carry them too
+  gurka::do_action(Options::route, map, {"A", "E"}, "auto",
+                   {{"/statistics", "true"}, {"/format", "osrm"}}, {}, &json);
+  response.Parse(json.c_str());
+  EXPECT_TRUE(response.HasMember("statistics"));
+}
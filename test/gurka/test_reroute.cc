@@ -0,0 +1,118 @@
+#include "gurka.h"
+#include "test.h"
+#include "thor/reverse_tree_cache.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class Reroute : public ::testing::Test {
+protected:
+  static gurka::map map;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    const std::string ascii_map = R"(
+      A----B----C----D
+      |    |    |    |
+      E----F----G----H
+      |              |
+      I--------------J
+    )";
+
+    const gurka::ways ways = {{"ABCD", {{"highway", "primary"}}},
+                              {"EFGH", {{"highway", "residential"}}},
+                              {"IJ", {{"highway", "motorway"}}},
+                              {"AEI", {{"highway", "secondary"}}},
+                              {"BF", {{"highway", "tertiary"}}},
+                              {"CG", {{"highway", "tertiary"}}},
+                              {"DHJ", {{"highway", "secondary"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_reroute",
+                            {{"mjolnir.concurrency", "1"},
+                             {"thor.reroute_cache.max_trees", "4"},
+                             {"thor.reroute_cache.check_interval", "0"}});
+    map.config.put("mjolnir.traffic_extract", "test/data/gurka_reroute/traffic.tar");
+    test::build_live_traffic_data(map.config);
+  }
+
+  valhalla::Api route(valhalla::tyr::actor_t& actor,
+                      const std::vector<std::string>& waypoints,
+                      const std::string& token = "") {
+    std::string locations;
+    for (const auto& waypoint : waypoints) {
+      const auto& ll = map.nodes[waypoint];
+      locations += (locations.empty() ? "" : ",") + std::string(R"({"lon":)") +
+                   std::to_string(ll.lng()) + R"(,"lat":)" + std::to_string(ll.lat()) + "}";
+    }
+    std::string request = R"({"costing":"auto","locations":[)" + locations + "]";
+    if (!token.empty())
+      request += R"(,"reroute_token":")" + token + R"(")";
+    request += "}";
+
+    valhalla::Api api;
+    actor.route(request, nullptr, &api);
+    return api;
+  }
+};
+
+gurka::map Reroute::map = {};
+
+TEST_F(Reroute, reuse_reverse_tree) {
+  auto reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  valhalla::tyr::actor_t actor(map.config, *reader, true);
+
+  // the first request fills the cache for this token
+  auto initial = route(actor, {"A", "D"}, "vehicle-1");
+  gurka::assert::raw::expect_path(initial, {"ABCD", "ABCD", "ABCD"});
+
+  // rerouting from anywhere towards the same destination must match a route computed from scratch
+  for (const auto& origin : {"E", "F", "I", "G"}) {
+    auto rerouted = route(actor, {origin, "D"}, "vehicle-1");
+    auto fresh = route(actor, {origin, "D"});
+    EXPECT_EQ(gurka::detail::get_paths(rerouted), gurka::detail::get_paths(fresh)) << origin;
+  }
+}
+
+TEST_F(Reroute, destination_changed) {
+  auto reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  valhalla::tyr::actor_t actor(map.config, *reader, true);
+
+  // a cached tree towards another destination must not be used
+  route(actor, {"A", "D"}, "vehicle-2");
+  auto rerouted = route(actor, {"E", "J"}, "vehicle-2");
+  auto fresh = route(actor, {"E", "J"});
+  EXPECT_EQ(gurka::detail::get_paths(rerouted), gurka::detail::get_paths(fresh));
+}
+
+TEST_F(Reroute, traffic_changed) {
+  auto reader = test::make_clean_graphreader(map.config.get_child("mjolnir"));
+  valhalla::tyr::actor_t actor(map.config, *reader, true);
+  auto cache = thor::ReverseTreeCache::shared(map.config.get_child("thor"));
+  ASSERT_TRUE(cache);
+
+  route(actor, {"A", "D"}, "vehicle-3");
+  const auto before = cache->version(*reader);
+
+  // a traffic update crawls the primary road, the tree computed before it must not be used
+  test::LiveTrafficCustomize crawl = [](baldr::GraphReader& reader, baldr::TrafficTile& tile,
+                                        int index, baldr::TrafficSpeed* current) -> void {
+    if (index == 0) {
+      tile.header->last_update = tile.header->last_update + 60;
+    }
+    auto graph_tile = reader.GetGraphTile(baldr::GraphId(tile.header->tile_id));
+    if (graph_tile->directededge(index)->classification() == baldr::RoadClass::kPrimary) {
+      current->breakpoint1 = 255;
+      current->overall_encoded_speed = 2;
+      current->encoded_speed1 = 2;
+    }
+  };
+  test::customize_live_traffic_data(map.config, crawl);
+  EXPECT_NE(cache->version(*reader), before);
+
+  auto rerouted = route(actor, {"E", "D"}, "vehicle-3");
+  auto fresh = route(actor, {"E", "D"});
+  EXPECT_EQ(gurka::detail::get_paths(rerouted), gurka::detail::get_paths(fresh));
+}
@@ -0,0 +1,115 @@
+#include "gurka.h"
+#include "tyr/actor.h"
+#include "tyr/result_cache.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class ResultCache : public ::testing::Test {
+protected:
+  static gurka::map map;
+  static std::shared_ptr<baldr::GraphReader> reader;
+
+  static void SetUpTestSuite() {
+    constexpr double gridsize = 100;
+
+    const std::string ascii_map = R"(
+      A----B----C
+           |
+           D----E
+    )";
+
+    const gurka::ways ways = {{"AB", {{"highway", "primary"}}},
+                              {"BC", {{"highway", "primary"}}},
+                              {"BD", {{"highway", "secondary"}}},
+                              {"DE", {{"highway", "secondary"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_result_cache",
+                            {{"mjolnir.concurrency", "1"}, {"loki.result_cache.max_size", "100000"}});
+    reader = std::make_shared<baldr::GraphReader>(map.config.get_child("mjolnir"));
+  }
+
+  std::string request(const std::string& extra = "") const {
+    return R"({"costing":"auto",)" + extra + R"("locations":[{"lon":)" +
+           std::to_string(map.nodes["A"].lng()) + R"(,"lat":)" +
+           std::to_string(map.nodes["A"].lat()) + R"(},{"lon":)" +
+           std::to_string(map.nodes["E"].lng()) + R"(,"lat":)" +
+           std::to_string(map.nodes["E"].lat()) + "}]}";
+  }
+};
+
+gurka::map ResultCache::map = {};
+std::shared_ptr<baldr::GraphReader> ResultCache::reader = {};
+
+TEST_F(ResultCache, identical_requests_are_answered_from_the_cache) {
+  tyr::actor_t actor(map.config, *reader, true);
+  auto cache = tyr::ResultCache::shared(map.config.get_child("loki"));
+  ASSERT_NE(cache, nullptr);
+
+  // the first request is computed and kept
+  auto first = actor.route(request());
+  auto size = cache->size();
+  EXPECT_GT(size, first.size());
+  EXPECT_EQ(actor.route(request()), first);
+  EXPECT_EQ(cache->size(), size);
+
+  // prove the second one never got past loki by swapping the stored response
+  Api api;
+  ParseApi(request(), Options::route, api);
+  auto key = cache->key(api, *reader);
+  ASSERT_FALSE(key.empty());
+  cache->put(key, "cached");
+  EXPECT_EQ(actor.route(request()), "cached");
+
+  // but callers who want the intermediate results always get them computed
+  Api computed;
+  EXPECT_EQ(actor.route(request(), nullptr, &computed), first);
+  EXPECT_GT(computed.trip().routes_size(), 0);
+}
+
+TEST_F(ResultCache, uncacheable_requests) {
+  tyr::actor_t actor(map.config, *reader, true);
+  auto cache = tyr::ResultCache::shared(map.config.get_child("loki"));
+
+  // the answer depends on when it was asked
+  Api api;
+  ParseApi(request(R"("date_time":{"type":0},)"), Options::route, api);
+  EXPECT_TRUE(cache->key(api, *reader).empty());
+
+  // the answer contains timings of its own computation
+  api.Clear();
+  ParseApi(request(R"("statistics":true,)"), Options::route, api);
+  EXPECT_TRUE(cache->key(api, *reader).empty());
+
+  // differing options make for differing keys
+  Api other;
+  ParseApi(request(R"("units":"miles",)"), Options::route, other);
+  api.Clear();
+  ParseApi(request(), Options::route, api);
+  EXPECT_NE(cache->key(api, *reader), cache->key(other, *reader));
+}
+
+TEST(ResultCacheEviction, least_recently_used_goes_first) {
+  tyr::ResultCache cache(100, 300, 10);
+  std::string response;
+
+  // too large a response is never kept
+  cache.put("k", std::string(20, 'x'));
+  EXPECT_FALSE(cache.get("k", response));
+
+  cache.put("a", "12345678");
+  cache.put("b", "12345678");
+  EXPECT_EQ(cache.size(), 18u);
+
+  // fill up the cache while keeping a in use
+  for (char c = 'c'; c < 'm'; ++c) {
+    EXPECT_TRUE(cache.get("a", response));
+    cache.put(std::string(1, c), "12345678");
+  }
+  EXPECT_LE(cache.size(), 100u);
+  EXPECT_TRUE(cache.get("a", response));
+  EXPECT_EQ(response, "12345678");
+  EXPECT_FALSE(cache.get("b", response));
+}
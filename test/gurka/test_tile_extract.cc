@@ -0,0 +1,102 @@
+#include "gurka.h"
+#include "baldr/graphreader.h"
+#include "baldr/tilehierarchy.h"
+#include "baldr/traffictile.h"
+#include "midgard/sequence.h"
+#include "mjolnir/tile_extract.h"
+
+#include <gtest/gtest.h>
+
+using namespace valhalla;
+
+class TileExtract : public ::testing::Test {
+protected:
+  static gurka::map map;
+  static std::string extract;
+  static std::string traffic;
+
+  static void SetUpTestSuite() {
+    // two roads far enough apart to be in different tiles on all levels
+    const std::string ascii_map = R"(
+      A-B                                     C-D
+    )";
+
+    const gurka::ways ways = {{"AB", {{"highway", "primary"}}}, {"CD", {{"highway", "primary"}}}};
+
+    const auto layout = gurka::detail::map_to_coordinates(ascii_map, 10000, {5.1, 52.0});
+    map = gurka::buildtiles(layout, ways, {}, {}, "test/data/gurka_tile_extract");
+
+    extract = map.config.get<std::string>("mjolnir.tile_dir") + "/extract/tiles.tar";
+    traffic = map.config.get<std::string>("mjolnir.tile_dir") + "/extract/traffic.tar";
+    auto config = map.config.get_child("mjolnir");
+    config.put("concurrency", 4);
+    mjolnir::TileExtractOptions options;
+    options.extract_path = extract;
+    options.traffic_path = traffic;
+    mjolnir::BuildTileExtract(config, options);
+  }
+};
+
+gurka::map TileExtract::map = {};
+std::string TileExtract::extract;
+std::string TileExtract::traffic;
+
+TEST_F(TileExtract, has_all_tiles) {
+  baldr::GraphReader from_dir(map.config.get_child("mjolnir"));
+
+  auto config = map.config;
+  config.put("mjolnir.tile_extract", extract);
+  config.put("mjolnir.traffic_extract", traffic);
+  config.erase("mjolnir.tile_dir");
+  baldr::GraphReader from_extract(config.get_child("mjolnir"));
+  ASSERT_EQ(from_extract.tile_extract(), extract);
+  EXPECT_EQ(from_extract.GetTileSet(), from_dir.GetTileSet());
+
+  // the tiles and their empty traffic are usable for routing
+  auto with_extract = map;
+  with_extract.config = config;
+  auto result = gurka::do_action(Options::route, with_extract, {"A", "B"}, "auto");
+  gurka::assert::raw::expect_path(result, {"AB"});
+  auto edge = gurka::findEdgeByNodes(from_extract, map.nodes, "A", "B");
+  auto tile = from_extract.GetGraphTile(std::get<0>(edge));
+  EXPECT_FALSE(tile->trafficspeed(std::get<1>(edge)).speed_valid());
+}
+
+TEST_F(TileExtract, tiles_are_aligned) {
+  for (const auto& path : {extract, traffic}) {
+    midgard::tar archive(path);
+    EXPECT_EQ(archive.corrupt_blocks, 0);
+    ASSERT_EQ(archive.contents.count("index.bin"), 1);
+    for (const auto& content : archive.contents) {
+      if (content.first == "index.bin")
+        continue;
+      EXPECT_EQ((content.second.first - archive.mm.get()) % 4096, 0) << content.first;
+    }
+  }
+}
+
+TEST_F(TileExtract, from_extract_in_bbox) {
+  auto config = map.config.get_child("mjolnir");
+  config.put("tile_extract", extract);
+  mjolnir::TileExtractOptions options;
+  options.extract_path = map.config.get<std::string>("mjolnir.tile_dir") + "/extract/ab.tar";
+  options.source_extract = extract;
+  const auto& a = map.nodes.at("A");
+  const auto& b = map.nodes.at("B");
+  options.bbox =
+      midgard::AABB2<midgard::PointLL>(a.lng(), a.lat() - 0.001, b.lng(), b.lat() + 0.001);
+  options.alignment = 512;
+  auto count = mjolnir::BuildTileExtract(config, options);
+
+  baldr::GraphReader all(config);
+  config.put("tile_extract", options.extract_path);
+  baldr::GraphReader ab(config);
+  auto tiles = ab.GetTileSet();
+  EXPECT_EQ(tiles.size(), count);
+  EXPECT_LT(tiles.size(), all.GetTileSet().size());
+  const auto& level = baldr::TileHierarchy::levels().back();
+  for (const auto& node : {"A", "B", "C"}) {
+    baldr::GraphId id(level.tiles.TileId(map.nodes.at(node)), level.level, 0);
+    EXPECT_EQ(tiles.count(id), std::string(node) != "C") << node;
+  }
+}
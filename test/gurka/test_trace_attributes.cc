@@ -150,4 +150,67 @@ TEST(Standalone, RetrieveTrafficSignal) {
 
   EXPECT_TRUE(edges[1]["end_node"].HasMember("traffic_signal"));
   EXPECT_FALSE(edges[1]["end_node"]["traffic_signal"].GetBool());
-}
\ No newline at end of file
+}
+TEST(Standalone, ColumnarEdges) {
+  const std::string ascii_map = R"(
+    A---B---C---D
+  )";
+
+  const gurka::ways ways = {{"AB", {{"highway", "primary"}, {"name", "Main"}}},
+                            {"BC", {{"highway", "residential"}, {"name", "Main"}}},
+                            {"CD", {{"highway", "primary"}, {"name", "Side"}}}};
+
+  const gurka::nodes nodes = {{"C", {{"highway", "traffic_signals"}}}};
+
+  const double gridsize = 10;
+  const auto layout = gurka::detail::map_to_coordinates(ascii_map, gridsize);
+  auto map = gurka::buildtiles(layout, ways, nodes, {}, "test/data/columnar_attributes");
+
+  std::string rows_json, columns_json;
+  gurka::do_action(valhalla::Options::trace_attributes, map, {"A", "B", "C", "D"}, "auto", {}, {},
+                   &rows_json, "via");
+  gurka::do_action(valhalla::Options::trace_attributes, map, {"A", "B", "C", "D"}, "auto",
+                   {{"/columnar", "true"}}, {}, &columns_json, "via");
+
+  rapidjson::Document rows, columns;
+  rows.Parse(rows_json.c_str());
+  columns.Parse(columns_json.c_str());
+
+  const auto& edges = rows["edges"];
+  const auto& cols = columns["edges"];
+  ASSERT_TRUE(edges.IsArray());
+  ASSERT_TRUE(cols.IsObject());
+  ASSERT_EQ(cols["count"].GetUint(), edges.Size());
+  ASSERT_EQ(edges.Size(), 3);
+
+  const auto& strings = cols["strings"];
+  auto string_at = [&](const rapidjson::Value& index) {
+    return std::string(strings[index.GetUint()].GetString());
+  };
+
+  int64_t way_id = 0, begin_shape_index = 0;
+  for (rapidjson::SizeType i = 0; i < edges.Size(); ++i) {
+    // strings come from the dictionary
+    EXPECT_EQ(string_at(cols["road_class"][i]), edges[i]["road_class"].GetString());
+    EXPECT_EQ(string_at(cols["use"][i]), edges[i]["use"].GetString());
+    ASSERT_EQ(cols["names"][i].Size(), edges[i]["names"].Size());
+    EXPECT_EQ(string_at(cols["names"][i][0]), edges[i]["names"][0].GetString());
+
+    // ids and shape indices are deltas
+    way_id += cols["way_id"][i].GetInt64();
+    EXPECT_EQ(way_id, edges[i]["way_id"].GetInt64());
+    begin_shape_index += cols["begin_shape_index"][i].GetInt64();
+    EXPECT_EQ(begin_shape_index, edges[i]["begin_shape_index"].GetInt64());
+
+    // numbers and flags are as is
+    EXPECT_NEAR(cols["length"][i].GetDouble(), edges[i]["length"].GetDouble(), 0.001);
+    EXPECT_EQ(cols["end_node"]["traffic_signal"][i].GetBool(),
+              edges[i]["end_node"]["traffic_signal"].GetBool());
+  }
+
+  // the repeated names and road classes are only listed once
+  EXPECT_EQ(string_at(cols["names"][0][0]), "Main");
+  EXPECT_EQ(cols["names"][0][0].GetUint(), cols["names"][1][0].GetUint());
+  EXPECT_EQ(cols["road_class"][0].GetUint(), cols["road_class"][2].GetUint());
+  EXPECT_LT(columns_json.size(), rows_json.size());
+}
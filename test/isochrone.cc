@@ -526,6 +526,40 @@ TEST(Isochrones, test_geotiff_vertical_orientation) {
 }
 #endif
 
+TEST(Isochrones, work_budget) {
+  // the expansion settles thousands of edges before it first checks the budget
+  auto budget_cfg =
+      test::make_config(VALHALLA_BUILD_DIR "test/data/utrecht_tiles",
+                        {{"service_limits.isochrone.max_locations", "2"},
+                         {"thor.budget.max_settled_edges", "100"}});
+  loki_worker_t loki_worker(budget_cfg);
+  thor_worker_t thor_worker(budget_cfg);
+  const auto request =
+      R"({"locations":[{"lat":52.078937,"lon":5.115321}],"costing":"bicycle","contours":[{"time":15}]})";
+
+  for (int i = 0; i < 2; ++i) {
+    // every request gets the whole budget
+    Api api;
+    ParseApi(request, Options::isochrone, api);
+    loki_worker.isochrones(api);
+    try {
+      thor_worker.isochrones(api);
+      FAIL() << "The work budget should have been exceeded";
+    } catch (const valhalla_exception_t& e) {
+      EXPECT_EQ(e.code, 446);
+    }
+    loki_worker.cleanup();
+    thor_worker.cleanup();
+  }
+
+  // the same request goes through without a budget
+  thor_worker_t unlimited(cfg);
+  Api api;
+  ParseApi(request, Options::isochrone, api);
+  loki_worker.isochrones(api);
+  EXPECT_FALSE(unlimited.isochrones(api).empty());
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
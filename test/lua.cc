@@ -4,8 +4,14 @@
 #include "test.h"
 
 #include <osmium/builder/osm_object_builder.hpp>
+#include <osmium/io/pbf_input.hpp>
 
+#include <map>
+#include <random>
+#include <regex>
+#include <set>
 #include <string>
+#include <vector>
 
 using namespace valhalla;
 
@@ -151,6 +157,143 @@ TEST(Lua, TestForwardBackward) {
   ASSERT_TRUE(results.count("maxweight_forward") == 1);
   ASSERT_TRUE(results.count("maxweight_backward") == 1);
 }
+
+std::map<std::string, std::string> sorted(const mjolnir::Tags& tags) {
+  return std::map<std::string, std::string>(tags.begin(), tags.end());
+}
+
+TEST(Lua, CompiledMatchesScript) {
+  // the built in script transformed in c++ has to give exactly what running it gives
+  const std::string script(lua_graph_lua, lua_graph_lua + lua_graph_lua_len);
+  mjolnir::LuaTagTransform lua(script);
+  mjolnir::LuaTagTransform compiled(script, true);
+
+  const std::vector<std::vector<std::pair<std::string, std::string>>> ways = {
+      {},
+      {{"highway", "primary"}, {"maxheight", "12'6\""}, {"maxspeed", "30 mph"}},
+      {{"highway", "residential"}, {"maxweight", "3.5 t"}, {"maxaxleload", "4000 lbs"}},
+      {{"highway", "tertiary"}, {"maxweight", "."}},
+      {{"highway", "service"}, {"maxwidth", "0x10"}, {"maxlength", " 1e1 "}, {"maxaxles", "inf"}},
+      {{"highway", "footway"}, {"bicycle", "yes"}, {"segregated", "yes"}, {"oneway", "-1"}},
+      {{"highway", "secondary"}, {"oneway", "yes"}, {"oneway:bicycle", "no"},
+       {"cycleway:right", "track"}},
+      {{"highway", "primary"}, {"hov", "designated"}, {"hov:lanes", "designated|designated"},
+       {"hov:minimum", "3"}},
+      {{"highway", "construction"}, {"construction", "motorway_link"}},
+      {{"route", "ferry"}, {"motor_vehicle", "no"}, {"foot", "yes"}},
+  };
+  for (const auto& way : ways) {
+    TagsBuilder tags;
+    for (const auto& tag : way) {
+      tags.insert(tag);
+    }
+    EXPECT_EQ(sorted(compiled.Transform(mjolnir::OSMType::kWay, 1, tags.get())),
+              sorted(lua.Transform(mjolnir::OSMType::kWay, 1, tags.get())));
+  }
+
+  const std::vector<std::vector<std::pair<std::string, std::string>>> others = {
+      {},
+      {{"barrier", "bollard"}, {"bicycle", "no"}},
+      {{"barrier", "toll_booth"}, {"payment:cash", "yes"}, {"payment:cards", "no"}},
+      {{"highway", "stop"}, {"direction", "both"}, {"iso:3166_2", "US-CA"}},
+      {{"type", "restriction"}, {"restriction:conditional", "no_left_turn @ (Mo-Fr 07:00-09:00)"}},
+      {{"type", "route"}, {"route", "bicycle"}, {"network", "rcn"}},
+  };
+  for (const auto& other : others) {
+    TagsBuilder tags;
+    for (const auto& tag : other) {
+      tags.insert(tag);
+    }
+    for (const auto type : {mjolnir::OSMType::kNode, mjolnir::OSMType::kRelation}) {
+      EXPECT_EQ(sorted(compiled.Transform(type, 1, tags.get())),
+                sorted(lua.Transform(type, 1, tags.get())));
+    }
+  }
+
+  // and on all the data of an extract
+  osmium::io::Reader reader(VALHALLA_SOURCE_DIR "test/data/liechtenstein-latest.osm.pbf");
+  size_t count = 0;
+  while (const osmium::memory::Buffer buffer = reader.read()) {
+    for (const auto& object : buffer.select<osmium::OSMObject>()) {
+      const auto type = object.type() == osmium::item_type::node  ? mjolnir::OSMType::kNode
+                        : object.type() == osmium::item_type::way ? mjolnir::OSMType::kWay
+                                                                  : mjolnir::OSMType::kRelation;
+      EXPECT_EQ(sorted(compiled.Transform(type, object.id(), object.tags())),
+                sorted(lua.Transform(type, object.id(), object.tags())))
+          << object.id();
+      ++count;
+    }
+  }
+  reader.close();
+  EXPECT_GT(count, 0);
+}
+
+TEST(Lua, CompiledMatchesScriptOnGeneratedTags) {
+  // the corpus is drawn from the keys and values the script itself looks at so that whatever is
+  // added to graph.lua gets compared without having to list it here too
+  const std::string script(lua_graph_lua, lua_graph_lua + lua_graph_lua_len);
+  mjolnir::LuaTagTransform lua(script);
+  mjolnir::LuaTagTransform compiled(script, true);
+
+  std::set<std::string> key_set, value_set;
+  const std::regex literal(R"re("([^"\\\n]*)")re");
+  const std::regex key_like("[a-z_][a-z0-9_:]*");
+  for (std::sregex_iterator match(script.begin(), script.end(), literal), end; match != end;
+       ++match) {
+    const auto text = (*match)[1].str();
+    value_set.insert(text);
+    if (std::regex_match(text, key_like)) {
+      key_set.insert(text);
+    }
+  }
+  // and values which are awkward to parse
+  for (const auto& value : {"", " ", "yes;no", "no|yes", "-1", "0", "1.5", "-3", "1e3", "inf", "nan",
+                            "30 mph", "50 km/h", "12'6\"", "3.5 t", "4000 lbs", "2.5 m", "none",
+                            "unknown", "Straße", "7;8;9", "designated|designated", "@ (Mo-Fr)"}) {
+    value_set.insert(value);
+  }
+  const std::vector<std::string> keys(key_set.begin(), key_set.end());
+  const std::vector<std::string> values(value_set.begin(), value_set.end());
+  ASSERT_GT(keys.size(), 100);
+
+  // the seed is fixed so a difference can be reproduced
+  std::mt19937 generator(48);
+  std::uniform_int_distribution<size_t> tag_count(0, 12), key(0, keys.size() - 1),
+      value(0, values.size() - 1);
+  std::bernoulli_distribution is_highway(0.85);
+  const std::vector<std::string> highways = {"motorway", "motorway_link", "trunk", "primary",
+                                             "secondary", "tertiary", "unclassified",
+                                             "residential", "living_street", "service", "track",
+                                             "footway", "cycleway", "path", "steps"};
+  std::uniform_int_distribution<size_t> highway(0, highways.size() - 1);
+  for (int i = 0; i < 20000; ++i) {
+    const auto type = i % 4 == 0   ? mjolnir::OSMType::kNode
+                      : i % 4 == 1 ? mjolnir::OSMType::kRelation
+                                   : mjolnir::OSMType::kWay;
+    std::map<std::string, std::string> generated;
+    if (type == mjolnir::OSMType::kWay && is_highway(generator)) {
+      generated["highway"] = highways[highway(generator)];
+    }
+    for (size_t t = tag_count(generator); t > 0; --t) {
+      generated[keys[key(generator)]] = values[value(generator)];
+    }
+
+    TagsBuilder tags;
+    for (const auto& tag : generated) {
+      tags.insert(tag);
+    }
+    // tags the script fails on have to fail the compiled transform as well
+    using result_t = std::pair<bool, std::map<std::string, std::string>>;
+    auto transform = [&](mjolnir::LuaTagTransform& transformer) {
+      try {
+        return result_t{true, sorted(transformer.Transform(type, i, tags.get()))};
+      } catch (const std::exception&) { return result_t{false, {}}; }
+    };
+    ASSERT_EQ(transform(compiled), transform(lua))
+        << "entity " << i << " of type " << static_cast<int>(type);
+  }
+}
+
 } // namespace
 
 // TODO: sweet jesus add more tests of this class!
@@ -1338,6 +1338,38 @@ TEST(NarrativeDictionary, test_en_US_approach_verbal_alert) {
   validate(us_customary_lengths, kExpectedUsCustomaryLengths);
 }
 
+TEST(NarrativeDictionary, test_phrase_template) {
+  PhraseTemplate phrase("<DESTINATION> is on the <RELATIVE_DIRECTION> of <<DESTINATION>>.");
+
+  // Every tag is replaced and the text around them is kept
+  EXPECT_EQ(phrase.Fill({{kRelativeDirectionTag, "left"}, {kDestinationTag, "Main St"}}),
+            "Main St is on the left of <Main St>.");
+
+  // Tags without a value are left as they are
+  EXPECT_EQ(phrase.Fill({{kRelativeDirectionTag, "right"}}),
+            "<DESTINATION> is on the right of <<DESTINATION>>.");
+  EXPECT_EQ(phrase.Fill({}), phrase.phrase());
+
+  // Lower case names between angle brackets are not tags
+  EXPECT_EQ(PhraseTemplate("a <b> <LEVEL> <").Fill({{"<b>", "x"}, {kLevelTag, "2"}}), "a <b> 2 <");
+}
+
+TEST(NarrativeDictionary, test_en_US_templates) {
+  std::shared_ptr<NarrativeDictionary> dictionary = GetNarrativeDictionary("en-US");
+
+  // Every phrase is loaded as a template keyed by its id
+  const auto& destination = dictionary->destination_subset;
+  ASSERT_EQ(destination.templates.size(), destination.phrases.size());
+  for (const auto& phrase : destination.phrases) {
+    validate(destination.templates.at(std::stoul(phrase.first)).phrase(), phrase.second);
+  }
+
+  // "3": "<DESTINATION> is on the <RELATIVE_DIRECTION>."
+  validate(destination.templates.at(3).Fill(
+               {{kDestinationTag, "Lancaster Brewing"}, {kRelativeDirectionTag, "right"}}),
+           "Lancaster Brewing is on the right.");
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -8,8 +8,10 @@
 #include <lz4frame.h>
 
 #include <cmath>
+#include <filesystem>
 #include <fstream>
 #include <list>
+#include <thread>
 
 using namespace valhalla;
 
@@ -117,6 +119,70 @@ TEST(Sample, getlz4) {
   _get("test/data/samplelz4");
 };
 
+TEST(Sample, concurrent_get) {
+  // a gzip and an lz4 copy of the same tile plus a corrupt one, so that threads race on unpacking,
+  // on reading already unpacked tiles and on marking the corrupt one as unknown. run it in a build
+  // with ENABLE_THREAD_SANITIZER=ON to catch data races in the cache
+  const std::string dir = "test/data/sampleconcurrent";
+  std::filesystem::create_directories(dir + "/N40");
+  std::filesystem::create_directories(dir + "/N41");
+  std::filesystem::copy_file("test/data/samplegz/N40/N40W077.hgt.gz", dir + "/N40/N40W077.hgt.gz",
+                             std::filesystem::copy_options::overwrite_existing);
+  std::filesystem::copy_file("test/data/samplelz4/N40/N40W077.hgt.lz4",
+                             dir + "/N40/N40W076.hgt.lz4",
+                             std::filesystem::copy_options::overwrite_existing);
+  {
+    std::ofstream file(dir + "/N41/N41W077.hgt.gz", std::ios::binary | std::ios::trunc);
+    file << "this is not gzipped elevation data";
+  }
+
+  // the lz4 copy sits one degree east of the gzip one
+  const std::vector<std::pair<double, double>> points = {
+      {-76.503915, 40.678783}, {-76.9, 40.0},       {-76.537011, 40.723872},
+      {-75.503915, 40.678783}, {-75.9, 40.0},       {-75.537011, 40.723872},
+      {-76.503915, 41.678783}, {-76.537011, 41.5},
+  };
+
+  // what a single thread gets from the raw tile, the corrupt tile has no data
+  skadi::sample raw("test/data/sample");
+  std::vector<double> expected;
+  for (auto p : points) {
+    if (p.second > 41) {
+      expected.push_back(skadi::get_no_data_value());
+      continue;
+    }
+    if (p.first > -76)
+      p.first -= 1;
+    expected.push_back(raw.get(p));
+  }
+
+  skadi::sample s(dir);
+  const size_t thread_count = 8;
+  std::vector<std::vector<double>> results(thread_count);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&, t]() {
+      auto& result = results[t];
+      result.resize(points.size());
+      // every thread starts at a different point so that the first touch of each tile varies
+      for (size_t round = 0; round < 50; ++round) {
+        for (size_t i = 0; i < points.size(); ++i) {
+          auto j = (i + t) % points.size();
+          result[j] = s.get(points[j]);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (size_t t = 0; t < thread_count; ++t) {
+    for (size_t i = 0; i < points.size(); ++i) {
+      EXPECT_NEAR(results[t][i], expected[i], 0.01) << "thread " << t << " point " << i;
+    }
+  }
+}
+
 struct testable_sample_t : public skadi::sample {
   testable_sample_t(const std::string& dir) : sample(dir) {
     {
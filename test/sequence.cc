@@ -1,7 +1,9 @@
 #include "midgard/sequence.h"
 #include "test.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 using namespace valhalla::midgard;
 
@@ -70,6 +72,38 @@ TEST(Sequence, Iterator) {
   EXPECT_EQ(i.position(), 0) << "Pre-decrement operator wasn't right";
 }
 
+TEST(Sequence, ParallelSort) {
+  // pseudo random ids with plenty of duplicates, the attributes remember where they came from
+  std::vector<osm_node> nodes;
+  for (uint32_t i = 0; i < 100000; ++i)
+    nodes.push_back({(i * 2654435761u) % 40000, 0.f, 0.f, i});
+  auto by_id = [](const osm_node& a, const osm_node& b) { return a.id < b.id; };
+  auto expected = nodes;
+  std::stable_sort(expected.begin(), expected.end(), by_id);
+
+  // once entirely in memory and once merged from many sorted sub-ranges, with any number of threads
+  // equal ids keep their order so the result is always the same
+  for (size_t buffer_size : {nodes.size() * 2 + 2, size_t(6002)}) {
+    for (unsigned int concurrency : {1u, 3u, 4u}) {
+      {
+        sequence<osm_node> sequence("parallel.nd", true, 512);
+        for (const auto& node : nodes)
+          sequence.push_back(node);
+        sequence.sort(by_id, buffer_size, concurrency);
+      }
+
+      sequence<osm_node> sequence("parallel.nd", false, 512);
+      ASSERT_EQ(sequence.size(), expected.size());
+      for (size_t i = 0; i < expected.size(); ++i) {
+        osm_node node = *sequence[i];
+        ASSERT_EQ(node.id, expected[i].id) << "Found wrong node at: " + std::to_string(i);
+        ASSERT_EQ(node.attributes, expected[i].attributes)
+            << "Found equal nodes out of order at: " + std::to_string(i);
+      }
+    }
+  }
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,68 @@
+#include "midgard/threadpool.h"
+#include "test.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace valhalla::midgard;
+
+namespace {
+
+TEST(ThreadPool, every_index_once) {
+  for (size_t size : {0, 1, 2, 4}) {
+    ThreadPool pool(size);
+    // the same threads take on job after job
+    for (size_t count : {0, 1, 7, 1000, 3}) {
+      std::vector<std::atomic<int>> calls(count);
+      pool.run(count, [&calls](size_t i) { ++calls[i]; });
+      for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(calls[i], 1) << "size " << size << " count " << count << " index " << i;
+      }
+    }
+  }
+}
+
+TEST(ThreadPool, spreads_over_threads) {
+  ThreadPool pool(4);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic<size_t> started(0);
+  pool.run(4, [&](size_t) {
+    // every call waits for the others so each one has to be on a thread of its own
+    ++started;
+    while (started < 4) {
+      std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+  EXPECT_EQ(threads.size(), 4);
+  EXPECT_EQ(threads.count(std::this_thread::get_id()), 1);
+}
+
+TEST(ThreadPool, rethrows) {
+  ThreadPool pool(3);
+  EXPECT_THROW(pool.run(100,
+                        [](size_t i) {
+                          if (i == 42) {
+                            throw std::runtime_error("failed");
+                          }
+                        }),
+               std::runtime_error);
+
+  // the pool still works afterwards
+  std::atomic<size_t> sum(0);
+  pool.run(10, [&sum](size_t i) { sum += i; });
+  EXPECT_EQ(sum, 45);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,9 +1,12 @@
 #include "mjolnir/uniquenames.h"
+#include "filesystem.h"
+#include "mjolnir/osmdata.h"
 #include "test.h"
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
-using namespace std;
 using namespace valhalla::mjolnir;
 
 namespace {
@@ -44,6 +47,72 @@ TEST(UniqueNames, TestAddAndIndex) {
   EXPECT_EQ(names.name(index6), "I-95 N");
 }
 
+TEST(UniqueNames, TestManyNames) {
+  UniqueNames names;
+  EXPECT_EQ(names.index(""), 0);
+  EXPECT_EQ(names.name(0), "");
+
+  // Enough names for the table to grow a few times, each added twice
+  std::vector<uint32_t> indexes;
+  for (int i = 0; i < 10000; ++i) {
+    indexes.push_back(names.index("Road " + std::to_string(i)));
+  }
+  for (int i = 0; i < 10000; ++i) {
+    EXPECT_EQ(names.index("Road " + std::to_string(i)), indexes[i]);
+    EXPECT_EQ(names.name(indexes[i]), "Road " + std::to_string(i));
+  }
+  EXPECT_EQ(names.Size(), 10000);
+  EXPECT_EQ(names.name(10001), "");
+
+  // Serialized names may hold nulls
+  std::string serialized("\x08\x00\x10", 3);
+  uint32_t index = names.index(serialized);
+  EXPECT_EQ(names.name(index), serialized);
+  EXPECT_NE(names.index(std::string("\x08")), index);
+}
+
+TEST(UniqueNames, TestMappedNames) {
+  const std::string tile_dir = "test/data/uniquenames/";
+  filesystem::create_directories(tile_dir);
+
+  OSMData written{0};
+  uint32_t main_street = written.name_offset_map.index("Main Street");
+  uint32_t i95 = written.name_offset_map.index("I-95");
+  const std::string serialized("\x08\x00\x10", 3);
+  uint32_t with_null = written.name_offset_map.index(serialized);
+  uint32_t us = written.node_names.index("US");
+  written.way_ref[1] = i95;
+  ASSERT_TRUE(written.write_to_temp_files(tile_dir));
+
+  // Without a threshold the names are read into memory and can be added to
+  OSMData in_memory{0};
+  ASSERT_TRUE(in_memory.read_from_temp_files(tile_dir));
+  EXPECT_EQ(in_memory.name_offset_map.name(main_street), "Main Street");
+  EXPECT_EQ(in_memory.name_offset_map.name(with_null), serialized);
+  EXPECT_EQ(in_memory.name_offset_map.index("I-95"), i95);
+  EXPECT_EQ(in_memory.name_offset_map.index("MD-32"), 4);
+
+  // Past the threshold they are read from the files
+  OSMData mapped{0};
+  ASSERT_TRUE(mapped.read_from_temp_files(tile_dir, 1));
+  EXPECT_LT(mapped.memory_use(), in_memory.memory_use());
+  EXPECT_EQ(mapped.name_offset_map.Size(), 3);
+  EXPECT_EQ(mapped.name_offset_map.name(0), "");
+  EXPECT_EQ(mapped.name_offset_map.name(main_street), "Main Street");
+  EXPECT_EQ(mapped.name_offset_map.name(mapped.way_ref[1]), "I-95");
+  EXPECT_EQ(mapped.name_offset_map.name(with_null), serialized);
+  EXPECT_EQ(mapped.name_offset_map.name(4), "");
+  EXPECT_EQ(mapped.node_names.name(us), "US");
+  EXPECT_THROW(mapped.name_offset_map.index("MD-32"), std::runtime_error);
+
+  // The parsed names can be swapped for the files too
+  ASSERT_TRUE(written.map_names(tile_dir));
+  EXPECT_EQ(written.name_offset_map.name(i95), "I-95");
+  EXPECT_EQ(written.node_names.name(us), "US");
+
+  OSMData::cleanup_temp_files(tile_dir);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
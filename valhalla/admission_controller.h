@@ -0,0 +1,156 @@
+#ifndef __VALHALLA_ADMISSION_CONTROLLER_H__
+#define __VALHALLA_ADMISSION_CONTROLLER_H__
+
+#include <valhalla/proto/api.pb.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace valhalla {
+
+/**
+ * Keeps a few expensive requests from occupying every worker of a service. Each request gets a
+ * rough estimate of how much graph it will have to expand, from its action, its number of
+ * locations, the distance between them and its costing. Requests estimated below heavy_cost are
+ * always let in. Heavier ones need one of a limited number of slots for their action, so that the
+ * remaining workers keep answering cheap requests with low latency. A heavy request that finds no
+ * free slot waits up to max_wait_ms for one, but a waiting request holds the loki worker that
+ * parsed it. So at most max_waiting requests of all actions wait at once, and any other heavy
+ * request without a slot is turned away with a 503 right away. With max_waiting below the number
+ * of loki workers, some of them are always left for cheap requests. The waiting requests of an
+ * action form a priority queue, the cheapest one gets the next free slot and requests of equal cost
+ * go in order of arrival. Those still waiting when their time is up are turned away with a 503.
+ *
+ * A slot is held through a lease which loki takes when it admits the request and which is given
+ * back by whichever stage answers it, so a controller only works when all stages run in one
+ * process. A lease the request never gives back, because it was dropped between stages, expires
+ * after lease_seconds. valhalla_service installs one for its workers to share when
+ * loki.admission.heavy_cost is set.
+ */
+class admission_controller_t {
+public:
+  /**
+   * @param config  the loki.admission section of the config
+   */
+  admission_controller_t(const boost::property_tree::ptree& config);
+
+  /**
+   * Makes the controller available to all service workers created afterwards in this process
+   * @param controller  the controller to share or nullptr to remove it
+   */
+  static void install(const std::shared_ptr<admission_controller_t>& controller);
+
+  /**
+   * @return the controller shared by the service workers of this process, nullptr if none
+   */
+  static std::shared_ptr<admission_controller_t> installed();
+
+  /**
+   * Estimates the cost of a parsed request, roughly in kilometers of route between two points
+   * @param api  the request
+   * @return the estimated cost, 0 for requests which don't expand the graph
+   */
+  static float estimate_cost(const Api& api);
+
+  /**
+   * Lets a request in if it is cheap or once a slot for heavy requests of its action is free,
+   * waiting for one in order of cost if there is room among the waiting requests. When a slot is
+   * taken its lease is marked in the requests info so that it can be released
+   * @param api   the freshly parsed request
+   * @param cost  its estimated cost
+   * @return false if the request should be turned away
+   */
+  bool admit(Api& api, float cost);
+
+  /**
+   * Gives back the slot held by a request, if any. May be called more than once
+   * @param api  the answered request
+   */
+  void release(Api& api);
+
+  /**
+   * @param action  the action to look at
+   * @return the number of heavy requests of the action which currently hold a slot
+   */
+  uint32_t in_flight(Options::Action action) const;
+
+  /**
+   * @param action  the action to look at
+   * @return the number of heavy requests of the action which are waiting for a slot
+   */
+  uint32_t waiting(Options::Action action) const;
+
+protected:
+  struct lease_t {
+    Options::Action action;
+    std::chrono::steady_clock::time_point expires;
+  };
+
+  // gives back the slots of the requests which have been gone for too long
+  void expire_leases(std::chrono::steady_clock::time_point now);
+
+  float heavy_cost_;
+  std::chrono::milliseconds max_wait_;
+  std::chrono::seconds lease_duration_;
+  uint32_t max_waiting_;
+  std::array<uint32_t, Options::Action_ARRAYSIZE> max_heavy_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable slot_freed_;
+  std::array<uint32_t, Options::Action_ARRAYSIZE> in_flight_;
+  // per action the cost and ticket of the requests waiting for a slot, cheapest and oldest first
+  std::array<std::set<std::pair<float, uint64_t>>, Options::Action_ARRAYSIZE> waiting_;
+  uint32_t waiting_count_;
+  std::unordered_map<uint64_t, lease_t> leases_;
+  uint64_t next_ticket_;
+};
+
+/**
+ * Gives back the slot of a request when a stage is done with it, on every way out of the stage,
+ * unless the request is handed on to the next stage which then becomes responsible for it
+ */
+class admission_guard_t {
+public:
+  /**
+   * @param controller  the controller the slot belongs to, may be null
+   * @param api         the request, must outlive the guard
+   */
+  admission_guard_t(const std::shared_ptr<admission_controller_t>& controller, Api& api)
+      : controller_(controller), api_(api), handed_on_(false) {
+  }
+
+  ~admission_guard_t() {
+    if (controller_ && !handed_on_) {
+      controller_->release(api_);
+    }
+  }
+
+  admission_guard_t(const admission_guard_t&) = delete;
+  admission_guard_t& operator=(const admission_guard_t&) = delete;
+
+  /**
+   * Keeps the slot when the request goes on to another stage
+   * @param handed_on  whether the request goes on rather than back to the client
+   */
+  void hand_on(bool handed_on = true) {
+    handed_on_ = handed_on;
+  }
+
+protected:
+  std::shared_ptr<admission_controller_t> controller_;
+  Api& api_;
+  bool handed_on_;
+};
+
+} // namespace valhalla
+
+#endif // __VALHALLA_ADMISSION_CONTROLLER_H__
@@ -0,0 +1,129 @@
+#ifndef VALHALLA_BALDR_ALTTILE_H_
+#define VALHALLA_BALDR_ALTTILE_H_
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphtile.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace valhalla {
+namespace baldr {
+
+// Suffix of the side tiles holding the landmark distances of the nodes of a graph tile
+const std::string SUFFIX_ALT = ".alt";
+
+// Distance of a node which is not connected to a landmark
+constexpr uint32_t kInvalidAltDistance = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Header of a landmark side tile. The dataset id and the node count tie it to the build of the graph
+ * tile it was computed for, a side tile which does not match its graph tile is not used.
+ */
+struct AltTileHeader {
+  uint64_t dataset_id;     // dataset id of the graph tile
+  uint32_t landmark_count; // number of landmarks, the same for every tile of a graph
+  uint32_t node_count;     // number of nodes in the graph tile
+};
+
+/**
+ * The road distances between a few landmark nodes and every node of a graph tile. Distances are in
+ * meters over all the edges of the graph regardless of access and direction of travel, so by the
+ * triangle inequality |d(L, a) - d(L, b)| is a lower bound on the length of any path between a and b.
+ * Distances are stored landmark by landmark, i.e. all the nodes of the tile for the first landmark
+ * then all of them for the next one.
+ */
+class AltTile {
+public:
+  /**
+   * Loads the side tile of a graph tile
+   *
+   * @param alt_dir  the directory the landmark side tiles are stored in
+   * @param tile     the graph tile
+   * @return the side tile or nullptr if there is none, it could not be read or it was computed for
+   *         another build of the graph tile
+   */
+  static std::shared_ptr<const AltTile> Create(const std::string& alt_dir, const GraphTile& tile);
+
+  /**
+   * Path of the side tile of a graph tile
+   *
+   * @param alt_dir  the directory the landmark side tiles are stored in
+   * @param tile_id  the graph tile
+   * @return the file path of the side tile
+   */
+  static std::string FileName(const std::string& alt_dir, const GraphId& tile_id);
+
+  uint32_t landmark_count() const {
+    return header_.landmark_count;
+  }
+
+  uint32_t node_count() const {
+    return header_.node_count;
+  }
+
+  /**
+   * @param landmark  the index of the landmark
+   * @param node      the index of the node within the graph tile
+   * @return the distance in meters between the landmark and the node or kInvalidAltDistance if they
+   *         are not connected
+   */
+  uint32_t distance(const uint32_t landmark, const uint32_t node) const {
+    return distances_[landmark * header_.node_count + node];
+  }
+
+  /**
+   * @return the approximate number of bytes the tile takes in memory
+   */
+  size_t SizeBytes() const {
+    return sizeof(AltTile) + distances_.capacity() * sizeof(uint32_t);
+  }
+
+protected:
+  AltTileHeader header_;
+  std::vector<uint32_t> distances_;
+};
+
+/**
+ * Loads landmark side tiles on demand and keeps the most recently used ones up to a memory budget.
+ * Safe to share between threads, callers should hold on to the tiles they are working with rather
+ * than looking them up for every node.
+ */
+class AltLandmarks {
+public:
+  /**
+   * @param pt  the mjolnir config, the side tiles are read from mjolnir.alt_dir and at most
+   *            mjolnir.alt_cache_size bytes of them are kept in memory
+   */
+  explicit AltLandmarks(const boost::property_tree::ptree& pt);
+
+  /**
+   * @param tile  the graph tile
+   * @return the side tile of the graph tile or nullptr if there is none or it doesn't match
+   */
+  std::shared_ptr<const AltTile> GetTile(const graph_tile_ptr& tile);
+
+protected:
+  using cache_entry_t = std::pair<GraphId, std::shared_ptr<const AltTile>>;
+
+  std::string alt_dir_;
+  size_t max_cache_size_;
+  size_t cache_size_;
+  std::mutex mutex_;
+  // most recently used tiles first, missing tiles are kept as nullptr so we only look for them once
+  std::list<cache_entry_t> lru_;
+  std::unordered_map<GraphId, std::list<cache_entry_t>::iterator> tiles_;
+};
+
+} // namespace baldr
+} // namespace valhalla
+
+#endif // VALHALLA_BALDR_ALTTILE_H_
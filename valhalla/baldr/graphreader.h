@@ -468,6 +468,23 @@ public:
     return !tile_extract_->traffic_tiles.empty();
   }
 
+  /**
+   * Returns the most recent update time of the live traffic tiles, 0 without live traffic. This
+   * reads the header of every traffic tile so it shouldn't be called for every request
+   * @return seconds since epoch of the last update of any traffic tile
+   */
+  uint64_t GetTrafficLastUpdate() const;
+
+  /**
+   * Identifies the build of the tiles on disk so that results computed from an older build can be
+   * told apart. This is the modification time of the tile extract, or for a tile directory the
+   * dataset id of its first level 0 tile, or that tile's modification time if it has no dataset id.
+   * The tile is read from disk rather than from the cache, so this shouldn't be called for every
+   * request
+   * @return the version of the tiles, 0 if it can't be determined
+   */
+  uint64_t GetTileSetVersion() const;
+
   /**
    * Get a pointer to a graph tile object given a GraphId.
    * @param graphid  the graphid of the tile
@@ -508,6 +525,24 @@ public:
     return GetGraphTile(pointll, TileHierarchy::levels().back().level);
   }
 
+  /**
+   * How many tile lookups were answered by the cache and how many had to load the tile from the
+   * extract, disk or url over the lifetime of the reader
+   */
+  struct tile_stats_t {
+    uint64_t cache_hits = 0;
+    uint64_t cache_misses = 0;
+  };
+
+  /**
+   * Returns the tile lookup counts of this reader. Lookups that are short circuited by the caller
+   * already holding the tile are not counted
+   * @return the counts of cache hits and misses
+   */
+  const tile_stats_t& TileStats() const {
+    return tile_stats_;
+  }
+
   /**
    * Clears the cache
    */
@@ -994,6 +1029,9 @@ protected:
 
   std::unique_ptr<TileCache> cache_;
 
+  // lookup counts for the request statistics, like the rest of the reader not thread safe
+  tile_stats_t tile_stats_;
+
   bool enable_incidents_;
 };
 
@@ -322,6 +322,39 @@ public:
     writer.SetMaxDecimalPlaces(precision);
   }
 
+  inline size_t get_size() const {
+    return buffer.GetSize();
+  }
+
+  /**
+   * Adds a value which was already serialized, e.g. by another writer
+   *
+   * @param name   the key of the value
+   * @param json   the serialized value
+   * @param type   the type of the value
+   */
+  inline void raw(const char* name, const writer_wrapper_t& json, rapidjson::Type type) {
+    writer.String(name);
+    writer.RawValue(json.get_buffer(), json.get_size(), type);
+  }
+
+  /**
+   * Adds a value which was already serialized to a string, e.g. by baldr::json, either as the
+   * value of a key or as an array element
+   *
+   * @param name   the key of the value
+   * @param json   the serialized value
+   * @param type   the type of the value
+   */
+  inline void raw(const char* name, const std::string& json, rapidjson::Type type) {
+    writer.String(name);
+    writer.RawValue(json.data(), json.size(), type);
+  }
+
+  inline void raw(const std::string& json, rapidjson::Type type) {
+    writer.RawValue(json.data(), json.size(), type);
+  }
+
   template <typename K, typename V> inline void operator()(const K& key, const V& value) {
     if constexpr (is_string_like_v<K>) {
       writer.String(key);
@@ -4,14 +4,23 @@
 #include <valhalla/odin/markup_formatter.h>
 #include <valhalla/odin/sign.h>
 
-#include <regex>
 #include <string>
 
 namespace valhalla {
 namespace baldr {
 
-// Regular expression to find numbers
-const std::regex kNumberSplitRegex("(\\D*)(\\d+)(\\D*)");
+// Character classes and case of the C locale which the formatters are written for
+inline bool is_ascii_digit(const char c) {
+  return c >= '0' && c <= '9';
+}
+
+inline bool is_ascii_alpha(const char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline char ascii_tolower(const char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
 
 /**
  * The generic verbal text formatter class that prepares strings for use with
@@ -57,10 +66,19 @@ public:
   virtual std::string Format(const std::string& text) const;
 
 protected:
-  virtual std::string ProcessNumberSplitMatch(const std::smatch& m) const;
-
   virtual std::string FormNumberSplitTts(const std::string& source) const;
 
+  /**
+   * Splits every number of the specified text into pairs of digits so that they are spoken
+   * like "12 34" rather than "one thousand two hundred thirty four".
+   *
+   * @param  source  the source string to transform.
+   * @param  keep_ordinals  whether numbers followed by st, nd, rd or th are kept whole.
+   *
+   * @return the text with its numbers split.
+   */
+  std::string SplitNumbers(const std::string& source, bool keep_ordinals) const;
+
   // TODO - if not needed for special case logic then remove
   std::string country_code_;
   std::string state_code_;
@@ -4,108 +4,162 @@
 #include <valhalla/baldr/verbal_text_formatter.h>
 
 #include <array>
-#include <regex>
+#include <cstdint>
 #include <string>
-#include <utility>
 
 namespace valhalla {
 namespace baldr {
 
-const std::regex kUsNumberSplitRegex("(\\D*)(\\d+)(st|nd|rd|th)?(\\D*)", std::regex_constants::icase);
-
-const std::regex kInterstateRegex("(\\bI)([ -])(H)?(\\d{1,3})", std::regex_constants::icase);
-const std::string kInterstateOutPattern = "Interstate $3$4";
-
-const std::regex kUsHighwayRegex("(\\bUS)([ -])(Highway )?(\\d{1,3})", std::regex_constants::icase);
-const std::string kUsHighwayOutPattern = "U.S. $3$4";
-
-const std::regex kLeadingOhRegex("( )(0)([1-9])");
-const std::string kLeadingOhOutPattern = "$1o$3";
-
-const std::array<std::pair<std::regex, std::string>, 4> kThousandFindReplace = {
-    {{std::regex("(^|\\D)([1-9]{1,2})(000$)"), "$1$2 thousand"},
-     {std::regex("(^|\\D)([1-9]{1,2})(000th)", std::regex_constants::icase), "$1$2 thousandth"},
-     {std::regex("(^|\\D)([1-9]{1,2})(000)( |-)"), "$1$2 thousand "},
-     {std::regex("(^|\\D)([1-9]{1,2})(000)(\\D)"), "$1$2 thousand $4"}}};
-
-const std::array<std::pair<std::regex, std::string>, 4> kHundredFindReplace = {
-    {{std::regex("(^|\\D)([1-9]{1,2})(00$)"), "$1$2 hundred"},
-     {std::regex("(^|\\D)([1-9]{1,2})(00th)", std::regex_constants::icase), "$1$2 hundredth"},
-     {std::regex("(^|\\D)([1-9]{1,2})(00)( |-)"), "$1$2 hundred "},
-     {std::regex("(^|\\D)([1-9]{1,2})(00)(\\D)"), "$1$2 hundred $4"}}};
-
-const std::array<std::pair<std::regex, std::string>, 53> kStateRoutes = {
-    {{std::regex("(\\bSR)([ -])?(\\d{1,4})", std::regex_constants::icase), "State Route $3"},
-     {std::regex("(\\bSH)([ -])?(\\d{1,4})", std::regex_constants::icase), "State Highway $3"},
-     {std::regex("(\\bCA)([ -])(\\d{1,3})", std::regex_constants::icase), "California $3"},
-     {std::regex("(\\bTX)([ -])(\\d{1,3})", std::regex_constants::icase), "Texas $3"},
-     {std::regex("(\\bFL)([ -])(A)?(\\d{1,3})", std::regex_constants::icase), "Florida $3$4"},
-     {std::regex("(\\bNY)([ -])(\\d{1,3})", std::regex_constants::icase), "New York $3"},
-     {std::regex("(\\bIL)([ -])(\\d{1,3})", std::regex_constants::icase), "Illinois $3"},
-     {std::regex("(\\bPA)([ -])(\\d{1,3})", std::regex_constants::icase), "Pennsylvania $3"},
-     {std::regex("(\\bOH)([ -])(\\d{1,3})", std::regex_constants::icase), "Ohio $3"},
-     {std::regex("(\\bGA)([ -])(\\d{1,3})", std::regex_constants::icase), "Georgia $3"},
-     {std::regex("(\\bNC)([ -])(\\d{1,3})", std::regex_constants::icase), "North Carolina $3"},
-     {std::regex("(\\bM)([ -])(\\d{1,3})", std::regex_constants::icase), "Michigan $3"},
-     {std::regex("(\\bNJ)([ -])(\\d{1,3})", std::regex_constants::icase), "New Jersey $3"},
-     {std::regex("(\\bVA)([ -])(\\d{1,3})", std::regex_constants::icase), "Virginia $3"},
-     {std::regex("(\\bWA)([ -])(\\d{1,3})", std::regex_constants::icase), "Washington $3"},
-     {std::regex("(\\bMA)([ -])(\\d{1,3})", std::regex_constants::icase), "Massachusetts $3"},
-     {std::regex("(\\bAZ)([ -])(\\d{1,3})", std::regex_constants::icase), "Arizona $3"},
-     {std::regex("(\\bIN)([ -])(\\d{1,3})", std::regex_constants::icase), "Indiana $3"},
-     {std::regex("(\\bTN)([ -])(\\d{1,3})", std::regex_constants::icase), "Tennessee $3"},
-     {std::regex("(\\bMO)([ -])(\\d{1,3})", std::regex_constants::icase), "Missouri $3"},
-     {std::regex("(\\bMO)([ -])([[:alpha:]]{1,2}\\b)", std::regex_constants::icase), "Missouri $3"},
-     {std::regex("(\\bMD)([ -])(\\d{1,3})", std::regex_constants::icase), "Maryland $3"},
-     {std::regex("(\\bWI)([ -])(\\d{1,3})", std::regex_constants::icase), "Wisconsin $3"},
-     {std::regex("(\\bMN)([ -])(\\d{1,3})", std::regex_constants::icase), "Minnesota $3"},
-     {std::regex("(\\bAL)([ -])(\\d{1,3})", std::regex_constants::icase), "Alabama $3"},
-     {std::regex("(\\bSC)([ -])(\\d{1,3})", std::regex_constants::icase), "South Carolina $3"},
-     {std::regex("(\\bLA)([ -])(\\d{1,4})", std::regex_constants::icase), "Louisiana $3"},
-     {std::regex("(\\bKY)([ -])(\\d{1,4})", std::regex_constants::icase), "Kentucky $3"},
-     {std::regex("(\\bOR)([ -])(\\d{1,3})", std::regex_constants::icase), "Oregon $3"},
-     {std::regex("(\\bOK)([ -])(\\d{1,3})", std::regex_constants::icase), "Oklahoma $3"},
-     {std::regex("(\\bCT)([ -])(\\d{1,3})", std::regex_constants::icase), "Connecticut $3"},
-     {std::regex("(\\bIA)([ -])(\\d{1,3})", std::regex_constants::icase), "Iowa $3"},
-     {std::regex("(\\bMS)([ -])(\\d{1,3})", std::regex_constants::icase), "Mississippi $3"},
-     {std::regex("(\\bAR)([ -])(\\d{1,3})", std::regex_constants::icase), "Arkansas $3"},
-     {std::regex("(\\bUT)([ -])(\\d{1,3})", std::regex_constants::icase), "Utah $3"},
-     {std::regex("(\\bKS)([ -])(\\d{1,3})", std::regex_constants::icase), "Kansas $3"},
-     {std::regex("(\\bNV)([ -])(\\d{1,3})", std::regex_constants::icase), "Nevada $3"},
-     {std::regex("(\\bNM)([ -])(\\d{1,4})", std::regex_constants::icase), "New Mexico $3"},
-     {std::regex("(\\bNE)([ -])(\\d{1,3})", std::regex_constants::icase), "Nebraska $3"},
-     {std::regex("(\\bWV)([ -])(\\d{1,3})", std::regex_constants::icase), "West Virginia $3"},
-     {std::regex("(\\bID)([ -])(\\d{1,3})", std::regex_constants::icase), "Idaho $3"},
-     {std::regex("(\\bHI)([ -])(\\d{1,4})", std::regex_constants::icase), "Hawaii $3"},
-     {std::regex("(\\bME)([ -])(\\d{1,3})", std::regex_constants::icase), "Maine $3"},
-     {std::regex("(\\bNH)([ -])(\\d{1,3})", std::regex_constants::icase), "New Hampshire $3"},
-     {std::regex("(\\bRI)([ -])(\\d{1,3})", std::regex_constants::icase), "Rhode Island $3"},
-     {std::regex("(\\bMT)([ -])(\\d{1,3})", std::regex_constants::icase), "Montana $3"},
-     {std::regex("(\\bDE)([ -])(\\d{1,3})", std::regex_constants::icase), "Delaware $3"},
-     {std::regex("(\\bSD)([ -])(\\d{1,4})", std::regex_constants::icase), "South Dakota $3"},
-     {std::regex("(\\bND)([ -])(\\d{1,4})", std::regex_constants::icase), "North Dakota $3"},
-     {std::regex("(\\bAK)([ -])(\\d{1,3})", std::regex_constants::icase), "Alaska $3"},
-     {std::regex("(\\bDC)([ -])(\\d{1,3})", std::regex_constants::icase), "D C $3"},
-     {std::regex("(\\bVT)([ -])(\\d{1,3})", std::regex_constants::icase), "Vermont $3"},
-     {std::regex("(\\bWY)([ -])(\\d{1,3})", std::regex_constants::icase), "Wyoming $3"}}};
-
-const std::array<std::pair<std::regex, std::string>, 7> kCountyRoutes = {
-    {{std::regex("(\\bCR)(\\d{1,4})([[:alpha:]]{1,2})?\\b", std::regex_constants::icase),
-      "County Route $2$3"},
-     {std::regex("(\\bCR)([ -])([[:alpha:]]{1,2})?(\\d{1,4})([[:alpha:]]{1,2})?\\b",
-                 std::regex_constants::icase),
-      "County Route $3$4$5"},
-     {std::regex("(\\bCR)([ -])([[:alpha:]]{1,2})\\b", std::regex_constants::icase),
-      "County Route $3"},
-     {std::regex("(\\bC R)(\\d{1,4})([[:alpha:]]{1,2})?\\b", std::regex_constants::icase),
-      "County Route $2$3"},
-     {std::regex("(\\bC R)([ -])([[:alpha:]]{1,2})?(\\d{1,4})([[:alpha:]]{1,2})?\\b",
-                 std::regex_constants::icase),
-      "County Route $3$4$5"},
-     {std::regex("(\\bC R)([ -])([[:alpha:]]{1,2})\\b", std::regex_constants::icase),
-      "County Route $3"},
-     {std::regex("(\\bCO)([ -])?(\\d{1,4})([[:alpha:]]{1,2})?\\b", std::regex_constants::icase),
-      "County Road $3$4"}}};
+/**
+ * Describes how a kind of route number such as "SR-12" or "CR 5A" is spoken. The prefix is matched
+ * case insensitively at the start of a word and is replaced, along with the separator after it, by
+ * the label. The rest of the route number is kept as is.
+ */
+struct RouteRule {
+  enum class Separator : uint8_t { kNone, kRequired, kOptional };
+
+  const char* prefix;
+  const char* label;
+  // Up to how many digits the number has, 0 for routes which are one or two letters instead
+  uint8_t max_digits;
+  // Whether a space or a dash comes between the prefix and the number
+  Separator separator = Separator::kRequired;
+  // Optional text between the separator and the number, e.g. the H of I-H10
+  const char* infix = "";
+  // Whether up to two letters may come before or after the number, the route then has to end a word
+  bool leading_letters = false;
+  bool trailing_letters = false;
+  // Whether the letters of the prefix may be split by a space or a dash, e.g. F-M
+  bool split_prefix = false;
+
+  /**
+   * Replaces every route number of this kind in the specified text.
+   *
+   * @param  source  the source string to transform.
+   *
+   * @return the text with its route numbers spoken.
+   */
+  std::string Replace(const std::string& source) const;
+
+  /**
+   * Matches a route number at the specified position of the text.
+   *
+   * @param  source  the text.
+   * @param  pos  where the route number would start.
+   * @param  keep  set to where the part of the route number that is kept starts.
+   * @param  end  set to where the route number ends.
+   *
+   * @return true if there is a route number at the position.
+   */
+  bool Match(const std::string& source, size_t pos, size_t& keep, size_t& end) const;
+};
+
+/**
+ * Describes how a round number such as 2000 or 300th is spoken. The number is one or two non zero
+ * digits followed by the zeros and must not be preceded by another digit.
+ */
+struct RoundNumberRule {
+  enum class Ending : uint8_t { kEnd, kOrdinal, kSeparator, kNonDigit };
+
+  const char* zeros;
+  // What has to follow the zeros: the end of the text, "th", a space or dash which is replaced
+  // or any other non digit which is kept
+  Ending ending;
+  const char* spoken;
+
+  /**
+   * Replaces every round number of this kind in the specified text.
+   *
+   * @param  source  the source string to transform.
+   *
+   * @return the text with its round numbers spoken.
+   */
+  std::string Replace(const std::string& source) const;
+};
+
+const RouteRule kInterstateRoute{"I", "Interstate", 3, RouteRule::Separator::kRequired, "H"};
+
+const RouteRule kUsHighwayRoute{"US", "U.S.", 3, RouteRule::Separator::kRequired, "Highway "};
+
+const std::array<RoundNumberRule, 4> kThousandFindReplace = {{
+    {"000", RoundNumberRule::Ending::kEnd, " thousand"},
+    {"000", RoundNumberRule::Ending::kOrdinal, " thousandth"},
+    {"000", RoundNumberRule::Ending::kSeparator, " thousand "},
+    {"000", RoundNumberRule::Ending::kNonDigit, " thousand "},
+}};
+
+const std::array<RoundNumberRule, 4> kHundredFindReplace = {{
+    {"00", RoundNumberRule::Ending::kEnd, " hundred"},
+    {"00", RoundNumberRule::Ending::kOrdinal, " hundredth"},
+    {"00", RoundNumberRule::Ending::kSeparator, " hundred "},
+    {"00", RoundNumberRule::Ending::kNonDigit, " hundred "},
+}};
+
+const std::array<RouteRule, 53> kStateRoutes = {{
+    {"SR", "State Route", 4, RouteRule::Separator::kOptional},
+    {"SH", "State Highway", 4, RouteRule::Separator::kOptional},
+    {"CA", "California", 3},
+    {"TX", "Texas", 3},
+    {"FL", "Florida", 3, RouteRule::Separator::kRequired, "A"},
+    {"NY", "New York", 3},
+    {"IL", "Illinois", 3},
+    {"PA", "Pennsylvania", 3},
+    {"OH", "Ohio", 3},
+    {"GA", "Georgia", 3},
+    {"NC", "North Carolina", 3},
+    {"M", "Michigan", 3},
+    {"NJ", "New Jersey", 3},
+    {"VA", "Virginia", 3},
+    {"WA", "Washington", 3},
+    {"MA", "Massachusetts", 3},
+    {"AZ", "Arizona", 3},
+    {"IN", "Indiana", 3},
+    {"TN", "Tennessee", 3},
+    {"MO", "Missouri", 3},
+    {"MO", "Missouri", 0},
+    {"MD", "Maryland", 3},
+    {"WI", "Wisconsin", 3},
+    {"MN", "Minnesota", 3},
+    {"AL", "Alabama", 3},
+    {"SC", "South Carolina", 3},
+    {"LA", "Louisiana", 4},
+    {"KY", "Kentucky", 4},
+    {"OR", "Oregon", 3},
+    {"OK", "Oklahoma", 3},
+    {"CT", "Connecticut", 3},
+    {"IA", "Iowa", 3},
+    {"MS", "Mississippi", 3},
+    {"AR", "Arkansas", 3},
+    {"UT", "Utah", 3},
+    {"KS", "Kansas", 3},
+    {"NV", "Nevada", 3},
+    {"NM", "New Mexico", 4},
+    {"NE", "Nebraska", 3},
+    {"WV", "West Virginia", 3},
+    {"ID", "Idaho", 3},
+    {"HI", "Hawaii", 4},
+    {"ME", "Maine", 3},
+    {"NH", "New Hampshire", 3},
+    {"RI", "Rhode Island", 3},
+    {"MT", "Montana", 3},
+    {"DE", "Delaware", 3},
+    {"SD", "South Dakota", 4},
+    {"ND", "North Dakota", 4},
+    {"AK", "Alaska", 3},
+    {"DC", "D C", 3},
+    {"VT", "Vermont", 3},
+    {"WY", "Wyoming", 3},
+}};
+
+const std::array<RouteRule, 7> kCountyRoutes = {{
+    {"CR", "County Route", 4, RouteRule::Separator::kNone, "", false, true},
+    {"CR", "County Route", 4, RouteRule::Separator::kRequired, "", true, true},
+    {"CR", "County Route", 0},
+    {"C R", "County Route", 4, RouteRule::Separator::kNone, "", false, true},
+    {"C R", "County Route", 4, RouteRule::Separator::kRequired, "", true, true},
+    {"C R", "County Route", 0},
+    {"CO", "County Road", 4, RouteRule::Separator::kOptional, "", false, true},
+}};
 
 /**
  * The US specific verbal text formatter class that prepares strings for use
@@ -127,8 +181,6 @@ public:
   std::string Format(const std::string& text) const override;
 
 protected:
-  std::string ProcessNumberSplitMatch(const std::smatch& m) const override;
-
   std::string FormNumberSplitTts(const std::string& source) const override;
 
   std::string FormInterstateTts(const std::string& source) const;
@@ -137,30 +189,16 @@ protected:
 
   virtual std::string ProcessStatesTts(const std::string& source) const;
 
-  bool FormStateTts(const std::string& source,
-                    const std::regex& state_regex,
-                    const std::string& state_output_pattern,
-                    std::string& tts) const;
+  bool FormStateTts(const std::string& source, const RouteRule& state_rule, std::string& tts) const;
 
   std::string ProcessCountysTts(const std::string& source) const;
 
-  bool FormCountyTts(const std::string& source,
-                     const std::regex& county_regex,
-                     const std::string& county_output_pattern,
-                     std::string& tts) const;
+  bool FormCountyTts(const std::string& source, const RouteRule& county_rule, std::string& tts) const;
 
   std::string ProcessThousandTts(const std::string& source) const;
 
-  std::string FormThousandTts(const std::string& source,
-                              const std::regex& thousand_regex,
-                              const std::string& thousand_output_pattern) const;
-
   std::string ProcessHundredTts(const std::string& source) const;
 
-  std::string FormHundredTts(const std::string& source,
-                             const std::regex& hundred_regex,
-                             const std::string& hundred_output_pattern) const;
-
   std::string FormLeadingOhTts(const std::string& source) const;
 };
 
@@ -8,8 +8,7 @@
 namespace valhalla {
 namespace baldr {
 
-const std::regex kColoradoRegex("(\\bCO)([ -])(\\d{1,3})", std::regex_constants::icase);
-const std::string kColoradoOutPattern = "Colorado $3";
+const RouteRule kColoradoRoute{"CO", "Colorado", 3};
 
 /**
  * The Colorado, US specific verbal text formatter class that prepares strings
@@ -9,12 +9,12 @@ namespace valhalla {
 namespace baldr {
 
 // Farm to Market
-const std::regex kFmRegex("(\\bF[ -]?M)([ -])?(\\d{1,4})", std::regex_constants::icase);
-const std::string kFmOutPattern = "Farm to Market Road $3";
+const RouteRule kFmRoute{"FM", "Farm to Market Road", 4, RouteRule::Separator::kOptional, "",
+                         false, false, true};
 
 // Ranch to Market
-const std::regex kRmRegex("(\\bR[ -]?M)([ -])?(\\d{1,4})", std::regex_constants::icase);
-const std::string kRmOutPattern = "Ranch to Market Road $3";
+const RouteRule kRmRoute{"RM", "Ranch to Market Road", 4, RouteRule::Separator::kOptional, "",
+                         false, false, true};
 
 /**
  * The Texas, US specific verbal text formatter class that prepares strings
@@ -42,6 +42,15 @@ public:
   std::string transit_available(Api& request);
   void status(Api& request) const;
 
+  /**
+   * Looks up the response of an identical earlier request in the result cache. On a miss the key
+   * is stored in the request info so that the stage which serializes the response can cache it
+   * @param request   the freshly parsed request
+   * @param response  set to the cached response on a hit
+   * @return true if the request was answered from the cache
+   */
+  bool cached_result(Api& request, std::string& response);
+
   void set_interrupt(const std::function<void()>* interrupt) override;
 
 protected:
@@ -15,6 +15,7 @@
 #include <queue>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -260,6 +261,9 @@ template <class T> class sequence {
 public:
   // static_assert(std::is_pod<T>::value, "sequence requires POD types for now");
   static const size_t npos = -1;
+  // how many elements sort keeps in memory at once by default, the run being sorted and the scratch
+  // space of the stable sort and merge included
+  static constexpr size_t sort_buffer_size = 1024 * 1024 * 512 / sizeof(T);
 
   using value_type = T;
 
@@ -322,57 +326,85 @@ public:
     return npos;
   }
 
-  // sort the file based on the predicate, and outputs to output_seq
+  // sort the file based on the predicate
   //
-  // Strategy is to first sort sub-ranges of length buffer_size in place.
-  // These should all fit in memory. Then, merge the sub-ranges into the
-  // output sequence via priority queue.
+  // Strategy is to first sort sub-ranges of length buffer_size / 2 in place, each of them with all
+  // of the threads. std::stable_sort and std::inplace_merge need scratch space as large as what they
+  // sort, so a run together with its scratch space holds buffer_size elements and fits in memory.
+  // Then, the sorted sub-ranges are cut at common splitter values into as many independent slices
+  // as there are threads and each thread merges its slice of every sub-range into its part of the
+  // output via priority queue. Equal elements keep the order they had in the file, so the result is
+  // the same whatever the buffer size and the number of threads. The predicate is called from
+  // several threads at once so it must not have side effects.
   void sort(const std::function<bool(const T&, const T&)>& predicate,
-            size_t buffer_size = 1024 * 1024 * 512 / sizeof(T)) {
+            size_t buffer_size = sort_buffer_size,
+            unsigned int concurrency = 1) {
     flush();
     // if no elements we are done
     if (memmap.size() == 0) {
       return;
     }
+    concurrency = std::max(concurrency, 1u);
+    buffer_size = std::max(buffer_size, static_cast<size_t>(1));
 
     // If there wont be any merging we may as well take the simple approach
-    if (buffer_size > memmap.size() + write_buffer.size()) {
-      std::sort(static_cast<T*>(memmap), static_cast<T*>(memmap) + memmap.size(), predicate);
+    T* data = static_cast<T*>(memmap);
+    const size_t run_size = std::max(buffer_size / 2, static_cast<size_t>(1));
+    if (run_size > memmap.size()) {
+      parallel_sort(data, data + memmap.size(), predicate, concurrency);
       return;
     }
 
+    // Sort the subsections
+    std::vector<std::pair<T*, T*>> runs;
+    for (size_t i = 0; i < memmap.size(); i += run_size) {
+      runs.emplace_back(data + i, data + std::min(memmap.size(), i + run_size));
+      parallel_sort(runs.back().first, runs.back().second, predicate, concurrency);
+    }
+
+    // Cut every run at the same splitter values so that the slices between two splitters can be
+    // merged independently. The splitters are taken from a sample of all runs
+    std::vector<T> samples;
+    const size_t samples_per_run = 16 * concurrency;
+    for (const auto& run : runs) {
+      size_t count = run.second - run.first;
+      for (size_t i = 1; i < samples_per_run; ++i) {
+        samples.push_back(run.first[count * i / samples_per_run]);
+      }
+    }
+    std::sort(samples.begin(), samples.end(), predicate);
+    std::vector<std::vector<T*>> cuts(concurrency + 1, std::vector<T*>(runs.size()));
+    for (size_t r = 0; r < runs.size(); ++r) {
+      cuts.front()[r] = runs[r].first;
+      cuts.back()[r] = runs[r].second;
+      for (size_t slice = 1; slice < concurrency; ++slice) {
+        const auto& splitter = samples[samples.size() * slice / concurrency];
+        cuts[slice][r] =
+            std::lower_bound(cuts[slice - 1][r], runs[r].second, splitter, predicate);
+      }
+    }
+
+    // Merge each slice into its part of a temporary file, the runs are read front to back
     auto tmp_path = filesystem::path(file_name).replace_filename(
         filesystem::path(file_name).filename().string() + ".tmp");
+#ifndef _WIN32
+    posix_madvise(data, memmap.size() * sizeof(T), POSIX_MADV_SEQUENTIAL);
+#endif
     {
-      // we need a temporary sequence to merge the sorted subsections into
-      sequence<T> output_seq(tmp_path.string(), true);
-
-      // Comparator needs to be inverted for pq to provide constant time *smallest* lookup
-      // Pq keeps track of element and its index.
-      auto cmp = [&predicate](const std::pair<T, size_t>& a, std::pair<T, size_t>& b) {
-        return predicate(b.first, a.first);
-      };
-      std::priority_queue<std::pair<T, size_t>, std::vector<std::pair<T, size_t>>, decltype(cmp)> pq(
-          cmp);
-
-      // Sort the subsections
-      for (size_t i = 0; i < memmap.size(); i += buffer_size) {
-        std::sort(static_cast<T*>(memmap) + i,
-                  static_cast<T*>(memmap) + std::min(memmap.size(), i + buffer_size), predicate);
-        pq.emplace(*at(i), i);
-      }
-
-      // Perform the merge
-      while (!pq.empty()) {
-        auto tmp = pq.top();
-        pq.pop();
-        output_seq.push_back(tmp.first);
-        size_t new_idx = tmp.second + 1;
-        if (new_idx % buffer_size != 0 && new_idx < memmap.size()) {
-          pq.emplace(*at(new_idx), new_idx);
+      mem_map<T> output;
+      output.create(tmp_path.string(), memmap.size(), POSIX_MADV_SEQUENTIAL);
+      std::vector<std::thread> threads;
+      T* out = output.get();
+      for (size_t slice = 0; slice < concurrency; ++slice) {
+        threads.emplace_back(merge, std::cref(cuts[slice]), std::cref(cuts[slice + 1]), out,
+                             std::cref(predicate));
+        for (size_t r = 0; r < runs.size(); ++r) {
+          out += cuts[slice + 1][r] - cuts[slice][r];
         }
       }
-      output_seq.flush();
+      for (auto& thread : threads) {
+        thread.join();
+      }
     }
 
     // Forget about this file for a second so we can swap in the temp file
@@ -584,6 +616,86 @@ public:
   }
 
 protected:
+  // sorts a range in memory with the given number of threads, each sorts a piece of the range and
+  // then neighboring pieces are merged pairwise until one is left. Both steps are stable so equal
+  // elements stay in the order of the range
+  static void parallel_sort(T* first,
+                            T* last,
+                            const std::function<bool(const T&, const T&)>& predicate,
+                            unsigned int concurrency) {
+    size_t count = last - first;
+    if (concurrency < 2 || count < 1024 * concurrency) {
+      std::stable_sort(first, last, predicate);
+      return;
+    }
+
+    std::vector<T*> pieces;
+    for (size_t i = 0; i <= concurrency; ++i) {
+      pieces.push_back(first + count * i / concurrency);
+    }
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i + 1 < pieces.size(); ++i) {
+      threads.emplace_back(
+          [&predicate](T* begin, T* end) { std::stable_sort(begin, end, predicate); }, pieces[i],
+          pieces[i + 1]);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    while (pieces.size() > 2) {
+      threads.clear();
+      std::vector<T*> merged{pieces.front()};
+      for (size_t i = 0; i + 2 < pieces.size(); i += 2) {
+        threads.emplace_back(
+            [&predicate](T* begin, T* middle, T* end) {
+              std::inplace_merge(begin, middle, end, predicate);
+            },
+            pieces[i], pieces[i + 1], pieces[i + 2]);
+        merged.push_back(pieces[i + 2]);
+      }
+      // an odd piece out moves on to the next round as it is
+      if (pieces.size() % 2 == 0) {
+        merged.push_back(pieces.back());
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      pieces = std::move(merged);
+    }
+  }
+
+  // merges the sorted ranges [begins[i], ends[i]) into out via priority queue, equal elements are
+  // taken from the ranges in order of their index
+  static void merge(const std::vector<T*>& begins,
+                    const std::vector<T*>& ends,
+                    T* out,
+                    const std::function<bool(const T&, const T&)>& predicate) {
+    // Comparator needs to be inverted for pq to provide constant time *smallest* lookup
+    // Pq keeps track of the current position in each range.
+    auto cmp = [&predicate](const std::pair<T*, size_t>& a, const std::pair<T*, size_t>& b) {
+      if (predicate(*b.first, *a.first)) {
+        return true;
+      }
+      return !predicate(*a.first, *b.first) && a.second > b.second;
+    };
+    std::priority_queue<std::pair<T*, size_t>, std::vector<std::pair<T*, size_t>>, decltype(cmp)> pq(
+        cmp);
+    for (size_t i = 0; i < begins.size(); ++i) {
+      if (begins[i] != ends[i]) {
+        pq.emplace(begins[i], i);
+      }
+    }
+    while (!pq.empty()) {
+      auto next = pq.top();
+      pq.pop();
+      *out++ = *next.first;
+      if (++next.first != ends[next.second]) {
+        pq.push(next);
+      }
+    }
+  }
+
   std::shared_ptr<std::fstream> file;
   std::string file_name;
   std::vector<T> write_buffer;
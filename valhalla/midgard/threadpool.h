@@ -0,0 +1,82 @@
+#ifndef VALHALLA_MIDGARD_THREADPOOL_H_
+#define VALHALLA_MIDGARD_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace valhalla {
+namespace midgard {
+
+/**
+ * A fixed number of threads which stay around to split up work that comes with every request, e.g.
+ * the candidates of a search or the legs of a route, so that no threads are started per request.
+ * The threads are only started the first time there is work for them and the calling thread always
+ * takes part. One job runs at a time, concurrent callers wait for their turn.
+ */
+class ThreadPool {
+public:
+  /**
+   * Constructor.
+   * @param size  The number of threads working on a job, including the calling thread. A pool of
+   *              size 1 or less runs every job on the calling thread.
+   */
+  explicit ThreadPool(size_t size);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @return  Returns the number of threads working on a job, including the calling thread.
+   */
+  size_t size() const {
+    return size_;
+  }
+
+  /**
+   * Calls the task with every index in [0, count) spread over the threads of the pool and returns
+   * once all of the calls are done. The first exception thrown by a call is rethrown here, the
+   * indices which were not started yet are skipped then.
+   * @param count  The number of indices.
+   * @param task   Called once for every index, from any of the threads.
+   */
+  void run(size_t count, const std::function<void(size_t)>& task);
+
+protected:
+  // works on jobs until the pool is destroyed
+  void work();
+
+  // takes indices of the current job until there are none left
+  void drain();
+
+  size_t size_;
+
+  // held for the whole of a job so that jobs don't overlap
+  std::mutex job_mutex_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(size_t)>* task_;
+  size_t count_;
+  std::atomic<size_t> next_;
+  // the threads which haven't finished the current job yet
+  size_t busy_;
+  // counts the jobs so that every thread takes part in each of them once
+  uint64_t generation_;
+  std::exception_ptr error_;
+  bool stop_;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace midgard
+} // namespace valhalla
+
+#endif // VALHALLA_MIDGARD_THREADPOOL_H_
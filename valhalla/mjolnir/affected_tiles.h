@@ -0,0 +1,72 @@
+#pragma once
+
+#include "baldr/graphid.h"
+#include "baldr/graphreader.h"
+#include "midgard/pointll.h"
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace valhalla {
+namespace mjolnir {
+
+// What an OSM change file touches, as far as the graph is concerned
+struct OsmChange {
+  // Locations of the changed nodes, both where they are after the change (when the file has them)
+  // and where they were before it (once read from the data the graph was built from)
+  std::vector<midgard::PointLL> locations;
+  // Ids of the nodes that were created, modified or deleted
+  std::unordered_set<uint64_t> node_ids;
+  // Ids of the nodes of the created and modified ways, which need not be in the change themselves
+  std::unordered_set<uint64_t> way_node_ids;
+  // Ids of the node members of changed relations, e.g. the via node of a turn restriction
+  std::unordered_set<uint64_t> member_node_ids;
+  // Ids of the ways that were created, modified or deleted, of the way members of changed
+  // relations, e.g. turn restrictions, and of the ways a changed node was part of
+  std::unordered_set<uint64_t> way_ids;
+};
+
+/**
+ * Reads an uncompressed OSM change (osc) file.
+ *
+ * @param filename path of the osc file
+ * @param change   the change to add the contents of the file to
+ */
+void read_osm_change(const std::string& filename, OsmChange& change);
+
+/**
+ * Looks up what the change touched before it was applied in the OSM data the graph was built
+ * from: where its nodes, the nodes of its ways and the node members of its relations were, and
+ * which ways its nodes were part of.
+ * The graph tiles don't keep OSM node ids so this can't be found from them.
+ *
+ * @param pbf_files the OSM extracts the graph was built from
+ * @param change    the change to add the locations and ways to
+ */
+void read_previous_osm(const std::vector<std::string>& pbf_files, OsmChange& change);
+
+/**
+ * Collects the tiles whose contents may differ once the change is applied and the graph is built
+ * again in full, e.g. to only publish those tiles of the new build. This does not rebuild the
+ * tiles, the graph is numbered and its hierarchy formed from all of the data. These are:
+ * - the tiles, on every level, of the locations of the changed nodes and of the nodes of changed
+ *   ways, before and after the change;
+ * - the tiles at both ends of the edges of changed ways;
+ * - the tiles on the other levels the nodes of those tiles transition to, since the hierarchy is
+ *   formed from the local level;
+ * - the tiles at both ends of the shortcuts crossing those tiles;
+ * - the tiles at the ends of every edge and transition of all of the above, since their nodes and
+ *   edges may be numbered differently once they are formed again and edges and transitions refer
+ *   to the nodes and opposing edges at their ends by id.
+ *
+ * @param reader GraphReader to access the graph the change applies to
+ * @param change what the change touches, with the previous locations already read
+ * @return the affected tiles on all of the levels
+ */
+std::set<baldr::GraphId> collect_affected_tiles(baldr::GraphReader& reader, const OsmChange& change);
+
+} // namespace mjolnir
+} // namespace valhalla
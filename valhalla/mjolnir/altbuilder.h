@@ -0,0 +1,26 @@
+#ifndef VALHALLA_MJOLNIR_ALTBUILDER_H
+#define VALHALLA_MJOLNIR_ALTBUILDER_H
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Class used to select landmarks and store the road distance between them and every node of the
+ * graph in side tiles. Routing uses the distances for a tighter A* heuristic (ALT).
+ */
+class AltBuilder {
+public:
+  /**
+   * Selects mjolnir.alt_landmark_count landmarks spread over the graph and writes their distances
+   * to the nodes of each tile into mjolnir.alt_dir. Does nothing if mjolnir.alt_dir is not set.
+   * @param pt  the config
+   */
+  static void Build(const boost::property_tree::ptree& pt);
+};
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_ALTBUILDER_H
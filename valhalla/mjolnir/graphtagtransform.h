@@ -0,0 +1,31 @@
+#ifndef VALHALLA_MJOLNIR_GRAPHTAGTRANSFORM_H
+#define VALHALLA_MJOLNIR_GRAPHTAGTRANSFORM_H
+
+#include <valhalla/mjolnir/osmdata.h>
+
+#include <osmium/osm/tag.hpp>
+#include <robin_hood.h>
+
+#include <string>
+
+namespace valhalla {
+namespace mjolnir {
+
+using Tags = robin_hood::unordered_map<std::string, std::string>;
+
+/**
+ * Transforms the tags of an OSM node, way or relation the way the nodes_proc, ways_proc and
+ * rels_proc functions of the built in lua/graph.lua do, without a lua interpreter. The results
+ * are the same as those of the script down to the formatting of numbers, so any change to
+ * lua/graph.lua has to be made here as well.
+ * @param type  the type of OSM entity the tags belong to
+ * @param tags  the tags of the entity
+ * @return the transformed tags, empty when the entity is of no use to the graph
+ * @throws std::runtime_error where the script would fail on the tags
+ */
+Tags TransformGraphTags(OSMType type, const osmium::TagList& tags);
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_GRAPHTAGTRANSFORM_H
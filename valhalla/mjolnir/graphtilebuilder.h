@@ -63,6 +63,13 @@ public:
    */
   void StoreTileData();
 
+  /**
+   * Output the tile to a file in another tile directory than the one it was read from, e.g.
+   * to stage it while other threads still read the original.
+   * @param  tile_dir  Base directory path to store the tile in.
+   */
+  void StoreTileData(const std::string& tile_dir);
+
   /**
    * Update a graph tile with new nodes and directed edges. Assumes no new
    * nodes or edges are added. Attributes within existing nodes and edges
@@ -73,6 +80,17 @@ public:
    */
   void Update(const std::vector<NodeInfo>& nodes, const std::vector<DirectedEdge>& directededges);
 
+  /**
+   * Update a graph tile with new nodes and directed edges, writing it to another tile directory
+   * than the one it was read from, e.g. to stage it while other threads still read the original.
+   * @param nodes Updated list of nodes
+   * @param directededges Updated list of edges.
+   * @param tile_dir Base directory path to store the tile in.
+   */
+  void Update(const std::vector<NodeInfo>& nodes,
+              const std::vector<DirectedEdge>& directededges,
+              const std::string& tile_dir);
+
   /**
    * Get the current list of node builders.
    * @return  Returns the node info builders.
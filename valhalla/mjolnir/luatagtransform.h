@@ -7,27 +7,27 @@ extern "C" {
 #include <lualib.h>
 }
 
+#include <valhalla/mjolnir/graphtagtransform.h>
 #include <valhalla/mjolnir/osmdata.h>
 
 #include <osmium/osm/tag.hpp>
-#include <robin_hood.h>
 
 #include <string>
 
 namespace valhalla {
 namespace mjolnir {
 
-using Tags = robin_hood::unordered_map<std::string, std::string>;
-
 /**
  */
 class LuaTagTransform {
 public:
   /**
    * Constructor
-   * @param lua   the string containing the lua code
+   * @param lua       the string containing the lua code
+   * @param compiled  the lua code is the built in lua/graph.lua, whose tag transforms are then
+   *                  done by TransformGraphTags rather than by running the script
    */
-  LuaTagTransform(const std::string& lua);
+  LuaTagTransform(const std::string& lua, bool compiled = false);
 
   LuaTagTransform(const LuaTagTransform&) = delete;
   LuaTagTransform& operator=(const LuaTagTransform&) = delete;
@@ -75,15 +75,34 @@ struct OSMData {
 
   /**
    * Read data from temporary files.
+   * @param tile_dir        Directory holding the temporary files.
+   * @param mmap_threshold  Bytes of memory past which the names are read from the memory mapped
+   *                        files instead of into memory, 0 to always read them into memory.
    * @return Returns true if successful, false if an error occurs.
    */
-  bool read_from_temp_files(const std::string& tile_dir);
+  bool read_from_temp_files(const std::string& tile_dir, size_t mmap_threshold = 0);
 
   /**
    * Read data from temporary unique name file.
+   * @param tile_dir        Directory holding the temporary files.
+   * @param mmap_threshold  Bytes of names past which they are read from the memory mapped file
+   *                        instead of into memory, 0 to always read them into memory.
    * @return Returns true if successful, false if an error occurs.
    */
-  bool read_from_unique_names_file(const std::string& tile_dir);
+  bool read_from_unique_names_file(const std::string& tile_dir, size_t mmap_threshold = 0);
+
+  /**
+   * Replace the names in memory with read only views of the temporary name files, which have to
+   * be written already. No names can be added afterwards.
+   * @return Returns true if successful, false if an error occurs.
+   */
+  bool map_names(const std::string& tile_dir);
+
+  /**
+   * Estimate the bytes of memory held by the data.
+   * @return Returns the bytes allocated for the maps and names.
+   */
+  size_t memory_use() const;
 
   /**
    * add the direction information to the forward or reverse map for relations.
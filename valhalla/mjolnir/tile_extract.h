@@ -0,0 +1,46 @@
+#pragma once
+
+#include "midgard/aabb2.h"
+#include "midgard/pointll.h"
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace valhalla {
+namespace mjolnir {
+
+// How to build a tile extract
+struct TileExtractOptions {
+  // Where to write the tile extract
+  std::string extract_path;
+  // Where to write the traffic extract, empty for no traffic extract
+  std::string traffic_path;
+  // Read the tiles from this tile extract rather than from the tile directory
+  std::string source_extract;
+  // Only archive the tiles intersecting this bounding box
+  std::optional<midgard::AABB2<midgard::PointLL>> bbox;
+  // Byte boundary the tile payloads start on, a multiple of the 512 byte tar block size. Tiles
+  // starting on a page can be mapped without touching the pages of their neighbors
+  size_t alignment = 4096;
+};
+
+/**
+ * Writes the tiles in mjolnir.tile_dir (or those of another tile extract) to a tar which starts
+ * with an index.bin file holding the offset, id and size of every tile, and optionally writes the
+ * matching traffic extract with an empty traffic tile per routing tile. The position of every
+ * entry is known up front so the tiles are copied into both archives by mjolnir.concurrency
+ * threads at once. Tile payloads are padded to the alignment with pax comment headers which tar
+ * and the tile extract reader skip. Both archives are read back and checked against the index
+ * before returning.
+ *
+ * @param pt       the mjolnir section of the config
+ * @param options  what to write and where
+ * @return the number of tiles archived
+ */
+size_t BuildTileExtract(const boost::property_tree::ptree& pt, const TileExtractOptions& options);
+
+} // namespace mjolnir
+} // namespace valhalla
@@ -0,0 +1,106 @@
+#ifndef VALHALLA_MJOLNIR_TILEWORKERS_H_
+#define VALHALLA_MJOLNIR_TILEWORKERS_H_
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphreader.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace valhalla {
+namespace mjolnir {
+
+/**
+ * Works through a queue of items, usually tiles, with mjolnir.concurrency threads. Every thread has
+ * a graph reader of its own which is trimmed between items when it is over committed. The first
+ * exception thrown by any of the threads is rethrown once all of them are done.
+ * @param  pt           Configuration.
+ * @param  items        Items to work on, they are taken from the front of the queue.
+ * @param  make_worker  Called once per thread with its reader, returns the function that is then
+ *                      called with each item the thread takes. This is where per thread state,
+ *                      e.g. open sequences, lives.
+ */
+template <typename item_t, typename make_worker_t>
+void RunTileWorkers(const boost::property_tree::ptree& pt,
+                    std::deque<item_t> items,
+                    const make_worker_t& make_worker) {
+  std::mutex lock;
+  std::vector<std::shared_ptr<std::thread>> threads(
+      std::max(static_cast<unsigned int>(1),
+               pt.get<unsigned int>("mjolnir.concurrency", std::thread::hardware_concurrency())));
+  std::list<std::promise<void>> results;
+  for (auto& thread : threads) {
+    results.emplace_back();
+    thread = std::make_shared<std::thread>(
+        [&pt, &items, &lock, &make_worker](std::promise<void>& result) {
+          try {
+            baldr::GraphReader reader(pt.get_child("mjolnir"));
+            auto work = make_worker(reader);
+            while (true) {
+              lock.lock();
+              if (items.empty()) {
+                lock.unlock();
+                break;
+              }
+              item_t item = std::move(items.front());
+              items.pop_front();
+              lock.unlock();
+
+              work(item);
+
+              // Check if we need to clear the tile cache.
+              if (reader.OverCommitted()) {
+                reader.Trim();
+              }
+            }
+            result.set_value();
+          } catch (...) { result.set_exception(std::current_exception()); }
+        },
+        std::ref(results.back()));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  // rethrow the first failure, if any
+  for (auto& result : results) {
+    result.get_future().get();
+  }
+}
+
+/**
+ * Get the directory a stage stores its new tiles in until all of them are done. It is next to the
+ * tile directory rather than inside it, so the tile directory only ever holds tiles and the staged
+ * tiles can still be moved over the originals without copying them.
+ * @param  tile_dir  Tile directory.
+ * @param  stage     Name of the stage.
+ * @return Returns the staging directory, it is not created.
+ */
+std::string StagingDir(const std::string& tile_dir, const std::string& stage);
+
+/**
+ * Move the tiles staged by a stage over the originals and remove the staging directory.
+ * @param  tile_dir        Tile directory.
+ * @param  staging_dir     Directory the stage stored its tiles in.
+ * @param  tiles           Tiles the stage ran over.
+ * @param  remove_missing  Whether the original of a tile that was not staged is removed, e.g.
+ *                         because all of its nodes and edges were filtered, or kept as it is.
+ */
+void PublishStagedTiles(const std::string& tile_dir,
+                        const std::string& staging_dir,
+                        const std::vector<baldr::GraphId>& tiles,
+                        bool remove_missing);
+
+} // namespace mjolnir
+} // namespace valhalla
+
+#endif // VALHALLA_MJOLNIR_TILEWORKERS_H_
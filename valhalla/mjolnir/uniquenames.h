@@ -1,19 +1,27 @@
 #ifndef VALHALLA_MJOLNIR_UNIQUENAMES_H
 #define VALHALLA_MJOLNIR_UNIQUENAMES_H
 
-#include <algorithm>
 #include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 namespace valhalla {
-namespace mjolnir {
+namespace midgard {
+template <class T> class mem_map;
+} // namespace midgard
 
-using NamesMap = std::unordered_map<std::string, uint32_t>;
+namespace mjolnir {
 
 /**
- * Class to hold a list of unique names and indexes to them.
+ * Class to hold a list of unique names and indexes to them. The names are stored back to back
+ * with null terminators in a single buffer and are found again through an open addressing table
+ * of their indexes, which costs a handful of bytes per name over the strings themselves. The
+ * names can also be read from a memory mapped file, in which case they can't be added to.
  */
 class UniqueNames {
 public:
@@ -21,8 +29,7 @@ public:
    * Constructor.
    */
   UniqueNames() {
-    // Insert dummy so index 0 is never used
-    index("");
+    Clear();
   }
 
   /**
@@ -32,18 +39,37 @@ public:
    * @return  Returns an index into the unique list of names.
    */
   uint32_t index(const std::string& name) {
-    // Find the name in the map. If it is there return the index.
-    auto it = names_.find(name);
-    if (it != names_.end()) {
-      return it->second;
-    } else {
-      // Not in the map, add index and update
-      it = names_.insert(it, NamesMap::value_type(name, 0));
-      indexes_.push_back(it);
-      uint32_t index = indexes_.size() - 1;
-      it->second = index;
-      return index;
+    // The blank name is always the first one
+    if (name.empty()) {
+      return 0;
+    }
+    if (file_) {
+      throw std::runtime_error("Can't add names to the names mapped from " + file_name_);
+    }
+
+    // Find the name in the table. If it is there return the index.
+    const size_t mask = slots_.size() - 1;
+    size_t slot = std::hash<std::string_view>{}(name) & mask;
+    for (; slots_[slot] != 0; slot = (slot + 1) & mask) {
+      if (view(slots_[slot]) == name) {
+        return slots_[slot];
+      }
+    }
+
+    // Not in the table, add the name and its index
+    if (strings_.size() + name.size() + 1 > std::numeric_limits<uint32_t>::max()) {
+      throw std::runtime_error("UniqueNames exceeded 4GB of names");
     }
+    uint32_t index = offsets_.size();
+    offsets_.push_back(strings_.size());
+    strings_.insert(strings_.end(), name.c_str(), name.c_str() + name.size() + 1);
+    slots_[slot] = index;
+
+    // Keep the table at most half full so that probing stays short
+    if (offsets_.size() * 2 > slots_.size()) {
+      Rehash(slots_.size() * 2);
+    }
+    return index;
   }
 
   /**
@@ -51,16 +77,21 @@ public:
    * @param  index  Index into the unique name list.
    * @return  Returns the name
    */
-  const std::string& name(const uint32_t index) const {
-    return (index < (uint32_t)indexes_.size()) ? indexes_[index]->first : indexes_[0]->first;
+  std::string name(const uint32_t index) const {
+    return (index < (uint32_t)offsets_.size()) ? std::string(view(index)) : std::string();
   }
 
   /**
    * Clear the names and indexes.
    */
   void Clear() {
-    names_.clear();
-    indexes_.clear();
+    file_.reset();
+    file_name_.clear();
+    mapped_ = nullptr;
+    end_ = 0;
+    strings_.assign(1, '\0');
+    offsets_.assign(1, 0);
+    slots_.assign(16, 0);
   }
 
   /**
@@ -69,16 +100,90 @@ public:
    * @return  Returns the number of unique names.
    */
   size_t Size() const {
-    return names_.size() - 1;
+    return offsets_.size() - 1;
+  }
+
+  /**
+   * Get the number of bytes of memory the names use. The pages of a mapped file are left to the
+   * page cache and are not counted.
+   * @return  Returns the bytes allocated for the names and their indexes.
+   */
+  size_t MemoryUse() const {
+    return strings_.capacity() + (offsets_.capacity() + slots_.capacity()) * sizeof(uint32_t);
+  }
+
+  /**
+   * Read the names from a memory mapped file rather than keeping copies of them. Only the offset
+   * of each name is held in memory afterwards and no names can be added.
+   * @param  file       The mapped file, kept open for as long as the names are used.
+   * @param  file_name  The path of the mapped file.
+   * @param  lengths    The length of each name including its null terminator.
+   * @param  strings    The null terminated names, back to back.
+   * @param  count      The number of names, not counting the blank name.
+   */
+  void Map(std::shared_ptr<midgard::mem_map<char>> file,
+           const std::string& file_name,
+           const uint32_t* lengths,
+           const char* strings,
+           uint32_t count) {
+    Clear();
+    offsets_.reserve(count + 2);
+    uint32_t offset = 0;
+    for (uint32_t n = 0; n < count; ++n) {
+      offsets_.push_back(offset);
+      offset += lengths[n];
+    }
+    end_ = offset;
+    std::vector<char>().swap(strings_);
+    std::vector<uint32_t>().swap(slots_);
+    file_ = std::move(file);
+    file_name_ = file_name;
+    mapped_ = strings;
   }
 
 protected:
-  // Map of names to indexes
-  NamesMap names_;
+  // The name at an index, which runs up to the null terminator before the next name. The blank
+  // name is kept apart from mapped names
+  std::string_view view(const uint32_t index) const {
+    if (file_) {
+      if (index == 0) {
+        return {};
+      }
+      const uint32_t end = index + 1 < offsets_.size() ? offsets_[index + 1] : end_;
+      return std::string_view(mapped_ + offsets_[index], end - offsets_[index] - 1);
+    }
+    const uint32_t end = index + 1 < offsets_.size() ? offsets_[index + 1] : strings_.size();
+    return std::string_view(strings_.data() + offsets_[index], end - offsets_[index] - 1);
+  }
+
+  void Rehash(size_t slot_count) {
+    slots_.assign(slot_count, 0);
+    const size_t mask = slot_count - 1;
+    for (uint32_t index = 1; index < offsets_.size(); ++index) {
+      size_t slot = std::hash<std::string_view>{}(view(index)) & mask;
+      while (slots_[slot] != 0) {
+        slot = (slot + 1) & mask;
+      }
+      slots_[slot] = index;
+    }
+  }
+
+  // The null terminated names back to back, starting with the blank name. Names may hold nulls
+  // themselves as their length follows from the offset of the next name
+  std::vector<char> strings_;
+
+  // Offset of each name within the strings, indexed by the name index
+  std::vector<uint32_t> offsets_;
+
+  // Open addressing table of name indexes where 0 marks an empty slot (the blank name is never
+  // looked up), the size is always a power of 2
+  std::vector<uint32_t> slots_;
 
-  // List of entries into the map
-  using nameiter = NamesMap::iterator;
-  std::vector<nameiter> indexes_;
+  // The file the names are read from when they are mapped
+  std::shared_ptr<midgard::mem_map<char>> file_;
+  std::string file_name_;
+  const char* mapped_ = nullptr;
+  uint32_t end_ = 0;
 };
 
 } // namespace mjolnir
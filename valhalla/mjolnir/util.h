@@ -36,7 +36,8 @@ enum class BuildStage : int8_t {
   kRestrictions = 12,
   kElevation = 13,
   kValidate = 14,
-  kCleanup = 15
+  kCleanup = 15,
+  kAlt = 16
 };
 
 constexpr uint8_t kMinor = 1;
@@ -61,7 +62,8 @@ inline BuildStage string_to_buildstage(const std::string& s) {
        {"restrictions", BuildStage::kRestrictions},
        {"elevation", BuildStage::kElevation},
        {"validate", BuildStage::kValidate},
-       {"cleanup", BuildStage::kCleanup}};
+       {"cleanup", BuildStage::kCleanup},
+       {"alt", BuildStage::kAlt}};
 
   auto i = stringToBuildStage.find(s);
   return (i == stringToBuildStage.cend()) ? BuildStage::kInvalid : i->second;
@@ -85,7 +87,8 @@ inline std::string to_string(BuildStage stg) {
        {static_cast<int8_t>(BuildStage::kRestrictions), "restrictions"},
        {static_cast<int8_t>(BuildStage::kElevation), "elevation"},
        {static_cast<int8_t>(BuildStage::kValidate), "validate"},
-       {static_cast<int8_t>(BuildStage::kCleanup), "cleanup"}};
+       {static_cast<int8_t>(BuildStage::kCleanup), "cleanup"},
+       {static_cast<int8_t>(BuildStage::kAlt), "alt"}};
 
   auto i = BuildStageStrings.find(static_cast<int8_t>(stg));
   return (i == BuildStageStrings.cend()) ? "null" : i->second;
@@ -1,11 +1,14 @@
 #ifndef VALHALLA_ODIN_DIRECTIONSBUILDER_H_
 #define VALHALLA_ODIN_DIRECTIONSBUILDER_H_
 
+#include <valhalla/midgard/threadpool.h>
 #include <valhalla/odin/enhancedtrippath.h>
 #include <valhalla/odin/maneuver.h>
 #include <valhalla/odin/markup_formatter.h>
 #include <valhalla/proto/api.pb.h>
 
+#include <atomic>
+#include <cstdint>
 #include <list>
 
 namespace valhalla {
@@ -17,19 +20,64 @@ namespace odin {
  */
 class DirectionsBuilder {
 public:
+  /**
+   * The parts of the directions which the serialized response will actually read. Anything outside
+   * of the scope is not built at all.
+   */
+  struct Scope {
+    // whether the response contains directions at all (gpx and some pbf responses do not)
+    bool directions = true;
+    // whether the response contains the verbal instructions (osrm only with voice_instructions)
+    bool verbal = true;
+  };
+
+  /**
+   * Works out which parts of the directions the response will read from the format, the pbf field
+   * selector and the other options of the request.
+   *
+   * @param options  the request options
+   * @return the scope of the directions to build
+   */
+  static Scope GetScope(const Options& options);
+
   /**
    * Returns the trip directions based on the specified directions options
    * and trip path. This method calls ManeuversBuilder::Build and
    * NarrativeBuilder::Build to form the maneuver list. This method
    * calls PopulateDirectionsLeg to transform the maneuver list into the
-   * trip directions.
+   * trip directions. Only the parts of the directions within the scope of the request are built
+   * and the time spent building the maneuvers and the narrative is added to the statistics.
    *
    * @param api   the protobuf object containing the request, the path and a place
    *              to store the resulting directions
+   * @param markup_formatter  formats the street names and signs of the narrative
+   * @param pool              threads to narrate the routes/legs on at once, without one they are
+   *                          narrated one after the other on the calling thread
    */
-  static void Build(Api& api, const MarkupFormatter& markup_formatter);
+  static void Build(Api& api,
+                    const MarkupFormatter& markup_formatter,
+                    midgard::ThreadPool* pool = nullptr);
 
 protected:
+  /**
+   * Builds the maneuvers, the narrative and the trip directions of a single leg.
+   *
+   * @param options           the request options
+   * @param scope             the parts of the directions to build
+   * @param markup_formatter  formats the street names and signs of the narrative
+   * @param trip_path         the leg to narrate
+   * @param trip_directions   where to store the resulting directions
+   * @param maneuvers_ns      accumulates the nanoseconds spent building maneuvers
+   * @param narrative_ns      accumulates the nanoseconds spent building the narrative
+   */
+  static void BuildLeg(const Options& options,
+                       const Scope& scope,
+                       const MarkupFormatter& markup_formatter,
+                       TripLeg& trip_path,
+                       DirectionsLeg& trip_directions,
+                       std::atomic<int64_t>& maneuvers_ns,
+                       std::atomic<int64_t>& narrative_ns);
+
   /**
    * Update the heading of ~0 length edges.
    *
@@ -3,9 +3,13 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <cstdint>
+#include <initializer_list>
 #include <locale>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -174,8 +178,55 @@ constexpr auto kLevelTag = "<LEVEL>";
 namespace valhalla {
 namespace odin {
 
+/**
+ * A phrase which is split into its literal text and its tags when the locale is loaded. Forming an
+ * instruction then takes a single pass over the phrase instead of searching it once per tag.
+ */
+class PhraseTemplate {
+public:
+  // A phrase tag and the value to replace it with
+  using slot_t = std::pair<std::string_view, std::string_view>;
+
+  PhraseTemplate() = default;
+
+  /**
+   * Splits the phrase into literal text and tags. A tag is an upper case name, which may contain
+   * underscores, between angle brackets such as <STREET_NAMES>.
+   * @param phrase  the tagged phrase from the locale
+   */
+  explicit PhraseTemplate(const std::string& phrase);
+
+  /**
+   * Returns the phrase with each tag replaced by the value of its slot. Tags without a slot are
+   * left in the phrase as they are.
+   * @param slots  the tags and their values
+   * @return the phrase with the values of the tags
+   */
+  std::string Fill(std::initializer_list<slot_t> slots) const;
+
+  /**
+   * Returns the tagged phrase.
+   * @return the phrase as it was loaded
+   */
+  const std::string& phrase() const {
+    return phrase_;
+  }
+
+protected:
+  struct Segment {
+    uint32_t offset;
+    uint32_t length;
+    bool tag;
+  };
+
+  std::string phrase_;
+  std::vector<Segment> segments_;
+};
+
 struct PhraseSet {
   std::unordered_map<std::string, std::string> phrases;
+  // The phrases split into text and tags, keyed by the phrase id
+  std::unordered_map<uint32_t, PhraseTemplate> templates;
 };
 
 struct StartSubset : PhraseSet {
@@ -31,7 +31,14 @@ public:
   NarrativeBuilder(const NarrativeBuilder&) = default;
   NarrativeBuilder& operator=(const NarrativeBuilder&) = delete;
 
-  void Build(std::list<Maneuver>& maneuvers);
+  /**
+   * Forms the text instructions of the specified maneuvers and, unless the response has no use for
+   * them, the verbal instructions as well.
+   *
+   * @param maneuvers  The maneuvers to form the narrative for.
+   * @param verbal     Whether to form the verbal instructions and verbal multi-cues.
+   */
+  void Build(std::list<Maneuver>& maneuvers, bool verbal = true);
 
   // A few of the form instruction methods need to be public to enable updates based on length
 
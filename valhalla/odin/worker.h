@@ -1,6 +1,7 @@
 #ifndef __VALHALLA_ODIN_SERVICE_H__
 #define __VALHALLA_ODIN_SERVICE_H__
 
+#include <valhalla/midgard/threadpool.h>
 #include <valhalla/odin/markup_formatter.h>
 #include <valhalla/proto/api.pb.h>
 #include <valhalla/worker.h>
@@ -32,6 +33,9 @@ public:
 
 protected:
   MarkupFormatter markup_formatter_;
+  // threads which narrate the routes of a single request at once, they are kept from request to
+  // request and take turns between concurrent ones
+  mutable midgard::ThreadPool narrative_pool_;
 
 private:
   std::string service_name() const override {
@@ -47,7 +47,9 @@ public:
   template <class coord_t> double get(const coord_t& coord);
 
   /**
-   * @brief Get multiple samples from the datasource
+   * @brief Get multiple samples from the datasource. The elevation tile is only looked up again
+   * when a posting falls in another tile than the one before it. Samples can be taken from many
+   * threads at once, they share the unpacked tiles and each tile is unpacked by one of them
    * @param coords  the list of postings at which to sample the datasource
    */
   template <class coords_t> std::vector<double> get_all(const coords_t& coords);
@@ -100,7 +102,6 @@ private:
    */
   void cache_initialisation(const std::string& source_path);
 
-  std::mutex cache_lck;
   std::string url_;
   std::unique_ptr<baldr::tile_getter_t> remote_loader_;
   // This parameter is used only in tests
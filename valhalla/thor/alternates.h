@@ -10,6 +10,8 @@ float get_max_sharing(const valhalla::Location& origin, const valhalla::Location
 
 void filter_alternates_by_stretch(std::vector<CandidateConnection>& connections);
 
+void filter_alternates_by_plateau(std::vector<CandidateConnection>& connections);
+
 bool validate_alternate_by_stretch(const std::vector<PathInfo>& optimal_path,
                                    const std::vector<PathInfo>& candidate_path);
 
@@ -18,6 +20,6 @@ bool validate_alternate_by_sharing(std::vector<std::unordered_set<baldr::GraphId
                                    const std::vector<PathInfo>& candidate_path,
                                    float at_most_shared);
 
-bool validate_alternate_by_local_optimality(const std::vector<PathInfo>& candidate_path);
+bool validate_alternate_by_local_optimality(const CandidateConnection& candidate, float optimal_cost);
 } // namespace thor
 } // namespace valhalla
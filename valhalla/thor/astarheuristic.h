@@ -1,23 +1,35 @@
 #ifndef VALHALLA_THOR_ASTARHEURISTIC_H_
 #define VALHALLA_THOR_ASTARHEURISTIC_H_
 
+#include <valhalla/baldr/alttile.h>
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphreader.h>
 #include <valhalla/midgard/distanceapproximator.h>
 #include <valhalla/midgard/pointll.h>
 #include <valhalla/midgard/util.h>
+#include <valhalla/proto/common.pb.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace valhalla {
 namespace thor {
 
 /**
  * Class to calculate A* cost heuristics based on distances of nodes from
- * a destination within the shortest path computation.
+ * a destination within the shortest path computation. The straight line
+ * distance can be tightened with precomputed road distances to landmarks
+ * (ALT) when the node is known.
  */
 class AStarHeuristic {
 public:
   /**
    * Constructor.
    */
-  AStarHeuristic() : distapprox_({}), costfactor_(1.0f) {
+  AStarHeuristic() : distapprox_({}), costfactor_(1.0f), reader_(nullptr), next_alt_tile_(0) {
   }
 
   /**
@@ -33,8 +45,25 @@ public:
   void Init(const midgard::PointLL& ll, const float factor) {
     distapprox_.SetTestPoint(ll);
     costfactor_ = factor;
+    landmarks_.reset();
+    reader_ = nullptr;
+    target_bounds_.clear();
+    ClearAltTiles();
   }
 
+  /**
+   * Uses landmark distances to tighten the estimate towards the target location. Must be called
+   * after Init. If the landmark distances do not cover the target only the straight line distance
+   * is used.
+   * @param  landmarks  Landmark side tiles, can be null
+   * @param  reader     Graph reader to find the nodes at the ends of the target edges and the graph
+   *                     tiles the side tiles are checked against, used until the next Init
+   * @param  target     The location the heuristic estimates the cost to
+   */
+  void InitLandmarks(const std::shared_ptr<baldr::AltLandmarks>& landmarks,
+                     baldr::GraphReader& reader,
+                     const valhalla::Location& target);
+
   /**
    * Get the distance to the destination given the lat,lng.
    * @param   ll  Current latitude, longitude.
@@ -77,10 +106,70 @@ public:
     return dist * costfactor_;
   }
 
-private:
+  /**
+   * Get the A* heuristic given the lat,lng of a graph node. Also return
+   * the straight line distance via an argument.
+   * @param   ll    Lat,lng of the node
+   * @param   node  The node, used to look up its landmark distances
+   * @param   dist  Distance (meters) to the destination.
+   * @return  Returns an estimate of the cost to the destination.
+   *          For A* shortest path this MUST UNDERESTIMATE the true cost.
+   */
+  float Get(const midgard::PointLL& ll, const baldr::GraphId& node, float& dist) const {
+    dist = sqrtf(distapprox_.DistanceSquared(ll));
+    if (target_bounds_.empty()) {
+      return dist * costfactor_;
+    }
+    return std::max(dist, LandmarkDistance(node)) * costfactor_;
+  }
+
+  /**
+   * Get the A* heuristic given the lat,lng of a graph node.
+   * @param   ll    Lat,lng of the node
+   * @param   node  The node, used to look up its landmark distances
+   * @return  Returns an estimate of the cost to the destination.
+   *          For A* shortest path this MUST UNDERESTIMATE the true cost.
+   */
+  float Get(const midgard::PointLL& ll, const baldr::GraphId& node) const {
+    float dist;
+    return Get(ll, node, dist);
+  }
+
+protected:
+  /**
+   * The largest lower bound on the road distance from the node to the
+   * target that any of the landmarks gives.
+   * @param   node  The node
+   * @return  Returns the lower bound in meters, 0 if unknown
+   */
+  float LandmarkDistance(const baldr::GraphId& node) const;
+
+  /**
+   * Forgets the side tiles looked up so far so their memory can be released.
+   */
+  void ClearAltTiles() {
+    recent_alt_tiles_.fill({});
+    next_alt_tile_ = 0;
+  }
+
   midgard::DistanceApproximator<midgard::PointLL> distapprox_; // Distance approximation
   float costfactor_; // Cost factor - ensures the cost estimate
                      // underestimates the true cost.
+
+  // Landmark distances and, per landmark, the range of distances of the
+  // nodes around the target. Landmarks which do not reach the target have
+  // an empty range (first > second)
+  std::shared_ptr<baldr::AltLandmarks> landmarks_;
+  std::vector<std::pair<uint32_t, uint32_t>> target_bounds_;
+  baldr::GraphReader* reader_;
+
+  // The side tiles of the last few graph tiles looked up. The search expands across a handful of
+  // tiles at a time so the shared cache, and its lock, is only needed when it moves on
+  static constexpr size_t kRecentAltTiles = 8;
+  mutable std::array<std::pair<baldr::GraphId, std::shared_ptr<const baldr::AltTile>>,
+                     kRecentAltTiles>
+      recent_alt_tiles_;
+  mutable size_t next_alt_tile_;
 };
 
 } // namespace thor
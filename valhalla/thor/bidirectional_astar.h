@@ -3,6 +3,7 @@
 
 #include <valhalla/baldr/double_bucket_queue.h>
 #include <valhalla/baldr/time_info.h>
+#include <valhalla/midgard/threadpool.h>
 #include <valhalla/proto/api.pb.h>
 #include <valhalla/sif/edgelabel.h>
 #include <valhalla/sif/hierarchylimits.h>
@@ -25,6 +26,11 @@ struct CandidateConnection {
   baldr::GraphId edgeid;
   baldr::GraphId opp_edgeid;
   float cost;
+  // The plateau is the stretch of edges around the connection where the forward and reverse search
+  // trees agree. Connections sharing a plateau describe the same via path. These are only filled in
+  // when alternates are requested.
+  baldr::GraphId plateau_start;
+  float plateau_cost = 0.f;
   bool operator<(const CandidateConnection& o) const {
     return cost < o.cost;
   }
@@ -33,6 +39,16 @@ struct CandidateConnection {
   }
 };
 
+/**
+ * The reverse search tree of a finished bidirectional A* search. Its settled labels hold the exact
+ * cost to the destination, so a later search towards the same destination can connect into it
+ * without running the reverse search again.
+ */
+struct ReverseSearchTree {
+  std::vector<sif::BDEdgeLabel> edgelabels;
+  EdgeStatus edgestatus;
+};
+
 /**
  * Bidirectional A* algorithm. Method for finding least-cost path.
  */
@@ -81,6 +97,22 @@ public:
    */
   void Clear() override;
 
+  /**
+   * Provide the reverse tree of an earlier search towards the same destination. The next call to
+   * GetBestPath (without alternates) only runs the forward search and connects into this tree.
+   * @param  tree  Reverse search tree, usually obtained from ReleaseReverseTree.
+   */
+  void SetReverseTree(std::unique_ptr<ReverseSearchTree> tree) {
+    reverse_tree_ = std::move(tree);
+  }
+
+  /**
+   * Hand over the reverse search tree of the last call to GetBestPath so it can be kept for later
+   * searches towards the same destination. Must be called before Clear.
+   * @return  Returns the reverse search tree.
+   */
+  std::unique_ptr<ReverseSearchTree> ReleaseReverseTree();
+
 protected:
   // Access mode used by the costing method
   uint32_t access_mode_;
@@ -122,6 +154,15 @@ protected:
   uint32_t desired_paths_count_;
   std::vector<CandidateConnection> best_connections_;
 
+  // Number of threads used to evaluate candidate connections when looking for alternates, they
+  // are kept in the pool from search to search
+  uint32_t alternates_concurrency_;
+  midgard::ThreadPool alternates_pool_;
+
+  // Reverse tree of an earlier search to reuse and whether the current search reuses one
+  std::unique_ptr<ReverseSearchTree> reverse_tree_;
+  bool reuse_reverse_tree_;
+
   // Extends search in one direction if the other direction exhausted, but only if the non-exhausted
   // end started on a not_thru or closed (due to live-traffic) edge
   bool extended_search_;
@@ -216,6 +257,20 @@ protected:
    */
   bool SetReverseConnection(baldr::GraphReader& graphreader, const sif::BDEdgeLabel& pred);
 
+  /**
+   * Find the plateau a candidate connection lies on by walking back along the forward tree and
+   * ahead along the reverse tree for as long as both trees use the same edges. Only reads the
+   * search trees so it is safe to call concurrently for different connections.
+   * @param  connection  The candidate connection, its plateau start and cost are set.
+   */
+  void FindPlateau(CandidateConnection& connection) const;
+
+  /**
+   * Find the plateaus of all the best connections, spreading the work over the up to
+   * alternates_concurrency_ threads of the pool.
+   */
+  void FindPlateaus();
+
   /**
    * Form the path from the adjacency lists. Recovers the path from the
    * where the paths meet back towards the origin then reverses this path.
@@ -81,6 +81,25 @@ public:
     expansion_callback_ = expansion_callback;
   }
 
+  /**
+   * Set a callback that will throw when the expansion should be aborted
+   * @param interrupt_callback  the function to periodically call to see if
+   *                            we should abort
+   */
+  void set_interrupt(const std::function<void()>* interrupt_callback) {
+    interrupt_ = interrupt_callback;
+  }
+
+  /**
+   * Returns how many edges the algorithm has settled (taken off of its adjacency list) over its
+   * whole lifetime. It is not reset by Clear so the work of an expansion is the difference of two
+   * calls
+   * @return the number of settled edges
+   */
+  uint64_t settled_edges() const {
+    return settled_edges_;
+  }
+
 protected:
   /**
    * Compute the best first graph traversal from a list of origin locations
@@ -168,7 +187,21 @@ protected:
   // separately from the other paths
   bool multipath_;
 
-  // TODO: add an interrupt here so that the caller can abort the main loop externally
+  // called every so often while expanding, throws when the expansion should be aborted
+  const std::function<void()>* interrupt_;
+
+  // edges taken off of the adjacency lists, for the request statistics and work budgets
+  uint64_t settled_edges_;
+
+  /**
+   * Counts a settled edge and periodically gives the caller the chance to abort the expansion
+   */
+  void Settled() {
+    ++settled_edges_;
+    if (interrupt_ && (settled_edges_ % kInterruptIterationsInterval) == 0) {
+      (*interrupt_)();
+    }
+  }
 
   /**
    * Initialization prior to computing the graph expansion
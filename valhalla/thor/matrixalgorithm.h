@@ -30,7 +30,8 @@ public:
    */
   MatrixAlgorithm(const boost::property_tree::ptree& config)
       : interrupt_(nullptr), has_time_(false), not_thru_pruning_(true), expansion_callback_(),
-        clear_reserved_memory_(config.get<bool>("clear_reserved_memory", false)) {
+        row_callback_(), clear_reserved_memory_(config.get<bool>("clear_reserved_memory", false)),
+        settled_edges_(0) {
   }
 
   MatrixAlgorithm(const MatrixAlgorithm&) = delete;
@@ -134,6 +135,27 @@ public:
     expansion_callback_ = expansion_callback;
   }
 
+  /**
+   * Sets the functor which is called with the index of a source as soon as its row of the matrix
+   * is final, so it can be serialized before the rest of the matrix is done. Algorithms which only
+   * finish rows at the very end never call it.
+   *
+   * @param  row_callback  the functor to call back with the source index of a finished row
+   */
+  using row_callback_t = std::function<void(const valhalla::Matrix&, uint32_t)>;
+  void set_row_callback(const row_callback_t& row_callback) {
+    row_callback_ = row_callback;
+  }
+
+  /**
+   * Returns how many edges the algorithm has settled (taken off of its adjacency list) over its
+   * whole lifetime. It is not reset by Clear so the work of a search is the difference of two calls
+   * @return the number of settled edges
+   */
+  uint64_t settled_edges() const {
+    return settled_edges_;
+  }
+
 protected:
   const std::function<void()>* interrupt_;
 
@@ -146,11 +168,17 @@ protected:
   // for tracking the expansion of the algorithm visually
   expansion_callback_t expansion_callback_;
 
+  // for serializing the rows of the matrix as soon as they are done
+  row_callback_t row_callback_;
+
   uint32_t max_reserved_labels_count_;
 
   // if `true` clean reserved memory for edge labels
   bool clear_reserved_memory_;
 
+  // edges taken off of the adjacency lists, for the request statistics and work budgets
+  uint64_t settled_edges_;
+
   // on first pass, resizes all PBF sequences and defaults to 0 or ""
   inline static void
   reserve_pbf_arrays(valhalla::Matrix& matrix, size_t size, bool verbose, uint32_t pass = 0) {
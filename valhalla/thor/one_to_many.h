@@ -0,0 +1,134 @@
+#ifndef VALHALLA_THOR_ONE_TO_MANY_H_
+#define VALHALLA_THOR_ONE_TO_MANY_H_
+
+#include <valhalla/baldr/graphid.h>
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/baldr/time_info.h>
+#include <valhalla/proto/api.pb.h>
+#include <valhalla/sif/dynamiccost.h>
+#include <valhalla/thor/dijkstras.h>
+#include <valhalla/thor/pathinfo.h>
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace valhalla {
+namespace thor {
+
+/**
+ * A best first (dijkstras) expansion from a single origin which runs until the shortest path to
+ * every destination has been settled. Rather than computing one route per destination, each with its
+ * own expansion from the same origin, the paths to all of the destinations are recovered from the one
+ * shared search tree.
+ */
+class OneToMany : public thor::Dijkstras {
+public:
+  /**
+   * Constructor.
+   * @param config A config object of key, value pairs
+   */
+  explicit OneToMany(const boost::property_tree::ptree& config = {});
+
+  /**
+   * Finds the best path from the first location of the request to each of the other locations
+   *
+   * @param api       The request whose first location is the origin and the rest destinations
+   * @param reader    Graph reader to provide access to graph primitives
+   * @param costings  Per mode costing objects
+   * @param mode      The mode specifying which costing to use
+   * @return          One path per destination in the order of the request locations. The path of a
+   *                  destination which could not be reached, or which lies behind the origin on the
+   *                  origin edge, is left empty
+   */
+  std::vector<std::vector<PathInfo>> Expand(valhalla::Api& api,
+                                            baldr::GraphReader& reader,
+                                            const sif::mode_costing_t& costings,
+                                            const sif::TravelMode mode);
+
+  /**
+   * Resets internal state before the next call
+   */
+  virtual void Clear() override;
+
+protected:
+  /**
+   * We only care about edges who have been settled which means we can completely ignore this
+   */
+  virtual void ExpandingNode(baldr::GraphReader&,
+                             graph_tile_ptr,
+                             const baldr::NodeInfo*,
+                             const sif::EdgeLabel&,
+                             const sif::EdgeLabel*) override {
+  }
+
+  /**
+   * Fired when the edge in the label has been settled. If a destination lies along it we remember
+   * the cost to reach it and stop the expansion once every destination has been settled
+   *
+   * @param reader      used for accessing graph primitives
+   * @param pred        label of the edge who has just been settled (shortest path found)
+   * @param route_type  enum of forward/reverse/multimodal
+   * @return whether to continue, prune this branch or stop the expansion
+   */
+  virtual thor::ExpansionRecommendation ShouldExpand(baldr::GraphReader& reader,
+                                                     const sif::EdgeLabel& pred,
+                                                     const thor::ExpansionType route_type) override;
+
+  /**
+   * Tell the expansion how many labels to expect and how many buckets to use
+   *
+   * @param bucket_count            impacts the number of buckets in the double bucket queue
+   * @param edge_label_reservation  an estimate of the total number of edgelabels for this expansion
+   */
+  virtual void GetExpansionHints(uint32_t& bucket_count,
+                                 uint32_t& edge_label_reservation) const override;
+
+  /**
+   * Prepares the lookup of destination edges and the distance bound of the expansion
+   *
+   * @param locations  The request locations, the first being the origin
+   * @param costing    The costing used to reject user avoided destination edges
+   */
+  void SetDestinations(const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+                       const std::shared_ptr<sif::DynamicCost>& costing);
+
+  /**
+   * Walks back the labels of each settled destination to recover its path from the origin
+   *
+   * @return The list of paths, one for each destination
+   */
+  std::vector<std::vector<PathInfo>> FormPaths() const;
+
+  // The best way found so far to reach a destination
+  struct Destination {
+    uint32_t label_index = baldr::kInvalidLabel; // label of the edge the destination lies on
+    sif::Cost cost{std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float path_distance = 0.f;    // distance from the origin to the destination
+    uint32_t remaining_edges = 0; // candidate edges which are not yet settled
+    bool behind_origin = false;   // a candidate edge is the origin edge but behind the origin
+  };
+  std::vector<Destination> destinations_;
+
+  // destination candidate edges to the indices of the destinations on them and their percent along
+  std::unordered_map<uint64_t, std::vector<std::pair<uint32_t, float>>> destination_edges_;
+
+  // origin candidate edges to their percent along
+  std::unordered_map<uint64_t, float> origin_edges_;
+
+  // number of destinations whose candidate edges have all been settled
+  uint32_t settled_count_;
+
+  // labels further than this from the origin are not expanded
+  float max_distance_;
+
+  // the time at the origin, used to cost the part of an edge past a destination
+  baldr::TimeInfo time_info_;
+};
+
+} // namespace thor
+} // namespace valhalla
+
+#endif // VALHALLA_THOR_ONE_TO_MANY_H_
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <valhalla/baldr/alttile.h>
 #include <valhalla/baldr/graphid.h>
 #include <valhalla/baldr/graphreader.h>
 #include <valhalla/baldr/tilehierarchy.h>
@@ -10,6 +11,7 @@
 #include <valhalla/thor/pathinfo.h>
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace valhalla {
@@ -32,7 +34,7 @@ public:
   PathAlgorithm(uint32_t max_reserved_labels_count, bool clear_reserved_memory)
       : interrupt(nullptr), has_ferry_(false), not_thru_pruning_(true), expansion_callback_(),
         max_reserved_labels_count_(max_reserved_labels_count),
-        clear_reserved_memory_(clear_reserved_memory) {
+        clear_reserved_memory_(clear_reserved_memory), settled_edges_(0) {
   }
 
   PathAlgorithm(const PathAlgorithm&) = delete;
@@ -83,6 +85,16 @@ public:
     interrupt = interrupt_callback;
   }
 
+  /**
+   * Set the landmark distances used to tighten the A* heuristic. Algorithms
+   * which do not use an A* heuristic ignore them.
+   * @param landmarks  the landmark side tiles or null to only use straight
+   *                   line distances
+   */
+  void set_landmarks(const std::shared_ptr<baldr::AltLandmarks>& landmarks) {
+    landmarks_ = landmarks;
+  }
+
   /**
    * Does the path include a ferry?
    * @return  Returns true if the path includes a ferry.
@@ -136,6 +148,15 @@ public:
     expansion_callback_ = expansion_callback;
   }
 
+  /**
+   * Returns how many edges the algorithm has settled (taken off of its adjacency list) over its
+   * whole lifetime. It is not reset by Clear so the work of a search is the difference of two calls
+   * @return the number of settled edges
+   */
+  uint64_t settled_edges() const {
+    return settled_edges_;
+  }
+
 protected:
   const std::function<void()>* interrupt;
 
@@ -143,6 +164,9 @@ protected:
 
   bool not_thru_pruning_; // Indicates whether to allow access into a not-thru region.
 
+  // landmark distances for the A* heuristic, may be null
+  std::shared_ptr<baldr::AltLandmarks> landmarks_;
+
   // for tracking the expansion of the algorithm visually
   expansion_callback_t expansion_callback_;
 
@@ -153,6 +177,9 @@ protected:
 
   // if `true` clean reserved memory for edge labels
   bool clear_reserved_memory_;
+
+  // edges taken off of the adjacency list, for the request statistics
+  uint64_t settled_edges_;
 };
 
 /**
@@ -0,0 +1,97 @@
+#ifndef VALHALLA_THOR_REVERSE_TREE_CACHE_H_
+#define VALHALLA_THOR_REVERSE_TREE_CACHE_H_
+
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/thor/bidirectional_astar.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace valhalla {
+namespace thor {
+
+/**
+ * Keeps the reverse search trees of bidirectional A* per navigation session (identified by the
+ * reroute token of the request) so that off-route recalculations towards the same destination only
+ * have to run the forward search. A tree is handed out to one search at a time and has to be put
+ * back afterwards. Trees are only reused when the fingerprint (destination, costing and the versions
+ * of the tiles and live traffic) matches.
+ */
+class ReverseTreeCache {
+public:
+  /**
+   * Constructor.
+   * @param max_trees  Maximum number of trees kept, the oldest is evicted when full.
+   * @param max_age    Seconds after which a stored tree is no longer used.
+   * @param check_interval  Seconds between checks of the tileset and live traffic versions.
+   */
+  ReverseTreeCache(size_t max_trees, uint32_t max_age, uint32_t check_interval = 10);
+
+  /**
+   * Get the cache shared by all thor workers of this process, creating it from the
+   * thor.reroute_cache section of the config if needed.
+   * @param config  The thor config.
+   * @return  Returns the shared cache or nullptr if rerouting is disabled.
+   */
+  static std::shared_ptr<ReverseTreeCache> shared(const boost::property_tree::ptree& config);
+
+  /**
+   * Get the versions of the tiles and live traffic, which have to be part of every fingerprint so
+   * that trees computed on older data aren't reused.
+   * @param reader  Used to check the versions from time to time.
+   * @return  Returns the versions or an empty string if they aren't known yet.
+   */
+  std::string version(const baldr::GraphReader& reader);
+
+  /**
+   * Take the tree stored for a session out of the cache.
+   * @param token        The reroute token of the session.
+   * @param fingerprint  Identifies the destination and costing of the request.
+   * @return  Returns the tree or nullptr if there is none or it does not match.
+   */
+  std::unique_ptr<ReverseSearchTree> take(const std::string& token, const std::string& fingerprint);
+
+  /**
+   * Store the tree of a session, replacing any previous one.
+   * @param token        The reroute token of the session.
+   * @param fingerprint  Identifies the destination and costing of the request.
+   * @param tree         The reverse search tree.
+   */
+  void put(const std::string& token,
+           const std::string& fingerprint,
+           std::unique_ptr<ReverseSearchTree> tree);
+
+  /**
+   * @return  Returns the number of trees currently stored.
+   */
+  size_t size() const;
+
+protected:
+  struct entry_t {
+    std::string fingerprint;
+    std::unique_ptr<ReverseSearchTree> tree;
+    std::chrono::steady_clock::time_point stored;
+  };
+
+  size_t max_trees_;
+  std::chrono::seconds max_age_;
+  std::chrono::seconds check_interval_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, entry_t> trees_;
+
+  // versions of the data, refreshed by one worker at a time outside of the lock
+  std::chrono::steady_clock::time_point checked_;
+  std::string version_;
+  bool refreshing_;
+};
+
+} // namespace thor
+} // namespace valhalla
+
+#endif // VALHALLA_THOR_REVERSE_TREE_CACHE_H_
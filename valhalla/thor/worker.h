@@ -18,6 +18,8 @@
 #include <valhalla/thor/costmatrix.h>
 #include <valhalla/thor/isochrone.h>
 #include <valhalla/thor/multimodal.h>
+#include <valhalla/thor/one_to_many.h>
+#include <valhalla/thor/reverse_tree_cache.h>
 #include <valhalla/thor/timedistancebssmatrix.h>
 #include <valhalla/thor/timedistancematrix.h>
 #include <valhalla/thor/triplegbuilder.h>
@@ -27,6 +29,12 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -65,11 +73,89 @@ public:
   void set_interrupt(const std::function<void()>* interrupt) override;
 
 protected:
+  /**
+   * A thread of the worker which computes legs of multipoint routes, along with what it needs to
+   * do so. Path algorithms, costings and graph readers are not thread safe so every thread owns its
+   * own. Their readers share one synchronized tile cache.
+   */
+  struct leg_slot_t {
+    explicit leg_slot_t(const boost::property_tree::ptree& config);
+    ~leg_slot_t();
+
+    /**
+     * Hands a job to the thread of the slot. The job must not throw
+     * @param job  the work to do
+     */
+    void run(std::function<void()> job);
+
+    /**
+     * Waits for the job of the slot to finish
+     * @param timeout  how long to wait at most
+     * @return whether the slot is idle
+     */
+    bool wait_for(std::chrono::milliseconds timeout);
+
+    /**
+     * Copies the counters of the slot to where other threads can read them
+     */
+    void publish();
+
+    std::shared_ptr<baldr::GraphReader> reader;
+    BidirectionalAStar bidir_astar;
+    TimeDepForward timedep_forward;
+    sif::mode_costing_t mode_costing;
+
+    // installed on the algorithms and the reader of the slot. it throws leg_cancelled_t when the
+    // legs are cancelled, the interrupt of the request itself is only called by the worker thread
+    std::function<void()> interrupt;
+
+    // the counters of the slot as of the last interrupt or job
+    std::atomic<uint64_t> settled_edges{0};
+    std::atomic<uint64_t> tile_cache_hits{0};
+    std::atomic<uint64_t> tile_cache_misses{0};
+
+  private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::function<void()> job;
+    bool stop = false;
+    std::thread thread;
+  };
+
+  // thrown on the threads of the leg slots once the legs of a route are cancelled
+  struct leg_cancelled_t {};
+
+  /**
+   * A leg of a multipoint route computed ahead of the sequential merge of the legs
+   */
+  struct speculative_leg_t {
+    std::vector<std::vector<thor::PathInfo>> paths;
+    // the departure time the leg was computed for, empty if it does not depend on time
+    std::string date_time;
+  };
+
   std::vector<std::vector<thor::PathInfo>> get_path(PathAlgorithm* path_algorithm,
                                                     Location& origin,
                                                     Location& destination,
                                                     const std::string& costing,
-                                                    const Options& options);
+                                                    const Options& options,
+                                                    leg_slot_t* slot = nullptr);
+  /**
+   * Computes the legs of a multipoint route concurrently. Time dependent legs are computed for an
+   * estimated departure time. Returns nothing if the legs depend on each other (through locations)
+   * or if concurrency is disabled. While the legs are computed the interrupt of the request keeps
+   * being checked on the calling thread, the first error of a leg (or the interrupt) is rethrown
+   * there once all the legs stopped.
+   *
+   * @param options    the request options
+   * @param locations  the correlated locations of the route, "current" time is resolved in place
+   * @param costing    the name of the costing
+   * @return one entry per leg, a leg without paths has to be computed sequentially
+   */
+  std::vector<speculative_leg_t>
+  compute_legs(const Options& options,
+               google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
+               const std::string& costing);
   void log_admin(const TripLeg&);
   thor::PathAlgorithm* get_path_algorithm(const std::string& routetype,
                                           const Location& origin,
@@ -87,8 +173,44 @@ protected:
    */
   std::vector<std::tuple<float, float, std::vector<meili::MatchResult>>> map_match(Api& request);
 
+  /**
+   * Running totals of the work done by the search algorithms and graph readers of this worker
+   */
+  struct search_counters_t {
+    uint64_t settled_edges;
+    uint64_t tile_cache_hits;
+    uint64_t tile_cache_misses;
+  };
+  search_counters_t search_counters() const;
+
+  /**
+   * Records how many edges were settled, how the tile cache fared and how long it took to build the
+   * trip legs for the request when the returned object goes out of scope
+   * @param api  the request to add the statistics to
+   * @return an object whose destructor records the statistics
+   */
+  midgard::Finally<std::function<void()>> measure_search(Api& api);
+
+  /**
+   * Limits on the work a single request may do, a limit of 0 is no limit
+   */
+  struct work_budget_t {
+    uint64_t max_settled_edges;
+    uint64_t max_tiles_loaded;
+    std::chrono::milliseconds max_time;
+  };
+
+  /**
+   * Holds the searches of the request to the work budget until the returned object goes out of
+   * scope. The budget is checked whenever a search polls its interrupt and throws once it is used
+   * up. Nested calls share the budget of the outermost one
+   * @return an object whose destructor stops checking the budget
+   */
+  midgard::Finally<std::function<void()>> enforce_budget();
+
   void path_arrive_by(Api& api, const std::string& costing);
   void path_depart_at(Api& api, const std::string& costing);
+  void path_one_to_many(Api& api, const std::string& costing);
   void parse_measurements(const Api& request);
   std::string parse_costing(const Api& request);
 
@@ -123,6 +245,24 @@ protected:
   TimeDistanceMatrix time_distance_matrix_;
   TimeDistanceBSSMatrix time_distance_bss_matrix_;
 
+  // Reverse search trees kept for rerouting, shared by the workers of this process
+  std::shared_ptr<ReverseTreeCache> reroute_cache;
+
+  // Threads for the legs of multipoint routes and how far off (in seconds) the estimated departure
+  // of a time dependent leg may be before it is recomputed
+  std::vector<std::unique_ptr<leg_slot_t>> leg_slots;
+  std::atomic<bool> legs_cancelled{false};
+  float max_leg_departure_drift;
+
+  // time spent building trip legs for the current request
+  std::chrono::steady_clock::duration trip_build_time{};
+
+  // the work budget of each request, the check of it while one is enforced and the interrupt
+  // calling that check. the leg slots call the check themselves as they can't call the interrupt
+  work_budget_t budget;
+  std::function<void()> budget_check;
+  std::function<void()> budget_interrupt;
+
   Isochrone isochrone_gen;
   std::shared_ptr<meili::MapMatcher> matcher;
   float max_timedep_distance;
@@ -133,6 +273,7 @@ protected:
   meili::MapMatcherFactory matcher_factory;
   baldr::AttributesController controller;
   Centroid centroid_gen;
+  OneToMany one_to_many_gen;
 
   // Hierarchy limits
   bool allow_hierarchy_limits_modifications;
@@ -0,0 +1,104 @@
+#ifndef VALHALLA_TYR_RESULT_CACHE_H_
+#define VALHALLA_TYR_RESULT_CACHE_H_
+
+#include <valhalla/baldr/graphreader.h>
+#include <valhalla/proto/api.pb.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace valhalla {
+namespace tyr {
+
+/**
+ * Keeps the serialized responses of route, matrix and isochrone requests so that identical requests
+ * can be answered without running loki, thor and odin again. Requests are identical when their
+ * normalized options are, i.e. after parsing and defaulting but before any correlation. The tileset
+ * and live traffic versions are part of the key, so when either changes the old responses are no
+ * longer found and age out. The cache is bounded by the bytes of the keys and responses it holds
+ * and evicts the least recently used response when full.
+ */
+class ResultCache {
+public:
+  /**
+   * Constructor.
+   * @param max_size        Maximum number of bytes of keys and responses kept.
+   * @param max_age         Seconds after which a stored response is no longer used.
+   * @param check_interval  Seconds between checks of the tileset and live traffic versions.
+   */
+  ResultCache(size_t max_size, uint32_t max_age, uint32_t check_interval);
+
+  /**
+   * Get the cache shared by all workers of this process, creating it from the result_cache
+   * section of the config if needed.
+   * @param config  The loki section of the config.
+   * @return  Returns the shared cache or nullptr if the cache is disabled.
+   */
+  static std::shared_ptr<ResultCache> shared(const boost::property_tree::ptree& config);
+
+  /**
+   * Make the key of a freshly parsed request.
+   * @param api     The request, its options must not have been touched by loki yet.
+   * @param reader  Used to check the tileset and live traffic versions from time to time.
+   * @return  Returns the key or an empty string if the response to the request can't be cached.
+   */
+  std::string key(const Api& api, const baldr::GraphReader& reader);
+
+  /**
+   * Look up the response to a request.
+   * @param key       The key of the request.
+   * @param response  Set to the stored response on a hit.
+   * @return  Returns true on a hit.
+   */
+  bool get(const std::string& key, std::string& response);
+
+  /**
+   * Store the response to a request, responses larger than a tenth of the cache are not kept.
+   * @param key       The key of the request.
+   * @param response  The serialized response.
+   */
+  void put(const std::string& key, const std::string& response);
+
+  /**
+   * @return  Returns the number of bytes of keys and responses currently stored.
+   */
+  size_t size() const;
+
+protected:
+  struct entry_t {
+    std::string response;
+    std::chrono::steady_clock::time_point stored;
+    std::list<std::string>::iterator recency;
+  };
+
+  // drops an entry, must hold the lock
+  void erase(std::unordered_map<std::string, entry_t>::iterator itr);
+
+  size_t max_size_;
+  std::chrono::seconds max_age_;
+  std::chrono::seconds check_interval_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, entry_t> entries_;
+  // keys from the most to the least recently used
+  std::list<std::string> recency_;
+  size_t size_;
+
+  // versions of the data, part of every key. they are refreshed by one worker at a time outside of
+  // the lock and then swapped in
+  std::chrono::steady_clock::time_point checked_;
+  std::string version_;
+  bool refreshing_;
+};
+
+} // namespace tyr
+} // namespace valhalla
+
+#endif // VALHALLA_TYR_RESULT_CACHE_H_
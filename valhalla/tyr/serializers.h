@@ -12,6 +12,7 @@
 #include <valhalla/midgard/pointll.h>
 #include <valhalla/proto/api.pb.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -32,6 +33,58 @@ std::string serializeDirections(Api& request);
  */
 std::string serializeMatrix(Api& request);
 
+/**
+ * Serializes the rows of a matrix one by one as the matrix algorithm finishes them instead of
+ * walking the whole matrix once it is done. Only the concise json format and the dense binary
+ * format can be written like this, see Supports(). Rows which were not written while the
+ * algorithm ran are written when finishing.
+ *
+ * The binary format is little-endian: the magic "VMTX", a uint16 version, uint16 flags (bit 0 is
+ * set for miles), uint32 source and target counts, then a uint32 duration in seconds for every
+ * cell (UINT32_MAX if there is no route) and a float32 distance in the requested units for every
+ * cell (NaN if there is no route), both in source-major order.
+ */
+class MatrixRowWriter {
+public:
+  explicit MatrixRowWriter(const Api& request);
+  ~MatrixRowWriter();
+
+  /**
+   * Whether the response to this request can be written row by row
+   * @param request  the request
+   * @return true if the format and the options of the request are supported
+   */
+  static bool Supports(const Api& request);
+
+  /**
+   * Serializes the row of a source, rows have to be written in order
+   * @param matrix        the matrix being computed
+   * @param source_index  the index of the source whose row is done
+   */
+  void WriteRow(const valhalla::Matrix& matrix, uint32_t source_index);
+
+  /**
+   * Serializes the rows which are left and wraps them up into the response
+   * @param request  the request with the finished matrix
+   * @return the response
+   */
+  std::string Finish(Api& request);
+
+private:
+  uint32_t sources_;
+  uint32_t targets_;
+  uint32_t next_row_;
+  double distance_scale_;
+  bool binary_;
+  bool found_;
+
+  // json arrays of the rows or the cells of the binary arrays
+  std::unique_ptr<rapidjson::writer_wrapper_t> json_durations_;
+  std::unique_ptr<rapidjson::writer_wrapper_t> json_distances_;
+  std::string binary_durations_;
+  std::string binary_distances_;
+};
+
 /**
  * Turn grid data contours into geojson
  *
@@ -102,12 +155,8 @@ std::string serializeTraceAttributes(
  */
 std::string serializeStatus(Api& request);
 
-// Return a JSON array of OpenLR 1.5 line location references for each edge of a map matching
+// Add a JSON array of OpenLR 1.5 line location references for each edge of a map matching
 // result. For the time being, result is only non-empty for auto costing requests.
-void route_references(baldr::json::MapPtr& route_json,
-                      const TripRoute& route,
-                      const Options& options);
-
 void openlr(const valhalla::Api& api, int route_index, rapidjson::writer_wrapper_t& writer);
 
 /**
@@ -123,15 +172,21 @@ std::string serializePbf(Api& request);
  * @return json string
  */
 void serializeWarnings(const valhalla::Api& api, rapidjson::writer_wrapper_t& writer);
-baldr::json::ArrayPtr serializeWarnings(const valhalla::Api& api);
 
 /**
- * Turns a line into a GeoJSON LineString geometry.
+ * @brief Turns the statistics collected so far along the pipeline into json, only those stages that
+ *        ran before serialization will be present
+ * @param api     The request with the statistics in its info object
+ * @param writer  The writer to add the statistics array to
+ */
+void serializeStatistics(const valhalla::Api& api, rapidjson::writer_wrapper_t& writer);
+
+/**
+ * Turns a line into a GeoJSON LineString geometry, the caller starts and ends the geometry object.
  *
- * @param shape  The points making up the line.
- * @returns The GeoJSON geometry of the LineString
+ * @param shape   The points making up the line.
+ * @param writer  The writer to add the type and coordinates of the LineString to
  */
-baldr::json::MapPtr geojson_shape(const std::vector<midgard::PointLL>& shape);
 void geojson_shape(const std::vector<midgard::PointLL>& shape, rapidjson::writer_wrapper_t& writer);
 
 // Elevation serialization support
@@ -255,24 +310,19 @@ namespace osrm {
  * Serialize a location into a osrm waypoint
  * http://project-osrm.org/docs/v5.5.1/api/#waypoint-object
  */
-valhalla::baldr::json::MapPtr
-waypoint(const valhalla::Location& location, bool is_tracepoint = false, bool is_optimized = false);
 void waypoint(const valhalla::Location& location,
               rapidjson::writer_wrapper_t& writer,
               bool is_tracepoint = false,
               bool is_optimized = false);
 
 /*
- * Serialize locations into osrm waypoints
+ * Serialize locations into osrm waypoints, the caller starts and ends the array
  */
-valhalla::baldr::json::ArrayPtr
-waypoints(const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
-          bool tracepoints = false);
 void waypoints(const google::protobuf::RepeatedPtrField<valhalla::Location>& locations,
                rapidjson::writer_wrapper_t& writer,
                bool tracepoints = false);
-valhalla::baldr::json::ArrayPtr waypoints(const valhalla::Trip& locations);
-valhalla::baldr::json::ArrayPtr intermediate_waypoints(const valhalla::TripLeg& leg);
+void waypoints(const valhalla::Trip& trip, rapidjson::writer_wrapper_t& writer);
+void intermediate_waypoints(const valhalla::TripLeg& leg, rapidjson::writer_wrapper_t& writer);
 
 void serializeIncidentProperties(rapidjson::writer_wrapper_t& writer,
                                  const valhalla::IncidentsTile::Metadata& incident_metadata,
@@ -5,6 +5,7 @@
 #include <valhalla/valhalla.h>
 
 #include <string>
+#include <vector>
 
 #ifdef ENABLE_SERVICES
 #include <prime_server/http_protocol.hpp>
@@ -128,6 +129,7 @@ const content_type JSON_MIME{"Content-type", "application/json;charset=utf-8"};
 const content_type JS_MIME{"Content-type", "application/javascript;charset=utf-8"};
 const content_type PBF_MIME{"Content-type", "application/x-protobuf"};
 const content_type GPX_MIME{"Content-type", "application/gpx+xml;charset=utf-8"};
+const content_type BINARY_MIME{"Content-type", "application/octet-stream"};
 } // namespace worker
 
 prime_server::worker_t::result_t to_response(const std::string& data,
@@ -136,6 +138,10 @@ prime_server::worker_t::result_t to_response(const std::string& data,
 #endif
 
 struct statsd_client_t;
+class admission_controller_t;
+namespace tyr {
+class ResultCache;
+}
 class service_worker_t {
 public:
   service_worker_t(const boost::property_tree::ptree& config);
@@ -173,6 +179,23 @@ public:
    */
   virtual void set_interrupt(const std::function<void()>* interrupt);
 
+  /**
+   * Keeps the finished response of a request whose key was set by loki so that the next identical
+   * request can be answered straight from the result cache. Does nothing if caching is disabled
+   * @param api       The request object which carries the key
+   * @param response  The serialized response
+   */
+  void cache_result(const Api& api, const std::string& response) const;
+
+  /**
+   * Options for the arena which holds the request object while it is being worked on. The first
+   * block of the arena is a buffer this worker keeps from one request to the next, so most requests
+   * get their options, trip and directions without a single heap allocation. Only one arena made
+   * from these options may be alive at a time
+   * @return the options to construct the arena of a request with
+   */
+  google::protobuf::ArenaOptions request_arena_options();
+
 protected:
   /**
    * This converts each protobuf stat into a string and adds it to the queue of unsent stats
@@ -189,10 +212,27 @@ protected:
    * Used to measure the time it takes to do an action in the current stage of the pipeline.
    * This should be called at the top of the scope in each major action of each worker
    *
-   * @param api  The request object where we store the timing information
+   * @param api     The request object where we store the timing information
+   * @param metric  The last part of the stat key, by default the latency of the whole action
    * @return an object whose destructor records the elapsed time since construction as a stat
    */
-  midgard::Finally<std::function<void()>> measure_scope_time(Api& api) const;
+  midgard::Finally<std::function<void()>>
+  measure_scope_time(Api& api, const std::string& metric = "latency_ms") const;
+
+  /**
+   * Records a stat for the current stage of the pipeline under the key action.info.worker.metric.
+   * Timings and per request counts are both recorded as timing so that statsd aggregates them
+   * into histograms
+   *
+   * @param api     The request object where we store the stat
+   * @param metric  The last part of the stat key
+   * @param value   The value of the stat
+   * @param type    The statsd type of the stat
+   */
+  void add_statistic(Api& api,
+                     const std::string& metric,
+                     double value,
+                     StatisticType type = timing) const;
 
   /**
    * Signals the start of the worker, sends statsd message if so configured
@@ -201,6 +241,9 @@ protected:
 
   const std::function<void()>* interrupt;
   std::unique_ptr<statsd_client_t> statsd_client;
+  std::shared_ptr<tyr::ResultCache> result_cache;
+  std::shared_ptr<admission_controller_t> admission;
+  std::vector<char> request_arena_block;
 };
 } // namespace valhalla
 